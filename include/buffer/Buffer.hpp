@@ -32,6 +32,14 @@ public:
         LOCKED_BY_CONSUMER       // 被消费者锁定，正在使用数据
     };
     
+    // CPU 访问方向（DMA_BUF_IOCTL_SYNC 的 READ / WRITE 标志）
+    enum class CpuAccess {
+        NONE = 0,
+        READ = 1,
+        WRITE = 2,
+        READ_WRITE = 3
+    };
+    
     /**
      * @brief 构造函数
      * @param id 唯一标识符
@@ -90,6 +98,27 @@ public:
     /// 设置 DMA-BUF fd（用于共享/导出）
     void setDmaBufFd(int fd) { dma_fd_ = fd; }
     
+    /// 设置虚拟地址（DMA-BUF 导入的 buffer 在首次 CPU 访问时才映射）
+    void setVirtualAddress(void* virt_addr) { virt_addr_ = virt_addr; }
+    
+    // ========== CPU 缓存同步（DMA-BUF）==========
+    
+    /**
+     * @brief 开始 CPU 访问（DMA_BUF_IOCTL_SYNC START）
+     * 
+     * 带缓存的 DMA-BUF heap 上，CPU 读写前后必须成对调用 begin/end，
+     * 内核据此做 cache invalidate / flush，保证与显示引擎等设备一致。
+     * 
+     * @param access 访问方向
+     * @return true 成功或无需同步（无 DMA-BUF fd、access 为 NONE）
+     */
+    bool beginCpuAccess(CpuAccess access) const;
+    
+    /**
+     * @brief 结束 CPU 访问（DMA_BUF_IOCTL_SYNC END），参数须与 beginCpuAccess 一致
+     */
+    bool endCpuAccess(CpuAccess access) const;
+    
     // ========== 引用计数（用于外部buffer生命周期检测）==========
     
     /// 增加引用计数
@@ -111,10 +140,10 @@ public:
     
     /**
      * @brief 基础校验：检查Buffer是否仍然有效
-     * @return true 如果 magic number 正确且地址非空
+     * @return true 如果 magic number 正确且地址非空（尚未映射的 DMA-BUF 导入 buffer 以 fd 为准）
      */
     bool isValid() const { 
-        return validation_magic_ == MAGIC_NUMBER && virt_addr_ != nullptr;
+        return validation_magic_ == MAGIC_NUMBER && (virt_addr_ != nullptr || dma_fd_ >= 0);
     }
     
     /**
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 /**
@@ -35,6 +36,20 @@ public:
      * @brief 获取分配器类型名称（用于调试）
      */
     virtual const char* name() const = 0;
+    
+    /**
+     * @brief 获取 buffer 的 DMA-BUF fd（用于导出 / 设备导入 / CPU 访问同步）
+     * @return 不支持 DMA-BUF 的分配器返回 -1
+     */
+    virtual int getDmaBufFd(void* ptr) const {
+        (void)ptr;
+        return -1;
+    }
+    
+    /**
+     * @brief CPU 访问是否需要 DMA_BUF_IOCTL_SYNC（CPU 映射带缓存的 DMA-BUF）
+     */
+    virtual bool needsCpuSync() const { return false; }
 };
 
 // ============================================================
@@ -62,9 +77,34 @@ public:
 // CMA/DMA 连续物理内存分配器（使用 DMA-BUF heap）
 // ============================================================
 
+/**
+ * @brief DMA-BUF heap 选择（按 pool 配置）
+ *
+ * - kind：CMA（物理连续，可给无 IOMMU 的显示引擎扫描）/ SYSTEM（离散页，需 IOMMU）/
+ *   AUTO（依次尝试 linux,cma → system → /dev/ion）
+ * - cached：CPU 映射是否带缓存。带缓存的 heap 上 CPU memcpy / 格式转换接近普通内存速度，
+ *   但必须用 DMA_BUF_IOCTL_SYNC 包住 CPU 访问（见 Buffer::beginCpuAccess）；
+ *   不带缓存的 heap（system-uncached、linux,cma-uncached，视内核而定）无需同步，但 CPU 读写慢
+ */
+struct DmaHeapOptions {
+    enum class Kind {
+        AUTO,
+        CMA,
+        SYSTEM
+    };
+
+    Kind kind;
+    bool cached;
+
+    DmaHeapOptions() : kind(Kind::AUTO), cached(true) {}
+    DmaHeapOptions(Kind heap_kind, bool heap_cached) : kind(heap_kind), cached(heap_cached) {}
+
+    static const char* kindToString(Kind kind);
+};
+
 class CMAAllocator : public BufferAllocator {
 public:
-    CMAAllocator();
+    explicit CMAAllocator(const DmaHeapOptions& options = DmaHeapOptions());
     ~CMAAllocator() override;
     
     void* allocate(size_t size, uint64_t* out_phys_addr) override;
@@ -76,14 +116,36 @@ public:
      * @param ptr 虚拟地址
      * @return DMA-BUF fd，失败返回 -1
      */
-    int getDmaBufFd(void* ptr) const;
+    int getDmaBufFd(void* ptr) const override;
+    
+    bool needsCpuSync() const override { return heap_cached_; }
     
     /**
      * @brief 获取物理地址（通过 /proc/self/pagemap）
      */
     uint64_t getPhysicalAddress(void* virt_addr);
     
+    /**
+     * @brief 实际打开的 heap 设备路径（首次分配前为空）
+     */
+    const std::string& getHeapPath() const { return heap_path_; }
+    
+    /**
+     * @brief 已分配 buffer 的 CPU 映射是否带缓存（需要 DMA_BUF_IOCTL_SYNC）
+     */
+    bool isCached() const { return heap_cached_; }
+    
+    /**
+     * @brief 按选项列出候选 heap 设备路径（按优先级）
+     */
+    static std::vector<const char*> heapCandidates(const DmaHeapOptions& options);
+    
 private:
+    /**
+     * @brief 打开 heap 设备（只打开一次，后续分配复用 fd）
+     */
+    bool openHeap();
+    
     /**
      * @brief 通过 DMA-BUF heap 分配连续物理内存
      * @param size 大小
@@ -100,6 +162,71 @@ private:
         size_t size;
     };
     std::vector<DmaBufferInfo> dma_buffers_;
+    
+    DmaHeapOptions options_;
+    int heap_fd_;                 // heap 设备 fd（-1 表示未打开）
+    std::string heap_path_;       // 实际使用的 heap 设备
+    bool heap_cached_;            // 实际 heap 的 CPU 映射是否带缓存
+};
+
+// ============================================================
+// udmabuf 分配器（memfd 普通内存 → DMA-BUF）
+// ============================================================
+
+/**
+ * @brief 从 sealed memfd 分配普通内存，经 /dev/udmabuf 包装为 DMA-BUF fd
+ *
+ * 没有 CMA / DMA heap 的机器上也能得到可导出、可跨进程 / 跨设备共享的 buffer，
+ * CPU 访问就是普通（带缓存）内存的速度。
+ *
+ * - 内存离散（非物理连续），只能给带 IOMMU / scatter-gather 的设备导入，
+ *   getPhysicalAddress 类接口对它没有意义
+ * - memfd 设置 F_SEAL_SHRINK（udmabuf 的要求），buffer 生命周期内大小不可缩小
+ * - hugetlb 模式下大小向上取整到大页（2MB），减少 TLB miss 和 udmabuf 的页表项；
+ *   系统没有预留大页时自动退回普通页
+ *
+ * 需要内核 udmabuf 模块（modprobe udmabuf）且对 /dev/udmabuf 有读写权限。
+ */
+class UdmabufAllocator : public BufferAllocator {
+public:
+    /**
+     * @param use_hugetlb 优先使用 MFD_HUGETLB 大页
+     */
+    explicit UdmabufAllocator(bool use_hugetlb = false);
+    ~UdmabufAllocator() override;
+    
+    void* allocate(size_t size, uint64_t* out_phys_addr) override;
+    void deallocate(void* ptr, size_t size) override;
+    const char* name() const override { return "UdmabufAllocator"; }
+    
+    int getDmaBufFd(void* ptr) const override;
+    bool needsCpuSync() const override { return true; }
+    
+    /**
+     * @brief 获取 buffer 背后的 memfd（可用于跨进程传递后重新 mmap）
+     */
+    int getMemFd(void* ptr) const;
+    
+    /**
+     * @brief 系统是否可用 udmabuf（/dev/udmabuf 可打开）
+     */
+    static bool isAvailable();
+    
+private:
+    struct UdmaBufferInfo {
+        void* virt_addr;
+        int memfd;
+        int dmabuf_fd;
+        size_t size;              // 实际映射大小（大页模式下向上取整）
+        bool hugetlb;
+    };
+    
+    bool openDevice();
+    void release(const UdmaBufferInfo& info);
+    
+    bool use_hugetlb_;
+    int dev_fd_;                  // /dev/udmabuf
+    std::vector<UdmaBufferInfo> buffers_;
 };
 
 // ============================================================
@@ -9,7 +9,9 @@
 #include <unordered_map>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 #include <memory>
+#include <functional>
 
 /**
  * @brief BufferPool - 核心 Buffer 调度器
@@ -24,7 +26,7 @@
  * - 三种构造方式（自有/外部简单/外部生命周期检测）
  * - 物理地址感知（虚拟+物理）
  * - 外部 buffer 生命周期检测（weak_ptr 语义）
- * - DMA-BUF 导出支持
+ * - DMA-BUF 导出 / 导入支持
  */
 class BufferPool {
 public:
@@ -35,6 +37,18 @@ public:
         size_t size;            // Buffer 大小
     };
     
+    // ========== DMA-BUF 导入信息结构 ==========
+    struct DmaBufImportInfo {
+        int fd;                 // DMA-BUF fd（pool 内部 dup，调用方仍持有并负责关闭原 fd）
+        size_t size;            // 帧数据大小（从 offset 起）
+        size_t offset;          // 帧数据在 DMA-BUF 内的偏移（无需页对齐）
+        uint32_t stride;        // 行跨度（字节，0 表示紧密排列）
+        
+        DmaBufImportInfo() : fd(-1), size(0), offset(0), stride(0) {}
+        DmaBufImportInfo(int f, size_t sz, size_t off = 0, uint32_t st = 0)
+            : fd(f), size(sz), offset(off), stride(st) {}
+    };
+    
     // ========== 构造方式 1: 自己分配 buffer ==========
     /**
      * @brief 创建 BufferPool（自有内存）
@@ -49,6 +63,36 @@ public:
                const std::string name = "UnnamedPool",
                const std::string category = "");
     
+    // ========== 构造方式 1b: 自己分配 buffer（指定 DMA-BUF heap）==========
+    /**
+     * @brief 创建 BufferPool（DMA-BUF heap 内存，按 pool 选择 heap 类型）
+     * @param count Buffer 数量
+     * @param size 每个 Buffer 的大小
+     * @param heap heap 选择（CMA / system，带缓存 / 不带缓存）
+     * @param name Pool 名称（用于全局注册和调试）
+     * @param category Pool 分类
+     * @throws std::runtime_error 如果分配失败
+     * @note 带缓存的 heap 默认开启生产者写同步（见 setCpuAccessSync）
+     */
+    BufferPool(int count, size_t size, const DmaHeapOptions& heap,
+               const std::string name = "UnnamedPool",
+               const std::string category = "");
+    
+    // ========== 构造方式 1c: 自己分配 buffer（指定分配器）==========
+    /**
+     * @brief 创建 BufferPool（使用调用方提供的分配器，如 UdmabufAllocator）
+     * @param count Buffer 数量
+     * @param size 每个 Buffer 的大小
+     * @param allocator 分配器（所有权转移给 pool）
+     * @param name Pool 名称（用于全局注册和调试）
+     * @param category Pool 分类
+     * @throws std::runtime_error 如果分配失败（不降级到其他分配器）
+     * @note 分配器提供 DMA-BUF fd 时 buffer 可导出；needsCpuSync() 时默认开启生产者写同步
+     */
+    BufferPool(int count, size_t size, std::unique_ptr<BufferAllocator> allocator,
+               const std::string name = "UnnamedPool",
+               const std::string category = "");
+    
     // ========== 构造方式 2: 托管外部 buffer（简单版）==========
     /**
      * @brief 创建 BufferPool（托管外部buffer）
@@ -117,6 +161,31 @@ public:
      */
     BufferPool(const std::string name, const std::string category, size_t max_capacity = 0);
     
+    // ========== 构造方式 5: 导入 DMA-BUF fd（零拷贝）==========
+    /**
+     * @brief 创建 BufferPool（导入其他进程 / V4L2 / DRM 设备导出的 DMA-BUF）
+     * 
+     * - 每个 fd 在构造时 dup 一份，pool 析构时关闭；调用方的 fd 不受影响
+     * - 不立即 mmap：buffer 的虚拟地址为空，只有 CPU 访问时才映射
+     *   （setCpuAccessSync 指定的 begin 时自动映射，或显式调用 mapForCpu）
+     * - 纯设备间传递（如显示引擎按 fd 扫描输出）全程不建立 CPU 映射
+     * - 面向设备生产者（V4L2 / DRM 直接写入 fd）：默认 (NONE, NONE) 同步时 acquireFree()
+     *   返回的 buffer 没有虚拟地址。CPU 生产者须先 setCpuAccessSync(WRITE, ...)
+     *   或对每个 buffer 调用 mapForCpu(buffer, WRITE)；VideoProducer 拒绝在导入 pool 上
+     *   运行需要 CPU 写入的 Reader
+     * - 只读导出的 fd（O_RDONLY）只建立只读映射：isCpuWritable() 为 false，
+     *   setCpuAccessSync 拒绝 WRITE，mapForCpu(WRITE) 失败
+     * - Buffer::getDmaBufFd() 始终有效，CPU 访问同步走 DMA_BUF_IOCTL_SYNC
+     * 
+     * @param imports DMA-BUF 描述数组
+     * @param name Pool 名称（用于全局注册和调试）
+     * @param category Pool 分类
+     * @throws std::invalid_argument 数组为空或 fd 无效
+     */
+    BufferPool(const std::vector<DmaBufImportInfo>& imports,
+               const std::string name = "UnnamedPool",
+               const std::string category = "");
+    
     /**
      * @brief 析构函数 - 释放资源
      */
@@ -133,6 +202,7 @@ public:
      * @param blocking 是否阻塞等待
      * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
      * @return Buffer* 成功返回 buffer，失败返回 nullptr
+     * @note 按生产者同步建立 CPU 映射失败的 buffer 移出循环（见 getUnmappableCount）
      */
     Buffer* acquireFree(bool blocking = true, int timeout_ms = -1);
     
@@ -149,6 +219,7 @@ public:
      * @param blocking 是否阻塞等待
      * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
      * @return Buffer* 成功返回 buffer，失败返回 nullptr
+     * @note 按消费者同步建立 CPU 映射失败时丢弃该帧，buffer 移出循环
      */
     Buffer* acquireFilled(bool blocking = true, int timeout_ms = -1);
     
@@ -193,6 +264,130 @@ public:
      */
     bool ejectBuffer(Buffer* buffer);
     
+    // ========== 扇出观察者接口（录制/转储/校验等旁路消费者）==========
+    
+    /**
+     * @brief 帧观察者回调类型
+     * @param buffer 消费者刚刚使用完（已显示）的 buffer，回调返回后即被回收
+     */
+    using FrameObserver = std::function<void(const Buffer* buffer)>;
+    
+    /**
+     * @brief 注册帧观察者（fan-out）
+     * 
+     * 观察者在消费者调用 releaseFilled() 时、buffer 回到空闲队列之前被调用，
+     * 因此看到的正是消费者实际使用（显示）过的帧，且无需第二条解码管线。
+     * 
+     * @param observer 回调函数
+     * @return 观察者 ID（用于 removeFrameObserver）
+     * 
+     * @note 回调在消费者线程中同步执行：必须快速返回（拷贝或丢弃），不能阻塞
+     * @note 生产者失败时调用 releaseFilled() 归还的空 buffer 不会通知观察者
+     */
+    int addFrameObserver(FrameObserver observer);
+    
+    /**
+     * @brief 注销帧观察者（返回后保证回调不再被调用）
+     */
+    bool removeFrameObserver(int observer_id);
+    
+    /**
+     * @brief 在观察者回调中保留 buffer（零拷贝旁路消费）
+     * 
+     * 被保留的 buffer 在 releaseFilled() 后不会立即回到空闲队列，
+     * 直到所有保留者调用 releaseRetained()，用于异步写盘等场景。
+     * 
+     * @param buffer 观察者回调收到的 buffer
+     * @return true 保留成功；false 表示不支持（如临时注入的 buffer），调用者应拷贝数据
+     * 
+     * @note 仅能在 FrameObserver 回调中调用
+     * @note 保留期间生产者可用的 buffer 减少，保留者必须限制同时保留的数量
+     */
+    bool retainBuffer(const Buffer* buffer);
+    
+    /**
+     * @brief 释放 retainBuffer() 的保留，最后一个保留者释放时 buffer 回到空闲队列
+     */
+    void releaseRetained(const Buffer* buffer);
+    
+    /// 获取当前被保留的 buffer 数量
+    int getRetainedCount() const;
+    
+    // ========== 空闲监听者接口（共享生产者调度）==========
+    
+    /**
+     * @brief 空闲监听者回调类型（有 buffer 回到空闲队列时调用）
+     */
+    using FreeListener = std::function<void()>;
+    
+    /**
+     * @brief 注册空闲监听者
+     * 
+     * 在 releaseFilled() / releaseRetained() 把 buffer 放回空闲队列之后调用（不持有 pool 锁），
+     * 供 ProducerExecutor 等调度器在 pool 有空闲 buffer 时才派发读帧任务，
+     * 而不是让线程阻塞在 acquireFree() 上。
+     * 
+     * @return 监听者 ID（用于 removeFreeListener）
+     * 
+     * @note 回调在归还 buffer 的线程（通常是消费者线程）中同步执行，必须快速返回；
+     *       回调中可以调用 getFreeCount() / acquireFree(false)
+     */
+    int addFreeListener(FreeListener listener);
+    
+    /**
+     * @brief 注销空闲监听者（返回后保证回调不再被调用）
+     */
+    bool removeFreeListener(int listener_id);
+    
+    // ========== CPU 缓存同步（DMA-BUF）==========
+    
+    /**
+     * @brief 设置生产者 / 消费者的 CPU 访问同步
+     * 
+     * 对带 DMA-BUF fd 的 buffer，pool 在以下位置调用 DMA_BUF_IOCTL_SYNC：
+     * - acquireFree() 之后 begin(producer)，submitFilled() / 生产者 releaseFilled() 之前 end(producer)
+     * - acquireFilled() 之后 begin(consumer)，releaseFilled() 时（观察者回调之后）end(consumer)
+     * 
+     * 典型配置：
+     * - 生产者 CPU 拷贝 / 转换写入、显示引擎读取：(WRITE, NONE)（带缓存 heap 的默认值）
+     * - 消费者还要在 CPU 上叠加 OSD：(WRITE, READ_WRITE)
+     * - 不带缓存的 heap / 普通内存：(NONE, NONE)
+     * 
+     * @return false 表示拒绝：含只读导入 fd 的 pool 上请求 WRITE（生产者或消费者），原设置不变
+     */
+    bool setCpuAccessSync(Buffer::CpuAccess producer, Buffer::CpuAccess consumer);
+    
+    Buffer::CpuAccess getProducerCpuAccess() const { return producer_access_.load(); }
+    Buffer::CpuAccess getConsumerCpuAccess() const { return consumer_access_.load(); }
+    
+    /**
+     * @brief buffer 的 CPU 映射是否带缓存（需要 DMA_BUF_IOCTL_SYNC 才能与设备保持一致）
+     * 
+     * 带缓存的 DMA-BUF 内存为 true（导入的 DMA-BUF 缓存属性未知，按带缓存处理）。
+     * 设备生产（如 V4L2 DMABUF 采集）时生产者同步为 NONE，但 CPU 消费者仍需 begin(READ)，
+     * 应根据此值而不是生产者同步模式判断
+     */
+    bool isCpuCached() const { return cpu_cached_; }
+    
+    /// DMA_BUF_IOCTL_SYNC 调用次数（begin + end）
+    uint64_t getCpuSyncCount() const { return sync_calls_.load(); }
+    
+    /**
+     * @brief 所有 buffer 是否都能建立可写的 CPU 映射
+     * 
+     * 只读导出的导入 fd（O_RDONLY，如 V4L2 capture 导出）返回 false，
+     * 这类 pool 只能由设备写入，CPU 只能读
+     */
+    bool isCpuWritable() const;
+    
+    /**
+     * @brief 因 CPU 映射失败而移出循环的 buffer 数量
+     * 
+     * acquireFree() / acquireFilled() 时映射失败的 buffer 不再放回队列（映射不会自行恢复），
+     * 等于 getTotalCount() 时再也取不到 buffer，生产者应停止而不是继续等待
+     */
+    int getUnmappableCount() const;
+    
     // ========== 查询接口 ==========
     
     /// 获取空闲 buffer 数量
@@ -290,22 +485,76 @@ public:
      * @brief 导出 buffer 为 DMA-BUF fd（用于跨进程共享）
      * @param buffer_id Buffer ID
      * @return DMA-BUF fd，失败返回 -1
-     * @note 仅 CMA/DMA buffer 支持导出
+     * @note 仅 DMA-BUF 分配器（CMAAllocator / UdmabufAllocator）的 buffer 支持导出；
+     *       fd 仍归 pool 所有，跨进程传递后由接收方 dup / close 自己的副本
      */
     int exportBufferAsDmaBuf(uint32_t buffer_id);
     
+    // ========== 高级功能：DMA-BUF 导入 ==========
+    
+    /**
+     * @brief 获取 buffer 的 CPU 地址，导入的 DMA-BUF 尚未映射时在此映射（线程安全）
+     * @param access 调用方的访问方式；包含 WRITE 时只读映射视为失败
+     * @return 虚拟地址；映射失败或只读 fd 上请求写入时返回 nullptr
+     * @note 映射一直保留到 pool 析构；非导入 buffer 直接返回 getVirtualAddress()
+     */
+    void* mapForCpu(Buffer* buffer, Buffer::CpuAccess access = Buffer::CpuAccess::READ_WRITE);
+    
+    /**
+     * @brief 是否为 DMA-BUF 导入 pool（构造方式 5）
+     */
+    bool isDmaBufImport() const { return !imports_.empty(); }
+    
+    /**
+     * @brief 获取导入时的描述（offset / stride 等）
+     * @return buffer 不是导入的 DMA-BUF 时返回 false
+     */
+    bool getImportInfo(uint32_t buffer_id, DmaBufImportInfo* info) const;
+    
+    /// 已建立 CPU 映射的导入 buffer 数量
+    int getMappedImportCount() const;
+    
 private:
     // ========== 内部初始化方法 ==========
     
-    void initializeOwnedBuffers(int count, size_t size, bool use_cma);
+    void initializeOwnedBuffers(int count, size_t size, bool use_cma,
+                                const DmaHeapOptions& heap = DmaHeapOptions());
+    void allocateOwnedBuffers(int count, size_t size,
+                              std::unique_ptr<BufferAllocator> allocator,
+                              bool allow_fallback);
+    std::unique_ptr<BufferAllocator> createFallbackAllocator() const;
+    void releaseOwnedBuffers();
     void initializeExternalBuffers(const std::vector<ExternalBufferInfo>& infos);
     void initializeFromHandles(std::vector<std::unique_ptr<BufferHandle>> handles);
+    void initializeDmaBufImports(const std::vector<DmaBufImportInfo>& imports);
+    void releaseDmaBufImports();
     
     // ========== 辅助方法 ==========
     
     /// 检查 buffer 是否属于本 pool
     bool verifyBufferOwnership(const Buffer* buffer) const;
     
+    /// 同上（调用者已持有 mutex_）
+    bool verifyBufferOwnershipLocked(const Buffer* buffer) const;
+    
+    /// validateBuffer 的实现（调用者已持有 mutex_，供 acquire* 内部使用）
+    bool validateBufferLocked(const Buffer* buffer) const;
+    
+    /// 通知所有帧观察者（releaseFilled 内部调用）
+    void notifyFrameObservers(const Buffer* buffer);
+    
+    /// 通知所有空闲监听者（调用者不能持有 mutex_）
+    void notifyFreeListeners();
+    
+    /// 将 buffer 放回空闲队列（调用者已持有 mutex_）
+    void recycleBufferLocked(Buffer* buffer);
+    
+    /// CPU 访问同步（调用者不持有 mutex_），begin 时无法建立所需映射返回 false
+    bool syncCpuAccess(Buffer* buffer, Buffer::CpuAccess access, bool begin);
+    
+    /// 将无法映射的 buffer 移出循环（调用者不持有 mutex_）
+    void retireUnmappableBuffer(Buffer* buffer);
+    
     /// 获取物理地址（通过 allocator）
     uint64_t getPhysicalAddress(void* virt_addr);
     
@@ -325,6 +574,16 @@ private:
     // 内存分配器（策略模式）
     std::unique_ptr<BufferAllocator> allocator_;
     
+    // 导入的 DMA-BUF（下标 = buffer id）
+    struct ImportedDmaBuf {
+        DmaBufImportInfo info;            // fd 为 pool 持有的 dup
+        void* map_base;                   // mmap 返回值（页对齐，未映射为 nullptr）
+        size_t map_length;
+        bool read_only;                   // fd 只允许 PROT_READ 映射（导入时按 fd 访问模式判断）
+    };
+    std::vector<ImportedDmaBuf> imports_;
+    mutable std::mutex import_mutex_;     // 保护懒映射
+    
     // 外部 buffer 生命周期跟踪
     std::vector<std::unique_ptr<BufferHandle>> external_handles_;  // 持有所有权
     std::vector<std::weak_ptr<bool>> lifetime_trackers_;           // 生命周期检测
@@ -345,5 +604,26 @@ private:
     
     // 统计
     uint32_t next_buffer_id_;             // 下一个分配的 Buffer ID
+    
+    // 扇出观察者
+    std::vector<std::pair<int, FrameObserver>> frame_observers_;
+    std::vector<std::pair<int, FreeListener>> free_listeners_;
+    int next_observer_id_;                // 观察者与空闲监听者共用
+    std::mutex observer_mutex_;           // 保护观察者 / 空闲监听者列表（回调期间持有）
+    
+    // 观察者保留的 buffer（受 mutex_ 保护）
+    struct RetainInfo {
+        int holds;                        // 未释放的保留次数
+        bool consumer_released;           // 消费者是否已调用 releaseFilled
+    };
+    std::unordered_map<const Buffer*, RetainInfo> retained_;
+    
+    // CPU 缓存同步
+    std::atomic<Buffer::CpuAccess> producer_access_;
+    std::atomic<Buffer::CpuAccess> consumer_access_;
+    bool cpu_cached_;                     // CPU 映射带缓存（构造后不变）
+    std::atomic<uint64_t> sync_calls_;
+    std::atomic<uint64_t> sync_failures_;
+    int unmappable_count_;                // 映射失败、已移出循环的 buffer（受 mutex_ 保护）
 };
 
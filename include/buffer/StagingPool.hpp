@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 零拷贝注入帧的暂存内存池
+ * 
+ * 推送型 Reader 把解码/转换后的帧放进暂存内存，再包装为 BufferHandle 注入
+ * BufferPool。帧在消费者 releaseFilled 后才释放，时机不受 reader 控制：
+ * - deleter 持有本池的 shared_ptr，把内存还回空闲列表
+ * - reader 先于这些帧销毁也安全
+ * - 稳态下不再每帧 new / delete 整帧内存
+ * 
+ * 使用示例：
+ * @code
+ * bool allocated = false;
+ * uint8_t* staging = pool->acquire(&allocated);
+ * // ... 写入一帧 ...
+ * auto handle = std::make_unique<BufferHandle>(staging, 0, pool->frame_size,
+ *     [pool](void* ptr) { pool->recycle(reinterpret_cast<uint8_t*>(ptr)); });
+ * @endcode
+ */
+struct StagingPool {
+    static constexpr size_t kMaxIdle = 8;   // 超出的归还直接释放（限制空闲内存）
+    
+    std::mutex mutex;
+    std::vector<uint8_t*> idle;
+    size_t frame_size;
+    
+    explicit StagingPool(size_t size) : frame_size(size) {
+        idle.reserve(kMaxIdle);     // recycle 不再扩容
+    }
+    
+    ~StagingPool() {
+        for (uint8_t* ptr : idle) {
+            delete[] ptr;
+        }
+    }
+    
+    StagingPool(const StagingPool&) = delete;
+    StagingPool& operator=(const StagingPool&) = delete;
+    
+    /**
+     * @param allocated 输出：是否新分配（空闲列表为空）
+     */
+    uint8_t* acquire(bool* allocated) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                uint8_t* ptr = idle.back();
+                idle.pop_back();
+                *allocated = false;
+                return ptr;
+            }
+        }
+        *allocated = true;
+        return new uint8_t[frame_size];
+    }
+    
+    void recycle(uint8_t* ptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (idle.size() < kMaxIdle) {
+                idle.push_back(ptr);
+                return;
+            }
+        }
+        delete[] ptr;
+    }
+};
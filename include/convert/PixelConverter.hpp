@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../buffer/Buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 像素格式枚举
+ *
+ * 32/16/12 位格式按"像素值"描述（小端存储，高位在前书写），
+ * 24 位格式按内存字节顺序描述（与 FFmpeg 命名一致）。
+ */
+enum class PixelFormat {
+    UNKNOWN,
+
+    // ========== RGB（可作为源和目标） ==========
+    ARGB8888,     // uint32: A[31:24] R[23:16] G[15:8] B[7:0]（内存 B,G,R,A）
+    XRGB8888,     // 同 ARGB8888，alpha 字节忽略（写入 0xFF）
+    ABGR8888,     // uint32: A[31:24] B[23:16] G[15:8] R[7:0]（内存 R,G,B,A）
+    BGR24,        // 内存 B,G,R（Linux fb 24bpp, red.offset=16）
+    RGB24,        // 内存 R,G,B
+    RGB565,       // uint16: R[15:11] G[10:5] B[4:0]
+    BGR565,       // uint16: B[15:11] G[10:5] R[4:0]
+    ARGB4444,     // uint16: A[15:12] R[11:8] G[7:4] B[3:0]
+    RGB444,       // 12bpp 紧凑排列：两个像素占 3 字节，像素值 R[11:8] G[7:4] B[3:0]
+
+    // ========== YUV（仅作为源） ==========
+    NV12,         // Y 平面 + UV 交错平面（4:2:0）
+    NV21,         // Y 平面 + VU 交错平面（4:2:0）
+    I420,         // Y / U / V 三平面（4:2:0）
+    YUYV,         // 打包 4:2:2：Y0 U Y1 V
+    UYVY          // 打包 4:2:2：U Y0 V Y1
+};
+
+/**
+ * @brief YUV → RGB 色彩空间
+ */
+enum class ColorSpace {
+    BT601_LIMITED,    // SD 视频默认（Y: 16-235）
+    BT601_FULL,       // JPEG / 全范围
+    BT709_LIMITED,    // HD 视频默认
+    BT709_FULL
+};
+
+/**
+ * @brief PixelConverter - 显示像素格式转换器
+ *
+ * 职责：
+ * - 在 ARGB8888 / XRGB8888 / ABGR8888 / BGR24 / RGB24 / RGB565 / BGR565 /
+ *   ARGB4444 / RGB444(12bpp) 之间互相转换
+ * - 将 NV12 / NV21 / I420 / YUYV / UYVY 转换为上述任意 RGB 格式
+ * - 根据 fb_var_screeninfo 的 bitfields 自动识别显示格式
+ *
+ * 实现方式：
+ * - 每种格式提供"行解包（→ ARGB8888）"和"行打包（ARGB8888 →）"两个函数
+ * - 源或目标为 ARGB8888 时直接解包/打包，不经过中间行
+ * - 热点路径（YUV→ARGB、ARGB→RGB565、BGR24↔ARGB）有 SSE2 / NEON 实现
+ * - 其余常用 RGB 格式对使用 PixelKernels 中按格式编译期特化的行内核
+ *   （构造时查表，每帧只按对齐选择 aligned / unaligned 实例）
+ *
+ * 使用示例：
+ * @code
+ * PixelFormat fb_format = display.getPixelFormat();   // 例如 RGB565
+ * PixelConverter converter(PixelFormat::ARGB8888, fb_format, 1920, 1080);
+ * converter.convert(src_buffer, fb_buffer);
+ * @endcode
+ *
+ * @note 不做缩放：源和目标尺寸相同
+ * @note 转换器本身无共享状态（除内部行缓冲），不同线程应使用不同实例
+ */
+class PixelConverter {
+public:
+    /**
+     * @brief 通道位域（与 struct fb_bitfield 的 offset/length 对应）
+     */
+    struct ChannelLayout {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param src_format 源格式
+     * @param dst_format 目标格式（必须为 RGB 格式）
+     * @param width, height 帧尺寸（像素）
+     * @param color_space YUV 源使用的色彩空间
+     *
+     * @note 不支持的组合不会抛异常，isSupported() 返回 false，convert() 失败
+     */
+    PixelConverter(PixelFormat src_format, PixelFormat dst_format,
+                   int width, int height,
+                   ColorSpace color_space = ColorSpace::BT601_LIMITED);
+
+    ~PixelConverter() = default;
+
+    /**
+     * @brief 转换组合是否受支持
+     */
+    bool isSupported() const { return supported_; }
+
+    /**
+     * @brief 设置源/目标行跨度（字节，0 表示紧凑排列）
+     *
+     * 对平面 YUV 格式，stride 指 Y 平面跨度，色度平面跨度按格式推导
+     */
+    void setSourceStride(size_t stride) { src_stride_ = stride; }
+    void setDestStride(size_t stride) { dst_stride_ = stride; }
+
+    /**
+     * @brief 转换一帧（平面格式的各平面在 src 中连续存放）
+     * @param src 源数据
+     * @param src_size 源数据大小（字节）
+     * @param dst 目标数据
+     * @param dst_size 目标数据大小（字节）
+     * @return 成功返回 true
+     */
+    bool convert(const void* src, size_t src_size, void* dst, size_t dst_size);
+
+    /**
+     * @brief 转换一帧（Buffer 版本）
+     */
+    bool convert(const Buffer& src, Buffer& dst);
+
+    /**
+     * @brief 转换一帧（各平面独立指针，用于 AVFrame 等）
+     * @param planes 源平面指针（packed 格式只用 planes[0]）
+     * @param strides 源平面跨度（字节）
+     */
+    bool convertPlanes(const uint8_t* const planes[3], const int strides[3],
+                       void* dst, size_t dst_size);
+
+    /**
+     * @brief 启用/禁用编译期特化的行内核（默认启用，禁用后走解包 + 打包通用路径，用于基准对比）
+     */
+    void setUseSpecializedKernels(bool enable) { use_specialized_ = enable; }
+
+    /**
+     * @brief 当前格式对使用的特化内核名称（如 "ABGR8888→RGB565"），无特化内核返回 nullptr
+     */
+    const char* getSpecializedKernelName() const { return specialized_name_; }
+
+    PixelFormat getSourceFormat() const { return src_format_; }
+    PixelFormat getDestFormat() const { return dst_format_; }
+
+    // ========== 格式工具函数 ==========
+
+    /**
+     * @brief 每像素位数（平面 YUV 返回平均值，如 NV12 = 12）
+     */
+    static int bitsPerPixel(PixelFormat format);
+
+    /**
+     * @brief 紧凑排列时一帧的字节数
+     */
+    static size_t frameSize(PixelFormat format, int width, int height);
+
+    /**
+     * @brief 紧凑排列时一行的字节数（平面格式为 Y 平面行）
+     */
+    static size_t rowBytes(PixelFormat format, int width);
+
+    static bool isYuv(PixelFormat format);
+
+    static const char* formatName(PixelFormat format);
+
+    /**
+     * @brief 按名称解析格式（不区分大小写，如 "rgb565"、"nv12"）
+     */
+    static PixelFormat formatFromName(const char* name);
+
+    /**
+     * @brief 根据 framebuffer bitfields 识别像素格式
+     * @param bits_per_pixel fb_var_screeninfo.bits_per_pixel
+     * @param red, green, blue, transp fb_var_screeninfo 对应位域
+     * @return 识别出的格式；无法识别时按 bits_per_pixel 猜测默认格式
+     */
+    static PixelFormat fromBitfields(int bits_per_pixel,
+                                     ChannelLayout red, ChannelLayout green,
+                                     ChannelLayout blue, ChannelLayout transp);
+
+    /**
+     * @brief 仅根据 bits_per_pixel 推测默认格式（32→ARGB8888, 24→BGR24, 16→RGB565, 12→RGB444）
+     */
+    static PixelFormat fromBitsPerPixel(int bits_per_pixel);
+
+    /**
+     * @brief 获取运行时选中的 SIMD 实现名称（"SSE2"/"NEON"/"Scalar"，见 CpuFeatures）
+     */
+    static const char* getKernelName();
+
+private:
+    /**
+     * @brief YUV → RGB 定点系数（6 位小数）
+     */
+    struct YuvCoefficients {
+        int y_offset;     // 16（limited）或 0（full）
+        int y_mul;
+        int v_to_r;
+        int u_to_g;
+        int v_to_g;
+        int u_to_b;
+    };
+
+    void unpackRow(const uint8_t* const planes[3], const int strides[3], int row, uint32_t* out);
+    void packRow(const uint32_t* in, uint8_t* out);
+
+    static YuvCoefficients coefficientsFor(ColorSpace color_space);
+
+    PixelFormat src_format_;
+    PixelFormat dst_format_;
+    int width_;
+    int height_;
+    ColorSpace color_space_;
+    YuvCoefficients coeffs_;
+    size_t src_stride_;
+    size_t dst_stride_;
+    bool supported_;
+
+    // 编译期特化的行内核（同 PixelKernels::RowKernel；[0] = 非对齐，[1] = 对齐），nullptr = 无特化
+    using RowKernel = void (*)(const uint8_t* src, uint8_t* dst, int width);
+    RowKernel specialized_[2];
+    const char* specialized_name_;
+    bool use_specialized_;
+
+    std::vector<uint32_t> row_buffer_;   // 中间 ARGB8888 行（源和目标都不是 ARGB 时使用）
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "PixelConverter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief 按像素格式特化的编译期内核库
+ *
+ * 组成：
+ * - PixelTraits<F>：格式 F 的每像素字节数、load（→ ARGB8888 值）、store（ARGB8888 值 →）
+ * - PixelRowKernel<Src, Dst, Aligned>：由两个 traits 组合出的行转换内核，
+ *   格式、每像素字节数和对齐在编译期确定，内层循环没有任何运行时分支，
+ *   编译器可以完全展开 / 向量化；Src == Dst 时特化为 memcpy
+ * - PixelKernels：常用格式对的实例化表，运行时按 (src, dst, 对齐) 查表取函数指针
+ *
+ * 与 PixelConverter 的"解包到 ARGB 中间行 + 打包"通用路径结果逐位一致
+ * （load/store 与 unpackRow/packRow 使用相同的位扩展 / 截断规则）。
+ *
+ * 使用示例：
+ * @code
+ * PixelKernels::RowKernel kernel = PixelKernels::find(PixelFormat::ABGR8888, PixelFormat::RGB565,
+ *                                                     PixelKernels::isAligned(src, src_stride) &&
+ *                                                     PixelKernels::isAligned(dst, dst_stride));
+ * if (kernel) {
+ *     for (int y = 0; y < height; y++) kernel(src + y * src_stride, dst + y * dst_stride, width);
+ * }
+ * @endcode
+ *
+ * @note RGB444（两像素共用 3 字节）和 YUV 源不在此库中，由 PixelConverter 处理
+ */
+
+// ============ 格式 traits ============
+
+template <PixelFormat F>
+struct PixelTraits;
+
+template <>
+struct PixelTraits<PixelFormat::ARGB8888> {
+    static constexpr int kBytes = 4;
+    static inline uint32_t load(const uint8_t* p) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        memcpy(p, &argb, 4);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::XRGB8888> {
+    static constexpr int kBytes = 4;
+    static inline uint32_t load(const uint8_t* p) {
+        return PixelTraits<PixelFormat::ARGB8888>::load(p) | 0xFF000000u;
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        PixelTraits<PixelFormat::ARGB8888>::store(argb | 0xFF000000u, p);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::ABGR8888> {
+    static constexpr int kBytes = 4;
+    static inline uint32_t swapRB(uint32_t v) {
+        return (v & 0xFF00FF00u) | ((v & 0xFF) << 16) | ((v >> 16) & 0xFF);
+    }
+    static inline uint32_t load(const uint8_t* p) {
+        return swapRB(PixelTraits<PixelFormat::ARGB8888>::load(p));
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        PixelTraits<PixelFormat::ARGB8888>::store(swapRB(argb), p);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::BGR24> {
+    static constexpr int kBytes = 3;
+    static inline uint32_t load(const uint8_t* p) {
+        return 0xFF000000u | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        p[0] = (uint8_t)argb;
+        p[1] = (uint8_t)(argb >> 8);
+        p[2] = (uint8_t)(argb >> 16);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::RGB24> {
+    static constexpr int kBytes = 3;
+    static inline uint32_t load(const uint8_t* p) {
+        return 0xFF000000u | ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        p[0] = (uint8_t)(argb >> 16);
+        p[1] = (uint8_t)(argb >> 8);
+        p[2] = (uint8_t)argb;
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::RGB565> {
+    static constexpr int kBytes = 2;
+    static inline uint32_t load(const uint8_t* p) {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        uint32_t r = (v >> 11) & 0x1F, g = (v >> 5) & 0x3F, b = v & 0x1F;
+        // 位复制扩展，保证 0x1F → 0xFF
+        return 0xFF000000u | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) |
+               ((b << 3) | (b >> 2));
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        uint16_t v = (uint16_t)(((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F));
+        memcpy(p, &v, 2);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::BGR565> {
+    static constexpr int kBytes = 2;
+    static inline uint32_t load(const uint8_t* p) {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        uint32_t b = (v >> 11) & 0x1F, g = (v >> 5) & 0x3F, r = v & 0x1F;
+        return 0xFF000000u | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) |
+               ((b << 3) | (b >> 2));
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        uint16_t v = (uint16_t)(((argb << 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 19) & 0x001F));
+        memcpy(p, &v, 2);
+    }
+};
+
+template <>
+struct PixelTraits<PixelFormat::ARGB4444> {
+    static constexpr int kBytes = 2;
+    static inline uint32_t load(const uint8_t* p) {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        return (((v >> 12) & 0xFu) * 17 << 24) | (((v >> 8) & 0xFu) * 17 << 16) |
+               (((v >> 4) & 0xFu) * 17 << 8) | ((v & 0xFu) * 17);
+    }
+    static inline void store(uint32_t argb, uint8_t* p) {
+        uint16_t v = (uint16_t)(((argb >> 16) & 0xF000) | ((argb >> 12) & 0x0F00) |
+                                ((argb >> 8) & 0x00F0) | ((argb >> 4) & 0x000F));
+        memcpy(p, &v, 2);
+    }
+};
+
+// ============ 行内核 ============
+
+/**
+ * @brief 行转换内核：Src 格式一行 → Dst 格式一行
+ * @tparam Aligned 源 / 目标行起始地址按 PixelKernels::kAlignment 对齐（提示编译器使用对齐访问）
+ */
+template <PixelFormat Src, PixelFormat Dst, bool Aligned>
+struct PixelRowKernel {
+    static void run(const uint8_t* src, uint8_t* dst, int width);
+};
+
+// 同格式：整行拷贝
+template <PixelFormat F, bool Aligned>
+struct PixelRowKernel<F, F, Aligned> {
+    static void run(const uint8_t* src, uint8_t* dst, int width) {
+        memcpy(dst, src, (size_t)width * PixelTraits<F>::kBytes);
+    }
+};
+
+/**
+ * @brief 常用格式对的实例化表与运行时查找
+ */
+class PixelKernels {
+public:
+    /**
+     * @brief 行内核函数指针
+     */
+    using RowKernel = void (*)(const uint8_t* src, uint8_t* dst, int width);
+
+    /**
+     * @brief Aligned 实例要求的地址 / 跨度对齐（字节）
+     */
+    static constexpr size_t kAlignment = 16;
+
+    /**
+     * @brief 查找 (src, dst) 的特化内核
+     * @param aligned 源 / 目标的行地址和跨度都满足 kAlignment
+     * @return 未实例化的组合返回 nullptr（调用方走通用路径）
+     */
+    static RowKernel find(PixelFormat src, PixelFormat dst, bool aligned);
+
+    /**
+     * @brief 表项名称（如 "ABGR8888→RGB565"），未实例化返回 nullptr
+     */
+    static const char* name(PixelFormat src, PixelFormat dst);
+
+    /**
+     * @brief 行起始地址和跨度是否都满足 kAlignment
+     */
+    static bool isAligned(const void* row, size_t stride) {
+        return ((reinterpret_cast<uintptr_t>(row) | stride) & (kAlignment - 1)) == 0;
+    }
+
+    /**
+     * @brief 表中实例化的格式对数量
+     */
+    static int count();
+};
+
+template <PixelFormat Src, PixelFormat Dst, bool Aligned>
+void PixelRowKernel<Src, Dst, Aligned>::run(const uint8_t* src, uint8_t* dst, int width) {
+    constexpr int kSrcBytes = PixelTraits<Src>::kBytes;
+    constexpr int kDstBytes = PixelTraits<Dst>::kBytes;
+    if (Aligned) {
+        src = static_cast<const uint8_t*>(__builtin_assume_aligned(src, PixelKernels::kAlignment));
+        dst = static_cast<uint8_t*>(__builtin_assume_aligned(dst, PixelKernels::kAlignment));
+    }
+    for (int x = 0; x < width; x++) {
+        PixelTraits<Dst>::store(PixelTraits<Src>::load(src + x * kSrcBytes), dst + x * kDstBytes);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @brief SIMD 指令集级别
+ *
+ * x86 与 ARM 各自按能力递增排列：
+ * - x86：SCALAR < SSE2 < SSE42 < AVX2 < AVX512
+ * - ARM：SCALAR < NEON < SVE
+ */
+enum class SimdLevel {
+    SCALAR = 0,
+    SSE2,
+    SSE42,
+    AVX2,
+    AVX512,
+    NEON,
+    SVE,
+};
+
+/**
+ * @brief 运行时 CPU 能力检测
+ *
+ * 进程内只检测一次（首次 get() 时），各模块的内核分发表据此选择实现：
+ * - x86：__builtin_cpu_supports（含 OS 对 AVX 寄存器状态的支持检查）
+ * - ARM：getauxval(AT_HWCAP / AT_HWCAP2)
+ *
+ * 环境变量 DISPLAY_SIMD_LEVEL 可把有效级别压低到指定值（scalar / sse2 / sse4.2 /
+ * avx2 / avx512 / neon / sve），用于和标量实现做基准对比；
+ * 高于硬件能力的值会被截断到检测结果。
+ *
+ * 使用示例：
+ * @code
+ * if (CpuFeatures::get().allows(SimdLevel::AVX2)) {
+ *     kernel = &blendRowAvx2;
+ * }
+ * @endcode
+ *
+ * @note 各模块的分发表在首次使用时解析并缓存，环境变量需在进程启动前设置
+ */
+class CpuFeatures {
+public:
+    /**
+     * @brief 硬件检测结果（不受环境变量影响）
+     */
+    struct Flags {
+        bool sse2;
+        bool sse42;
+        bool avx2;
+        bool avx512;        ///< AVX-512 F + BW
+        bool neon;
+        bool sve;
+        bool crc32;         ///< ARMv8 CRC32 扩展（x86 的 CRC32C 属于 SSE4.2）
+
+        Flags()
+            : sse2(false), sse42(false), avx2(false), avx512(false)
+            , neon(false), sve(false), crc32(false) {}
+    };
+
+    /**
+     * @brief 环境变量名
+     */
+    static constexpr const char* kEnvOverride = "DISPLAY_SIMD_LEVEL";
+
+    /**
+     * @brief 获取进程内唯一实例（首次调用时检测，线程安全）
+     */
+    static const CpuFeatures& get();
+
+    /**
+     * @brief 硬件检测结果
+     */
+    const Flags& getFlags() const { return flags_; }
+
+    /**
+     * @brief 硬件支持的最高级别
+     */
+    SimdLevel getDetectedLevel() const { return detected_; }
+
+    /**
+     * @brief 有效级别（应用环境变量后）
+     */
+    SimdLevel getLevel() const { return level_; }
+
+    /**
+     * @brief 有效级别是否被环境变量压低
+     */
+    bool isOverridden() const { return level_ != detected_; }
+
+    /**
+     * @brief 是否允许使用指定级别的内核
+     *
+     * SCALAR 总是允许；其余级别要求与有效级别属于同一架构且不高于有效级别
+     */
+    bool allows(SimdLevel level) const;
+
+    /**
+     * @brief 是否允许使用硬件 CRC32C（x86 SSE4.2 / ARMv8 CRC32）
+     */
+    bool allowsHardwareCrc() const;
+
+    /**
+     * @brief 打印检测结果与有效级别
+     */
+    void print() const;
+
+    /**
+     * @brief 级别名称（"Scalar"、"SSE2"、"SSE4.2"、"AVX2"、"AVX-512"、"NEON"、"SVE"）
+     */
+    static const char* levelName(SimdLevel level);
+
+    /**
+     * @brief 解析级别名称（大小写不敏感，接受 "sse42"、"avx512" 等写法）
+     * @return 无法识别时返回 false
+     */
+    static bool parseLevel(const char* name, SimdLevel* level);
+
+private:
+    CpuFeatures();
+    CpuFeatures(const CpuFeatures&) = delete;
+    CpuFeatures& operator=(const CpuFeatures&) = delete;
+
+    void detect();
+    void applyOverride();
+
+    Flags flags_;
+    SimdLevel detected_;
+    SimdLevel level_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief 整帧拷贝 / 比较内核（运行时按 CpuFeatures 分发）
+ *
+ * - copy：大块（≥ kStreamingThreshold）拷贝在 x86 上使用非临时存储（AVX2 / SSE2），
+ *   绕过缓存直接写入目标，适合 framebuffer、DMA buffer 等 CPU 之后不再读取的目标；
+ *   小块和其他平台走 libc memcpy
+ * - mismatch：返回第一个不同字节的偏移（AVX2 / SSE2 / NEON 按块比较）
+ *
+ * 分发表在首次调用时按有效 SIMD 级别解析（受 DISPLAY_SIMD_LEVEL 影响）。
+ */
+class MemoryKernels {
+public:
+    /**
+     * @brief 使用非临时存储的最小拷贝大小（字节）
+     */
+    static constexpr size_t kStreamingThreshold = 1024 * 1024;
+
+    /**
+     * @brief 拷贝 size 字节（dst / src 不重叠）
+     */
+    static void copy(void* dst, const void* src, size_t size);
+
+    /**
+     * @brief 查找第一个不同字节
+     * @return 偏移；完全相同时返回 size
+     */
+    static size_t mismatch(const void* a, const void* b, size_t size);
+
+    /**
+     * @brief 两段内存是否相同
+     */
+    static bool equal(const void* a, const void* b, size_t size) {
+        return mismatch(a, b, size) == size;
+    }
+
+    /**
+     * @brief 获取运行时选中的内核名称（如 "AVX2"、"SSE2"、"NEON"、"Scalar"）
+     */
+    static const char* getKernelName();
+};
@@ -4,8 +4,11 @@
 #include "IDisplayDevice.hpp"
 #include "../buffer/Buffer.hpp"
 #include "../buffer/BufferPool.hpp"
+#include "../convert/PixelConverter.hpp"
+#include "../verify/FrameVerifier.hpp"
 #include <vector>
 #include <memory>
+#include <functional>
 #include <stdexcept>
 
 /**
@@ -41,6 +44,14 @@ private:
     int height_;                      // 显示高度（像素）
     int bits_per_pixel_;              // 每像素位数（可以是非整数字节，如12bit、16bit、24bit、32bit等）
     size_t buffer_size_;              // 单个buffer大小（字节）
+    PixelFormat pixel_format_;        // 由 fb_var_screeninfo 位域识别出的像素格式
+    
+    // ============ 格式转换（按需创建，源格式变化时重建）============
+    std::unique_ptr<PixelConverter> converter_;
+    ColorSpace converter_color_space_;
+    
+    // ============ 帧校验（可选，不拥有所有权）============
+    FrameVerifier* frame_verifier_;
     
     // ============ 状态标志 ============
     bool is_initialized_;
@@ -159,6 +170,56 @@ public:
      */
     bool displayBufferByMemcpyToFramebuffer(Buffer* buffer);
     
+    /**
+     * @brief 转换像素格式后拷贝到 framebuffer 再显示
+     * @param buffer 源 Buffer（尺寸与显示分辨率相同）
+     * @param src_format 源像素格式（如 ARGB8888、NV12）
+     * @param color_space YUV 源的色彩空间
+     * @return true 显示成功，false 显示失败
+     * 
+     * @note 目标格式由 getPixelFormat() 自动决定，同一份素材可用于
+     *       RGB565 / BGR24 / ARGB8888 / 12bpp 等不同面板
+     * @note 源格式与显示格式相同时等价于 displayBufferByMemcpyToFramebuffer()
+     */
+    bool displayBufferByConvertToFramebuffer(Buffer* buffer, PixelFormat src_format,
+                                             ColorSpace color_space = ColorSpace::BT601_LIMITED);
+    
+    /**
+     * @brief 写入函数：直接把一帧写入 framebuffer 后台 buffer（格式 getPixelFormat()，尺寸为显示分辨率）
+     */
+    using FramebufferWriter = std::function<bool(Buffer& back_buffer)>;
+    
+    /**
+     * @brief 由调用方直接写入 framebuffer 后台 buffer 再显示（融合转换 + 上屏）
+     * @param writer 写入函数（如解码器 sws_scale 直接输出到 back_buffer）
+     * @param frame_index 帧号（用于 PRE_DISPLAY 校验，-1 = 未知）
+     * @return true 显示成功，false 无空闲 buffer / 写入失败 / 切换失败
+     * 
+     * @note 工作流程：
+     *   1. 从 framebuffer pool 获取一个空闲 buffer（即 getBuffer(id) 的后台 buffer）
+     *   2. 调用 writer 写入
+     *   3. 切换显示到该 buffer（FBIOPAN_DISPLAY）
+     * 
+     * @note 与 displayBufferByMemcpyToFramebuffer() 相比省掉中间 buffer 和一次整帧拷贝：
+     *       解码 -> 转换到 pool buffer -> memcpy 变为 解码 -> 转换到 framebuffer
+     * @note writer 失败时 buffer 归还，不切换显示
+     */
+    bool displayByWritingToFramebuffer(const FramebufferWriter& writer, int frame_index = -1);
+    
+    /**
+     * @brief 获取显示像素格式（根据 fb_var_screeninfo 的 red/green/blue/transp 位域识别）
+     */
+    PixelFormat getPixelFormat() const { return pixel_format_; }
+    
+    /**
+     * @brief 设置帧校验器（nullptr 关闭）
+     * 
+     * 在 POST_CONVERT（转换结果）和 PRE_DISPLAY（即将扫描输出的 buffer）校验点哈希
+     * 
+     * @note 不拥有所有权，verifier 生命周期须覆盖显示过程
+     */
+    void setFrameVerifier(FrameVerifier* verifier) { frame_verifier_ = verifier; }
+    
     // ============ 新接口：BufferPool 访问 ============
     
     /**
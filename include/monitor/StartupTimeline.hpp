@@ -0,0 +1,117 @@
+#ifndef STARTUP_TIMELINE_HPP
+#define STARTUP_TIMELINE_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <thread>
+
+/**
+ * StartupTimeline - 启动阶段时间线记录
+ *
+ * 职责：
+ * - 记录各初始化阶段（设备打开、pool 分配、源探测……）的开始/结束时间和所在线程
+ * - 记录瞬时事件（如首帧上屏）
+ * - 打印甘特图风格的时间线报告，直观显示哪些阶段并行、哪个阶段在关键路径上
+ *
+ * 线程安全：begin/end/mark 可在任意线程调用
+ *
+ * 使用示例：
+ *   StartupTimeline timeline;
+ *   {
+ *       StartupTimeline::Scope scope(timeline, "display.initialize");
+ *       display.initialize(0);
+ *   }
+ *   timeline.mark("first frame on screen");
+ *   timeline.print(200.0);   // 与 200ms 目标比较
+ */
+class StartupTimeline {
+public:
+    /**
+     * 阶段记录（时间相对 reset() 时刻，毫秒）
+     */
+    struct Stage {
+        std::string name;
+        double begin_ms;
+        double end_ms;             // < 0 表示尚未结束
+        int thread_slot;           // 线程序号（按首次出现顺序编号，T0 为第一个线程）
+        bool ok;
+    };
+
+    /**
+     * RAII 阶段：构造时 begin，析构时 end
+     */
+    class Scope {
+    public:
+        Scope(StartupTimeline& timeline, const std::string& name)
+            : timeline_(timeline), id_(timeline.begin(name)), ok_(true) {}
+        ~Scope() { timeline_.end(id_, ok_); }
+
+        /**
+         * 标记阶段结果（默认成功）
+         */
+        void setOk(bool ok) { ok_ = ok; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& timeline_;
+        int id_;
+        bool ok_;
+    };
+
+    StartupTimeline();
+
+    /**
+     * 清空记录，并以当前时刻为时间零点
+     */
+    void reset();
+
+    /**
+     * 开始一个阶段
+     * @return 阶段 ID（传给 end()）
+     */
+    int begin(const std::string& name);
+
+    /**
+     * 结束阶段
+     */
+    void end(int stage_id, bool ok = true);
+
+    /**
+     * 记录瞬时事件（同名事件只记录第一次）
+     */
+    void mark(const std::string& name);
+
+    /**
+     * 事件时刻（毫秒），未发生返回 -1
+     */
+    double getMarkMs(const std::string& name) const;
+
+    /**
+     * 距时间零点的毫秒数
+     */
+    double elapsedMs() const;
+
+    std::vector<Stage> getStages() const;
+
+    /**
+     * 打印时间线
+     * @param target_ms 目标耗时（> 0 时与最后一个事件比较）
+     */
+    void print(double target_ms = 0.0) const;
+
+private:
+    std::chrono::steady_clock::time_point origin_;
+    std::vector<Stage> stages_;
+    std::vector<std::pair<std::string, double>> marks_;
+    std::vector<std::thread::id> threads_;       // 线程序号表
+    mutable std::mutex mutex_;
+
+    double nowMs() const;
+    int threadSlotLocked();
+};
+
+#endif // STARTUP_TIMELINE_HPP
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "../buffer/Buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <mutex>
+
+/**
+ * @brief OsdOverlay - ARGB8888 叠加层（OSD）混合模块
+ *
+ * 职责：
+ * - 管理多个 ARGB8888 叠加层（时间戳、标签、状态图标等）
+ * - 在显示前将叠加层 alpha 混合到视频帧上（原地修改 Buffer）
+ * - 脏区域跟踪：只有图层内容变化时才重新合成，静态图层不产生额外开销
+ *
+ * 工作原理：
+ * 1. 图层按添加顺序（z 序）合成到一张与帧同尺寸的预乘 alpha 画布上
+ * 2. 画布按行记录非透明区间（span），完全透明的像素永远不参与混合
+ * 3. 图层更新只标记脏矩形，下一次 apply() 只重新合成脏矩形内的画布和 span
+ * 4. apply() 对每个 span 调用 SIMD 混合内核（AVX2 / SSE2 / NEON / 标量）
+ *
+ * 混合公式（预乘 alpha，"over" 运算）：
+ *   dst = src + dst * (255 - src_alpha) / 255
+ *
+ * 使用示例：
+ * @code
+ * OsdOverlay osd(1920, 1080);
+ * int ts = osd.addLayer(32, 32, 400, 48);
+ * osd.fillLayerRect(ts, 0, 0, 400, 48, 0x80000000);  // 半透明黑底
+ *
+ * Buffer* frame = pool.acquireFilled(true, 100);
+ * osd.apply(frame);                      // 原地混合
+ * display.displayFilledFramebuffer(frame);
+ * pool.releaseFilled(frame);
+ * @endcode
+ *
+ * 线程安全：图层操作与 apply() 由内部互斥锁保护，可在 UI 线程更新、消费者线程混合
+ */
+class OsdOverlay {
+public:
+    /**
+     * @brief 混合统计信息
+     */
+    struct Stats {
+        uint64_t frames_blended;      // 已混合的帧数
+        uint64_t recompose_count;     // 画布重新合成次数（脏区域触发）
+        uint64_t blended_pixels;      // 累计参与混合的像素数
+        uint64_t recomposed_pixels;   // 累计重新合成的像素数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param frame_width 帧宽度（像素）
+     * @param frame_height 帧高度（像素）
+     * @param frame_stride 帧行跨度（字节，0 表示 width * 4）
+     * @throws std::invalid_argument 如果尺寸无效
+     */
+    OsdOverlay(int frame_width, int frame_height, size_t frame_stride = 0);
+
+    ~OsdOverlay();
+
+    // 禁止拷贝
+    OsdOverlay(const OsdOverlay&) = delete;
+    OsdOverlay& operator=(const OsdOverlay&) = delete;
+
+    // ========== 图层管理 ==========
+
+    /**
+     * @brief 添加图层（新图层位于最上方）
+     * @param x, y 图层在帧中的位置（可部分超出帧范围）
+     * @param width, height 图层尺寸
+     * @return 图层 ID，失败返回 -1
+     *
+     * @note 新图层初始为全透明
+     */
+    int addLayer(int x, int y, int width, int height);
+
+    /**
+     * @brief 移除图层
+     */
+    bool removeLayer(int layer_id);
+
+    /**
+     * @brief 更新图层像素（非预乘 ARGB8888，内部转换为预乘格式）
+     * @param layer_id 图层 ID
+     * @param argb 源像素
+     * @param stride_pixels 源行跨度（像素，0 表示图层宽度）
+     */
+    bool updateLayer(int layer_id, const uint32_t* argb, int stride_pixels = 0);
+
+    /**
+     * @brief 用纯色填充图层内的矩形（非预乘 ARGB8888）
+     *
+     * 用于绘制底框、进度条、状态指示灯等简单图元，只标记该矩形为脏
+     */
+    bool fillLayerRect(int layer_id, int x, int y, int width, int height, uint32_t argb);
+
+    /**
+     * @brief 移动图层
+     */
+    bool moveLayer(int layer_id, int x, int y);
+
+    /**
+     * @brief 显示/隐藏图层
+     */
+    bool setLayerVisible(int layer_id, bool visible);
+
+    /**
+     * @brief 设置图层整体透明度（0-255，与像素 alpha 相乘）
+     */
+    bool setLayerAlpha(int layer_id, uint8_t alpha);
+
+    // ========== 混合 ==========
+
+    /**
+     * @brief 将所有可见图层原地混合到帧上
+     * @param frame 帧 Buffer（ARGB8888，大小至少 stride * height）
+     * @return 成功返回 true
+     */
+    bool apply(Buffer* frame);
+
+    /**
+     * @brief 将所有可见图层原地混合到帧内存上
+     */
+    bool apply(void* frame_data, size_t frame_size);
+
+    /**
+     * @brief 是否存在非透明像素（无内容时 apply() 立即返回）
+     */
+    bool hasVisibleContent();
+
+    // ========== 统计 ==========
+
+    Stats getStats() const;
+    void resetStats();
+    void printStats() const;
+
+    /**
+     * @brief 获取运行时选中的混合内核名称（"AVX2"/"SSE2"/"NEON"/"Scalar"，见 CpuFeatures）
+     */
+    static const char* getKernelName();
+
+    // ========== 混合内核（公开以便基准测试） ==========
+
+    /**
+     * @brief 将预乘 ARGB8888 源行混合到目标行（按 CPU 能力分发的 SIMD 版本）
+     * @param dst 目标像素（原地修改）
+     * @param src 预乘源像素
+     * @param count 像素数
+     */
+    static void blendRow(uint32_t* dst, const uint32_t* src, int count);
+
+    /**
+     * @brief 标量参考实现（与 blendRow 结果逐位一致）
+     */
+    static void blendRowScalar(uint32_t* dst, const uint32_t* src, int count);
+
+private:
+    /**
+     * @brief 图层描述
+     */
+    struct Layer {
+        int id;
+        int x, y;
+        int width, height;
+        bool visible;
+        uint8_t alpha;
+        std::vector<uint32_t> pixels;   // 预乘 ARGB8888
+    };
+
+    /**
+     * @brief 行内非透明区间 [begin, end)
+     */
+    struct Span {
+        int begin;
+        int end;
+    };
+
+    /**
+     * @brief 矩形（用于脏区域）
+     */
+    struct Rect {
+        int x0, y0, x1, y1;            // [x0, x1) x [y0, y1)
+        bool empty() const { return x0 >= x1 || y0 >= y1; }
+    };
+
+    // ========== 内部辅助方法 ==========
+    Layer* findLayer(int layer_id);
+    void markDirty(int x, int y, int width, int height);
+    void markLayerDirty(const Layer& layer);
+    void recomposeDirtyRegion();
+    void rebuildRowSpans(int row);
+    bool blendInto(uint8_t* frame_base);
+
+    static uint32_t premultiply(uint32_t argb, uint8_t extra_alpha);
+
+    // ========== 帧参数 ==========
+    int frame_width_;
+    int frame_height_;
+    size_t frame_stride_;
+
+    // ========== 图层 ==========
+    std::vector<Layer> layers_;        // 按 z 序排列（后面的在上层）
+    int next_layer_id_;
+
+    // ========== 合成画布 ==========
+    std::vector<uint32_t> canvas_;               // 预乘 ARGB8888，frame_width_ x frame_height_
+    std::vector<std::vector<Span>> row_spans_;   // 每行的非透明区间
+    Rect dirty_;                                 // 待重新合成的区域
+
+    // ========== 统计 ==========
+    Stats stats_;
+
+    mutable std::mutex mutex_;
+};
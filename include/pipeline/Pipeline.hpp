@@ -0,0 +1,421 @@
+#pragma once
+
+#include "../buffer/BufferPool.hpp"
+#include "../display/LinuxFramebufferDevice.hpp"
+#include "../producer/VideoProducer.hpp"
+#include "../overlay/OsdOverlay.hpp"
+#include "../sink/VideoRecorder.hpp"
+#include "../sink/RawDumpSink.hpp"
+#include "../verify/FrameVerifier.hpp"
+#include "../monitor/StartupTimeline.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <future>
+
+/**
+ * @brief PipelineConfig - 声明式流水线描述（source → pool → transform → sink）
+ *
+ * 一份描述包含：
+ * - source：读取器类型、路径、循环、生产者线程数、输出格式、探测预算
+ * - pool：使用 display 的 framebuffer pool / 自有 pool（数量、分配器）/ 动态注入 pool（容量）
+ * - transform：OSD 矩形图层（送显前原地混合）
+ * - sink：显示方式、队列策略、录制 / 原始转储 / golden 校验旁路
+ *
+ * 可由 PipelineBuilder 链式构建，也可从 INI 风格的配置文件加载，
+ * 部署时调整 pool 深度、线程数等无需重新编译：
+ * ```
+ * # 注释以 # 或 ; 开头，行尾注释同样支持
+ * [source]
+ * reader   = mmap            # auto/mmap/iouring/direct/rtsp/rtp/ffmpeg/images/v4l2
+ * path     = /data/video.raw
+ * loop     = true
+ * threads  = 2
+ * schedule = interleaved    # 多线程取帧：interleaved / chunked（连续帧块 + 工作窃取，按帧序提交）
+ * chunk    = 8               # chunked：每块帧数
+ * format   = 1920x1080@32    # 可选，默认使用显示设备格式
+ * fast_open = false          # 低延迟探测预算（rtsp/ffmpeg）
+ * codec    = h264:1920x1080  # 可选，跳过码流探测
+ * io       = file           # ffmpeg 解复用 I/O：file / mmap / iouring
+ * map_window = auto          # mmap：auto / full / N（N 帧滑动窗口，大文件有界地址空间）
+ *
+ * [pool]
+ * type      = display        # display / own / dynamic
+ * count     = 4              # own：buffer 数量
+ * allocator = normal         # own：normal / cma / udmabuf（memfd 内存包装为 DMA-BUF）
+ * heap      = auto           # own + cma：auto / cma / system（DMA-BUF heap）
+ * cached    = yes            # own + cma：CPU 映射带缓存（CPU 访问用 DMA_BUF_IOCTL_SYNC 同步）
+ * hugetlb   = no             # own + udmabuf：memfd 使用 2MB 大页
+ * capacity  = 10             # dynamic：最大注入数量
+ *
+ * [osd]                      # 每个 [osd] 段增加一个矩形图层
+ * rect  = 20,20,400,80
+ * color = 0x80000000         # ARGB
+ *
+ * [sink]
+ * display    = auto          # auto / flip / dma / memcpy / none
+ * device     = 0             # framebuffer 索引
+ * policy     = fifo          # fifo：逐帧显示；latest：丢弃积压，只显示最新帧
+ * vsync      = true
+ * timeout_ms = 100
+ * record     = capture.mp4
+ * dump       = dump.raw
+ * golden     = golden.txt
+ * max_frames = 0             # 0 = 直到 Ctrl+C / 流结束
+ *
+ * [startup]
+ * parallel  = true           # 源打开/探测与显示设备、pool 初始化并行
+ * target_ms = 200            # 首帧上屏目标（时间线报告中比较）
+ * ```
+ */
+struct PipelineConfig {
+    /**
+     * @brief BufferPool 来源
+     */
+    enum class PoolMode {
+        DISPLAY,                   // display 托管的 framebuffer pool（零拷贝翻页）
+        OWN,                       // 自有 pool（普通内存或 CMA）
+        DYNAMIC                    // 动态注入 pool（解码器 / 推送源提供 buffer）
+    };
+
+    /**
+     * @brief 送显方式
+     */
+    enum class DisplayMode {
+        AUTO,                      // framebuffer pool → 翻页；有物理地址 → DMA；否则 memcpy
+        FLIP,                      // displayFilledFramebuffer
+        DMA,                       // displayBufferByDMA
+        MEMCPY,                    // displayBufferByMemcpyToFramebuffer
+        NONE                       // 不显示（只跑 source / transform / 旁路 sink）
+    };
+
+    /**
+     * @brief filled 队列消费策略
+     */
+    enum class QueuePolicy {
+        FIFO,                      // 逐帧显示
+        LATEST                     // 取最新帧，积压的旧帧直接归还（低延迟）
+    };
+
+    struct SourceConfig {
+        std::string path;
+        VideoReaderFactory::ReaderType reader_type;
+        bool loop;
+        int thread_count;
+        int width;                 // 0 = 显示设备宽度
+        int height;
+        int bits_per_pixel;
+        StreamProbeConfig probe;
+        VideoProducer::Schedule schedule;
+        int chunk_frames;          // schedule = CHUNKED
+        std::shared_ptr<ProducerExecutor> executor;   // 多个 pipeline 共享的读帧线程池（仅代码配置）
+
+        SourceConfig()
+            : reader_type(VideoReaderFactory::ReaderType::AUTO)
+            , loop(true), thread_count(1)
+            , width(0), height(0), bits_per_pixel(0)
+            , schedule(VideoProducer::Schedule::INTERLEAVED)
+            , chunk_frames(VideoProducer::kDefaultChunkFrames) {}
+    };
+
+    struct PoolConfig {
+        PoolMode mode;
+        int buffer_count;          // OWN
+        bool use_cma;              // OWN
+        DmaHeapOptions heap;       // OWN + use_cma
+        bool use_udmabuf;          // OWN（与 use_cma 互斥）
+        bool hugetlb;              // OWN + use_udmabuf
+        int max_capacity;          // DYNAMIC
+        std::string name;
+
+        PoolConfig()
+            : mode(PoolMode::DISPLAY), buffer_count(4), use_cma(false)
+            , use_udmabuf(false), hugetlb(false), max_capacity(10), name("Pipeline_Pool") {}
+    };
+
+    struct OsdBox {
+        int x;
+        int y;
+        int width;
+        int height;
+        uint32_t argb;
+
+        OsdBox() : x(0), y(0), width(0), height(0), argb(0) {}
+        OsdBox(int bx, int by, int bw, int bh, uint32_t color)
+            : x(bx), y(by), width(bw), height(bh), argb(color) {}
+    };
+
+    struct SinkConfig {
+        DisplayMode display_mode;
+        int device_index;
+        QueuePolicy policy;
+        bool vsync;
+        int acquire_timeout_ms;
+        std::string record_path;
+        std::string dump_path;
+        std::string golden_path;
+        int max_frames;            // 0 = 不限
+
+        SinkConfig()
+            : display_mode(DisplayMode::AUTO), device_index(0)
+            , policy(QueuePolicy::FIFO), vsync(true), acquire_timeout_ms(100)
+            , max_frames(0) {}
+    };
+
+    struct StartupConfig {
+        bool parallel;             // 并行初始化
+        double target_ms;          // 首帧上屏目标（0 = 不比较）
+
+        StartupConfig() : parallel(true), target_ms(200.0) {}
+    };
+
+    SourceConfig source;
+    PoolConfig pool;
+    std::vector<OsdBox> osd;
+    SinkConfig sink;
+    StartupConfig startup;
+
+    /**
+     * @brief 从 INI 风格的配置文件加载（未出现的键保持当前值）
+     * @return false 文件无法读取或存在无法识别的段 / 键 / 值（打印行号）
+     */
+    bool loadFile(const std::string& path);
+
+    /**
+     * @brief 解析配置文本（格式同 loadFile）
+     */
+    bool parse(const std::string& text);
+
+    /**
+     * @brief 检查组合是否合法（如 DMA 显示需要 CMA / 动态 pool）
+     */
+    bool validate(std::string* error) const;
+
+    void print() const;
+
+    static const char* poolModeToString(PoolMode mode);
+    static const char* displayModeToString(DisplayMode mode);
+    static const char* queuePolicyToString(QueuePolicy policy);
+};
+
+/**
+ * @brief Pipeline - 按 PipelineConfig 实例化并运行整条流水线
+ *
+ * start() 创建：显示设备 → BufferPool → VideoProducer 线程 → 旁路 sink（录制 / 转储 / 校验）
+ * → OSD 图层；run() 在调用线程上执行消费者循环。
+ *
+ * 并行初始化（startup.parallel）：
+ * ```
+ * T0: display.initialize ──→ pool.create ──→ producer.start → sinks
+ * T1: source.open（探测）────────────────┘
+ * T2: pool.create（显式 format 的自有 / 动态 pool）
+ * ```
+ * 源的格式已知（显式 format，或编码流 RTSP / FFMPEG / RTP 不需要输出格式）时，
+ * 源的打开与显示设备初始化同时开始；否则在显示设备就绪后与 pool 分配并行。
+ * 各阶段记录在 StartupTimeline 中，首帧上屏时打印时间线报告。
+ *
+ * 使用示例：
+ * @code
+ * PipelineConfig config;
+ * if (!config.loadFile("deploy.ini")) return -1;
+ * Pipeline pipeline(config);
+ * if (!pipeline.start()) return -1;
+ * pipeline.run(&g_running);        // Ctrl+C / max_frames / 流结束时返回
+ * pipeline.stop();
+ * @endcode
+ */
+class Pipeline {
+public:
+    explicit Pipeline(const PipelineConfig& config);
+    ~Pipeline();
+
+    // 禁止拷贝
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * @brief 实例化 display / pool / sink / producer 并启动生产者
+     */
+    bool start();
+
+    /**
+     * @brief 在后台线程执行 start()
+     */
+    std::future<bool> startAsync();
+
+    /**
+     * @brief 并行启动多条流水线（多路流的解码器同时打开/探测）
+     * @return 全部启动成功
+     */
+    static bool startAll(const std::vector<Pipeline*>& pipelines);
+
+    /**
+     * @brief 消费者循环（阻塞）
+     * @param keep_running 外部停止标志（可为 nullptr，此时只响应 requestStop()）
+     * @return 已显示（消费）的帧数
+     */
+    int run(const volatile bool* keep_running = nullptr);
+
+    /**
+     * @brief 请求 run() 返回（可在其他线程调用）
+     */
+    void requestStop() { stop_requested_ = true; }
+
+    /**
+     * @brief 停止生产者和旁路 sink，释放资源（析构时自动调用）
+     */
+    void stop();
+
+    bool isStarted() const { return started_; }
+    int getConsumedFrames() const { return consumed_frames_.load(); }
+    int getDroppedFrames() const { return dropped_frames_.load(); }
+
+    /**
+     * @brief 流水线使用的 BufferPool（start() 前为 nullptr）
+     */
+    BufferPool* getBufferPool() { return pool_; }
+
+    /**
+     * @brief golden 校验失败帧数（未启用校验时为 0）
+     */
+    uint64_t getVerifyMismatches() const;
+
+    const PipelineConfig& getConfig() const { return config_; }
+    const StartupTimeline& getStartupTimeline() const { return timeline_; }
+    std::string getLastError() const;
+    void printStats() const;
+
+private:
+    PipelineConfig config_;
+
+    // ============ 运行时对象（按创建顺序，逆序销毁）============
+    std::unique_ptr<LinuxFramebufferDevice> display_;
+    std::unique_ptr<BufferPool> owned_pool_;
+    BufferPool* pool_;                         // display pool 或 owned_pool_
+    std::unique_ptr<FrameVerifier> verifier_;
+    std::unique_ptr<VideoRecorder> recorder_;
+    std::unique_ptr<RawDumpSink> dump_sink_;
+    std::unique_ptr<OsdOverlay> osd_;
+    std::unique_ptr<VideoProducer> producer_;
+
+    // ============ 帧格式 ============
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+
+    // ============ 启动时间线 ============
+    StartupTimeline timeline_;
+
+    // ============ 状态 ============
+    bool started_;
+    std::atomic<bool> stop_requested_;
+    std::atomic<bool> producer_failed_;
+
+    // ============ 统计信息 ============
+    std::atomic<int> consumed_frames_;
+    std::atomic<int> dropped_frames_;           // LATEST 策略丢弃的积压帧
+    std::atomic<int> display_errors_;
+
+    // ============ 错误处理 ============
+    std::string last_error_;
+    mutable std::mutex error_mutex_;
+
+    // ============ 内部辅助方法 ============
+    bool createDisplay();
+    bool createPool();
+    void createSinks();
+    void createTransforms();
+    bool startProducer(std::shared_ptr<VideoFile> source);
+
+    /**
+     * @brief 当前帧格式对应的生产者配置
+     */
+    VideoProducer::Config makeProducerConfig() const;
+
+    bool hasExplicitFormat() const;
+
+    /**
+     * @brief 源的打开不依赖显示设备（格式已知或读取器忽略输出格式）
+     */
+    bool sourceIndependentOfDisplay() const;
+
+    /**
+     * @brief 按 DisplayMode 送显一帧
+     */
+    bool presentFrame(Buffer* buffer);
+
+    /**
+     * @brief 非循环 source 的所有帧都已消费
+     */
+    bool reachedEndOfStream() const;
+
+    void setError(const std::string& error);
+};
+
+/**
+ * @brief PipelineBuilder - PipelineConfig 的链式构建接口
+ *
+ * 使用示例：
+ * @code
+ * auto pipeline = PipelineBuilder()
+ *     .source("video.raw", VideoReaderFactory::ReaderType::MMAP)
+ *     .producerThreads(2)
+ *     .ownPool(6, true)
+ *     .osdBox(20, 20, 400, 80, 0x80000000)
+ *     .display(PipelineConfig::DisplayMode::DMA)
+ *     .policy(PipelineConfig::QueuePolicy::LATEST)
+ *     .build();
+ * @endcode
+ */
+class PipelineBuilder {
+public:
+    PipelineBuilder() = default;
+    explicit PipelineBuilder(const PipelineConfig& base) : config_(base) {}
+
+    // ============ source ============
+    PipelineBuilder& source(const std::string& path,
+                            VideoReaderFactory::ReaderType type = VideoReaderFactory::ReaderType::AUTO);
+    PipelineBuilder& loop(bool enable);
+    PipelineBuilder& producerThreads(int count);
+    PipelineBuilder& schedule(VideoProducer::Schedule schedule,
+                              int chunk_frames = VideoProducer::kDefaultChunkFrames);
+    PipelineBuilder& executor(std::shared_ptr<ProducerExecutor> executor);
+    PipelineBuilder& format(int width, int height, int bits_per_pixel);
+    PipelineBuilder& probe(const StreamProbeConfig& probe);
+
+    // ============ pool ============
+    PipelineBuilder& displayPool();
+    PipelineBuilder& ownPool(int count, bool use_cma = false);
+    PipelineBuilder& dmaHeap(DmaHeapOptions::Kind kind, bool cached = true);   // 隐含 use_cma
+    PipelineBuilder& udmabuf(bool hugetlb = false);                            // own pool 使用 udmabuf
+    PipelineBuilder& dynamicPool(int max_capacity);
+
+    // ============ transform ============
+    PipelineBuilder& osdBox(int x, int y, int width, int height, uint32_t argb);
+
+    // ============ sink ============
+    PipelineBuilder& display(PipelineConfig::DisplayMode mode, int device_index = 0);
+    PipelineBuilder& policy(PipelineConfig::QueuePolicy policy);
+    PipelineBuilder& vsync(bool enable);
+    PipelineBuilder& record(const std::string& path);
+    PipelineBuilder& dump(const std::string& path);
+    PipelineBuilder& golden(const std::string& path);
+    PipelineBuilder& maxFrames(int count);
+
+    // ============ startup ============
+    PipelineBuilder& parallelInit(bool enable);
+    PipelineBuilder& firstFrameTarget(double target_ms);
+
+    const PipelineConfig& config() const { return config_; }
+
+    /**
+     * @brief 校验配置并创建 Pipeline（未启动）
+     * @return nullptr 配置不合法（打印原因）
+     */
+    std::unique_ptr<Pipeline> build() const;
+
+private:
+    PipelineConfig config_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "../buffer/BufferPool.hpp"
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief ProducerExecutor - 多个 VideoProducer 共享的读帧 / 解码线程池
+ *
+ * 每个 VideoProducer 默认自建 thread_count 个线程，各自阻塞在 acquireFree() 上；
+ * 16 路流 × 2 线程就是 32 个大部分时间在睡眠的线程。共享执行器只开 worker_count 个线程
+ * （默认 CPU 核数），各生产者以"读一帧"为单位提交任务：
+ *
+ * - 按需派发：只在源的 pool 有空闲 buffer 时派发任务（每个源最多 max_parallel 个在途），
+ *   pool 满时不占用 worker；消费者归还 buffer 时由 BufferPool 空闲监听者重新派发
+ * - 工作窃取：每个 worker 一个任务队列，从头部取自己的任务（各源按提交顺序轮流），
+ *   空闲时从其他 worker 队列尾部偷取；worker 线程内派发的后续任务进入本地队列
+ * - 任务不阻塞：取不到 buffer 时返回 NO_BUFFER，等下一次空闲通知
+ *
+ * 线程数随核数而不是流数增长，繁忙的流自动占用空闲流让出的 worker。
+ *
+ * 使用方式：
+ * ```cpp
+ * auto executor = std::make_shared<ProducerExecutor>();      // CPU 核数个 worker
+ * VideoProducer::Config config("a.raw", 1920, 1080, 32, true, 2);
+ * config.executor = executor;                                 // thread_count = 最大并行读取数
+ * producer_a.start(config);
+ * ```
+ *
+ * @note removeSource() 等待该源的在途任务结束，不能在任务（StepFunction）中调用
+ * @note 执行器必须比所有注册的源活得久（VideoProducer 通过 Config 持有 shared_ptr）
+ */
+class ProducerExecutor {
+public:
+    /**
+     * @brief 一次任务（读一帧）的结果
+     */
+    enum class StepResult {
+        CONTINUE,       // 已处理一帧（成功或跳过），可继续派发
+        NO_BUFFER,      // pool 没有空闲 buffer，等空闲通知再派发
+        FINISHED        // 源已结束（非循环读完 / 连续失败 / 停止），不再派发
+    };
+
+    /**
+     * @brief 任务函数：读取一帧并提交（在 worker 线程中执行，同一源可能并发调用）
+     */
+    using StepFunction = std::function<StepResult()>;
+
+    /**
+     * @brief 构造函数
+     * @param worker_count worker 线程数（<= 0 时使用 CPU 核数）
+     */
+    explicit ProducerExecutor(int worker_count = 0);
+
+    /**
+     * @brief 析构函数 - 停止所有 worker（调用前应已 removeSource 所有源）
+     */
+    ~ProducerExecutor();
+
+    // 禁止拷贝和赋值
+    ProducerExecutor(const ProducerExecutor&) = delete;
+    ProducerExecutor& operator=(const ProducerExecutor&) = delete;
+
+    // ========== 源管理 ==========
+
+    /**
+     * @brief 注册一个源并立即按 pool 空闲 buffer 数派发任务
+     * @param pool 源填充的 BufferPool（用于空闲监听和派发判断）
+     * @param max_parallel 该源最多同时在途的任务数
+     * @param step 任务函数
+     * @return 源 ID（用于 removeSource），失败返回 -1
+     */
+    int addSource(BufferPool& pool, int max_parallel, StepFunction step);
+
+    /**
+     * @brief 注销源：停止派发，等待在途任务结束（返回后 step 不再被调用）
+     */
+    void removeSource(int source_id);
+
+    // ========== 查询接口 ==========
+
+    int getWorkerCount() const { return worker_count_; }
+    int getSourceCount() const;
+
+    /// 已执行的任务数 / 其中偷取的任务数 / 取不到 buffer 的任务数
+    uint64_t getExecutedTasks() const { return executed_tasks_.load(); }
+    uint64_t getStolenTasks() const { return stolen_tasks_.load(); }
+    uint64_t getNoBufferTasks() const { return no_buffer_tasks_.load(); }
+
+    /// 打印统计信息
+    void printStats() const;
+
+private:
+    struct Source {
+        int id;
+        BufferPool* pool;
+        int max_parallel;
+        StepFunction step;
+        int listener_id;
+
+        std::mutex mutex;
+        std::condition_variable idle_cv;
+        int in_flight;                   // 已派发（排队或执行中）的任务数（受 mutex 保护）
+        bool active;                     // 受 mutex 保护
+
+        Source() : id(-1), pool(nullptr), max_parallel(1), listener_id(-1)
+                 , in_flight(0), active(true) {}
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Source>> tasks;   // 一个元素 = 该源的一次任务
+    };
+
+    /**
+     * @brief 按 pool 空闲 buffer 数和在途任务数为源派发任务
+     */
+    void schedule(const std::shared_ptr<Source>& source);
+
+    /**
+     * @brief 任务入队（worker 线程内进入本地队列，其他线程轮流分配）
+     */
+    void push(std::shared_ptr<Source> source);
+
+    /**
+     * @brief 取任务：先本地队列头部，再从其他队列尾部偷取
+     */
+    bool popTask(int index, std::shared_ptr<Source>* source);
+
+    void runTask(const std::shared_ptr<Source>& source);
+    void workerLoop(int index);
+
+    int worker_count_;
+    std::unique_ptr<Worker[]> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_;
+    std::atomic<unsigned> next_worker_;  // 非 worker 线程入队时轮流选择
+
+    // 睡眠 / 唤醒（queued_ 在 sleep_mutex_ 下递增，避免丢失唤醒）
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<int64_t> queued_;
+
+    // 源列表
+    mutable std::mutex sources_mutex_;
+    std::map<int, std::shared_ptr<Source>> sources_;
+    int next_source_id_;
+
+    // 统计
+    std::atomic<uint64_t> executed_tasks_;
+    std::atomic<uint64_t> stolen_tasks_;
+    std::atomic<uint64_t> no_buffer_tasks_;
+};
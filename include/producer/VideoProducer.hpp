@@ -3,12 +3,17 @@
 #include "../buffer/BufferPool.hpp"
 #include "../videoFile/VideoFile.hpp"
 #include "../monitor/PerformanceMonitor.hpp"
+#include "../verify/FrameVerifier.hpp"
+#include "ProducerExecutor.hpp"
 #include <string>
 #include <vector>
+#include <map>
 #include <thread>
 #include <atomic>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <condition_variable>
 
 /**
  * @brief VideoProducer - 独立的视频生产者模块
@@ -24,9 +29,36 @@
  * - 职责单一（只负责视频读取）
  * - 配置驱动（通过 Config 结构体）
  * - 线程安全（支持多线程生产）
+ * 
+ * 多线程取帧方式（Config::schedule）：
+ * - INTERLEAVED：各线程原子递增取单帧，相邻帧落在不同线程，每个线程的读取都是跳跃的，
+ *   内核顺序预读失效；提交顺序取决于读取完成顺序
+ * - CHUNKED：每个线程领取连续 chunk_frames 帧的块，块内顺序读取（领取时对整块发预读提示）；
+ *   自己的块读完后，若有线程落后（剩余 ≥ 半块）先偷取它剩余帧的后一半，否则领新块；
+ *   预分配 buffer 模式下按帧序提交到 filled 队列：先读完的帧暂存（占着 buffer），
+ *   前面的帧提交时一并按序提交，读取线程不等待，输出顺序与单线程一致
+ * 
+ * 共享执行器（Config::executor）：不自建线程，每帧作为一个任务提交给多个生产者共享的
+ * ProducerExecutor，pool 有空闲 buffer 时才派发；thread_count 变为最多同时在途的读取数。
+ * 任务先取 buffer 再领 ticket，按 ticket 顺序提交（预分配模式），schedule 不生效
+ * 
+ * @note 按序提交的重排窗口受 pool 深度限制：最多领先最早未提交帧
+ *       (buffer 总数 - kConsumerReserve) 帧，超出时领帧线程等待，
+ *       保证最早的帧总能拿到 buffer；块大小相应限制为 窗口 / 线程数
  */
 class VideoProducer {
 public:
+    /**
+     * @brief 多线程取帧方式
+     */
+    enum class Schedule {
+        INTERLEAVED,        // 逐帧交错（默认）
+        CHUNKED             // 连续帧块 + 工作窃取，按帧序提交
+    };
+    
+    static constexpr int kDefaultChunkFrames = 8;
+    static constexpr int kConsumerReserve = 2;     // 按序提交时给消费者（显示中 / 翻转中）预留的 buffer
+    
     /**
      * @brief 视频配置结构
      */
@@ -38,18 +70,24 @@ public:
         bool loop;                                     // 是否循环播放
         int thread_count;                              // 生产者线程数（默认1）
         VideoReaderFactory::ReaderType reader_type;    // 读取器类型（默认AUTO）
+        StreamProbeConfig probe;                       // 探测预算（FFMPEG / RTSP）、映射窗口（MMAP）
+        Schedule schedule;                             // 多线程取帧方式（默认INTERLEAVED）
+        int chunk_frames;                              // CHUNKED：每块帧数
+        std::shared_ptr<ProducerExecutor> executor;    // 共享读帧线程池（nullptr = 自建线程）
         
         // 默认构造
         Config() 
             : width(0), height(0), bits_per_pixel(0)
             , loop(false), thread_count(1)
-            , reader_type(VideoReaderFactory::ReaderType::AUTO) {}
+            , reader_type(VideoReaderFactory::ReaderType::AUTO)
+            , schedule(Schedule::INTERLEAVED), chunk_frames(kDefaultChunkFrames) {}
         
         // 便利构造
         Config(const std::string& path, int w, int h, int bpp, bool l = false, int tc = 1,
                VideoReaderFactory::ReaderType rt = VideoReaderFactory::ReaderType::AUTO)
             : file_path(path), width(w), height(h), bits_per_pixel(bpp)
-            , loop(l), thread_count(tc), reader_type(rt) {}
+            , loop(l), thread_count(tc), reader_type(rt)
+            , schedule(Schedule::INTERLEAVED), chunk_frames(kDefaultChunkFrames) {}
     };
     
     /**
@@ -81,6 +119,25 @@ public:
      */
     bool start(const Config& config);
     
+    /**
+     * @brief 使用已打开的视频源启动（跳过 open/探测）
+     * @param config 视频配置
+     * @param source openSource() 预先打开的源（nullptr 时等价于 start(config)）
+     * @return true 如果启动成功
+     * 
+     * 用于并行初始化：源的打开/探测不依赖 BufferPool，可与显示设备初始化、
+     * pool 分配同时进行，pool 就绪后再调用本接口
+     */
+    bool start(const Config& config, std::shared_ptr<VideoFile> source);
+    
+    /**
+     * @brief 按配置创建并打开视频源（不依赖 BufferPool，可在任意线程调用）
+     * @param config 视频配置
+     * @param error 失败原因（可为 nullptr）
+     * @return 已打开的源，失败返回 nullptr
+     */
+    static std::shared_ptr<VideoFile> openSource(const Config& config, std::string* error = nullptr);
+    
     /**
      * @brief 停止视频生产者
      */
@@ -103,6 +160,16 @@ public:
     /// 获取总帧数
     int getTotalFrames() const;
     
+    /// CHUNKED：已领取的新块数 / 偷取次数
+    int getClaimedChunks() const { return claimed_chunks_.load(); }
+    int getStolenRanges() const { return stolen_ranges_.load(); }
+    
+    /// 是否运行在共享执行器上
+    bool usesExecutor() const { return executor_source_ >= 0; }
+    
+    /// 取帧方式名称（"interleaved"、"chunked"）
+    static const char* scheduleToString(Schedule schedule);
+    
     // ========== 错误处理 ==========
     
     /**
@@ -118,6 +185,20 @@ public:
      */
     std::string getLastError() const;
     
+    // ========== 帧校验 ==========
+    
+    /**
+     * @brief 设置帧校验器（POST_READ 校验点，nullptr 关闭）
+     * 
+     * 每帧读取成功后、提交到 filled 队列前按真实帧索引哈希，
+     * 并记录 Buffer -> 帧索引，供后续校验点对齐
+     * 
+     * @note 须在 start() 前设置；仅预分配 buffer 模式生效（动态注入模式看不到 buffer）
+     */
+    void setFrameVerifier(FrameVerifier* verifier) {
+        frame_verifier_ = verifier;
+    }
+    
     // ========== 调试接口 ==========
     
     /// 打印统计信息
@@ -132,6 +213,69 @@ private:
      */
     void producerThreadFunc(int thread_id);
     
+    /**
+     * @brief 领取下一帧的序号（ticket，帧号 = ticket % total_frames_）
+     * @return 没有更多帧时返回 false
+     */
+    bool claimTicket(int thread_id, int64_t* ticket);
+    
+    /**
+     * @brief CHUNKED：为线程补充帧范围（先偷取，再领新块），并发预读提示
+     */
+    bool refillLane(int thread_id);
+    
+    /**
+     * @brief CHUNKED：等待 ticket 进入重排窗口（停止时返回 false）
+     */
+    bool waitForWindow(int64_t ticket);
+    
+    /**
+     * @brief CHUNKED：按 ticket 顺序提交（buffer 为 nullptr 表示该帧读取失败，只推进序号）
+     * 
+     * 不是下一个待提交的 ticket 时暂存；是则连同之后连续的暂存帧一起提交
+     */
+    void submitInOrder(int64_t ticket, Buffer* buffer);
+    
+    /**
+     * @brief CHUNKED：线程提前退出时放弃自己剩余的帧（按失败推进序号，避免其他线程等待）
+     */
+    void abandonLane(int thread_id);
+    
+    /**
+     * @brief 对 ticket 范围 [begin, end) 发预读提示（循环模式下按文件末尾拆分）
+     */
+    void hintRange(int64_t begin, int64_t end) const;
+    
+    /**
+     * @brief 共享执行器任务：读取一帧并提交（不阻塞，取不到 buffer 时返回 NO_BUFFER）
+     */
+    ProducerExecutor::StepResult executorStep();
+    
+    /**
+     * @brief 推送源线程函数（事件驱动）
+     * 
+     * Reader 内部线程注入帧并发出事件，本线程睡眠等待事件，
+     * 只统计真实注入的帧，不轮询读取接口
+     */
+    void pushSourceThreadFunc();
+    
+    /**
+     * @brief 推送源事件回调（在 Reader 线程中执行）
+     */
+    void onSourceEvent(IVideoReader::SourceEvent event);
+    
+    /**
+     * @brief pool 中所有 buffer 都因 CPU 映射失败移出循环（acquireFree 永远取不到）
+     */
+    bool poolExhaustedByMapFailures() const;
+    
+    /**
+     * @brief 关闭视频源（先注销事件回调，再释放 VideoFile）
+     * 
+     * start() 的失败路径与 stop() 共用，保证回调不会指向已停止的 producer
+     */
+    void closeSource();
+    
     /**
      * @brief 设置错误信息并触发回调
      */
@@ -154,6 +298,36 @@ private:
     std::atomic<int> skipped_frames_;
     std::atomic<int> next_frame_index_;  // 下一个要读取的帧索引（原子递增）
     
+    // CHUNKED 调度：每个线程一个 ticket 范围 [begin, end)，其他线程可从尾部偷取
+    struct Lane {
+        std::mutex mutex;
+        int64_t begin;
+        int64_t end;
+        
+        Lane() : begin(0), end(0) {}
+    };
+    std::unique_ptr<Lane[]> lanes_;      // nullptr = INTERLEAVED
+    int lane_count_;
+    int chunk_frames_;                   // 实际块大小（受重排窗口限制）
+    std::atomic<int64_t> next_chunk_;
+    std::atomic<int> claimed_chunks_;
+    std::atomic<int> stolen_ranges_;
+    
+    // CHUNKED 按序提交（仅预分配 buffer 模式）
+    bool ordered_submit_;
+    int64_t reorder_window_;             // 最多领先最早未提交帧的 ticket 数
+    std::mutex order_mutex_;
+    std::condition_variable order_cv_;
+    int64_t next_submit_ticket_;         // 受 order_mutex_ 保护
+    std::map<int64_t, Buffer*> parked_;  // 已读完、等待前面帧的 buffer（受 order_mutex_ 保护）
+    
+    // 共享执行器
+    std::shared_ptr<ProducerExecutor> executor_;
+    int executor_source_;                // -1 = 自建线程
+    bool needs_external_buffer_;
+    std::atomic<int64_t> next_ticket_;
+    std::atomic<int> consecutive_failures_;
+    
     // 配置
     Config config_;
     int total_frames_;
@@ -163,6 +337,17 @@ private:
     mutable std::mutex error_mutex_;
     std::string last_error_;
     
+    // 帧校验（可选，不拥有所有权）
+    FrameVerifier* frame_verifier_;
+    
+    // 推送源（事件驱动模式）
+    bool push_source_;
+    std::mutex event_mutex_;
+    std::condition_variable event_cv_;
+    int pending_frames_;                 // 已注入未统计的帧（受 event_mutex_ 保护）
+    int pending_drops_;                  // 已丢弃未统计的帧（受 event_mutex_ 保护）
+    bool end_of_stream_;                 // 受 event_mutex_ 保护
+    
     // 性能监控
     std::chrono::steady_clock::time_point start_time_;
 };
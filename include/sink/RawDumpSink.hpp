@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../buffer/Buffer.hpp"
+#include "../buffer/BufferPool.hpp"
+#include <liburing.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * @brief RawDumpSink - 原始帧转储旁路消费者（io_uring 批量写盘）
+ *
+ * 职责：
+ * - 作为 BufferPool 的扇出观察者，将消费者实际显示过的帧原样写入文件
+ * - 输出为无文件头的原始帧序列，可直接用 MMAP / IOURING 读取器回放
+ * - 用于调试和 golden 图像采集
+ *
+ * 数据流：
+ * ```
+ * 显示线程: releaseFilled → FrameObserver → retainBuffer（零拷贝，不拷贝像素）
+ *                                              │  （保留数已达上限 → 丢帧计数）
+ *                                              ▼
+ * 写盘线程:  pending 队列 → 批量 io_uring_prep_write + 一次 submit
+ *                        → 完成 → releaseRetained（buffer 回到空闲队列）
+ * ```
+ *
+ * 特点：
+ * - 零拷贝：直接从 pool buffer 写盘；地址不满足 O_DIRECT 对齐或 buffer 无法保留时
+ *   才拷贝到预分配的对齐 bounce buffer
+ * - O_DIRECT：帧大小为块大小整数倍时启用，绕过页缓存，避免脏页回写抖动
+ * - 背压：同时保留的 pool buffer 数有上限（max_inflight），超过即丢帧，
+ *   生产者始终有 buffer 可用，显示线程永不阻塞
+ *
+ * 使用示例：
+ * @code
+ * RawDumpSink::Config cfg("/data/dump.raw");
+ * RawDumpSink sink;
+ * sink.start(cfg, display.getBufferPool());
+ * // ... 正常显示 ...
+ * sink.stop();                     // 等待在途写入完成
+ * @endcode
+ *
+ * @note 保留的 buffer 在写完前不会回到空闲队列，max_inflight 应明显小于 pool 容量
+ */
+class RawDumpSink {
+public:
+    /**
+     * @brief 转储配置
+     */
+    struct Config {
+        std::string output_path;        // 输出文件
+        size_t frame_size;              // 每帧写入字节数（0 = pool buffer 大小）
+        int max_inflight;               // 最多同时保留/在途的帧数（背压阈值）
+        int batch_size;                 // 单次 io_uring_submit 最多提交的写请求数
+        int bounce_buffers;             // 对齐 bounce buffer 数量（无法零拷贝时使用）
+        bool use_direct_io;             // 尝试 O_DIRECT
+        int max_frames;                 // 最多转储帧数（0 = 不限）
+
+        Config()
+            : frame_size(0), max_inflight(2), batch_size(4)
+            , bounce_buffers(2), use_direct_io(true), max_frames(0) {}
+
+        explicit Config(const std::string& path, size_t size = 0)
+            : output_path(path), frame_size(size), max_inflight(2), batch_size(4)
+            , bounce_buffers(2), use_direct_io(true), max_frames(0) {}
+    };
+
+    /**
+     * @brief 转储统计
+     */
+    struct Stats {
+        uint64_t frames_written;        // 已写完的帧数
+        uint64_t frames_dropped;        // 背压丢帧数
+        uint64_t bytes_written;         // 已写入字节数
+        uint64_t zero_copy_frames;      // 直接从 pool buffer 写出的帧数
+        uint64_t bounce_frames;         // 经 bounce buffer 拷贝的帧数
+        uint64_t submit_calls;          // io_uring_submit 调用次数
+        uint64_t write_errors;          // 写失败次数
+        int peak_inflight;              // 在途写入峰值
+        double avg_write_ms;            // 平均每帧 入队→写完 耗时
+        double throughput_mbps;         // 平均写入吞吐（MB/s）
+    };
+
+    RawDumpSink();
+    ~RawDumpSink();
+
+    // 禁止拷贝
+    RawDumpSink(const RawDumpSink&) = delete;
+    RawDumpSink& operator=(const RawDumpSink&) = delete;
+
+    // ========== 生命周期 ==========
+
+    /**
+     * @brief 打开输出文件、初始化 io_uring 并挂接到 pool
+     * @return 成功返回 true
+     */
+    bool start(const Config& config, BufferPool& pool);
+
+    /**
+     * @brief 从 pool 分离，等待在途写入完成并关闭文件
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    /// 是否启用了 O_DIRECT
+    bool isDirectIo() const { return direct_io_; }
+
+    // ========== 统计 ==========
+
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    /**
+     * @brief 一次写请求（每帧一个）
+     */
+    struct WriteRequest {
+        const Buffer* retained;         // 保留的 pool buffer（bounce 时为 nullptr）
+        int bounce_index;               // bounce buffer 下标（-1 = 零拷贝）
+        const uint8_t* data;            // 写入源地址
+        size_t length;                  // 剩余字节数
+        off_t offset;                   // 文件偏移
+        std::chrono::steady_clock::time_point enqueue_time;
+    };
+
+    void onFrame(const Buffer* buffer);
+    void writerThreadFunc();
+    void submitBatch(std::deque<WriteRequest*>& batch);
+    void reapCompletions(std::deque<WriteRequest*>& batch, bool wait);
+    void completeRequest(WriteRequest* request, bool success);
+    bool isAligned(const void* addr) const;
+
+    Config config_;
+    size_t frame_size_;
+    size_t block_size_;                 // O_DIRECT 对齐要求
+    bool direct_io_;
+    int fd_;
+
+    // ========== io_uring ==========
+    struct io_uring ring_;
+    bool ring_initialized_;
+    int inflight_;                      // 已提交未完成（仅写盘线程访问）
+
+    // ========== 挂接 ==========
+    BufferPool* pool_;
+    int observer_id_;
+
+    // ========== 请求队列 ==========
+    std::vector<WriteRequest> requests_;            // 预分配的请求对象
+    std::vector<WriteRequest*> free_requests_;
+    std::deque<WriteRequest*> pending_;
+    std::vector<void*> bounce_;                     // 对齐 bounce buffer
+    std::vector<int> free_bounce_;
+    uint64_t next_frame_index_;
+    int outstanding_;                   // 已接收未完成的帧（背压计数）
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // ========== 线程 ==========
+    std::thread writer_thread_;
+    std::atomic<bool> running_;
+
+    // ========== 统计 ==========
+    std::atomic<uint64_t> frames_written_;
+    std::atomic<uint64_t> frames_dropped_;
+    std::atomic<uint64_t> bytes_written_;
+    std::atomic<uint64_t> zero_copy_frames_;
+    std::atomic<uint64_t> bounce_frames_;
+    std::atomic<uint64_t> submit_calls_;
+    std::atomic<uint64_t> write_errors_;
+    std::atomic<uint64_t> write_time_us_;
+    std::atomic<int> peak_inflight_;
+    std::chrono::steady_clock::time_point start_time_;
+    std::chrono::steady_clock::time_point stop_time_;
+};
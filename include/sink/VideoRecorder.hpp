@@ -0,0 +1,207 @@
+#pragma once
+
+#include "../buffer/Buffer.hpp"
+#include "../buffer/BufferPool.hpp"
+#include "../convert/PixelConverter.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+
+// FFmpeg 前向声明
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVStream;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/**
+ * @brief VideoRecorder - 录制旁路消费者（编码 + 封装到文件）
+ *
+ * 职责：
+ * - 作为 BufferPool 的扇出观察者，捕获消费者实际显示过的帧
+ * - 在独立工作线程上用 libavcodec 编码，用 libavformat 封装为 MP4/MKV
+ * - 有界队列：编码跟不上时丢帧，绝不阻塞显示线程
+ *
+ * 数据流：
+ * ```
+ * 显示线程: acquireFilled → display → releaseFilled
+ *                                          │ (FrameObserver)
+ *                                          ▼
+ *                              submitFrame(): 取空闲槽位 → memcpy
+ *                                          │  （无空闲槽位 → 丢帧计数）
+ *                                          ▼
+ * 编码线程:                  pending 队列 → sws_scale → avcodec → av_interleaved_write_frame
+ * ```
+ *
+ * 特点：
+ * - 槽位在 start() 时一次性分配，运行期无内存分配
+ * - PTS 取自捕获时刻（按 fps 量化），可正确反映显示端的实际节奏
+ * - 输出容器由文件扩展名决定（.mp4 / .mkv / .mov ...）
+ *
+ * 使用示例：
+ * @code
+ * VideoRecorder::Config cfg("capture.mp4", 1920, 1080, PixelFormat::ARGB8888);
+ * VideoRecorder recorder;
+ * recorder.start(cfg);
+ * recorder.attach(display.getBufferPool());   // 扇出录制
+ * // ... 正常显示 ...
+ * recorder.stop();                            // 刷新编码器并写文件尾
+ * @endcode
+ */
+class VideoRecorder {
+public:
+    /**
+     * @brief 录制配置
+     */
+    struct Config {
+        std::string output_path;        // 输出文件（扩展名决定容器格式）
+        int width;                      // 帧宽度
+        int height;                     // 帧高度
+        PixelFormat input_format;       // 输入帧像素格式
+        int fps;                        // 编码帧率（时间基 1/fps）
+        int64_t bit_rate;               // 目标码率（bps）
+        int gop_size;                   // GOP 长度
+        int queue_depth;                // 有界队列深度（帧）
+        int encoder_threads;            // 编码器内部线程数（0 = 自动）
+        std::string codec_name;         // 编码器名称（空 = 按容器默认 H.264）
+        std::string encoder_options;    // 编码器选项（如 "preset=ultrafast:tune=zerolatency"）
+
+        Config()
+            : width(0), height(0), input_format(PixelFormat::ARGB8888)
+            , fps(30), bit_rate(4000000), gop_size(60)
+            , queue_depth(8), encoder_threads(2) {}
+
+        Config(const std::string& path, int w, int h, PixelFormat fmt = PixelFormat::ARGB8888,
+               int frame_rate = 30)
+            : output_path(path), width(w), height(h), input_format(fmt)
+            , fps(frame_rate), bit_rate(4000000), gop_size(60)
+            , queue_depth(8), encoder_threads(2) {}
+    };
+
+    /**
+     * @brief 录制统计
+     */
+    struct Stats {
+        uint64_t captured_frames;       // 进入队列的帧数
+        uint64_t dropped_frames;        // 因队列满而丢弃的帧数
+        uint64_t encoded_frames;        // 已编码帧数
+        uint64_t written_packets;       // 已写入的包数
+        uint64_t written_bytes;         // 已写入的字节数
+        double avg_encode_ms;           // 平均每帧转换 + 编码耗时
+    };
+
+    VideoRecorder();
+    ~VideoRecorder();
+
+    // 禁止拷贝
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+
+    // ========== 生命周期 ==========
+
+    /**
+     * @brief 打开输出文件、初始化编码器并启动编码线程
+     * @return 成功返回 true
+     */
+    bool start(const Config& config);
+
+    /**
+     * @brief 停止录制：分离所有 pool、编码剩余帧、刷新编码器、写文件尾
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // ========== 帧输入 ==========
+
+    /**
+     * @brief 作为扇出观察者挂接到 BufferPool
+     * @return 成功返回 true
+     * @note 可挂接多个 pool；stop() 时自动分离
+     */
+    bool attach(BufferPool& pool);
+
+    /**
+     * @brief 从 BufferPool 分离
+     */
+    bool detach(BufferPool& pool);
+
+    /**
+     * @brief 提交一帧（非阻塞，拷贝数据）
+     * @return true 已入队，false 队列满被丢弃或未运行
+     */
+    bool submitFrame(const void* data, size_t size);
+    bool submitFrame(const Buffer* buffer);
+
+    // ========== 统计 ==========
+
+    Stats getStats() const;
+    void printStats() const;
+
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    /**
+     * @brief 预分配的帧槽位
+     */
+    struct FrameSlot {
+        std::vector<uint8_t> data;
+        std::chrono::steady_clock::time_point capture_time;
+    };
+
+    bool openOutput();
+    void closeOutput();
+    void encoderThreadFunc();
+    bool encodeSlot(FrameSlot* slot);
+    bool drainPackets();
+    void setError(const std::string& error, int ffmpeg_error = 0);
+
+    Config config_;
+    size_t frame_size_;                 // 输入帧字节数
+
+    // ========== FFmpeg 资源 ==========
+    AVFormatContext* format_ctx_;
+    AVCodecContext* codec_ctx_;
+    AVStream* stream_;
+    AVFrame* yuv_frame_;                // 复用的编码输入帧
+    AVPacket* packet_;                  // 复用的输出包
+    SwsContext* sws_ctx_;
+    int sws_src_format_;                // sws 输入 AVPixelFormat
+    std::unique_ptr<PixelConverter> pre_converter_;  // FFmpeg 无对应格式时先转为 ARGB8888
+    std::vector<uint8_t> staging_;      // pre_converter_ 的输出
+    int64_t last_pts_;
+    std::chrono::steady_clock::time_point start_time_;
+    bool first_frame_;
+
+    // ========== 有界队列 ==========
+    std::vector<std::unique_ptr<FrameSlot>> slots_;
+    std::vector<FrameSlot*> free_slots_;
+    std::deque<FrameSlot*> pending_;
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+
+    // ========== 扇出挂接 ==========
+    std::vector<std::pair<BufferPool*, int>> attached_pools_;
+    std::mutex attach_mutex_;
+
+    // ========== 线程 ==========
+    std::thread encoder_thread_;
+    std::atomic<bool> running_;
+
+    // ========== 统计 ==========
+    std::atomic<uint64_t> captured_frames_;
+    std::atomic<uint64_t> dropped_frames_;
+    std::atomic<uint64_t> encoded_frames_;
+    std::atomic<uint64_t> written_packets_;
+    std::atomic<uint64_t> written_bytes_;
+    std::atomic<uint64_t> encode_time_us_;
+
+    std::string last_error_;
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "../buffer/Buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <functional>
+
+/**
+ * @brief 帧校验点（管线中的哈希位置）
+ */
+enum class VerifyPoint {
+    POST_READ = 0,    // 读取/解码后（VideoProducer 提交前）
+    POST_CONVERT,     // 像素格式转换后（framebuffer 中的转换结果）
+    PRE_DISPLAY       // 送显前（即将扫描输出的字节）
+};
+
+/**
+ * @brief FrameVerifier - 帧校验和 / golden 回归校验
+ *
+ * 职责：
+ * - 在配置的校验点计算每帧哈希（CRC32C，SSE4.2 / ARMv8 CRC 硬件指令）
+ * - 与 golden 列表比对，统计匹配/不匹配/缺失
+ * - 没有 golden 时记录哈希，可保存为新的 golden 文件
+ *
+ * 帧哈希定义（与内核无关，SIMD 与标量结果逐位一致）：
+ * - 帧按字节均分为 4 条 lane（各 lane 长度按 8 字节对齐，余数归最后一条）
+ * - 每条 lane 独立计算 CRC32C（4 条依赖链交错执行，隐藏 crc32 指令延迟）
+ * - 帧哈希 = 4 个 lane CRC（小端）拼接后的 CRC32C
+ *
+ * 帧索引：
+ * - POST_READ 由生产者传入真实帧索引，并按 Buffer* 记录
+ * - 后续校验点按 Buffer*（或转换源 Buffer*）查回帧索引，多线程乱序也能对上
+ * - 查不到时退化为该校验点的顺序计数
+ *
+ * golden 文件格式（文本，# 开头为注释）：
+ * ```
+ * # <point> <frame_index> <crc32c>
+ * post-read 0 1a2b3c4d
+ * pre-display 0 1a2b3c4d
+ * ```
+ *
+ * 使用示例：
+ * @code
+ * FrameVerifier verifier;
+ * verifier.enablePoint(VerifyPoint::POST_READ);
+ * verifier.enablePoint(VerifyPoint::PRE_DISPLAY);
+ * verifier.setLoopLength(producer.getTotalFrames());
+ * if (!verifier.loadGolden("golden.txt")) {
+ *     // 首次运行：记录
+ * }
+ * producer.setFrameVerifier(&verifier);
+ * display.setFrameVerifier(&verifier);
+ * // ... 播放 ...
+ * verifier.printStats();
+ * if (!verifier.hasGolden()) verifier.saveGolden("golden.txt");
+ * @endcode
+ *
+ * @note 所有接口线程安全；1080p ARGB 帧的哈希开销约为一次 memcpy 的几分之一
+ */
+class FrameVerifier {
+public:
+    static const int kPointCount = 3;
+
+    /**
+     * @brief 单个校验点的统计
+     */
+    struct PointStats {
+        uint64_t hashed_frames;       // 已哈希帧数
+        uint64_t matched_frames;      // 与 golden 一致
+        uint64_t mismatched_frames;   // 与 golden 不一致
+        uint64_t missing_frames;      // golden 中无此帧（或记录模式）
+        double avg_hash_us;           // 平均每帧哈希耗时
+        double hash_gbps;             // 哈希吞吐（GB/s）
+    };
+
+    /**
+     * @brief 不匹配回调（在调用 verify 的线程中执行）
+     */
+    using MismatchCallback = std::function<void(VerifyPoint point, int frame_index,
+                                                uint32_t expected, uint32_t actual)>;
+
+    FrameVerifier();
+    ~FrameVerifier() = default;
+
+    // 禁止拷贝
+    FrameVerifier(const FrameVerifier&) = delete;
+    FrameVerifier& operator=(const FrameVerifier&) = delete;
+
+    // ========== 配置 ==========
+
+    /**
+     * @brief 启用/禁用校验点（默认全部禁用，禁用时 verify() 立即返回）
+     */
+    void enablePoint(VerifyPoint point, bool enable = true);
+    bool isEnabled(VerifyPoint point) const;
+
+    /**
+     * @brief 设置参与哈希的字节数（0 = 整个 buffer）
+     */
+    void setFrameSize(size_t frame_size) { frame_size_ = frame_size; }
+
+    /**
+     * @brief 设置循环长度（>0 时帧索引按此取模，用于循环播放）
+     */
+    void setLoopLength(int frames) { loop_length_ = frames; }
+
+    void setMismatchCallback(MismatchCallback callback);
+
+    // ========== golden 文件 ==========
+
+    /**
+     * @brief 加载 golden 文件
+     * @return 成功返回 true（文件不存在或为空返回 false）
+     */
+    bool loadGolden(const std::string& path);
+
+    /**
+     * @brief 保存本次记录的哈希为 golden 文件
+     */
+    bool saveGolden(const std::string& path) const;
+
+    bool hasGolden() const;
+
+    // ========== 校验 ==========
+
+    /**
+     * @brief 校验一个 Buffer
+     * @param point 校验点
+     * @param buffer 帧数据
+     * @param frame_index 帧索引（-1 = 按 Buffer* 查回，查不到用顺序计数）
+     * @return false 仅表示与 golden 不一致；未启用/无 golden 时返回 true
+     */
+    bool verify(VerifyPoint point, const Buffer* buffer, int frame_index = -1);
+
+    /**
+     * @brief 校验一段内存
+     */
+    bool verify(VerifyPoint point, const void* data, size_t size, int frame_index = -1);
+
+    /**
+     * @brief 查询 Buffer 最近一次关联的帧索引（未关联返回 -1）
+     */
+    int lookupFrameIndex(const Buffer* buffer) const;
+
+    // ========== 统计 ==========
+
+    PointStats getStats(VerifyPoint point) const;
+    uint64_t getTotalMismatches() const;
+    void printStats() const;
+    void resetStats();
+
+    // ========== 哈希工具函数 ==========
+
+    /**
+     * @brief 标准 CRC32C（Castagnoli，反射，初值/结果取反）
+     * @param crc 上一段的结果（用于分段计算）
+     */
+    static uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+    /**
+     * @brief 帧哈希（4 lane CRC32C，见类说明）
+     */
+    static uint32_t hashFrame(const void* data, size_t size);
+
+    /**
+     * @brief 帧哈希的标量参考实现（查表，结果与 hashFrame 一致）
+     */
+    static uint32_t hashFrameScalar(const void* data, size_t size);
+
+    static const char* pointName(VerifyPoint point);
+
+    /**
+     * @brief 按名称解析校验点（"post-read" / "post-convert" / "pre-display"）
+     */
+    static bool pointFromName(const char* name, VerifyPoint* point);
+
+    /**
+     * @brief 获取运行时选中的 CRC 实现名称（"SSE4.2"/"ARMv8 CRC"/"Scalar"，见 CpuFeatures）
+     */
+    static const char* getKernelName();
+
+private:
+    /**
+     * @brief 单个校验点的状态
+     */
+    struct PointState {
+        std::atomic<bool> enabled;
+        std::atomic<int> sequence;                    // 顺序计数（无帧索引时使用）
+        std::atomic<uint64_t> hashed;
+        std::atomic<uint64_t> matched;
+        std::atomic<uint64_t> mismatched;
+        std::atomic<uint64_t> missing;
+        std::atomic<uint64_t> hash_ns;
+        std::atomic<uint64_t> bytes;
+        std::unordered_map<int, uint32_t> golden;     // 帧索引 -> 期望哈希（受 mutex_ 保护）
+        std::unordered_map<int, uint32_t> recorded;   // 帧索引 -> 本次哈希（受 mutex_ 保护）
+    };
+
+    int resolveFrameIndex(const Buffer* buffer, int frame_index);
+
+    PointState points_[kPointCount];
+    size_t frame_size_;
+    int loop_length_;
+    bool has_golden_;
+
+    std::unordered_map<const Buffer*, int> frame_tags_;   // Buffer* -> 帧索引
+    MismatchCallback mismatch_callback_;
+    mutable std::mutex mutex_;
+};
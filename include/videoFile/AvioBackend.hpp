@@ -0,0 +1,140 @@
+#ifndef AVIO_BACKEND_HPP
+#define AVIO_BACKEND_HPP
+
+#include "StreamOpenConfig.hpp"
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <chrono>
+
+// FFmpeg 前向声明
+struct AVIOContext;
+
+/**
+ * @brief AvioBackend - FfmpegVideoReader 解复用用的自定义文件 I/O
+ *
+ * libavformat 默认通过 file: 协议读文件：32KB 缓冲，每次 refill 一次 read()，
+ * 高码率文件解复用时系统调用和内核 → 用户态拷贝都很多。这里提供两个自定义 AVIOContext：
+ *
+ * - MMAP：整个文件只读映射（MADV_SEQUENTIAL），read_packet 直接从映射拷出；
+ *   AVIOContext 开启 direct 模式，大块读取绕过 AVIO 内部缓冲，只剩一次拷贝
+ * - IOURING：文件按 block_size 分块，始终保持 readahead_blocks 个 io_uring 读请求在途，
+ *   消费完一块立即重新提交下一块；seek 超出窗口时排空在途请求后从新位置重新预读
+ * - DEFAULT：不创建 AVIOContext（getContext() 返回 nullptr），仍走 file: 协议，
+ *   只用于统计对比
+ *
+ * 统计（getStats）：
+ * - bytes：交给 libavformat 的字节数（DEFAULT 为 /proc/self/io 的 rchar 增量）
+ * - syscalls：后端自身发起的系统调用数（open / fstat / mmap / io_uring_enter 等；
+ *   DEFAULT 为 /proc/self/io 的 syscr 增量，是进程级计数，多线程时偏大）
+ *
+ * 使用方式：
+ * ```cpp
+ * auto backend = AvioBackend::create(AvioBackendType::IOURING);
+ * backend->open(path);
+ * AVFormatContext* fmt = avformat_alloc_context();
+ * if (backend->getContext()) {
+ *     fmt->pb = backend->getContext();
+ *     fmt->flags |= AVFMT_FLAG_CUSTOM_IO;
+ * }
+ * avformat_open_input(&fmt, path, nullptr, nullptr);
+ * // ... avformat_close_input(&fmt) 之后再销毁 backend
+ * ```
+ */
+class AvioBackend {
+public:
+    struct Options {
+        size_t avio_buffer_size;       // AVIOContext 内部缓冲
+        size_t block_size;             // IOURING：单个预读块大小
+        int readahead_blocks;          // IOURING：在途预读块数（也是队列深度）
+
+        Options()
+            : avio_buffer_size(256 * 1024)
+            , block_size(1024 * 1024)
+            , readahead_blocks(8) {}
+    };
+
+    struct Stats {
+        uint64_t bytes;                // 交给解复用器的字节数
+        uint64_t syscalls;             // 系统调用数
+        uint64_t seeks;                // seek 次数（不含 AVSEEK_SIZE 查询）
+        uint64_t refills;              // IOURING：窗口重建次数（seek 到窗口外）
+        double elapsed_s;              // 打开到现在的时长
+
+        Stats() : bytes(0), syscalls(0), seeks(0), refills(0), elapsed_s(0) {}
+
+        double bytesPerSec() const { return elapsed_s > 0 ? bytes / elapsed_s : 0; }
+        double syscallsPerSec() const { return elapsed_s > 0 ? syscalls / elapsed_s : 0; }
+    };
+
+    /**
+     * @brief 创建后端
+     */
+    static std::unique_ptr<AvioBackend> create(AvioBackendType type, const Options& options = Options());
+
+    /**
+     * @brief 后端名称（"file"、"mmap"、"iouring"）
+     */
+    static const char* typeToString(AvioBackendType type);
+
+    /**
+     * @brief 解析后端名称（"default" / "file"、"mmap"、"iouring" / "io_uring"）
+     */
+    static bool parseType(const char* name, AvioBackendType* type);
+
+    virtual ~AvioBackend();
+
+    /**
+     * @brief 打开文件并创建 AVIOContext
+     */
+    virtual bool open(const char* path) = 0;
+
+    /**
+     * @brief 释放 AVIOContext 与文件资源（须在 avformat_close_input 之后调用）
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 自定义 AVIOContext（DEFAULT 返回 nullptr）
+     */
+    AVIOContext* getContext() const { return avio_ctx_; }
+
+    virtual AvioBackendType type() const = 0;
+    const char* name() const { return typeToString(type()); }
+
+    virtual Stats getStats() const;
+
+    /**
+     * @brief 打印统计（吞吐与系统调用频率）
+     */
+    void printStats() const;
+
+protected:
+    explicit AvioBackend(const Options& options);
+
+    /// 创建 AVIOContext（read_packet / seek 回调转发到 readPacket / seekTo）
+    bool createContext(bool direct);
+    void freeContext();
+
+    virtual int readPacket(uint8_t* buf, int size) = 0;
+    virtual int64_t seekTo(int64_t offset, int whence) = 0;
+
+    /// 按 whence 计算新位置（SEEK_SET / SEEK_CUR / SEEK_END），越界返回 -1
+    int64_t resolveSeek(int64_t offset, int whence) const;
+
+    Options options_;
+    AVIOContext* avio_ctx_;
+    int64_t file_size_;
+    int64_t pos_;
+    Stats stats_;
+    std::chrono::steady_clock::time_point open_time_;
+
+private:
+    static int readPacketThunk(void* opaque, uint8_t* buf, int size);
+    static int64_t seekThunk(void* opaque, int64_t offset, int whence);
+
+    AvioBackend(const AvioBackend&) = delete;
+    AvioBackend& operator=(const AvioBackend&) = delete;
+};
+
+#endif // AVIO_BACKEND_HPP
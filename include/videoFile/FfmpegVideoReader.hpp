@@ -2,6 +2,7 @@
 #define FFMPEG_VIDEO_READER_HPP
 
 #include "IVideoReader.hpp"
+#include "AvioBackend.hpp"
 #include "../buffer/Buffer.hpp"
 #include "../buffer/BufferPool.hpp"
 #include "../decoder/IDecoder.hpp"
@@ -10,6 +11,7 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <chrono>
 
 // FFmpeg 前向声明
 struct AVFormatContext;
@@ -68,6 +70,12 @@ private:
     SwsContext* sws_ctx_;              // 图像格式转换
     int video_stream_index_;
     
+    // ============ 解码循环复用对象 ============
+    // 解码串行进行（mutex_），一个包 + 一帧即可覆盖，打开后首次解码时分配，关闭时释放；
+    // 稳态每帧只 unref，不再 av_packet_alloc / av_frame_alloc
+    AVPacket* packet_;
+    AVFrame* frame_;                   // decodeOneFrame 的输出（下一次解码前有效）
+    
     // ============ 文件信息 ============
     char file_path_[MAX_VIDEO_PATH_LENGTH];
     int width_;                        // 视频原始宽度
@@ -76,6 +84,7 @@ private:
     int output_height_;                // 输出高度（可能缩放）
     int output_bpp_;                   // 输出位深（如 32 for ARGB888）
     int output_pixel_format_;          // 输出像素格式（如 AV_PIX_FMT_BGRA）
+    bool output_format_fixed_;         // setOutputFormat 指定了输出格式（不再按位深推导）
     
     // ============ 解码状态 ============
     int total_frames_;                 // 总帧数（估算）
@@ -92,12 +101,23 @@ private:
     const char* decoder_name_;         // 指定解码器名称（如 "h264_taco"）
     AVDictionary* codec_options_;      // 解码器选项（用于 h264_taco 配置）
     
+    // ============ 解复用 I/O ============
+    std::unique_ptr<AvioBackend> io_backend_;  // 自定义 AVIOContext（file: 协议时只做统计）
+    
+    // ============ 打开延迟 ============
+    StreamProbeConfig probe_config_;   // 探测预算 / 调用方编码参数 / I/O 后端
+    OpenTimings open_timings_;         // 打开耗时分解（受 mutex_ 保护）
+    std::chrono::steady_clock::time_point open_start_;
+    std::chrono::steady_clock::time_point open_done_;
+    bool first_frame_pending_;         // 打开后首帧尚未解码
+    
     // ============ 线程安全 ============
     mutable std::mutex mutex_;
     
     // ============ 统计信息 ============
     std::atomic<int> decoded_frames_;
     std::atomic<int> decode_errors_;
+    std::atomic<uint64_t> decode_allocations_;   // 解码循环自身的堆分配次数（包 / 帧对象）
     
     // ============ 错误处理 ============
     std::string last_error_;
@@ -120,6 +140,12 @@ private:
      */
     bool findVideoStream();
     
+    /**
+     * @brief 用调用方提供的编码参数填充视频流（跳过探测时）
+     * @return 编码类型与容器不符时返回 false（回退到探测）
+     */
+    bool applyCodecParams(AVCodecParameters* codecpar);
+    
     /**
      * @brief 初始化解码器
      */
@@ -135,9 +161,14 @@ private:
      */
     bool initializeSwsContext();
     
+    /**
+     * @brief 分配（首次）复用的 AVPacket / AVFrame
+     */
+    bool ensureDecodeObjects();
+    
     /**
      * @brief 解码一帧
-     * @return AVFrame* 解码后的帧，失败返回nullptr
+     * @return AVFrame* 解码后的帧（即 frame_，由 reader 持有，下一次解码前有效），失败返回nullptr
      */
     AVFrame* decodeOneFrame();
     
@@ -252,6 +283,13 @@ public:
      */
     void setOutputBitsPerPixel(int bpp);
     
+    /**
+     * @brief 指定输出像素格式和尺寸（open 前后均可，下一帧生效）
+     * @note 支持 ARGB8888 / XRGB8888 / ABGR8888 / BGR24 / RGB24 / RGB565 / BGR565，
+     *       与显示格式一致时 readFrameTo 可直接写入 framebuffer
+     */
+    bool setOutputFormat(PixelFormat format, int width, int height) override;
+    
     /**
      * @brief 指定解码器名称（如 "h264_taco"）
      */
@@ -262,6 +300,22 @@ public:
      */
     void setHardwareDecoder(bool enable);
     
+    /**
+     * @brief 设置探测预算 / 调用方编码参数 / I/O 后端（在open之前调用）
+     */
+    void setProbeConfig(const StreamProbeConfig& config) override;
+    
+    /**
+     * @brief 选择解复用的文件 I/O 后端（在open之前调用，等价于设置 probe_config.io_backend）
+     * @note 自定义后端打开失败时回退到 file: 协议
+     */
+    void setIoBackend(AvioBackendType type);
+    
+    /**
+     * @brief 解复用 I/O 统计（读取字节 / 系统调用数及其速率），未打开时全为 0
+     */
+    AvioBackend::Stats getIoStats() const;
+    
     // ============ 信息查询 ============
     
     /**
@@ -274,6 +328,14 @@ public:
      */
     int getDecodeErrors() const { return decode_errors_.load(); }
     
+    /**
+     * @brief 获取解码循环自身的堆分配次数
+     * 
+     * 统计 reader 为解码分配的包 / 帧对象（不含 FFmpeg 内部的包数据与帧缓冲池），
+     * 打开后首帧之后应保持不变，可用于断言稳态解码每帧零分配
+     */
+    uint64_t getDecodeAllocations() const { return decode_allocations_.load(); }
+    
     /**
      * @brief 检查是否支持零拷贝
      */
@@ -294,6 +356,11 @@ public:
      */
     const char* getCodecName() const;
     
+    /**
+     * @brief 获取打开耗时分解（首帧解码前 first_frame_ms 为 -1）
+     */
+    OpenTimings getOpenTimings() const;
+    
     /**
      * @brief 打印统计信息
      */
@@ -2,8 +2,11 @@
 #define IVIDEO_READER_HPP
 
 #include "../buffer/Buffer.hpp"
+#include "StreamOpenConfig.hpp"
+#include "../convert/PixelConverter.hpp"
 #include <stddef.h>  // For size_t
 #include <sys/types.h>  // For ssize_t
+#include <functional>
 
 /**
  * IVideoReader - 视频读取器抽象接口
@@ -23,6 +26,17 @@
  */
 class IVideoReader {
 public:
+    /**
+     * 推送源事件（由 Reader 内部线程发出）
+     */
+    enum class SourceEvent {
+        FRAME_AVAILABLE,    // 一帧已注入 BufferPool
+        FRAME_DROPPED,      // 一帧已解码但未能注入（如 pool 已满）
+        END_OF_STREAM       // 流结束，之后不会再有帧
+    };
+    
+    using SourceEventCallback = std::function<void(SourceEvent event)>;
+    
     virtual ~IVideoReader() = default;
     
     // ============ 文件操作 ============
@@ -223,6 +237,84 @@ public:
         // 普通Reader（Mmap、IoUring）不需要BufferPool
         (void)pool;
     }
+    
+    // ============ 推送源接口（事件驱动）============
+    
+    /**
+     * 查询此 Reader 是否为推送源
+     * 
+     * 推送源由内部线程产生帧并直接注入 BufferPool（如 RTSP 零拷贝模式），
+     * readFrameAtThreadSafe() 不会阻塞也不代表真实帧。上层应注册
+     * SourceEventCallback 并等待事件，而不是循环调用读取接口。
+     * 
+     * @return 默认 false（拉取式 Reader）
+     */
+    virtual bool isPushSource() const {
+        return false;
+    }
+    
+    /**
+     * 设置推送源事件回调（nullptr 取消）
+     * 
+     * @note 回调在 Reader 内部线程中执行，必须快速返回
+     * @note 默认实现为空（拉取式 Reader 不发出事件）
+     */
+    virtual void setSourceEventCallback(SourceEventCallback callback) {
+        (void)callback;
+    }
+    
+    // ============ 打开延迟配置 ============
+    
+    /**
+     * 设置探测预算 / 调用方提供的编码参数（需在 open 之前调用）
+     * 
+     * @note 默认实现为空（raw Reader 无需探测）
+     */
+    virtual void setProbeConfig(const StreamProbeConfig& config) {
+        (void)config;
+    }
+    
+    // ============ 游标（多消费者共享同一打开的文件）============
+    
+    /**
+     * 查询此 Reader 是否支持独立游标（VideoCursor）
+     * 
+     * 要求 readFrameAtThreadSafe() 只按帧号定位、不依赖内部读取位置，
+     * 多个游标才能共享同一个 fd / 映射各自读取。
+     * 
+     * @return 默认 false（解码器、推送源等有顺序状态的 Reader）
+     */
+    virtual bool supportsCursors() const {
+        return false;
+    }
+    
+    /**
+     * 预读提示：即将读取 [frame_index, frame_index + frame_count)
+     * 
+     * 由 VideoCursor 按各自的顺序读取检测发出，不改变 Reader 状态，可在任意线程调用
+     * 
+     * @note 默认实现为空
+     */
+    virtual void readaheadHint(int frame_index, int frame_count) const {
+        (void)frame_index;
+        (void)frame_count;
+    }
+    
+    /**
+     * 指定解码输出的像素格式和尺寸（编码视频 Reader 在转换时直接输出目标格式）
+     * 
+     * 用于融合转换 + 上屏：解码器直接转换到 framebuffer 后台 buffer（显示格式、显示分辨率），
+     * 省掉中间 buffer 和一次整帧拷贝。可在 open 前后调用，从下一帧开始生效
+     * 
+     * @return Reader 不支持输出格式转换或该格式不支持时返回 false
+     * @note 默认实现返回 false（raw Reader 按文件格式原样输出）
+     */
+    virtual bool setOutputFormat(PixelFormat format, int width, int height) {
+        (void)format;
+        (void)width;
+        (void)height;
+        return false;
+    }
 };
 
 #endif // IVIDEO_READER_HPP
@@ -0,0 +1,233 @@
+#ifndef IMAGE_SEQUENCE_READER_HPP
+#define IMAGE_SEQUENCE_READER_HPP
+
+#include "IVideoReader.hpp"
+#include "../buffer/Buffer.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+// FFmpeg 前向声明
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+struct SwsContext;
+
+#define MAX_IMAGE_SEQUENCE_PATH_LENGTH 1024
+
+/**
+ * ImageSequenceReader - 编号图片序列读取器（PNG / JPEG / BMP）
+ *
+ * 功能：
+ * - 输入为 printf 风格的文件名模板（frames/%05d.png）或目录（按自然序排序）
+ * - 工作线程池并行解码（libavcodec 图片解码器），每个线程持有独立的解码上下文
+ * - 在播放游标之前预取 prefetch_depth 帧，解码结果直接转换为输出格式
+ * - 按帧序号取帧：readFrameAtThreadSafe(i) 等待第 i 帧就绪后拷贝到外部 Buffer，
+ *   配合单线程 VideoProducer 即可按顺序填充 BufferPool
+ *
+ * 输出格式：
+ * - openRaw(path, w, h, bpp)：缩放到指定分辨率，24 (BGR24) / 32 (BGRA) bpp
+ * - open(path)：使用第一张图片的分辨率，32bpp
+ *
+ * 使用方式：
+ * ```cpp
+ * VideoProducer::Config config("anim/%04d.png", w, h, 32, true, 1,
+ *                              VideoReaderFactory::ReaderType::IMAGE_SEQUENCE);
+ * ```
+ *
+ * @note 模板中只允许一个整数转换（%d / %0Nd），起始编号在 0~4 中自动探测
+ */
+class ImageSequenceReader : public IVideoReader {
+public:
+    /**
+     * 统计信息
+     */
+    struct SequenceStats {
+        int decoded_frames;        // 解码完成的帧数
+        int decode_errors;         // 解码失败的帧数
+        int prefetch_hits;         // 请求时已就绪
+        int prefetch_misses;       // 请求时需要等待解码
+        double avg_decode_ms;      // 单帧平均解码+转换耗时
+    };
+
+private:
+    /**
+     * 预取槽状态
+     */
+    enum class SlotState {
+        EMPTY,                     // 空闲
+        QUEUED,                    // 已排队，等待工作线程
+        DECODING,                  // 工作线程正在写入
+        READY,                     // 解码完成
+        FAILED                     // 解码失败
+    };
+
+    struct Slot {
+        int frame_index;           // 当前持有的帧（-1 = 无）
+        SlotState state;
+        bool pinned;               // 正在被拷贝出去，不可复用
+        std::vector<uint8_t> data; // 输出格式的帧数据
+    };
+
+    /**
+     * 工作线程私有的解码上下文（按编码类型复用）
+     */
+    struct WorkerContext {
+        AVCodecContext* codec_ctx;
+        int codec_id;              // AVCodecID
+        AVPacket* packet;
+        AVFrame* frame;
+        SwsContext* sws_ctx;
+        std::vector<uint8_t> file_data;  // 文件内容（含 FFmpeg 要求的尾部填充）
+    };
+
+    // ============ 文件信息 ============
+    char path_[MAX_IMAGE_SEQUENCE_PATH_LENGTH];
+    std::vector<std::string> files_;   // 按帧序排列的图片路径
+    long total_file_size_;
+
+    // ============ 输出格式 ============
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+    int output_pixel_format_;          // AV_PIX_FMT_BGRA / AV_PIX_FMT_BGR24
+
+    // ============ 预取缓存（prefetch_depth_ 个槽位，按 frame_index 查找）============
+    std::vector<Slot> slots_;
+    std::deque<int> decode_queue_;     // 待解码的槽位序号
+    int prefetch_depth_;
+    int worker_count_;
+    std::mutex cache_mutex_;
+    std::condition_variable cache_cv_;           // 帧就绪 / 槽释放（读取方等待）
+    std::condition_variable queue_cv_;           // 有新任务（工作线程等待）
+
+    // ============ 工作线程 ============
+    std::vector<std::thread> workers_;
+    bool stop_workers_;                // 受 cache_mutex_ 保护
+
+    // ============ 播放状态 ============
+    std::atomic<int> current_frame_index_;
+    bool is_open_;
+
+    // ============ 统计信息 ============
+    std::atomic<int> decoded_frames_;
+    std::atomic<int> decode_errors_;
+    std::atomic<int> prefetch_hits_;
+    std::atomic<int> prefetch_misses_;
+    std::atomic<long long> decode_time_us_;
+
+    // ============ 内部辅助方法 ============
+
+    /**
+     * 展开模板或扫描目录，填充 files_
+     */
+    bool resolveFiles(const char* path);
+    bool resolvePattern(const char* pattern);
+    bool resolveDirectory(const char* dir);
+
+    /**
+     * 解码第一张图片，获取原始分辨率（open() 时使用）
+     */
+    bool probeFirstImage(int* width, int* height);
+
+    /**
+     * 解码图片到 ctx.frame（原始像素格式）
+     */
+    bool loadImage(WorkerContext& ctx, const std::string& file);
+
+    /**
+     * 解码图片并转换为输出格式写入 dest
+     */
+    bool decodeImageTo(WorkerContext& ctx, const std::string& file, uint8_t* dest);
+
+    void releaseWorkerContext(WorkerContext& ctx);
+
+    void startWorkers();
+    void stopWorkers();
+    void workerThreadFunc(int worker_id);
+
+    /**
+     * 查找持有第 frame_index 帧的槽位（需持有 cache_mutex_）
+     * @return 槽位序号，-1 = 不在缓存中
+     */
+    int findSlotLocked(int frame_index) const;
+
+    /**
+     * 把 [frame_index, frame_index + prefetch_depth_) 排入解码队列（需持有 cache_mutex_）
+     *
+     * 窗口在末尾回绕到开头（帧数少于深度时去重），窗口内已缓存/排队的帧不会被覆盖
+     * @return 第 frame_index 帧已在缓存中或已排队
+     */
+    bool scheduleLocked(int frame_index);
+
+    /**
+     * 等待第 frame_index 帧就绪并拷贝到 dest（线程安全）
+     */
+    bool fetchFrame(int frame_index, void* dest, size_t size);
+
+public:
+    // ============ 构造/析构 ============
+
+    ImageSequenceReader();
+    virtual ~ImageSequenceReader();
+
+    // 禁止拷贝
+    ImageSequenceReader(const ImageSequenceReader&) = delete;
+    ImageSequenceReader& operator=(const ImageSequenceReader&) = delete;
+
+    // ============ IVideoReader 接口实现 ============
+
+    bool open(const char* path) override;
+    bool openRaw(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+
+    bool requiresExternalBuffer() const override {
+        return true;  // 解码结果拷贝到预分配的 Buffer
+    }
+
+    bool readFrameTo(Buffer& dest_buffer) override;
+    bool readFrameTo(void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAt(int frame_index, Buffer& dest_buffer) override;
+    bool readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const override;
+
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+
+    const char* getReaderType() const override;
+
+    // ============ 图片序列特有接口 ============
+
+    /**
+     * 设置解码线程数（open 之前调用，默认 min(CPU 核数, 4)）
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * 设置预取深度（open 之前调用，默认 工作线程数 * 2）
+     */
+    void setPrefetchDepth(int depth);
+
+    SequenceStats getSequenceStats() const;
+    void printStats() const;
+};
+
+#endif // IMAGE_SEQUENCE_READER_HPP
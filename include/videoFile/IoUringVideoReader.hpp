@@ -76,6 +76,11 @@ public:
     
     const char* getReaderType() const override;
     
+    bool supportsCursors() const override {
+        return true;  // readFrameAtThreadSafe 按帧号 pread
+    }
+    void readaheadHint(int frame_index, int frame_count) const override;
+    
     // ============ IoUring 专有接口（保留原有功能） ============
     
     /**
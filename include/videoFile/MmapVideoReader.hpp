@@ -4,7 +4,14 @@
 #include "IVideoReader.hpp"
 #include "../buffer/Buffer.hpp"
 #include <stddef.h>  // For size_t
+#include <stdint.h>
 #include <sys/types.h>  // For ssize_t
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #define MAX_PATH_LENGTH 512  // Maximum path length
 
@@ -25,6 +32,18 @@
  * - 文件大小 < 1GB
  * - 随机访问模式
  * - 单线程或少量线程
+ * 
+ * 滑动窗口模式（大文件）：
+ * - 整文件映射在 32 位平台上受地址空间限制，多 GB 的 raw 录像直接 mmap 失败；
+ *   64 位平台上也会长期占用一个巨大的 VMA
+ * - 窗口模式下每次只映射 window_frames 帧（按帧对齐，偏移为 64 位），
+ *   最多同时驻留 kMaxResidentWindows 个窗口，超出时按 LRU 解除映射
+ * - 读到窗口 N 时，后台线程提前映射窗口 N+1（MAP_POPULATE 预读，末尾回绕到 0 以支持循环播放），
+ *   跨窗口边界时不需要在读取线程里等待缺页
+ * - 读取线程持有窗口的 shared_ptr 直到拷贝完成，淘汰不会拆掉正在读取的映射
+ * 
+ * 映射方式由 StreamProbeConfig::map_window_frames 或 setMapWindow() 在打开前指定：
+ * 0 = 自动（文件超过 kAutoWindowThreshold 时使用窗口），< 0 = 整文件，> 0 = 窗口帧数
  */
 class MmapVideoReader : public IVideoReader {
 private:
@@ -41,10 +60,37 @@ private:
     size_t frame_size_;               // 单帧大小（字节）
     
     // ============ 文件信息 ============
-    long file_size_;                  // 文件大小（字节）
+    int64_t file_size_;               // 文件大小（字节，64 位）
     int total_frames_;                // 总帧数
     int current_frame_index_;         // 当前帧索引
     
+    // ============ 滑动窗口映射 ============
+    struct MapWindow {
+        int index;                    // 窗口序号（首帧 = index * window_frames_）
+        int first_frame;
+        void* base;                   // mmap 返回地址（页对齐）
+        size_t length;
+        size_t delta;                 // 首帧在映射内的偏移（文件偏移对齐到页后的余数）
+        uint64_t last_used;           // LRU 时间戳
+        
+        MapWindow() : index(-1), first_frame(0), base(nullptr), length(0), delta(0), last_used(0) {}
+        ~MapWindow();
+    };
+    
+    int requested_window_;            // 打开前指定的窗口帧数（0 = 自动，< 0 = 整文件）
+    int window_frames_;               // 实际窗口帧数（0 = 整文件映射）
+    int window_count_;
+    mutable std::mutex window_mutex_;
+    mutable std::condition_variable window_cv_;
+    mutable std::vector<std::shared_ptr<MapWindow>> windows_;   // 驻留窗口
+    mutable uint64_t window_clock_;
+    mutable int prefetch_index_;      // 待后台映射的窗口（-1 = 无）
+    mutable int mapping_index_;       // 后台线程正在映射的窗口（-1 = 无）
+    bool prefetch_stop_;
+    std::thread prefetch_thread_;
+    mutable std::atomic<uint64_t> window_maps_;     // 累计映射窗口数
+    mutable std::atomic<uint64_t> window_stalls_;   // 读取线程同步映射次数（预读没赶上）
+    
     // ============ 状态标志 ============
     bool is_open_;
     
@@ -96,6 +142,35 @@ private:
      * 解除文件映射
      */
     void unmapFile();
+    
+    /**
+     * 按窗口序号映射一段文件（populate 为 true 时预先读入所有页）
+     */
+    std::shared_ptr<MapWindow> mapWindow(int index, bool populate) const;
+    
+    /**
+     * 获取包含指定窗口的映射（未驻留时同步映射），并安排后台预读下一个窗口
+     */
+    std::shared_ptr<MapWindow> acquireWindow(int index) const;
+    
+    /**
+     * 插入驻留窗口（需持有 window_mutex_）
+     * 
+     * 同一窗口已驻留时返回已有映射；超过 kMaxResidentWindows 时按 LRU 淘汰，
+     * 淘汰的窗口放入 evicted，由调用方在释放锁之后销毁（munmap 不在锁内执行）
+     */
+    std::shared_ptr<MapWindow> insertWindowLocked(const std::shared_ptr<MapWindow>& window,
+                                                  std::vector<std::shared_ptr<MapWindow>>* evicted) const;
+    
+    /**
+     * 后台预读线程
+     */
+    void prefetchLoop();
+    
+    /**
+     * 将一帧拷贝到目标地址（整文件 / 窗口两种映射）
+     */
+    bool copyFrame(int frame_index, void* dest_buffer) const;
 
 public:
     // ============ 构造/析构 ============
@@ -107,6 +182,24 @@ public:
     MmapVideoReader(const MmapVideoReader&) = delete;
     MmapVideoReader& operator=(const MmapVideoReader&) = delete;
     
+    // ============ 映射方式 ============
+    
+    static constexpr int kMaxResidentWindows = 3;                       // 前一 / 当前 / 预读
+    static constexpr size_t kDefaultWindowBytes = 64 * 1024 * 1024;     // 自动模式的窗口大小
+    static constexpr int64_t kAutoWindowThreshold =
+        sizeof(void*) < 8 ? 512LL * 1024 * 1024 : 4LL * 1024 * 1024 * 1024;
+    
+    /**
+     * 设置映射方式（需在 open 之前调用）
+     * @param window_frames 0 = 自动，< 0 = 整文件映射，> 0 = 滑动窗口帧数
+     */
+    void setMapWindow(int window_frames);
+    
+    /**
+     * 实际窗口帧数（0 = 整文件映射）
+     */
+    int getMapWindowFrames() const { return window_frames_; }
+    
     // ============ IVideoReader 接口实现 ============
     
     bool open(const char* path) override;
@@ -141,6 +234,13 @@ public:
     bool isAtEnd() const override;
     
     const char* getReaderType() const override;
+    
+    bool supportsCursors() const override {
+        return true;  // readFrameAtThreadSafe 按帧号从映射拷贝
+    }
+    void readaheadHint(int frame_index, int frame_count) const override;
+    
+    void setProbeConfig(const StreamProbeConfig& config) override;
 };
 
 #endif // MMAP_VIDEO_READER_HPP
@@ -0,0 +1,376 @@
+#ifndef RTP_VIDEO_READER_HPP
+#define RTP_VIDEO_READER_HPP
+
+#include "IVideoReader.hpp"
+#include "../buffer/Buffer.hpp"
+#include "../decoder/Decoder.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+// FFmpeg 前向声明
+struct AVPacket;
+struct AVBufferRef;
+struct AVBufferPool;
+struct SwsContext;
+
+// 前向声明 BufferPool（避免循环依赖）
+class BufferPool;
+struct StagingPool;
+
+#define MAX_RTP_PATH_LENGTH 512
+
+/**
+ * RtpVideoReader - RTP/UDP 直收 H.264/H.265 视频读取器
+ *
+ * 功能：
+ * - 不经过 RTSP 会话和 libavformat，直接接收摄像头推送的 RTP/UDP 码流
+ * - recvmmsg 批量收包到预分配的包 arena（每次系统调用最多 64 个包）
+ * - H.264 (RFC 6184) / H.265 (RFC 7798) 解包：单 NAL、STAP-A/AP、FU-A/FU
+ * - 按 RTP marker / 时间戳组帧，送入 Decoder 门面解码
+ * - 序号跟踪：丢包、乱序、重复统计，RFC 3550 到达抖动
+ * - 乱序重排：解包前经过 kReorderDepth（8 个包）的重排窗口，
+ *   窗口内的乱序包按扩展序号归位后再解包，不再按丢包处理
+ *
+ * 零拷贝解包：
+ * - 负载从 arena 只拷贝一次，直接写入从 AVBufferPool 取得的访问单元缓冲
+ *   （Annex-B 起始码 + NAL），该缓冲以引用计数方式交给解码器，不再拷贝
+ * - FU-A 分片直接追加到同一缓冲，不经过中间 NAL 缓冲
+ *
+ * 丢包处理：
+ * - 缺口在重排窗口内等不到（窗口外的新包到达，或接收空闲 100ms）即判为丢包，
+ *   所在访问单元整帧丢弃，并等待下一个 IDR/IRAP 再恢复解码，
+ *   避免参考帧缺失造成的花屏扩散
+ *
+ * URL 格式：
+ * ```
+ * rtp://[bind_addr]:port[?codec=h264|h265][&pt=96][&size=1920x1080]
+ * rtp://:5004?codec=h264&size=1920x1080          # 单播
+ * rtp://239.0.0.1:5004?codec=h265&size=3840x2160 # 组播（自动加入组）
+ * ```
+ * codec/size 未在 URL 中给出时使用 setProbeConfig() 的 codec_name/width/height
+ *
+ * 测试：
+ * ```
+ * ffmpeg -re -i video.mp4 -an -c:v copy -f rtp rtp://127.0.0.1:5004
+ * ./display_test -m rtp "rtp://:5004?codec=h264&size=1920x1080"
+ * ```
+ *
+ * @note 仅适用于可信局域网（无 SRTP、无 RTCP 反馈）
+ */
+class RtpVideoReader : public IVideoReader {
+public:
+    /**
+     * 接收/解包统计
+     */
+    struct RtpStats {
+        uint64_t packets_received;     // 收到的 RTP 包
+        uint64_t bytes_received;       // 收到的字节数（含 RTP 头）
+        uint64_t packets_lost;         // 序号缺口（迟到的包到达后会扣回）
+        uint64_t packets_reordered;    // 迟到包（序号小于已收到的最大序号）
+        uint64_t packets_late;         // 超出重排窗口的迟到包（缺口已按丢包处理，丢弃）
+        uint64_t packets_duplicate;    // 重复包
+        uint64_t packets_invalid;      // 非 RTP / 负载类型不符 / 截断 / 不支持的打包方式
+        uint64_t access_units;         // 送入解码器的访问单元
+        uint64_t access_units_dropped; // 因丢包/溢出/等待关键帧丢弃的访问单元
+        uint64_t recv_calls;           // recvmmsg 调用次数
+        double avg_batch;              // 平均每次 recvmmsg 收到的包数
+        double jitter_ms;              // RFC 3550 到达抖动
+    };
+
+private:
+    static const int kRecvBatch = 64;              // 单次 recvmmsg 最多收包数
+    static const int kPacketSlotSize = 2048;       // arena 中每个包槽大小（> 以太网 MTU）
+    static const int kMaxAccessUnitSize = 4 << 20; // 单个访问单元上限（4MB）
+    static const int kReorderDepth = 8;            // 重排窗口（包数）：最多暂存 8 个超前到达的包
+
+    // ============ 连接信息 ============
+    char url_[MAX_RTP_PATH_LENGTH];
+    struct sockaddr_in bind_addr_;
+    bool multicast_;
+    int socket_fd_;
+    int payload_type_;                 // 期望的 RTP 负载类型（-1 = 不检查）
+    bool hevc_;                        // H.265 (true) / H.264 (false)
+    int coded_width_;                  // 码流分辨率
+    int coded_height_;
+
+    // ============ 输出格式 ============
+    int width_;                        // 输出宽度
+    int height_;                       // 输出高度
+    int output_pixel_format_;          // 输出像素格式（AV_PIX_FMT_BGRA / BGR24）
+    StreamProbeConfig probe_config_;   // 调用方提供的编码参数
+
+    // ============ 收包 arena（recvmmsg 直接写入）============
+    std::vector<uint8_t> arena_;       // kRecvBatch * kPacketSlotSize
+    std::unique_ptr<struct mmsghdr[]> msgs_;
+    std::unique_ptr<struct iovec[]> iovecs_;
+
+    // ============ 序号跟踪（仅接收线程访问）============
+    bool seq_initialized_;
+    uint32_t ssrc_;
+    uint16_t highest_seq_;             // 已收到的最大序号
+    uint64_t seen_mask_;               // bit i = (highest_seq_ - i) 已收到
+    int64_t last_transit_;             // 抖动计算：上一个包的 到达 - RTP 时间戳
+    double jitter_;                    // RFC 3550 抖动（RTP 时钟单位）
+
+    // ============ 乱序重排（仅接收线程访问）============
+    /**
+     * 重排窗口中暂存的包：负载拷贝在 reorder_arena_ 的同号槽中。
+     * 窗口为 (next_ext_seq_, next_ext_seq_ + kReorderDepth]，槽号 = 扩展序号 % kReorderDepth，
+     * 按序到达的包不经过窗口（直接从收包 arena 解包，不拷贝）
+     */
+    struct ReorderSlot {
+        bool used;
+        uint64_t ext_seq;              // 扩展序号（含回绕计数）
+        uint32_t timestamp;
+        bool marker;
+        size_t size;                   // 负载长度
+    };
+    std::vector<ReorderSlot> reorder_slots_;
+    std::vector<uint8_t> reorder_arena_;  // kReorderDepth * kPacketSlotSize
+    uint64_t next_ext_seq_;            // 下一个待解包的扩展序号
+    int reorder_count_;                // 窗口中暂存的包数
+    bool reorder_gap_;                 // 下一个解包的包之前有被放弃的缺口
+
+    // ============ 访问单元组帧（仅接收线程访问）============
+    AVBufferPool* au_pool_;            // 访问单元缓冲池（解码器释放引用后回收）
+    AVBufferRef* au_buf_;              // 当前正在组装的访问单元
+    size_t au_size_;
+    uint32_t au_timestamp_;
+    bool au_active_;
+    bool au_corrupt_;                  // 组帧期间丢包 / 溢出 / FU 起始分片缺失
+    bool au_has_keyframe_;             // 含 IDR (H.264) / IRAP (H.265)
+    bool in_fragment_;                 // 正在接收 FU 分片
+    bool waiting_keyframe_;            // 丢包后等待关键帧
+    AVPacket* packet_;                 // 复用的 AVPacket
+
+    // ============ 解码 ============
+    Decoder decoder_;
+    SwsContext* sws_ctx_;
+
+    // ============ 接收线程 ============
+    std::thread recv_thread_;
+    std::atomic<bool> running_;
+
+    // ============ 内部帧缓冲（传统模式）============
+    struct FrameSlot {
+        std::vector<uint8_t> data;
+        bool filled;
+    };
+    std::vector<FrameSlot> internal_buffer_;
+    int write_index_;
+    int read_index_;
+    std::mutex buffer_mutex_;
+    std::condition_variable buffer_cv_;
+
+    // ============ 零拷贝模式 ============
+    BufferPool* buffer_pool_;
+    std::shared_ptr<StagingPool> staging_pool_;  // 注入帧的暂存内存，消费者归还后复用
+
+    // ============ 推送源事件 ============
+    SourceEventCallback event_callback_;
+    std::mutex event_mutex_;
+
+    // ============ 统计信息 ============
+    std::atomic<int> decoded_frames_;
+    std::atomic<int> dropped_frames_;
+    std::atomic<uint64_t> packets_received_;
+    std::atomic<uint64_t> bytes_received_;
+    std::atomic<uint64_t> packets_lost_;
+    std::atomic<uint64_t> packets_reordered_;
+    std::atomic<uint64_t> packets_late_;
+    std::atomic<uint64_t> packets_duplicate_;
+    std::atomic<uint64_t> packets_invalid_;
+    std::atomic<uint64_t> access_units_;
+    std::atomic<uint64_t> access_units_dropped_;
+    std::atomic<uint64_t> recv_calls_;
+    std::atomic<uint64_t> jitter_us_;
+
+    // ============ 状态 ============
+    bool is_open_;
+
+    // ============ 错误处理 ============
+    std::string last_error_;
+    mutable std::mutex error_mutex_;
+
+    // ============ 内部辅助方法 ============
+
+    /**
+     * 解析 rtp:// URL（地址、端口、codec/pt/size 参数）
+     */
+    bool parseUrl(const char* url);
+
+    /**
+     * 创建、配置并绑定 UDP socket（大接收缓冲、组播加入）
+     */
+    bool openSocket();
+
+    /**
+     * 打开解码器、AVBufferPool 和收包 arena
+     */
+    bool openDecoder();
+
+    /**
+     * 接收线程主函数（poll + recvmmsg 批量收包）
+     */
+    void recvThreadFunc();
+
+    /**
+     * 处理一个 RTP 包（arena 中的原始数据）
+     */
+    void handlePacket(const uint8_t* data, size_t length, int64_t arrival_us);
+
+    /**
+     * 更新序号状态（丢包/乱序/重复统计）
+     * @return false 表示重复包，应丢弃（迟到包交给重排窗口处理）
+     */
+    bool trackSequence(uint16_t seq);
+
+    /**
+     * 重排：按序到达的包直接解包，超前的包暂存到窗口，迟于窗口的包丢弃
+     */
+    void reorderPacket(uint16_t seq, uint32_t timestamp, bool marker,
+                       const uint8_t* payload, size_t size);
+
+    /**
+     * 按序解包窗口中从 next_ext_seq_ 开始的连续暂存包
+     * @param give_up_before 早于该扩展序号的缺口不再等待（按丢包处理），
+     *                       UINT64_MAX = 清空整个窗口
+     */
+    void drainReorderWindow(uint64_t give_up_before);
+
+    /**
+     * 组帧并解包一个负载（按扩展序号顺序调用）
+     * @param gap 该包之前有丢失的包
+     */
+    void processPayload(const uint8_t* payload, size_t size,
+                        uint32_t timestamp, bool marker, bool gap);
+
+    /**
+     * 解包 H.264 负载并追加到当前访问单元
+     */
+    bool depacketizeH264(const uint8_t* payload, size_t size);
+
+    /**
+     * 解包 H.265 负载并追加到当前访问单元
+     */
+    bool depacketizeH265(const uint8_t* payload, size_t size);
+
+    /**
+     * 追加 [起始码 +] 数据到当前访问单元
+     */
+    bool appendToAccessUnit(const uint8_t* header, size_t header_size,
+                            const uint8_t* data, size_t size, bool start_code);
+
+    /**
+     * 开始新的访问单元（从 AVBufferPool 取缓冲）
+     */
+    bool beginAccessUnit(uint32_t timestamp);
+
+    /**
+     * 结束当前访问单元：完整则送入解码器，否则丢弃
+     */
+    void finishAccessUnit();
+
+    /**
+     * 取出解码器输出的所有帧并分发
+     */
+    void drainDecoder();
+
+    /**
+     * 转换格式并分发一帧（注入 BufferPool 或存入内部缓冲）
+     */
+    void deliverFrame(AVFrame* frame);
+
+    /**
+     * 从内部缓冲区拷贝帧（传统模式）
+     */
+    bool copyFromInternalBuffer(void* dest, size_t size);
+
+    void emitSourceEvent(SourceEvent event);
+    void setError(const std::string& error);
+
+public:
+    // ============ 构造/析构 ============
+
+    RtpVideoReader();
+    virtual ~RtpVideoReader();
+
+    // 禁止拷贝
+    RtpVideoReader(const RtpVideoReader&) = delete;
+    RtpVideoReader& operator=(const RtpVideoReader&) = delete;
+
+    // ============ IVideoReader 接口实现 ============
+
+    /**
+     * 打开 RTP 流，输出分辨率 = 码流分辨率，32bpp
+     */
+    bool open(const char* path) override;
+
+    /**
+     * 打开 RTP 流并指定输出分辨率/位深（24 或 32）
+     */
+    bool openRaw(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+
+    bool requiresExternalBuffer() const override {
+        return false;  // 解码后内部拷贝或动态注入
+    }
+
+    bool readFrameTo(Buffer& dest_buffer) override;
+    bool readFrameTo(void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAt(int frame_index, Buffer& dest_buffer) override;
+    bool readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const override;
+
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+
+    const char* getReaderType() const override;
+
+    // ============ 零拷贝 / 推送源 ============
+
+    void setBufferPool(void* pool) override;
+
+    bool isPushSource() const override {
+        return buffer_pool_ != nullptr;
+    }
+
+    void setSourceEventCallback(SourceEventCallback callback) override;
+
+    /**
+     * codec_name/width/height 作为 URL 未指定时的默认码流参数，extradata 预先送入解码器
+     */
+    void setProbeConfig(const StreamProbeConfig& config) override;
+
+    // ============ RTP 特有接口 ============
+
+    RtpStats getRtpStats() const;
+    int getDecodedFrames() const { return decoded_frames_.load(); }
+    int getDroppedFrames() const { return dropped_frames_.load(); }
+    std::string getLastError() const;
+    void printStats() const;
+};
+
+#endif // RTP_VIDEO_READER_HPP
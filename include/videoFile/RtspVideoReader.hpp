@@ -10,6 +10,7 @@
 #include <condition_variable>
 #include <queue>
 #include <memory>
+#include <chrono>
 
 // FFmpeg 前向声明
 struct AVFormatContext;
@@ -21,6 +22,7 @@ struct SwsContext;
 
 // 前向声明 BufferPool（避免循环依赖）
 class BufferPool;
+struct StagingPool;
 
 #define MAX_RTSP_PATH_LENGTH 512
 
@@ -35,7 +37,7 @@ class BufferPool;
  * 
  * 特点：
  * - 实时流处理（无总帧数概念）
- * - 自动重连机制
+ * - 自动重连机制（指数退避 + 复用缓存的流参数跳过探测 + 保温解码器，从下一个 IDR 恢复）
  * - 线程安全的帧访问
  * - 支持硬件加速解码（可选）
  * 
@@ -55,6 +57,35 @@ class BufferPool;
  * ```
  */
 class RtspVideoReader : public IVideoReader {
+public:
+    /**
+     * 自动重连配置
+     */
+    struct ReconnectConfig {
+        bool enabled;                  // 网络错误/EOF 时自动重连
+        int initial_backoff_ms;        // 首次重试前等待
+        int max_backoff_ms;            // 退避上限（每次失败翻倍）
+        int max_attempts;              // 最大连续重试次数（0 = 不限）
+        bool reuse_stream_params;      // 复用首次连接的流参数，跳过 avformat_find_stream_info
+        
+        ReconnectConfig()
+            : enabled(true), initial_backoff_ms(100), max_backoff_ms(5000)
+            , max_attempts(0), reuse_stream_params(true) {}
+    };
+    
+    /**
+     * 重连统计
+     */
+    struct ReconnectStats {
+        int reconnects;                // 成功重连次数
+        int failed_attempts;           // 失败的重试次数
+        int fast_reconnects;           // 走快速路径（跳过探测 + 保温解码器）的次数
+        int skipped_packets;           // 等待 IDR 期间丢弃的包
+        double last_connect_ms;        // 最近一次重连：断开 → 会话重建完成
+        double last_ttff_ms;           // 最近一次重连：断开 → 首帧解码完成
+        double avg_ttff_ms;            // 平均重连首帧时间
+    };
+
 private:
     // ============ FFmpeg 资源 ============
     AVFormatContext* format_ctx_;
@@ -62,6 +93,10 @@ private:
     SwsContext* sws_ctx_;              // 图像格式转换
     int video_stream_index_;
     
+    // ============ 解码循环复用对象（仅解码线程访问）============
+    AVPacket* packet_;
+    AVFrame* frame_;                   // decodeOneFrame 的输出（下一次解码前有效）
+    
     // ============ RTSP 连接信息 ============
     char rtsp_url_[MAX_RTSP_PATH_LENGTH];
     int width_;                        // 输出宽度
@@ -88,9 +123,46 @@ private:
     // ============ 零拷贝模式 ============
     BufferPool* buffer_pool_;          // 可选：零拷贝模式的BufferPool
     
+    /**
+     * 注入帧的暂存内存池：消费者归还（BufferHandle 析构）时内存回到空闲列表，
+     * 稳态下不再每帧 new / delete 整帧内存（见 buffer/StagingPool.hpp）
+     */
+    std::shared_ptr<StagingPool> staging_pool_;
+    
+    // ============ 推送源事件 ============
+    SourceEventCallback event_callback_;
+    std::mutex event_mutex_;           // 保护 event_callback_
+    bool eos_signaled_;                // END_OF_STREAM 只发送一次
+    
+    // ============ 自动重连 ============
+    ReconnectConfig reconnect_config_;
+    AVCodecParameters* cached_codecpar_;   // 首次连接的流参数（含 extradata）
+    std::atomic<bool> abort_request_;      // 中断阻塞中的 FFmpeg I/O（close 时置位）
+    int last_read_error_;                  // 最近一次 av_read_frame 的返回值（仅解码线程访问）
+    bool waiting_keyframe_;                // 重连后丢包直到下一个关键帧
+    bool ttff_pending_;                    // 重连后首帧尚未解码
+    std::chrono::steady_clock::time_point disconnect_time_;
+    
+    // ============ 打开延迟 ============
+    StreamProbeConfig probe_config_;       // 探测预算 / 调用方编码参数
+    OpenTimings open_timings_;             // 首次打开耗时分解（受 timing_mutex_ 保护）
+    std::chrono::steady_clock::time_point open_start_;
+    std::chrono::steady_clock::time_point open_done_;
+    bool first_frame_pending_;             // 打开后首帧尚未解码
+    mutable std::mutex timing_mutex_;
+    
     // ============ 统计信息 ============
     std::atomic<int> decoded_frames_;
     std::atomic<int> dropped_frames_;
+    std::atomic<int> reconnects_;
+    std::atomic<int> failed_attempts_;
+    std::atomic<int> fast_reconnects_;
+    std::atomic<int> skipped_packets_;
+    std::atomic<uint64_t> last_connect_us_;
+    std::atomic<uint64_t> last_ttff_us_;
+    std::atomic<uint64_t> total_ttff_us_;
+    std::atomic<int> ttff_samples_;
+    std::atomic<uint64_t> decode_allocations_;   // 解码循环自身的堆分配（包 / 帧对象、暂存帧）
     
     // ============ 状态 ============
     bool is_open_;
@@ -104,14 +176,49 @@ private:
     
     /**
      * 连接 RTSP 流并初始化解码器
+     * @param timings 非空时记录 连接/探测/解码器 耗时
      */
-    bool connectRTSP();
+    bool connectRTSP(OpenTimings* timings = nullptr);
     
     /**
      * 断开 RTSP 连接并释放资源
      */
     void disconnectRTSP();
     
+    /**
+     * 打开 RTSP 会话并定位视频流
+     * @param fast 使用缓存的流参数，跳过 avformat_find_stream_info
+     * @param timings 非空时记录 连接/探测 耗时
+     * 
+     * 非快速路径下按 probe_config_ 设置探测预算；调用方提供了编码参数时同样跳过探测
+     */
+    bool openInput(bool fast, OpenTimings* timings = nullptr);
+    
+    /**
+     * 用调用方提供的编码参数填充视频流
+     * @return 编码类型与 SDP 不符时返回 false（回退到探测）
+     */
+    bool applyCodecParams(AVCodecParameters* codecpar);
+    
+    /**
+     * 按当前视频流参数创建并打开解码器
+     */
+    bool openDecoder();
+    
+    /**
+     * 重建 RTSP 会话（指数退避，直到成功/超过次数/关闭）
+     * 
+     * 优先走快速路径：只重建 AVFormatContext，复用缓存参数跳过探测，
+     * 解码器与 SwsContext 保温（仅 flush），从下一个 IDR 恢复解码；
+     * 编码参数变化时回退到完整连接
+     */
+    bool reconnectRTSP();
+    
+    /**
+     * FFmpeg 阻塞 I/O 中断回调
+     */
+    static int interruptCallback(void* opaque);
+    
     /**
      * 解码线程主函数
      */
@@ -119,10 +226,15 @@ private:
     
     /**
      * 从RTSP接收并解码一帧
-     * @return AVFrame* 解码后的帧，失败返回nullptr
+     * @return AVFrame* 解码后的帧（即 frame_，下一次解码前有效），失败返回nullptr
      */
     AVFrame* decodeOneFrame();
     
+    /**
+     * 零拷贝模式：转换一帧到暂存内存并注入 BufferPool
+     */
+    void injectFrame(AVFrame* frame);
+    
     /**
      * 将AVFrame转换为目标格式并存储
      * @param frame 源帧
@@ -147,6 +259,11 @@ private:
      */
     void setError(const std::string& error);
     
+    /**
+     * 发出推送源事件（解码线程调用）
+     */
+    void emitSourceEvent(SourceEvent event);
+    
     /**
      * 获取AVFrame的物理地址（如果可用）
      */
@@ -205,6 +322,17 @@ public:
      */
     void setBufferPool(void* pool) override;
     
+    // ============ 推送源接口 ============
+    
+    /**
+     * 零拷贝模式下为推送源：帧由解码线程注入，读取接口立即返回
+     */
+    bool isPushSource() const override {
+        return buffer_pool_ != nullptr;
+    }
+    
+    void setSourceEventCallback(SourceEventCallback callback) override;
+    
     // ============ RTSP 特有接口 ============
     
     /**
@@ -217,11 +345,39 @@ public:
      */
     int getDroppedFrames() const { return dropped_frames_.load(); }
     
+    /**
+     * 获取解码循环自身的堆分配次数
+     * 
+     * 统计包 / 帧对象和零拷贝暂存帧的分配（不含 FFmpeg 内部缓冲与注入时的 Buffer 包装对象），
+     * 首帧之后应保持不变（暂存池填满后），可用于断言稳态解码每帧零分配
+     */
+    uint64_t getDecodeAllocations() const { return decode_allocations_.load(); }
+    
     /**
      * 获取连接状态
      */
     bool isConnected() const { return connected_.load(); }
     
+    /**
+     * 设置自动重连配置（需在 openRaw 之前调用）
+     */
+    void setReconnectConfig(const ReconnectConfig& config) { reconnect_config_ = config; }
+    
+    /**
+     * 获取重连统计
+     */
+    ReconnectStats getReconnectStats() const;
+    
+    /**
+     * 设置探测预算 / 调用方编码参数（需在 openRaw 之前调用）
+     */
+    void setProbeConfig(const StreamProbeConfig& config) override;
+    
+    /**
+     * 获取首次打开耗时分解（首帧解码前 first_frame_ms 为 -1）
+     */
+    OpenTimings getOpenTimings() const;
+    
     /**
      * 获取最后错误信息
      */
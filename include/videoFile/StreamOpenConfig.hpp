@@ -0,0 +1,101 @@
+#ifndef STREAM_OPEN_CONFIG_HPP
+#define STREAM_OPEN_CONFIG_HPP
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * AvioBackendType - FfmpegVideoReader 解复用的文件 I/O 后端（见 AvioBackend）
+ */
+enum class AvioBackendType {
+    DEFAULT,                           // libavformat 自带 file: 协议（32KB 缓冲 read()）
+    MMAP,                              // 直接从文件映射取数据，无 read() 系统调用
+    IOURING,                           // io_uring 大块异步预读
+};
+
+/**
+ * StreamProbeConfig - 编码流/文件打开时的探测预算（FfmpegVideoReader / RtspVideoReader）
+ *
+ * avformat_find_stream_info 默认最多读取 5MB / 5 秒数据来推断流参数，
+ * 对 RTSP 和裸码流而言这通常是打开延迟的主要部分。
+ *
+ * 两种降低打开延迟的方式：
+ * 1. 调小探测预算（probesize / analyzeduration / fpsprobesize）
+ * 2. 由调用方直接给出编码参数（codec_name + 分辨率 + extradata），完全跳过探测
+ *
+ * 使用方式：
+ * ```cpp
+ * VideoProducer::Config config(url, w, h, bpp, false, 1, VideoReaderFactory::ReaderType::RTSP);
+ * config.probe = StreamProbeConfig::lowLatency();      // 方式1
+ * config.probe.codec_name = "h264";                     // 方式2（跳过探测）
+ * config.probe.width = 1920;
+ * config.probe.height = 1080;
+ * ```
+ */
+struct StreamProbeConfig {
+    int64_t probesize;                 // 探测最多读取字节数（-1 = FFmpeg 默认）
+    int64_t analyzeduration_us;        // 探测最长时长，微秒（-1 = FFmpeg 默认）
+    int fpsprobesize;                  // 帧率探测帧数（-1 = FFmpeg 默认，0 = 不探测）
+
+    // ============ 调用方提供的编码参数（codec_name 非空时跳过探测）============
+    std::string codec_name;            // 解码器名称（如 "h264" / "hevc"）
+    int width;                         // 编码分辨率（必填）
+    int height;
+    std::vector<uint8_t> extradata;    // SPS/PPS 等（可选，为空时从码流带内获取）
+
+    // ============ 本地文件解复用 I/O（FfmpegVideoReader）============
+    AvioBackendType io_backend;
+
+    // ============ raw 文件映射方式（MmapVideoReader）============
+    int map_window_frames;             // 0 = 自动，< 0 = 整文件映射，> 0 = 滑动窗口帧数
+
+    StreamProbeConfig()
+        : probesize(-1), analyzeduration_us(-1), fpsprobesize(-1)
+        , width(0), height(0), io_backend(AvioBackendType::DEFAULT)
+        , map_window_frames(0) {}
+
+    /**
+     * 低延迟预设：32KB / 100ms，不探测帧率
+     */
+    static StreamProbeConfig lowLatency() {
+        StreamProbeConfig config;
+        config.probesize = 32 * 1024;
+        config.analyzeduration_us = 100000;
+        config.fpsprobesize = 0;
+        return config;
+    }
+
+    bool hasCodecParams() const {
+        return !codec_name.empty();
+    }
+};
+
+/**
+ * OpenTimings - 打开耗时分解（毫秒）
+ */
+struct OpenTimings {
+    double connect_ms;                 // avformat_open_input（RTSP: DESCRIBE/SETUP/PLAY，文件: 读头）
+    double probe_ms;                   // avformat_find_stream_info（跳过时为 0）
+    double decoder_ms;                 // 解码器 + 格式转换器初始化
+    double first_frame_ms;             // 打开完成 → 首帧解码完成（-1 = 尚未解码）
+    double total_ms;                   // 开始打开 → 首帧解码完成
+    bool probe_skipped;                // 使用了调用方/缓存的参数，未探测
+
+    OpenTimings()
+        : connect_ms(0), probe_ms(0), decoder_ms(0)
+        , first_frame_ms(-1), total_ms(0), probe_skipped(false) {}
+
+    void print(const char* reader_name) const {
+        printf("⏱️  %s open latency: connect %.1f ms, probe %.1f ms%s, decoder %.1f ms",
+               reader_name, connect_ms, probe_ms, probe_skipped ? " (skipped)" : "", decoder_ms);
+        if (first_frame_ms >= 0) {
+            printf(", first frame %.1f ms, total %.1f ms\n", first_frame_ms, total_ms);
+        } else {
+            printf("\n");
+        }
+    }
+};
+
+#endif // STREAM_OPEN_CONFIG_HPP
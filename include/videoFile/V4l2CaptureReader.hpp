@@ -0,0 +1,283 @@
+#ifndef V4L2_CAPTURE_READER_HPP
+#define V4L2_CAPTURE_READER_HPP
+
+#include "IVideoReader.hpp"
+#include "../buffer/Buffer.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+// 前向声明 BufferPool（避免循环依赖）
+class BufferPool;
+struct v4l2_buffer;
+
+#define MAX_V4L2_PATH_LENGTH 256
+
+/**
+ * V4l2CaptureReader - V4L2 摄像头采集读取器（流式 I/O）
+ *
+ * 三种工作方式：
+ * 1. DMABUF 导入（零拷贝）：setBufferPool() 传入预分配的 CMA BufferPool，
+ *    空闲 buffer 导出为 DMA-BUF fd 后直接 QBUF 给驱动，采集完成即 submitFilled()，
+ *    消费者拿到的 buffer 带物理地址，可直接 displayBufferByDMA()
+ * 2. MMAP 注入：setBufferPool() 传入动态注入模式的 BufferPool，驱动分配的
+ *    mmap buffer 以 BufferHandle 注入，消费者 releaseFilled() 时自动重新 QBUF
+ * 3. 传统模式：不设置 BufferPool，readFrameTo() 从 MMAP buffer 拷贝一帧
+ *
+ * 延迟统计：
+ * - 驱动时间戳（CLOCK_MONOTONIC）→ DQBUF：驱动/采集延迟
+ * - 驱动时间戳 → 消费者 releaseFilled()（通过 BufferPool 帧观察者）：采集到显示延迟
+ *
+ * 使用方式（vivid 虚拟采集设备）：
+ * ```
+ * sudo modprobe vivid
+ * ./display_test -m v4l2 /dev/video0
+ * ```
+ *
+ * @note path 为设备节点（/dev/videoN）；openRaw 的 bpp 决定像素格式：
+ *       32 → V4L2_PIX_FMT_XBGR32（内存序 B,G,R,X，与 ARGB8888 framebuffer 一致），24 → BGR24
+ */
+class V4l2CaptureReader : public IVideoReader {
+public:
+    /**
+     * 缓冲区内存类型
+     */
+    enum class MemoryMode {
+        AUTO,                      // 预分配 CMA BufferPool → DMABUF，否则 MMAP
+        MMAP,                      // 驱动分配，mmap 到用户空间
+        DMABUF                     // 导入 BufferPool 的 DMA-BUF
+    };
+
+    /**
+     * 采集统计
+     */
+    struct CaptureStats {
+        int captured_frames;       // DQBUF 成功的帧数
+        int dropped_frames;        // 无空闲 buffer / 注入失败 / 驱动报错的帧
+        int sequence_gaps;         // 驱动 sequence 跳号（驱动侧丢帧）
+        double avg_dequeue_ms;     // 驱动时间戳 → DQBUF
+        double avg_display_ms;     // 驱动时间戳 → 消费者释放
+        double min_display_ms;
+        double max_display_ms;
+        int display_samples;
+    };
+
+private:
+    /**
+     * MMAP buffer 的共享状态
+     *
+     * 注入 BufferPool 的 BufferHandle 的 deleter 持有它的 shared_ptr：
+     * 消费者在 Reader 关闭后才释放 buffer 时，映射仍然有效，且不会再 QBUF
+     */
+    struct MmapState {
+        int fd;                            // dup 的设备 fd（状态析构时关闭）
+        std::vector<void*> addrs;
+        std::vector<size_t> lengths;
+        std::vector<int> dma_fds;          // VIDIOC_EXPBUF 导出的 DMA-BUF fd（-1 = 不支持）
+        std::mutex mutex;
+        bool streaming;                    // false 后 deleter 不再 QBUF
+
+        MmapState() : fd(-1), streaming(false) {}
+        ~MmapState();
+        bool queue(int index);
+    };
+
+    // ============ 设备信息 ============
+    char device_path_[MAX_V4L2_PATH_LENGTH];
+    int fd_;
+    std::string driver_name_;
+    std::string card_name_;
+
+    // ============ 格式 ============
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+    uint32_t pixel_format_;            // V4L2_PIX_FMT_*
+    uint32_t bytes_per_line_;
+    uint32_t size_image_;
+
+    // ============ 流式 I/O ============
+    MemoryMode requested_mode_;
+    MemoryMode memory_mode_;           // 实际使用的模式（开始采集后确定）
+    int buffer_count_;                 // 请求的驱动 buffer 数量
+    std::shared_ptr<MmapState> mmap_state_;
+    std::vector<Buffer*> dmabuf_slots_;        // V4L2 index → 当前排队的 BufferPool buffer（nullptr = 空槽）
+    bool streaming_;
+
+    // ============ 采集线程 ============
+    std::thread capture_thread_;
+    std::atomic<bool> running_;
+
+    // ============ 零拷贝模式 ============
+    BufferPool* buffer_pool_;
+    bool pool_is_dynamic_;             // 动态注入模式的 pool（MMAP 注入），否则预分配
+    int observer_id_;                  // BufferPool 帧观察者（延迟统计）
+
+    // ============ 推送源事件 ============
+    SourceEventCallback event_callback_;
+    std::mutex event_mutex_;
+
+    // ============ 延迟统计 ============
+    std::unordered_map<const Buffer*, int64_t> capture_times_;   // buffer → 驱动时间戳（微秒）
+    mutable std::mutex latency_mutex_;
+    int64_t display_latency_sum_us_;
+    int64_t display_latency_min_us_;
+    int64_t display_latency_max_us_;
+    int display_samples_;
+    std::atomic<long long> dequeue_latency_sum_us_;
+
+    // ============ 统计信息 ============
+    std::atomic<int> captured_frames_;
+    std::atomic<int> dropped_frames_;
+    std::atomic<int> sequence_gaps_;
+    uint32_t last_sequence_;
+    bool has_sequence_;
+    int current_frame_index_;
+
+    // ============ 状态 ============
+    bool is_open_;
+
+    // ============ 错误处理 ============
+    std::string last_error_;
+    mutable std::mutex error_mutex_;
+
+    // ============ 内部辅助方法 ============
+
+    /**
+     * 查询能力并协商格式（S_FMT）
+     */
+    bool configureDevice(int width, int height, int bits_per_pixel);
+
+    /**
+     * 申请 buffer、排队并 STREAMON（按 memory_mode_）
+     */
+    bool startStreaming();
+    bool setupMmapBuffers();
+    bool setupDmabufBuffers();
+    void stopStreaming();
+
+    /**
+     * 把 BufferPool 的空闲 buffer 以 DMA-BUF 方式排入 V4L2 槽位
+     */
+    bool queueDmabufSlot(int index, Buffer* buffer);
+
+    /**
+     * 为空槽补充空闲 buffer（消费者释放后）
+     */
+    void refillDmabufSlots(int timeout_ms);
+
+    /**
+     * 等待并取出一帧（poll + DQBUF）
+     * @return 1 成功，0 超时，-1 错误
+     */
+    int dequeueBuffer(struct v4l2_buffer* buf, int timeout_ms);
+
+    void captureThreadFunc();
+    void handleMmapFrame(const struct v4l2_buffer& buf);
+    void handleDmabufFrame(const struct v4l2_buffer& buf);
+
+    /**
+     * 记录驱动延迟和序号，返回帧的采集时间（CLOCK_MONOTONIC 微秒）
+     */
+    int64_t recordCapture(const struct v4l2_buffer& buf);
+
+    /**
+     * BufferPool 帧观察者：消费者释放（已显示）时计算采集到显示延迟
+     */
+    void onBufferReleased(const Buffer* buffer);
+
+    void emitSourceEvent(SourceEvent event);
+    void setError(const std::string& error);
+
+public:
+    // ============ 构造/析构 ============
+
+    V4l2CaptureReader();
+    virtual ~V4l2CaptureReader();
+
+    // 禁止拷贝
+    V4l2CaptureReader(const V4l2CaptureReader&) = delete;
+    V4l2CaptureReader& operator=(const V4l2CaptureReader&) = delete;
+
+    // ============ IVideoReader 接口实现 ============
+
+    /**
+     * 打开设备，使用当前分辨率，32bpp
+     */
+    bool open(const char* path) override;
+
+    /**
+     * 打开设备并协商分辨率/位深（驱动可能调整分辨率，以 getWidth/getHeight 为准）
+     */
+    bool openRaw(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+
+    bool requiresExternalBuffer() const override {
+        return false;  // 采集线程自行提交/注入
+    }
+
+    bool readFrameTo(Buffer& dest_buffer) override;
+    bool readFrameTo(void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAt(int frame_index, Buffer& dest_buffer) override;
+    bool readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) override;
+    bool readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const override;
+
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+
+    const char* getReaderType() const override;
+
+    // ============ 零拷贝 / 推送源 ============
+
+    /**
+     * 设置 BufferPool 并开始采集（推送模式）
+     * - 预分配的 CMA pool：DMABUF 导入
+     * - 动态注入 pool：MMAP 注入
+     */
+    void setBufferPool(void* pool) override;
+
+    bool isPushSource() const override {
+        return buffer_pool_ != nullptr;
+    }
+
+    void setSourceEventCallback(SourceEventCallback callback) override;
+
+    // ============ V4L2 特有接口 ============
+
+    /**
+     * 设置内存类型（开始采集前调用，默认 AUTO）
+     */
+    void setMemoryMode(MemoryMode mode);
+
+    /**
+     * 设置驱动 buffer 数量（开始采集前调用，默认 4）
+     */
+    void setBufferCount(int count);
+
+    MemoryMode getMemoryMode() const { return memory_mode_; }
+    CaptureStats getCaptureStats() const;
+    std::string getLastError() const;
+    void printStats() const;
+
+    static const char* memoryModeToString(MemoryMode mode);
+};
+
+#endif // V4L2_CAPTURE_READER_HPP
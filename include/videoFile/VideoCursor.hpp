@@ -0,0 +1,119 @@
+#ifndef VIDEO_CURSOR_HPP
+#define VIDEO_CURSOR_HPP
+
+#include "../buffer/Buffer.hpp"
+#include <stddef.h>
+#include <memory>
+
+class VideoFile;
+
+/**
+ * VideoCursor - 同一个已打开 VideoFile 上的独立读取游标
+ *
+ * VideoFile 自身只有一个读取位置（current_frame_index_），多个消费者（显示、缩略图、
+ * 校验……）同时顺序读取同一文件时只能各自重新打开，或都挤在 readFrameAtThreadSafe 上
+ * 自己维护帧号。游标把"位置 + 预读状态"从 Reader 中拆出来：
+ *
+ * - 共享：fd、mmap 映射（含滑动窗口）、帧索引（raw 文件按帧号定位）
+ * - 独立：读取位置、顺序读取检测、预读进度
+ *
+ * 读取全部走 readFrameAtThreadSafe()，不修改 VideoFile 的状态；
+ * 每个游标本身不是线程安全的（一个消费者线程一个游标），不同游标可并发读取。
+ *
+ * 预读：连续两次顺序读取后，游标对接下来的 readahead 帧发出 readaheadHint()
+ * （posix_fadvise WILLNEED）；已提示的范围消耗过半时再推进，随机访问时重置。
+ *
+ * 仅 supportsCursors() 的 Reader（MMAP / IOURING）可创建游标：其他 Reader（如 FFmpeg）
+ * 不支持并发的按帧号读取，在其上构造的游标无效（isValid() 为 false，所有读取失败）。
+ *
+ * 使用方式：
+ * ```cpp
+ * auto video = std::make_shared<VideoFile>(VideoReaderFactory::ReaderType::MMAP);
+ * video->open("video.raw", 1920, 1080, 32);
+ *
+ * VideoCursor display(video);              // 持有 VideoFile
+ * VideoCursor thumbnails(video);
+ * thumbnails.setReadahead(0);              // 跳跃读取，不预读
+ *
+ * display.readFrameTo(buffer);             // 各自前进，互不影响
+ * thumbnails.readFrameAt(300, thumb_buffer);
+ *
+ * auto verifier = display.clone();         // 从 display 当前位置开始
+ * ```
+ */
+class VideoCursor {
+public:
+    static constexpr int kDefaultReadaheadFrames = 4;
+
+    /**
+     * 创建游标并持有 VideoFile（游标存活期间文件不会被释放）
+     * @param start_frame 初始位置
+     * @note 文件未打开或 Reader 不支持游标时游标无效（isValid() 为 false）
+     */
+    explicit VideoCursor(std::shared_ptr<const VideoFile> file, int start_frame = 0);
+
+    /**
+     * 游标是否可用（文件已打开且 Reader 支持游标）
+     */
+    bool isValid() const { return file_ != nullptr; }
+
+    /**
+     * 从当前位置复制出一个新游标（共享文件，预读状态重新开始）
+     */
+    std::unique_ptr<VideoCursor> clone() const;
+
+    // ============ 读取操作 ============
+
+    bool readFrameTo(Buffer& dest_buffer);
+    bool readFrameTo(void* dest_buffer, size_t buffer_size);
+    bool readFrameAt(int frame_index, Buffer& dest_buffer);
+    bool readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size);
+
+    // ============ 导航操作 ============
+
+    bool seek(int frame_index);
+    bool seekToBegin();
+    bool seekToEnd();
+    bool skip(int frame_count);
+
+    // ============ 信息查询 ============
+
+    int getCurrentFrameIndex() const { return position_; }
+    int getTotalFrames() const;
+    size_t getFrameSize() const;
+    bool hasMoreFrames() const;
+    bool isAtEnd() const;
+    const VideoFile* getFile() const { return file_; }
+
+    // ============ 预读 ============
+
+    /**
+     * 设置预读帧数（0 = 关闭）
+     */
+    void setReadahead(int frames);
+    int getReadahead() const { return readahead_frames_; }
+
+private:
+    friend class VideoFile;
+
+    /**
+     * 创建不持有 VideoFile 的游标（VideoFile::createCursor / clone 使用，调用方保证文件比游标活得久）
+     */
+    VideoCursor(const VideoFile* file, int start_frame);
+
+    /**
+     * 按本次读取的帧号更新顺序检测，需要时发出预读提示
+     */
+    void updateReadahead(int frame_index);
+
+    std::shared_ptr<const VideoFile> owner_;   // 可为空（不持有）
+    const VideoFile* file_;                    // 无效游标为 nullptr
+
+    int position_;                             // 下一次顺序读取的帧
+    int readahead_frames_;
+    int last_index_;                           // 上一次读取的帧（-1 = 尚未读取）
+    int sequential_run_;                       // 连续顺序读取次数
+    int readahead_end_;                        // 已提示预读到的帧（不含）
+};
+
+#endif // VIDEO_CURSOR_HPP
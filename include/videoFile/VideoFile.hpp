@@ -3,6 +3,7 @@
 
 #include "IVideoReader.hpp"
 #include "VideoReaderFactory.hpp"
+#include "VideoCursor.hpp"
 #include "../buffer/Buffer.hpp"
 #include <memory>
 #include <stddef.h>
@@ -178,6 +179,53 @@ public:
      * @param pool BufferPool指针
      */
     void setBufferPool(void* pool);
+    
+    // ============ 推送源接口（透传到 Reader）============
+    
+    /**
+     * 查询 Reader 是否为推送源（内部线程注入帧，需事件驱动消费）
+     */
+    bool isPushSource() const;
+    
+    /**
+     * 设置推送源事件回调（透传到底层Reader）
+     */
+    void setSourceEventCallback(IVideoReader::SourceEventCallback callback);
+    
+    // ============ 打开延迟配置（透传到 Reader）============
+    
+    /**
+     * 设置探测预算 / 调用方提供的编码参数（需在 open 之前调用）
+     */
+    void setProbeConfig(const StreamProbeConfig& config);
+    
+    /**
+     * 指定解码输出的像素格式和尺寸（透传到 Reader，仅编码视频 Reader 支持）
+     */
+    bool setOutputFormat(PixelFormat format, int width, int height);
+    
+    // ============ 游标（多消费者共享）============
+    
+    /**
+     * 查询当前 Reader 是否支持独立游标（MMAP / IOURING）
+     */
+    bool supportsCursors() const;
+    
+    /**
+     * 创建一个独立游标（共享 fd / 映射，位置与预读状态独立）
+     * 
+     * @param start_frame 初始位置
+     * @return Reader 不支持游标或文件未打开时返回 nullptr
+     * 
+     * @note 返回的游标不持有 VideoFile，调用方需保证 VideoFile 比游标活得久；
+     *       VideoFile 由 shared_ptr 管理时可直接构造 VideoCursor(shared_ptr) 持有它
+     */
+    std::unique_ptr<VideoCursor> createCursor(int start_frame = 0) const;
+    
+    /**
+     * 预读提示（透传到底层Reader，供 VideoCursor 使用）
+     */
+    void readaheadHint(int frame_index, int frame_count) const;
 };
 
 #endif // VIDEOFILE_HPP
@@ -30,7 +30,10 @@ public:
         IOURING,       // 强制使用 io_uring 实现
         DIRECT_READ,   // 强制使用普通 read 实现（暂未实现）
         RTSP,          // RTSP 视频流解码器
-        FFMPEG         // FFmpeg 编码视频文件解码器
+        FFMPEG,        // FFmpeg 编码视频文件解码器
+        RTP,           // RTP/UDP 直收 H.264/H.265 解码器
+        IMAGE_SEQUENCE,// 编号图片序列（PNG/JPEG/BMP，并行解码）
+        V4L2           // V4L2 摄像头采集（MMAP / DMABUF 导入）
     };
     
     /**
@@ -1,5 +1,26 @@
 #include "../../include/buffer/Buffer.hpp"
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#if __has_include(<linux/dma-buf.h>)
+#include <linux/dma-buf.h>
+#endif
+#endif
+
+#ifndef DMA_BUF_IOCTL_SYNC
+struct dma_buf_sync {
+    unsigned long long flags;
+};
+#define DMA_BUF_SYNC_READ      (1 << 0)
+#define DMA_BUF_SYNC_WRITE     (2 << 0)
+#define DMA_BUF_SYNC_START     (0 << 2)
+#define DMA_BUF_SYNC_END       (1 << 2)
+#define DMA_BUF_BASE           'b'
+#define DMA_BUF_IOCTL_SYNC     _IOW(DMA_BUF_BASE, 0, struct dma_buf_sync)
+#endif
 
 // ========== 构造函数 ==========
 
@@ -121,3 +142,45 @@ const char* Buffer::ownershipToString(Ownership ownership) {
     }
 }
 
+// ========== CPU 缓存同步 ==========
+
+static bool syncDmaBuf(int fd, Buffer::CpuAccess access, unsigned long long phase) {
+#ifdef __linux__
+    if (fd < 0 || access == Buffer::CpuAccess::NONE) {
+        return true;
+    }
+    
+    struct dma_buf_sync sync;
+    sync.flags = phase;
+    if (static_cast<int>(access) & static_cast<int>(Buffer::CpuAccess::READ)) {
+        sync.flags |= DMA_BUF_SYNC_READ;
+    }
+    if (static_cast<int>(access) & static_cast<int>(Buffer::CpuAccess::WRITE)) {
+        sync.flags |= DMA_BUF_SYNC_WRITE;
+    }
+    
+    int ret;
+    do {
+        ret = ioctl(fd, DMA_BUF_IOCTL_SYNC, &sync);
+    } while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+    
+    if (ret < 0) {
+        printf("⚠️  Warning: DMA_BUF_IOCTL_SYNC failed on fd=%d: %s\n", fd, strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)access;
+    (void)phase;
+    return true;
+#endif
+}
+
+bool Buffer::beginCpuAccess(CpuAccess access) const {
+    return syncDmaBuf(dma_fd_, access, DMA_BUF_SYNC_START);
+}
+
+bool Buffer::endCpuAccess(CpuAccess access) const {
+    return syncDmaBuf(dma_fd_, access, DMA_BUF_SYNC_END);
+}
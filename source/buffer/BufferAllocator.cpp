@@ -33,6 +33,30 @@ struct dma_heap_allocation_data {
 #define DMA_HEAP_IOCTL_ALLOC _IOWR('H', 0x0, struct dma_heap_allocation_data)
 #endif
 
+#if __has_include(<linux/udmabuf.h>)
+#include <linux/udmabuf.h>
+#else
+struct udmabuf_create {
+    uint32_t memfd;
+    uint32_t flags;
+    uint64_t offset;
+    uint64_t size;
+};
+#define UDMABUF_FLAGS_CLOEXEC 0x01
+#define UDMABUF_CREATE _IOW('u', 0x42, struct udmabuf_create)
+#endif
+
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_SEAL_SHRINK 0x0002
+#endif
+
 #endif  // __linux__
 
 // ============================================================
@@ -118,10 +142,24 @@ uint64_t NormalAllocator::getPhysicalAddress(void* virt_addr) {
 // CMAAllocator 实现
 // ============================================================
 
-CMAAllocator::CMAAllocator() {
+const char* DmaHeapOptions::kindToString(Kind kind) {
+    switch (kind) {
+        case Kind::AUTO:   return "auto";
+        case Kind::CMA:    return "cma";
+        case Kind::SYSTEM: return "system";
+        default:           return "unknown";
+    }
+}
+
+CMAAllocator::CMAAllocator(const DmaHeapOptions& options)
+    : options_(options)
+    , heap_fd_(-1)
+    , heap_cached_(options.cached)
+{
     // 构造时可以检测系统是否支持 DMA-BUF
 #ifdef __linux__
-    printf("🔧 Initializing CMAAllocator...\n");
+    printf("🔧 Initializing CMAAllocator (heap=%s, %s)...\n",
+           DmaHeapOptions::kindToString(options_.kind), options_.cached ? "cached" : "uncached");
 #if HAS_DMA_HEAP
     printf("   DMA-BUF heap support: ✅ Available\n");
 #else
@@ -143,6 +181,11 @@ CMAAllocator::~CMAAllocator() {
         }
     }
     dma_buffers_.clear();
+    
+    if (heap_fd_ >= 0) {
+        close(heap_fd_);
+        heap_fd_ = -1;
+    }
 }
 
 void* CMAAllocator::allocate(size_t size, uint64_t* out_phys_addr) {
@@ -211,33 +254,65 @@ int CMAAllocator::getDmaBufFd(void* ptr) const {
     return -1;
 }
 
-void* CMAAllocator::allocateDmaBuf(size_t size, int* out_fd, uint64_t* out_phys_addr) {
+std::vector<const char*> CMAAllocator::heapCandidates(const DmaHeapOptions& options) {
+    using Kind = DmaHeapOptions::Kind;
+    switch (options.kind) {
+        case Kind::CMA:
+            if (options.cached) {
+                return { "/dev/dma_heap/linux,cma", "/dev/dma_heap/reserved" };
+            }
+            return { "/dev/dma_heap/linux,cma-uncached" };
+        case Kind::SYSTEM:
+            if (options.cached) {
+                return { "/dev/dma_heap/system" };
+            }
+            return { "/dev/dma_heap/system-uncached" };
+        case Kind::AUTO:
+        default:
+            return {
+                "/dev/dma_heap/linux,cma",   // CMA heap
+                "/dev/dma_heap/system",      // System heap
+                "/dev/ion",                  // 旧版 ION（Android）
+            };
+    }
+}
+
+bool CMAAllocator::openHeap() {
 #ifdef __linux__
-    // 尝试打开 DMA heap 设备
-    const char* heap_paths[] = {
-        "/dev/dma_heap/linux,cma",   // CMA heap
-        "/dev/dma_heap/system",      // System heap
-        "/dev/ion",                  // 旧版 ION（Android）
-    };
-    
-    int heap_fd = -1;
-    const char* used_path = nullptr;
+    if (heap_fd_ >= 0) {
+        return true;
+    }
     
+    std::vector<const char*> heap_paths = heapCandidates(options_);
     for (const char* path : heap_paths) {
-        heap_fd = open(path, O_RDWR);
-        if (heap_fd >= 0) {
-            used_path = path;
+        heap_fd_ = open(path, O_RDWR | O_CLOEXEC);
+        if (heap_fd_ >= 0) {
+            heap_path_ = path;
             break;
         }
     }
     
-    if (heap_fd < 0) {
-        printf("❌ Failed to open DMA heap device (tried %zu paths)\n", 
-               sizeof(heap_paths) / sizeof(heap_paths[0]));
-        return nullptr;
+    if (heap_fd_ < 0) {
+        printf("❌ Failed to open DMA heap device (tried %zu paths, heap=%s %s)\n",
+               heap_paths.size(), DmaHeapOptions::kindToString(options_.kind),
+               options_.cached ? "cached" : "uncached");
+        return false;
     }
     
-    printf("   📂 Opened DMA heap: %s\n", used_path);
+    // 只有显式请求的 *-uncached heap 是非缓存映射
+    heap_cached_ = heap_path_.find("uncached") == std::string::npos;
+    printf("   📂 Opened DMA heap: %s (%s)\n", heap_path_.c_str(), heap_cached_ ? "cached" : "uncached");
+    return true;
+#else
+    return false;
+#endif
+}
+
+void* CMAAllocator::allocateDmaBuf(size_t size, int* out_fd, uint64_t* out_phys_addr) {
+#ifdef __linux__
+    if (!openHeap()) {
+        return nullptr;
+    }
     
     // 分配 DMA buffer
     struct dma_heap_allocation_data heap_data;
@@ -246,14 +321,12 @@ void* CMAAllocator::allocateDmaBuf(size_t size, int* out_fd, uint64_t* out_phys_
     heap_data.fd_flags = O_RDWR | O_CLOEXEC;
     heap_data.heap_flags = 0;
     
-    if (ioctl(heap_fd, DMA_HEAP_IOCTL_ALLOC, &heap_data) < 0) {
-        printf("❌ DMA_HEAP_IOCTL_ALLOC failed: %s\n", strerror(errno));
-        close(heap_fd);
+    if (ioctl(heap_fd_, DMA_HEAP_IOCTL_ALLOC, &heap_data) < 0) {
+        printf("❌ DMA_HEAP_IOCTL_ALLOC failed on %s: %s\n", heap_path_.c_str(), strerror(errno));
         return nullptr;
     }
     
     *out_fd = heap_data.fd;
-    close(heap_fd);  // heap_fd 可以关闭，DMA buffer fd 保持打开
     
     // mmap DMA buffer 到用户空间
     void* virt_addr = mmap(NULL, size, PROT_READ | PROT_WRITE, 
@@ -289,6 +362,207 @@ uint64_t CMAAllocator::getPhysicalAddress(void* virt_addr) {
     return normal.getPhysicalAddress(virt_addr);
 }
 
+// ============================================================
+// UdmabufAllocator 实现
+// ============================================================
+
+namespace {
+
+const char* const kUdmabufDevice = "/dev/udmabuf";
+const size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t roundUp(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+}  // namespace
+
+UdmabufAllocator::UdmabufAllocator(bool use_hugetlb)
+    : use_hugetlb_(use_hugetlb)
+    , dev_fd_(-1)
+{
+#ifdef __linux__
+    printf("🔧 Initializing UdmabufAllocator (%s)...\n", use_hugetlb_ ? "hugetlb" : "4K pages");
+#else
+    printf("⚠️  Warning: UdmabufAllocator not supported on this platform\n");
+#endif
+}
+
+UdmabufAllocator::~UdmabufAllocator() {
+    for (const auto& info : buffers_) {
+        release(info);
+    }
+    buffers_.clear();
+    
+    if (dev_fd_ >= 0) {
+        close(dev_fd_);
+        dev_fd_ = -1;
+    }
+}
+
+bool UdmabufAllocator::isAvailable() {
+#ifdef __linux__
+    int fd = open(kUdmabufDevice, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool UdmabufAllocator::openDevice() {
+#ifdef __linux__
+    if (dev_fd_ >= 0) {
+        return true;
+    }
+    dev_fd_ = open(kUdmabufDevice, O_RDWR | O_CLOEXEC);
+    if (dev_fd_ < 0) {
+        printf("❌ Failed to open %s: %s (modprobe udmabuf?)\n", kUdmabufDevice, strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void* UdmabufAllocator::allocate(size_t size, uint64_t* out_phys_addr) {
+    if (out_phys_addr) {
+        *out_phys_addr = 0;     // 非物理连续，没有单一物理地址
+    }
+#ifdef __linux__
+    if (size == 0 || !openDevice()) {
+        return nullptr;
+    }
+    
+    // 1. memfd（大页优先，失败退回普通页）
+    bool hugetlb = false;
+    size_t map_size = roundUp(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    int memfd = -1;
+    if (use_hugetlb_) {
+        memfd = memfd_create("display-udmabuf", MFD_ALLOW_SEALING | MFD_HUGETLB | MFD_CLOEXEC);
+        if (memfd >= 0) {
+            size_t huge_size = roundUp(size, kHugePageSize);
+            if (ftruncate(memfd, (off_t)huge_size) == 0) {
+                hugetlb = true;
+                map_size = huge_size;
+            } else {
+                close(memfd);
+                memfd = -1;
+            }
+        }
+        if (memfd < 0) {
+            printf("⚠️  Warning: hugetlb memfd unavailable (%s), using 4K pages\n", strerror(errno));
+        }
+    }
+    if (memfd < 0) {
+        memfd = memfd_create("display-udmabuf", MFD_ALLOW_SEALING | MFD_CLOEXEC);
+        if (memfd < 0) {
+            printf("❌ memfd_create failed: %s\n", strerror(errno));
+            return nullptr;
+        }
+        if (ftruncate(memfd, (off_t)map_size) != 0) {
+            printf("❌ ftruncate memfd to %zu failed: %s\n", map_size, strerror(errno));
+            close(memfd);
+            return nullptr;
+        }
+    }
+    
+    // 2. udmabuf 要求 memfd 带 F_SEAL_SHRINK（且不能有 F_SEAL_WRITE）
+    if (fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) != 0) {
+        printf("❌ F_SEAL_SHRINK failed: %s\n", strerror(errno));
+        close(memfd);
+        return nullptr;
+    }
+    
+    // 3. 包装为 DMA-BUF
+    struct udmabuf_create create;
+    memset(&create, 0, sizeof(create));
+    create.memfd = (uint32_t)memfd;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = 0;
+    create.size = map_size;
+    
+    int dmabuf_fd = ioctl(dev_fd_, UDMABUF_CREATE, &create);
+    if (dmabuf_fd < 0) {
+        printf("❌ UDMABUF_CREATE failed (size=%zu%s): %s\n",
+               map_size, hugetlb ? ", hugetlb" : "", strerror(errno));
+        close(memfd);
+        return nullptr;
+    }
+    
+    // 4. CPU 侧映射 memfd（与 DMA-BUF 共享同一组页）
+    void* virt_addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (virt_addr == MAP_FAILED) {
+        printf("❌ mmap memfd failed: %s\n", strerror(errno));
+        close(dmabuf_fd);
+        close(memfd);
+        return nullptr;
+    }
+    
+    buffers_.push_back({virt_addr, memfd, dmabuf_fd, map_size, hugetlb});
+    printf("✅ udmabuf allocated: virt=%p, size=%zu%s, memfd=%d, dmabuf_fd=%d\n",
+           virt_addr, map_size, hugetlb ? " (hugetlb)" : "", memfd, dmabuf_fd);
+    return virt_addr;
+#else
+    (void)size;
+    printf("❌ ERROR: udmabuf allocation not supported on this platform\n");
+    return nullptr;
+#endif
+}
+
+void UdmabufAllocator::deallocate(void* ptr, size_t size) {
+    if (!ptr) return;
+    
+    auto it = std::find_if(buffers_.begin(), buffers_.end(),
+                          [ptr](const UdmaBufferInfo& info) {
+                              return info.virt_addr == ptr;
+                          });
+    
+    if (it != buffers_.end()) {
+        release(*it);
+        buffers_.erase(it);
+        printf("🧹 udmabuf deallocated: %p\n", ptr);
+    } else {
+        munmap(ptr, size);
+        printf("⚠️  Warning: udmabuf %p not found in registry, forced unmap\n", ptr);
+    }
+}
+
+void UdmabufAllocator::release(const UdmaBufferInfo& info) {
+    // DMA-BUF 持有 memfd 页的引用：已导出给设备 / 其他进程的 fd 在这里关闭后仍然有效
+    if (info.virt_addr) {
+        munmap(info.virt_addr, info.size);
+    }
+    if (info.dmabuf_fd >= 0) {
+        close(info.dmabuf_fd);
+    }
+    if (info.memfd >= 0) {
+        close(info.memfd);
+    }
+}
+
+int UdmabufAllocator::getDmaBufFd(void* ptr) const {
+    for (const auto& info : buffers_) {
+        if (info.virt_addr == ptr) {
+            return info.dmabuf_fd;
+        }
+    }
+    return -1;
+}
+
+int UdmabufAllocator::getMemFd(void* ptr) const {
+    for (const auto& info : buffers_) {
+        if (info.virt_addr == ptr) {
+            return info.memfd;
+        }
+    }
+    return -1;
+}
+
 // ============================================================
 // ExternalAllocator 实现
 // ============================================================
@@ -5,6 +5,10 @@
 #include <stdexcept>
 #include <algorithm>
 #include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 // ============================================================
 // 构造函数实现
@@ -18,6 +22,13 @@ BufferPool::BufferPool(int count, size_t size, bool use_cma,
     , buffer_size_(size)
     , max_capacity_(0)
     , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
 {
     printf("\n📦 Initializing BufferPool '%s' (owned buffers)...\n", name_.c_str());
     printf("   Buffer count: %d\n", count);
@@ -35,6 +46,76 @@ BufferPool::BufferPool(int count, size_t size, bool use_cma,
     printf("   Filled buffers: %d\n", getFilledCount());
 }
 
+BufferPool::BufferPool(int count, size_t size, const DmaHeapOptions& heap,
+                       const std::string name, const std::string category)
+    : name_(name)
+    , category_(category)
+    , registry_id_(0)
+    , buffer_size_(size)
+    , max_capacity_(0)
+    , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
+{
+    printf("\n📦 Initializing BufferPool '%s' (owned buffers)...\n", name_.c_str());
+    printf("   Buffer count: %d\n", count);
+    printf("   Buffer size: %zu bytes (%.2f MB)\n", size, size / (1024.0 * 1024.0));
+    printf("   Memory type: DMA-BUF heap (%s, %s)\n",
+           DmaHeapOptions::kindToString(heap.kind), heap.cached ? "cached" : "uncached");
+    
+    initializeOwnedBuffers(count, size, true, heap);
+    
+    // 自动注册到全局注册表
+    registry_id_ = BufferPoolRegistry::getInstance().registerPool(this, name_, category_);
+    
+    printf("✅ BufferPool '%s' initialized successfully\n", name_.c_str());
+    printf("   Total buffers: %d\n", getTotalCount());
+    printf("   Free buffers: %d\n", getFreeCount());
+    printf("   Filled buffers: %d\n", getFilledCount());
+}
+
+BufferPool::BufferPool(int count, size_t size, std::unique_ptr<BufferAllocator> allocator,
+                       const std::string name, const std::string category)
+    : name_(name)
+    , category_(category)
+    , registry_id_(0)
+    , buffer_size_(size)
+    , max_capacity_(0)
+    , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
+{
+    if (!allocator) {
+        throw std::invalid_argument("BufferPool allocator is null");
+    }
+    
+    printf("\n📦 Initializing BufferPool '%s' (owned buffers)...\n", name_.c_str());
+    printf("   Buffer count: %d\n", count);
+    printf("   Buffer size: %zu bytes (%.2f MB)\n", size, size / (1024.0 * 1024.0));
+    printf("   Memory type: %s\n", allocator->name());
+    
+    // 调用方显式指定的分配器失败时不降级
+    allocateOwnedBuffers(count, size, std::move(allocator), false);
+    
+    // 自动注册到全局注册表
+    registry_id_ = BufferPoolRegistry::getInstance().registerPool(this, name_, category_);
+    
+    printf("✅ BufferPool '%s' initialized successfully\n", name_.c_str());
+    printf("   Total buffers: %d\n", getTotalCount());
+    printf("   Free buffers: %d\n", getFreeCount());
+    printf("   Filled buffers: %d\n", getFilledCount());
+}
+
 BufferPool::BufferPool(const std::vector<ExternalBufferInfo>& external_buffers,
                        const std::string name, const std::string category)
     : name_(name)
@@ -43,6 +124,13 @@ BufferPool::BufferPool(const std::vector<ExternalBufferInfo>& external_buffers,
     , buffer_size_(0)
     , max_capacity_(0)
     , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
 {
     printf("\n📦 Initializing BufferPool '%s' (external buffers - simple mode)...\n", name_.c_str());
     printf("   External buffer count: %zu\n", external_buffers.size());
@@ -69,6 +157,13 @@ BufferPool::BufferPool(std::vector<std::unique_ptr<BufferHandle>> handles,
     , buffer_size_(0)
     , max_capacity_(0)
     , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
 {
     printf("\n📦 Initializing BufferPool '%s' (external buffers - lifetime tracking)...\n", name_.c_str());
     printf("   BufferHandle count: %zu\n", handles.size());
@@ -95,6 +190,13 @@ BufferPool::BufferPool(const std::string name, const std::string category, size_
     , buffer_size_(0)
     , max_capacity_(max_capacity)
     , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
 {
     printf("\n📦 Initializing BufferPool '%s' (dynamic injection mode)...\n", name_.c_str());
     printf("   Initial buffer count: 0 (buffers will be injected dynamically)\n");
@@ -115,6 +217,39 @@ BufferPool::BufferPool(const std::string name, const std::string category, size_
     printf("   Note: Buffers will be injected at runtime via injectFilledBuffer()\n");
 }
 
+BufferPool::BufferPool(const std::vector<DmaBufImportInfo>& imports,
+                       const std::string name, const std::string category)
+    : name_(name)
+    , category_(category)
+    , registry_id_(0)
+    , buffer_size_(0)
+    , max_capacity_(0)
+    , next_buffer_id_(0)
+    , next_observer_id_(0)
+    , producer_access_(Buffer::CpuAccess::NONE)
+    , consumer_access_(Buffer::CpuAccess::NONE)
+    , cpu_cached_(false)
+    , sync_calls_(0)
+    , sync_failures_(0)
+    , unmappable_count_(0)
+{
+    printf("\n📦 Initializing BufferPool '%s' (DMA-BUF import)...\n", name_.c_str());
+    printf("   Imported fd count: %zu\n", imports.size());
+    
+    if (imports.empty()) {
+        throw std::invalid_argument("DMA-BUF import array is empty");
+    }
+    
+    initializeDmaBufImports(imports);
+    
+    // 自动注册到全局注册表
+    registry_id_ = BufferPoolRegistry::getInstance().registerPool(this, name_, category_);
+    
+    printf("✅ BufferPool '%s' initialized successfully (DMA-BUF import, lazy mmap)\n", name_.c_str());
+    printf("   Total buffers: %d\n", getTotalCount());
+    printf("   Free buffers: %d\n", getFreeCount());
+}
+
 BufferPool::~BufferPool() {
     printf("\n🧹 Cleaning up BufferPool '%s'...\n", name_.c_str());
     printf("   Total buffers: %d\n", getTotalCount());
@@ -133,6 +268,9 @@ BufferPool::~BufferPool() {
         }
     }
     
+    // 导入的 DMA-BUF：解除懒映射并关闭 dup 的 fd
+    releaseDmaBufImports();
+    
     // 外部 buffer 通过 BufferHandle 自动释放（RAII）
     // external_handles_ 会在析构时自动清理
     
@@ -143,14 +281,20 @@ BufferPool::~BufferPool() {
 // 内部初始化方法
 // ============================================================
 
-void BufferPool::initializeOwnedBuffers(int count, size_t size, bool use_cma) {
+void BufferPool::initializeOwnedBuffers(int count, size_t size, bool use_cma,
+                                        const DmaHeapOptions& heap) {
     // 选择分配器
     if (use_cma) {
-        allocator_ = std::make_unique<CMAAllocator>();
+        allocateOwnedBuffers(count, size, std::make_unique<CMAAllocator>(heap), true);
     } else {
-        allocator_ = std::make_unique<NormalAllocator>();
+        allocateOwnedBuffers(count, size, std::make_unique<NormalAllocator>(), false);
     }
-    
+}
+
+void BufferPool::allocateOwnedBuffers(int count, size_t size,
+                                      std::unique_ptr<BufferAllocator> allocator,
+                                      bool allow_fallback) {
+    allocator_ = std::move(allocator);
     printf("   Selected allocator: %s\n", allocator_->name());
     
     // 预分配容器空间
@@ -165,23 +309,30 @@ void BufferPool::initializeOwnedBuffers(int count, size_t size, bool use_cma) {
         if (virt_addr == nullptr) {
             printf("❌ ERROR: Failed to allocate buffer #%d\n", i);
             
-            // 如果是 CMA 失败，尝试降级到普通内存
-            if (use_cma) {
-                printf("⚠️  Falling back to normal memory...\n");
-                allocator_ = std::make_unique<NormalAllocator>();
-                virt_addr = allocator_->allocate(size, &phys_addr);
+            // DMA-BUF 分配失败：降级（CMA → udmabuf → 普通内存），已分配的 buffer 全部重来，
+            // 保证同一个 pool 内只有一种分配器
+            std::unique_ptr<BufferAllocator> fallback;
+            if (allow_fallback) {
+                fallback = createFallbackAllocator();
             }
-            
-            if (virt_addr == nullptr) {
-                // 清理已分配的资源
+            if (!fallback) {
                 throw std::runtime_error("Buffer allocation failed");
             }
+            
+            printf("⚠️  Falling back to %s...\n", fallback->name());
+            releaseOwnedBuffers();
+            allocator_ = std::move(fallback);
+            i = -1;
+            continue;
         }
         
         // 创建 Buffer 对象
         uint32_t id = next_buffer_id_++;
         buffers_.emplace_back(id, virt_addr, phys_addr, size, Buffer::Ownership::OWNED);
         
+        // DMA-BUF 内存（heap / udmabuf）：记录 fd（CPU 访问同步与导出都需要）
+        buffers_.back().setDmaBufFd(allocator_->getDmaBufFd(virt_addr));
+        
         // 添加到索引
         buffer_map_[id] = &buffers_.back();
         
@@ -190,6 +341,110 @@ void BufferPool::initializeOwnedBuffers(int count, size_t size, bool use_cma) {
         
         printf("   Buffer #%u: virt=%p, phys=0x%016lx\n", id, virt_addr, phys_addr);
     }
+    
+    // 带缓存的 DMA-BUF：生产者 CPU 写入后必须 flush，设备才能看到完整数据
+    cpu_cached_ = allocator_->needsCpuSync();
+    if (cpu_cached_) {
+        producer_access_ = Buffer::CpuAccess::WRITE;
+        CMAAllocator* cma = dynamic_cast<CMAAllocator*>(allocator_.get());
+        printf("   CPU access sync: producer write (%s)\n",
+               cma ? cma->getHeapPath().c_str() : allocator_->name());
+    }
+}
+
+std::unique_ptr<BufferAllocator> BufferPool::createFallbackAllocator() const {
+    // CMA / heap 不可用：优先 udmabuf（仍可导出 DMA-BUF），否则普通内存
+    if (dynamic_cast<CMAAllocator*>(allocator_.get()) && UdmabufAllocator::isAvailable()) {
+        return std::make_unique<UdmabufAllocator>();
+    }
+    if (allocator_->name() != std::string("NormalAllocator")) {
+        return std::make_unique<NormalAllocator>();
+    }
+    return nullptr;
+}
+
+void BufferPool::releaseOwnedBuffers() {
+    for (auto& buffer : buffers_) {
+        allocator_->deallocate(buffer.getVirtualAddress(), buffer.size());
+    }
+    buffers_.clear();
+    buffer_map_.clear();
+    while (!free_queue_.empty()) {
+        free_queue_.pop();
+    }
+    next_buffer_id_ = 0;
+}
+
+void BufferPool::initializeDmaBufImports(const std::vector<DmaBufImportInfo>& imports) {
+    // 不分配也不释放内存，生命周期由 DMA-BUF 引用计数保证
+    allocator_ = std::make_unique<ExternalAllocator>();
+    
+    buffer_size_ = imports[0].size;
+    buffers_.reserve(imports.size());
+    buffer_map_.reserve(imports.size());
+    imports_.reserve(imports.size());
+    
+    for (const auto& info : imports) {
+        if (info.fd < 0 || info.size == 0) {
+            releaseDmaBufImports();
+            throw std::invalid_argument("Invalid DMA-BUF import (fd < 0 or size == 0)");
+        }
+        if (info.size != buffer_size_) {
+            printf("⚠️  Warning: Imported DMA-BUF size mismatch (%zu vs %zu)\n",
+                   info.size, buffer_size_);
+        }
+        
+        // 持有自己的引用：调用方关闭原 fd 后 buffer 仍然有效
+        int fd = fcntl(info.fd, F_DUPFD_CLOEXEC, 0);
+        if (fd < 0) {
+            printf("❌ ERROR: dup DMA-BUF fd=%d failed: %s\n", info.fd, strerror(errno));
+            releaseDmaBufImports();
+            throw std::invalid_argument("Invalid DMA-BUF fd");
+        }
+        
+        ImportedDmaBuf imported;
+        imported.info = info;
+        imported.info.fd = fd;
+        imported.map_base = nullptr;
+        imported.map_length = 0;
+        imported.read_only = (fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDONLY;
+        imports_.push_back(imported);
+        
+        // 虚拟地址留空，首次 CPU 访问时映射
+        uint32_t id = next_buffer_id_++;
+        buffers_.emplace_back(id, nullptr, 0, info.size, Buffer::Ownership::EXTERNAL);
+        buffers_.back().setDmaBufFd(fd);
+        
+        buffer_map_[id] = &buffers_.back();
+        free_queue_.push(&buffers_.back());
+        
+        printf("   Buffer #%u: dma_fd=%d (from %d), size=%zu, offset=%zu, stride=%u%s\n",
+               id, fd, info.fd, info.size, info.offset, info.stride,
+               imported.read_only ? " (read-only)" : "");
+    }
+    
+    // 导出方的缓存属性未知，按带缓存处理（对不带缓存的内存 DMA_BUF_IOCTL_SYNC 只是空操作）
+    cpu_cached_ = true;
+}
+
+void BufferPool::releaseDmaBufImports() {
+    std::lock_guard<std::mutex> lock(import_mutex_);
+    for (size_t i = 0; i < imports_.size(); i++) {
+        ImportedDmaBuf& imported = imports_[i];
+        if (imported.map_base) {
+            munmap(imported.map_base, imported.map_length);
+            imported.map_base = nullptr;
+        }
+        if (imported.info.fd >= 0) {
+            close(imported.info.fd);
+            imported.info.fd = -1;
+        }
+        if (i < buffers_.size()) {
+            buffers_[i].setVirtualAddress(nullptr);
+            buffers_[i].setDmaBufFd(-1);
+        }
+    }
+    imports_.clear();
 }
 
 void BufferPool::initializeExternalBuffers(const std::vector<ExternalBufferInfo>& infos) {
@@ -314,7 +569,7 @@ Buffer* BufferPool::acquireFree(bool blocking, int timeout_ms) {
     free_queue_.pop();
     
     // 校验 buffer 有效性（特别是外部 buffer）
-    if (!validateBuffer(buffer)) {
+    if (!validateBufferLocked(buffer)) {
         printf("❌ ERROR: Acquired invalid buffer #%u\n", buffer->id());
         // 重新放回队列（避免丢失）
         free_queue_.push(buffer);
@@ -324,7 +579,13 @@ Buffer* BufferPool::acquireFree(bool blocking, int timeout_ms) {
     // 更新状态
     buffer->setState(Buffer::State::LOCKED_BY_PRODUCER);
     buffer->addRef();
+    lock.unlock();
     
+    // 生产者无法获得所需映射：移出循环，不交出 buffer（放回队列会被立即再次取到）
+    if (!syncCpuAccess(buffer, producer_access_.load(), true)) {
+        retireUnmappableBuffer(buffer);
+        return nullptr;
+    }
     return buffer;
 }
 
@@ -340,6 +601,9 @@ void BufferPool::submitFilled(Buffer* buffer) {
         return;
     }
     
+    // 生产者写入结束：flush CPU 缓存后再交给消费者 / 设备
+    syncCpuAccess(buffer, producer_access_.load(), false);
+    
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -385,14 +649,20 @@ Buffer* BufferPool::acquireFilled(bool blocking, int timeout_ms) {
     filled_queue_.pop();
     
     // 校验
-    if (!validateBuffer(buffer)) {
+    if (!validateBufferLocked(buffer)) {
         printf("❌ ERROR: Acquired invalid filled buffer #%u\n", buffer->id());
         return nullptr;
     }
     
     // 更新状态
     buffer->setState(Buffer::State::LOCKED_BY_CONSUMER);
+    lock.unlock();
     
+    // 消费者无法获得所需映射：丢弃这一帧，buffer 移出循环
+    if (!syncCpuAccess(buffer, consumer_access_.load(), true)) {
+        retireUnmappableBuffer(buffer);
+        return nullptr;
+    }
     return buffer;
 }
 
@@ -402,6 +672,16 @@ void BufferPool::releaseFilled(Buffer* buffer) {
         return;
     }
     
+    // 扇出：消费者用完的帧先交给旁路观察者（录制、转储、校验）
+    Buffer::State state = buffer->state();
+    if (state == Buffer::State::LOCKED_BY_CONSUMER) {
+        notifyFrameObservers(buffer);
+        syncCpuAccess(buffer, consumer_access_.load(), false);
+    } else if (state == Buffer::State::LOCKED_BY_PRODUCER) {
+        // 生产者失败归还：结束 acquireFree 开始的 CPU 访问
+        syncCpuAccess(buffer, producer_access_.load(), false);
+    }
+    
     // 检查是否是临时注入的buffer
     bool is_transient = false;
     {
@@ -424,16 +704,217 @@ void BufferPool::releaseFilled(Buffer* buffer) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        // 更新状态
         buffer->releaseRef();
-        buffer->setState(Buffer::State::IDLE);
         
-        // 放回空闲队列
-        free_queue_.push(buffer);
+        // 被观察者保留：等最后一个 releaseRetained() 再回收
+        auto it = retained_.find(buffer);
+        if (it != retained_.end()) {
+            if (it->second.holds > 0) {
+                it->second.consumer_released = true;
+                return;
+            }
+            retained_.erase(it);
+        }
         
-        // 通知生产者
-        free_cv_.notify_one();
+        recycleBufferLocked(buffer);
+    }
+    notifyFreeListeners();
+}
+
+void BufferPool::recycleBufferLocked(Buffer* buffer) {
+    // 更新状态
+    buffer->setState(Buffer::State::IDLE);
+    
+    // 放回空闲队列
+    free_queue_.push(buffer);
+    
+    // 通知生产者
+    free_cv_.notify_one();
+}
+
+// ============================================================
+// CPU 缓存同步（DMA-BUF）
+// ============================================================
+
+bool BufferPool::setCpuAccessSync(Buffer::CpuAccess producer, Buffer::CpuAccess consumer) {
+    int write = static_cast<int>(Buffer::CpuAccess::WRITE);
+    bool wants_write = ((static_cast<int>(producer) | static_cast<int>(consumer)) & write) != 0;
+    if (wants_write && !isCpuWritable()) {
+        // 只读 fd 上每次 acquire 都会映射失败：配置时一次性拒绝
+        printf("❌ ERROR: BufferPool '%s' has read-only DMA-BUF imports, CPU write access refused\n",
+               name_.c_str());
+        return false;
+    }
+    producer_access_ = producer;
+    consumer_access_ = consumer;
+    return true;
+}
+
+bool BufferPool::isCpuWritable() const {
+    std::lock_guard<std::mutex> lock(import_mutex_);
+    for (const auto& imported : imports_) {
+        if (imported.read_only) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int BufferPool::getUnmappableCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return unmappable_count_;
+}
+
+void BufferPool::retireUnmappableBuffer(Buffer* buffer) {
+    printf("❌ ERROR: Buffer #%u cannot be mapped for CPU access, removed from circulation\n",
+           buffer->id());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer->refCount() > 0) {
+            buffer->releaseRef();
+        }
+        buffer->setState(Buffer::State::IDLE);
+        unmappable_count_++;
+    }
+}
+
+bool BufferPool::syncCpuAccess(Buffer* buffer, Buffer::CpuAccess access, bool begin) {
+    if (access == Buffer::CpuAccess::NONE || buffer->getDmaBufFd() < 0) {
+        return true;
+    }
+    // 导入的 DMA-BUF：第一次 CPU 访问时才建立映射（写访问还要求映射可写）
+    if (begin && !imports_.empty() && !mapForCpu(buffer, access)) {
+        sync_failures_++;
+        return false;
+    }
+    bool ok = begin ? buffer->beginCpuAccess(access) : buffer->endCpuAccess(access);
+    sync_calls_++;
+    if (!ok) {
+        sync_failures_++;
+    }
+    return true;
+}
+
+// ============================================================
+// 扇出观察者实现
+// ============================================================
+
+int BufferPool::addFrameObserver(FrameObserver observer) {
+    if (!observer) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    int id = next_observer_id_++;
+    frame_observers_.emplace_back(id, std::move(observer));
+    printf("🔀 BufferPool '%s': frame observer #%d attached\n", name_.c_str(), id);
+    return id;
+}
+
+bool BufferPool::removeFrameObserver(int observer_id) {
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    for (auto it = frame_observers_.begin(); it != frame_observers_.end(); ++it) {
+        if (it->first == observer_id) {
+            frame_observers_.erase(it);
+            printf("🔀 BufferPool '%s': frame observer #%d detached\n", name_.c_str(), observer_id);
+            return true;
+        }
+    }
+    return false;
+}
+
+void BufferPool::notifyFrameObservers(const Buffer* buffer) {
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    for (auto& entry : frame_observers_) {
+        entry.second(buffer);
+    }
+}
+
+// ============================================================
+// 空闲监听者实现
+// ============================================================
+
+int BufferPool::addFreeListener(FreeListener listener) {
+    if (!listener) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    int id = next_observer_id_++;
+    free_listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+bool BufferPool::removeFreeListener(int listener_id) {
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    for (auto it = free_listeners_.begin(); it != free_listeners_.end(); ++it) {
+        if (it->first == listener_id) {
+            free_listeners_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void BufferPool::notifyFreeListeners() {
+    std::lock_guard<std::mutex> lock(observer_mutex_);
+    for (auto& entry : free_listeners_) {
+        entry.second();
+    }
+}
+
+bool BufferPool::retainBuffer(const Buffer* buffer) {
+    if (buffer == nullptr) {
+        return false;
+    }
+    
+    // 临时注入的 buffer 在 releaseFilled 中立即销毁，无法保留
+    {
+        std::lock_guard<std::mutex> lock(transient_mutex_);
+        if (transient_handles_.find(const_cast<Buffer*>(buffer)) != transient_handles_.end()) {
+            return false;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!verifyBufferOwnershipLocked(buffer) ||
+        buffer->state() != Buffer::State::LOCKED_BY_CONSUMER) {
+        return false;
+    }
+    
+    RetainInfo& info = retained_[buffer];
+    info.holds++;
+    return true;
+}
+
+void BufferPool::releaseRetained(const Buffer* buffer) {
+    if (buffer == nullptr) {
+        return;
     }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = retained_.find(buffer);
+    if (it == retained_.end() || it->second.holds <= 0) {
+        printf("⚠️  Warning: Buffer #%u is not retained\n", buffer->id());
+        return;
+    }
+    
+    if (--it->second.holds > 0 || !it->second.consumer_released) {
+        return;
+    }
+    
+    // 最后一个保留者，且消费者已归还：回收
+    retained_.erase(it);
+    auto owned = buffer_map_.find(buffer->id());
+    if (owned == buffer_map_.end()) {
+        return;
+    }
+    recycleBufferLocked(owned->second);
+    lock.unlock();
+    notifyFreeListeners();
+}
+
+int BufferPool::getRetainedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(retained_.size());
 }
 
 // ============================================================
@@ -504,6 +985,11 @@ const Buffer* BufferPool::getBufferById(uint32_t id) const {
 // ============================================================
 
 bool BufferPool::validateBuffer(const Buffer* buffer) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return validateBufferLocked(buffer);
+}
+
+bool BufferPool::validateBufferLocked(const Buffer* buffer) const {
     if (!buffer) {
         return false;
     }
@@ -513,8 +999,8 @@ bool BufferPool::validateBuffer(const Buffer* buffer) const {
         return false;
     }
     
-    // 所有权检查
-    if (!verifyBufferOwnership(buffer)) {
+    // 所有权检查（mutex_ 已由调用者持有，不能再次加锁）
+    if (!verifyBufferOwnershipLocked(buffer)) {
         return false;
     }
     
@@ -570,6 +1056,19 @@ void BufferPool::printStats() const {
     }
     printf("   Total ref count: %d\n", total_refs);
     
+    if (!imports_.empty()) {
+        printf("   DMA-BUF imports: %zu (CPU-mapped: %d)\n", imports_.size(), getMappedImportCount());
+    }
+    
+    if (producer_access_.load() != Buffer::CpuAccess::NONE ||
+        consumer_access_.load() != Buffer::CpuAccess::NONE) {
+        printf("   CPU access sync: %llu calls, %llu failed\n",
+               (unsigned long long)sync_calls_.load(), (unsigned long long)sync_failures_.load());
+    }
+    if (getUnmappableCount() > 0) {
+        printf("   Unmappable buffers (removed): %d\n", getUnmappableCount());
+    }
+    
     // 有效性检查
     printf("   All buffers valid: %s\n", validateAllBuffers() ? "✅ Yes" : "❌ No");
 }
@@ -600,30 +1099,102 @@ int BufferPool::exportBufferAsDmaBuf(uint32_t buffer_id) {
         return existing_fd;
     }
     
-    // 只有 CMA buffer 可以导出
-    if (allocator_->name() != std::string("CMAAllocator")) {
-        printf("❌ ERROR: Only CMA buffers can be exported as DMA-BUF\n");
-        return -1;
-    }
-    
-    // 从 CMAAllocator 获取 fd
-    CMAAllocator* cma = dynamic_cast<CMAAllocator*>(allocator_.get());
-    if (!cma) {
-        printf("❌ ERROR: Failed to cast to CMAAllocator\n");
-        return -1;
-    }
-    
-    int fd = cma->getDmaBufFd(buffer->getVirtualAddress());
+    // 只有 DMA-BUF 分配器（CMA / heap、udmabuf）的 buffer 可以导出
+    int fd = allocator_->getDmaBufFd(buffer->getVirtualAddress());
     if (fd >= 0) {
         buffer->setDmaBufFd(fd);
         printf("✅ Buffer #%u exported as DMA-BUF fd=%d\n", buffer_id, fd);
     } else {
-        printf("❌ ERROR: Failed to get DMA-BUF fd for buffer #%u\n", buffer_id);
+        printf("❌ ERROR: Failed to get DMA-BUF fd for buffer #%u (allocator %s)\n",
+               buffer_id, allocator_->name());
     }
     
     return fd;
 }
 
+// ============================================================
+// 高级功能：DMA-BUF 导入
+// ============================================================
+
+void* BufferPool::mapForCpu(Buffer* buffer, Buffer::CpuAccess access) {
+    if (!buffer) {
+        return nullptr;
+    }
+    
+    bool want_write = (static_cast<int>(access) & static_cast<int>(Buffer::CpuAccess::WRITE)) != 0;
+    
+    std::lock_guard<std::mutex> lock(import_mutex_);
+    uint32_t id = buffer->id();
+    bool is_import = id < imports_.size() && &buffers_[id] == buffer;
+    if (!is_import) {
+        return buffer->getVirtualAddress();
+    }
+    
+    ImportedDmaBuf& imported = imports_[id];
+    if (want_write && imported.read_only) {
+        printf("❌ ERROR: Imported DMA-BUF #%u (fd=%d) is read-only, write access refused\n",
+               id, imported.info.fd);
+        return nullptr;
+    }
+    if (imported.map_base) {
+        return buffer->getVirtualAddress();
+    }
+    
+    // mmap 偏移必须页对齐：从所在页开始映射，虚拟地址再加上页内偏移
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t map_offset = imported.info.offset / page * page;
+    size_t delta = imported.info.offset - map_offset;
+    size_t length = delta + imported.info.size;
+    
+    bool read_only = imported.read_only;
+    void* base = mmap(NULL, length, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED,
+                      imported.info.fd, (off_t)map_offset);
+    if (base == MAP_FAILED && errno == EACCES && !read_only) {
+        // fd 可写但导出方拒绝可写映射：记为只读，写访问不能用只读映射代替
+        imported.read_only = true;
+        if (want_write) {
+            printf("❌ ERROR: Imported DMA-BUF #%u (fd=%d) is read-only, write access refused\n",
+                   id, imported.info.fd);
+            return nullptr;
+        }
+        base = mmap(NULL, length, PROT_READ, MAP_SHARED, imported.info.fd, (off_t)map_offset);
+        read_only = true;
+    }
+    if (base == MAP_FAILED) {
+        printf("❌ ERROR: mmap imported DMA-BUF #%u (fd=%d, offset=%zu, size=%zu) failed: %s\n",
+               id, imported.info.fd, imported.info.offset, imported.info.size, strerror(errno));
+        return nullptr;
+    }
+    
+    imported.map_base = base;
+    imported.map_length = length;
+    imported.read_only = read_only;
+    buffer->setVirtualAddress(static_cast<uint8_t*>(base) + delta);
+    return buffer->getVirtualAddress();
+}
+
+bool BufferPool::getImportInfo(uint32_t buffer_id, DmaBufImportInfo* info) const {
+    std::lock_guard<std::mutex> lock(import_mutex_);
+    if (buffer_id >= imports_.size()) {
+        return false;
+    }
+    if (info) {
+        *info = imports_[buffer_id].info;
+    }
+    return true;
+}
+
+int BufferPool::getMappedImportCount() const {
+    std::lock_guard<std::mutex> lock(import_mutex_);
+    int mapped = 0;
+    for (const auto& imported : imports_) {
+        if (imported.map_base) {
+            mapped++;
+        }
+    }
+    return mapped;
+}
+
 // ============================================================
 // 辅助方法
 // ============================================================
@@ -636,6 +1207,13 @@ bool BufferPool::verifyBufferOwnership(const Buffer* buffer) const {
     // 使用 buffer_map_ 进行验证（适用于所有模式：预分配、外部托管、动态注入）
     // 优点：O(1) 查询，统一逻辑，支持所有 BufferPool 构造方式
     std::lock_guard<std::mutex> lock(mutex_);
+    return verifyBufferOwnershipLocked(buffer);
+}
+
+bool BufferPool::verifyBufferOwnershipLocked(const Buffer* buffer) const {
+    if (!buffer) {
+        return false;
+    }
     auto it = buffer_map_.find(buffer->id());
     return (it != buffer_map_.end() && it->second == buffer);
 }
@@ -0,0 +1,821 @@
+#include "../../include/convert/PixelConverter.hpp"
+#include "../../include/convert/PixelKernels.hpp"
+#include "../../include/cpu/CpuFeatures.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// ============ 标量辅助函数 ============
+
+static inline uint8_t clamp255(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static inline uint32_t makeArgb(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// ============ YUV → ARGB 行内核 ============
+
+/**
+ * 将一行 4:2:0 / 4:2:2 平面或半平面 YUV 转换为 ARGB8888
+ * @param u, v 色度指针（第 x 个像素的色度位于 u[(x/2) * uv_step]）
+ * @param uv_step 1 = 平面（I420），2 = 交错（NV12/NV21）
+ *
+ * 定点计算（6 位小数），SIMD 与标量结果逐位一致：
+ *   yt = (Y - y_offset) * y_mul + 32
+ *   R = (yt + E * v_to_r) >> 6
+ *   G = (yt - D * u_to_g - E * v_to_g) >> 6
+ *   B = (yt + D * u_to_b) >> 6
+ */
+static void yuvToArgbRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uv_step,
+                               uint32_t* out, int width,
+                               int y_offset, int y_mul, int v_to_r, int u_to_g, int v_to_g, int u_to_b) {
+    for (int x = 0; x < width; x++) {
+        int c = x / 2 * uv_step;
+        int yt = (y[x] - y_offset) * y_mul + 32;
+        int d = u[c] - 128;
+        int e = v[c] - 128;
+        out[x] = makeArgb(0xFF,
+                          clamp255((yt + e * v_to_r) >> 6),
+                          clamp255((yt - d * u_to_g - e * v_to_g) >> 6),
+                          clamp255((yt + d * u_to_b) >> 6));
+    }
+}
+
+#if defined(__SSE2__)
+static void yuvToArgbRowSimd(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uv_step,
+                             uint32_t* out, int width,
+                             int y_offset, int y_mul, int v_to_r, int u_to_g, int v_to_g, int u_to_b) {
+    int x = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c_yoff = _mm_set1_epi16((short)y_offset);
+    const __m128i c_ymul = _mm_set1_epi16((short)y_mul);
+    const __m128i c_128 = _mm_set1_epi16(128);
+    const __m128i c_round = _mm_set1_epi16(32);
+    const __m128i c_vr = _mm_set1_epi16((short)v_to_r);
+    const __m128i c_ug = _mm_set1_epi16((short)u_to_g);
+    const __m128i c_vg = _mm_set1_epi16((short)v_to_g);
+    const __m128i c_ub = _mm_set1_epi16((short)u_to_b);
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    const uint8_t* uv_base = (u < v) ? u : v;
+    const bool u_first = (u < v);
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i y16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+        __m128i u16, v16;
+        if (uv_step == 1) {
+            uint32_t u4, v4;
+            memcpy(&u4, u + x / 2, 4);
+            memcpy(&v4, v + x / 2, 4);
+            u16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)u4), zero);
+            v16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)v4), zero);
+            u16 = _mm_unpacklo_epi16(u16, u16);   // u0 u0 u1 u1 ...
+            v16 = _mm_unpacklo_epi16(v16, v16);
+        } else {
+            __m128i uv = _mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv_base + x)), zero);
+            __m128i even = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)),
+                                               _MM_SHUFFLE(2, 2, 0, 0));
+            __m128i odd = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)),
+                                              _MM_SHUFFLE(3, 3, 1, 1));
+            u16 = u_first ? even : odd;
+            v16 = u_first ? odd : even;
+        }
+
+        __m128i yt = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y16, c_yoff), c_ymul), c_round);
+        __m128i d = _mm_sub_epi16(u16, c_128);
+        __m128i e = _mm_sub_epi16(v16, c_128);
+
+        __m128i r = _mm_srai_epi16(_mm_adds_epi16(yt, _mm_mullo_epi16(e, c_vr)), 6);
+        __m128i g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(yt, _mm_mullo_epi16(d, c_ug)),
+                                                  _mm_mullo_epi16(e, c_vg)), 6);
+        __m128i b = _mm_srai_epi16(_mm_adds_epi16(yt, _mm_mullo_epi16(d, c_ub)), 6);
+
+        // 饱和打包到 8 位，再交织为 B,G,R,A
+        __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+        __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x + 4), _mm_unpackhi_epi16(bg, ra));
+    }
+
+    // 尾部像素（x 为 8 的倍数，色度偏移落在完整的 2 像素组上）
+    int c = x / 2 * uv_step;
+    yuvToArgbRowScalar(y + x, u + c, v + c, uv_step, out + x, width - x,
+                       y_offset, y_mul, v_to_r, u_to_g, v_to_g, u_to_b);
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+static void yuvToArgbRowSimd(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uv_step,
+                             uint32_t* out, int width,
+                             int y_offset, int y_mul, int v_to_r, int u_to_g, int v_to_g, int u_to_b) {
+    int x = 0;
+    const int16x8_t c_yoff = vdupq_n_s16((int16_t)y_offset);
+    const int16x8_t c_128 = vdupq_n_s16(128);
+    const int16x8_t c_round = vdupq_n_s16(32);
+    const uint8_t* uv_base = (u < v) ? u : v;
+    const bool u_first = (u < v);
+
+    for (; x + 8 <= width; x += 8) {
+        int16x8_t y16 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x)));
+        uint8x8_t u8, v8;
+        if (uv_step == 1) {
+            uint32_t u4, v4;
+            memcpy(&u4, u + x / 2, 4);
+            memcpy(&v4, v + x / 2, 4);
+            uint8x8_t uu = vreinterpret_u8_u32(vdup_n_u32(u4));
+            uint8x8_t vv = vreinterpret_u8_u32(vdup_n_u32(v4));
+            u8 = vzip_u8(uu, uu).val[0];   // u0 u0 u1 u1 ...
+            v8 = vzip_u8(vv, vv).val[0];
+        } else {
+            uint8x8_t uv = vld1_u8(uv_base + x);
+            uint8x8x2_t split = vuzp_u8(uv, uv);      // val[0] = 偶数字节，val[1] = 奇数字节
+            uint8x8_t even = vzip_u8(split.val[0], split.val[0]).val[0];
+            uint8x8_t odd = vzip_u8(split.val[1], split.val[1]).val[0];
+            u8 = u_first ? even : odd;
+            v8 = u_first ? odd : even;
+        }
+
+        int16x8_t yt = vaddq_s16(vmulq_n_s16(vsubq_s16(y16, c_yoff), (int16_t)y_mul), c_round);
+        int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), c_128);
+        int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), c_128);
+
+        uint8x8x4_t bgra;
+        bgra.val[2] = vqshrun_n_s16(vqaddq_s16(yt, vmulq_n_s16(e, (int16_t)v_to_r)), 6);
+        bgra.val[1] = vqshrun_n_s16(vqsubq_s16(vqsubq_s16(yt, vmulq_n_s16(d, (int16_t)u_to_g)),
+                                               vmulq_n_s16(e, (int16_t)v_to_g)), 6);
+        bgra.val[0] = vqshrun_n_s16(vqaddq_s16(yt, vmulq_n_s16(d, (int16_t)u_to_b)), 6);
+        bgra.val[3] = vdup_n_u8(0xFF);
+        vst4_u8(reinterpret_cast<uint8_t*>(out + x), bgra);
+    }
+
+    // 尾部像素（x 为 8 的倍数，色度偏移落在完整的 2 像素组上）
+    int c = x / 2 * uv_step;
+    yuvToArgbRowScalar(y + x, u + c, v + c, uv_step, out + x, width - x,
+                       y_offset, y_mul, v_to_r, u_to_g, v_to_g, u_to_b);
+}
+#endif
+
+// ============ RGB 打包/解包行内核 ============
+
+static void argbToRgb565RowScalar(const uint32_t* in, uint16_t* out, int width) {
+    for (int x = 0; x < width; x++) {
+        uint32_t p = in[x];
+        out[x] = (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+    }
+}
+
+static void bgr24ToArgbRowScalar(const uint8_t* in, uint32_t* out, int width) {
+    for (int x = 0; x < width; x++) {
+        const uint8_t* p = in + x * 3;
+        out[x] = makeArgb(0xFF, p[2], p[1], p[0]);
+    }
+}
+
+static void argbToBgr24RowScalar(const uint32_t* in, uint8_t* out, int width) {
+    for (int x = 0; x < width; x++) {
+        uint32_t p = in[x];
+        uint8_t* q = out + x * 3;
+        q[0] = (uint8_t)p;
+        q[1] = (uint8_t)(p >> 8);
+        q[2] = (uint8_t)(p >> 16);
+    }
+}
+
+#if defined(__SSE2__)
+static void argbToRgb565RowSimd(const uint32_t* in, uint16_t* out, int width) {
+    int x = 0;
+    const __m128i mask_r = _mm_set1_epi32(0xF800);
+    const __m128i mask_g = _mm_set1_epi32(0x07E0);
+    const __m128i mask_b = _mm_set1_epi32(0x001F);
+    for (; x + 8 <= width; x += 8) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x + 4));
+        __m128i v0 = _mm_or_si128(_mm_or_si128(
+                         _mm_and_si128(_mm_srli_epi32(p0, 8), mask_r),
+                         _mm_and_si128(_mm_srli_epi32(p0, 5), mask_g)),
+                         _mm_and_si128(_mm_srli_epi32(p0, 3), mask_b));
+        __m128i v1 = _mm_or_si128(_mm_or_si128(
+                         _mm_and_si128(_mm_srli_epi32(p1, 8), mask_r),
+                         _mm_and_si128(_mm_srli_epi32(p1, 5), mask_g)),
+                         _mm_and_si128(_mm_srli_epi32(p1, 3), mask_b));
+        // packs_epi32 是有符号饱和：先符号扩展低 16 位，保证原样打包
+        v0 = _mm_srai_epi32(_mm_slli_epi32(v0, 16), 16);
+        v1 = _mm_srai_epi32(_mm_slli_epi32(v1, 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_packs_epi32(v0, v1));
+    }
+    argbToRgb565RowScalar(in + x, out + x, width - x);
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+static void argbToRgb565RowSimd(const uint32_t* in, uint16_t* out, int width) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t p = vld4_u8(reinterpret_cast<const uint8_t*>(in + x));
+        uint16x8_t v = vshll_n_u8(p.val[2], 8);              // R → [15:8]
+        v = vsriq_n_u16(v, vshll_n_u8(p.val[1], 8), 5);      // G → [10:3]
+        v = vsriq_n_u16(v, vshll_n_u8(p.val[0], 8), 11);     // B → [4:0]
+        vst1q_u16(out + x, v);
+    }
+    argbToRgb565RowScalar(in + x, out + x, width - x);
+}
+
+static void bgr24ToArgbRowSimd(const uint8_t* in, uint32_t* out, int width) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x3_t bgr = vld3_u8(in + x * 3);
+        uint8x8x4_t bgra;
+        bgra.val[0] = bgr.val[0];
+        bgra.val[1] = bgr.val[1];
+        bgra.val[2] = bgr.val[2];
+        bgra.val[3] = vdup_n_u8(0xFF);
+        vst4_u8(reinterpret_cast<uint8_t*>(out + x), bgra);
+    }
+    bgr24ToArgbRowScalar(in + x * 3, out + x, width - x);
+}
+
+static void argbToBgr24RowSimd(const uint32_t* in, uint8_t* out, int width) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(in + x));
+        uint8x8x3_t bgr;
+        bgr.val[0] = bgra.val[0];
+        bgr.val[1] = bgra.val[1];
+        bgr.val[2] = bgra.val[2];
+        vst3_u8(out + x * 3, bgr);
+    }
+    argbToBgr24RowScalar(in + x, out + x * 3, width - x);
+}
+#endif
+
+// ============ 行内核分发表 ============
+
+namespace {
+
+struct ConvertRowKernels {
+    void (*yuv_to_argb)(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uv_step,
+                        uint32_t* out, int width,
+                        int y_offset, int y_mul, int v_to_r, int u_to_g, int v_to_g, int u_to_b);
+    void (*argb_to_rgb565)(const uint32_t* in, uint16_t* out, int width);
+    void (*bgr24_to_argb)(const uint8_t* in, uint32_t* out, int width);
+    void (*argb_to_bgr24)(const uint32_t* in, uint8_t* out, int width);
+    const char* name;
+};
+
+ConvertRowKernels selectRowKernels() {
+    ConvertRowKernels k = { &yuvToArgbRowScalar, &argbToRgb565RowScalar,
+                            &bgr24ToArgbRowScalar, &argbToBgr24RowScalar, "Scalar" };
+#if defined(__SSE2__)
+    if (CpuFeatures::get().allows(SimdLevel::SSE2)) {
+        k.yuv_to_argb = &yuvToArgbRowSimd;
+        k.argb_to_rgb565 = &argbToRgb565RowSimd;
+        k.name = "SSE2";
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    if (CpuFeatures::get().allows(SimdLevel::NEON)) {
+        k.yuv_to_argb = &yuvToArgbRowSimd;
+        k.argb_to_rgb565 = &argbToRgb565RowSimd;
+        k.bgr24_to_argb = &bgr24ToArgbRowSimd;
+        k.argb_to_bgr24 = &argbToBgr24RowSimd;
+        k.name = "NEON";
+    }
+#endif
+    return k;
+}
+
+const ConvertRowKernels& rowKernels() {
+    static const ConvertRowKernels kernels = selectRowKernels();
+    return kernels;
+}
+
+} // namespace
+
+// ============ 构造函数 ============
+
+PixelConverter::PixelConverter(PixelFormat src_format, PixelFormat dst_format,
+                               int width, int height, ColorSpace color_space)
+    : src_format_(src_format)
+    , dst_format_(dst_format)
+    , width_(width)
+    , height_(height)
+    , color_space_(color_space)
+    , coeffs_(coefficientsFor(color_space))
+    , src_stride_(0)
+    , dst_stride_(0)
+    , supported_(true)
+    , specialized_{nullptr, nullptr}
+    , specialized_name_(nullptr)
+    , use_specialized_(true)
+{
+    if (width <= 0 || height <= 0) {
+        printf("❌ ERROR: PixelConverter invalid size %dx%d\n", width, height);
+        supported_ = false;
+    } else if (src_format == PixelFormat::UNKNOWN || dst_format == PixelFormat::UNKNOWN) {
+        printf("❌ ERROR: PixelConverter unknown pixel format\n");
+        supported_ = false;
+    } else if (isYuv(dst_format)) {
+        printf("❌ ERROR: PixelConverter: YUV destination (%s) is not supported\n",
+               formatName(dst_format));
+        supported_ = false;
+    } else if ((src_format == PixelFormat::RGB444 || dst_format == PixelFormat::RGB444) &&
+               (width % 2) != 0) {
+        // 12bpp 紧凑格式两个像素共用 3 字节，奇数宽度会导致行不按字节对齐
+        printf("❌ ERROR: PixelConverter: RGB444 requires even width (got %d)\n", width);
+        supported_ = false;
+    }
+
+    if (supported_ && src_format != PixelFormat::ARGB8888 && dst_format != PixelFormat::ARGB8888 &&
+        src_format != dst_format) {
+        row_buffer_.resize(width);
+    }
+
+    // 格式对在编译期特化表中时，整行一次完成（无中间行、无逐像素 switch）
+    if (supported_) {
+        specialized_[0] = PixelKernels::find(src_format, dst_format, false);
+        specialized_[1] = PixelKernels::find(src_format, dst_format, true);
+        specialized_name_ = PixelKernels::name(src_format, dst_format);
+    }
+}
+
+// ============ 转换接口 ============
+
+bool PixelConverter::convert(const void* src, size_t src_size, void* dst, size_t dst_size) {
+    if (!supported_ || !src || !dst) {
+        return false;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(src);
+    size_t y_stride = src_stride_ ? src_stride_ : rowBytes(src_format_, width_);
+    int chroma_height = (height_ + 1) / 2;
+
+    const uint8_t* planes[3] = { base, nullptr, nullptr };
+    int strides[3] = { (int)y_stride, 0, 0 };
+    size_t required = y_stride * height_;
+
+    switch (src_format_) {
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+            planes[1] = base + y_stride * height_;
+            strides[1] = (int)y_stride;
+            required += y_stride * chroma_height;
+            break;
+        case PixelFormat::I420: {
+            size_t c_stride = (y_stride + 1) / 2;
+            planes[1] = base + y_stride * height_;
+            planes[2] = planes[1] + c_stride * chroma_height;
+            strides[1] = strides[2] = (int)c_stride;
+            required += c_stride * chroma_height * 2;
+            break;
+        }
+        case PixelFormat::RGB444:
+            // 与 LinuxFramebufferDevice 的 buffer_size 计算一致（总位数 / 8 向上取整）
+            if (!src_stride_) {
+                required = frameSize(src_format_, width_, height_);
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (src_size < required) {
+        printf("❌ ERROR: PixelConverter source too small (%zu < %zu bytes, %s %dx%d)\n",
+               src_size, required, formatName(src_format_), width_, height_);
+        return false;
+    }
+
+    return convertPlanes(planes, strides, dst, dst_size);
+}
+
+bool PixelConverter::convert(const Buffer& src, Buffer& dst) {
+    return convert(src.data(), src.size(), dst.data(), dst.size());
+}
+
+bool PixelConverter::convertPlanes(const uint8_t* const planes[3], const int strides[3],
+                                   void* dst, size_t dst_size) {
+    if (!supported_ || !planes || !planes[0] || !dst) {
+        return false;
+    }
+
+    size_t dst_row_bytes = rowBytes(dst_format_, width_);
+    size_t dst_stride = dst_stride_ ? dst_stride_ : dst_row_bytes;
+    if (dst_size < dst_stride * (height_ - 1) + dst_row_bytes) {
+        printf("❌ ERROR: PixelConverter destination too small (%zu bytes, %s %dx%d)\n",
+               dst_size, formatName(dst_format_), width_, height_);
+        return false;
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(dst);
+
+    if (use_specialized_ && specialized_[0]) {
+        bool aligned = PixelKernels::isAligned(planes[0], (size_t)strides[0]) &&
+                       PixelKernels::isAligned(out, dst_stride);
+        RowKernel kernel = specialized_[aligned ? 1 : 0];
+        for (int row = 0; row < height_; row++) {
+            kernel(planes[0] + (size_t)strides[0] * row, out + dst_stride * row, width_);
+        }
+        return true;
+    }
+
+    for (int row = 0; row < height_; row++) {
+        uint8_t* dst_row = out + dst_stride * row;
+
+        if (src_format_ == dst_format_) {
+            memcpy(dst_row, planes[0] + (size_t)strides[0] * row, dst_row_bytes);
+        } else if (src_format_ == PixelFormat::ARGB8888) {
+            packRow(reinterpret_cast<const uint32_t*>(planes[0] + (size_t)strides[0] * row), dst_row);
+        } else if (dst_format_ == PixelFormat::ARGB8888) {
+            unpackRow(planes, strides, row, reinterpret_cast<uint32_t*>(dst_row));
+        } else {
+            unpackRow(planes, strides, row, row_buffer_.data());
+            packRow(row_buffer_.data(), dst_row);
+        }
+    }
+    return true;
+}
+
+// ============ 行解包：任意格式 → ARGB8888 ============
+
+void PixelConverter::unpackRow(const uint8_t* const planes[3], const int strides[3],
+                               int row, uint32_t* out) {
+    const uint8_t* p = planes[0] + (size_t)strides[0] * row;
+    const int w = width_;
+
+    switch (src_format_) {
+        case PixelFormat::ARGB8888:
+            memcpy(out, p, (size_t)w * 4);
+            break;
+
+        case PixelFormat::XRGB8888: {
+            const uint32_t* in = reinterpret_cast<const uint32_t*>(p);
+            for (int x = 0; x < w; x++) {
+                out[x] = in[x] | 0xFF000000u;
+            }
+            break;
+        }
+
+        case PixelFormat::ABGR8888: {
+            const uint32_t* in = reinterpret_cast<const uint32_t*>(p);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                out[x] = (v & 0xFF00FF00u) | ((v & 0xFF) << 16) | ((v >> 16) & 0xFF);
+            }
+            break;
+        }
+
+        case PixelFormat::BGR24:
+            rowKernels().bgr24_to_argb(p, out, w);
+            break;
+
+        case PixelFormat::RGB24:
+            for (int x = 0; x < w; x++) {
+                out[x] = makeArgb(0xFF, p[x * 3], p[x * 3 + 1], p[x * 3 + 2]);
+            }
+            break;
+
+        case PixelFormat::RGB565:
+        case PixelFormat::BGR565: {
+            const uint16_t* in = reinterpret_cast<const uint16_t*>(p);
+            bool swap = (src_format_ == PixelFormat::BGR565);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                uint32_t hi = (v >> 11) & 0x1F, g = (v >> 5) & 0x3F, lo = v & 0x1F;
+                hi = (hi << 3) | (hi >> 2);     // 位复制扩展，保证 0x1F → 0xFF
+                g = (g << 2) | (g >> 4);
+                lo = (lo << 3) | (lo >> 2);
+                out[x] = swap ? makeArgb(0xFF, lo, g, hi) : makeArgb(0xFF, hi, g, lo);
+            }
+            break;
+        }
+
+        case PixelFormat::ARGB4444: {
+            const uint16_t* in = reinterpret_cast<const uint16_t*>(p);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                out[x] = makeArgb(((v >> 12) & 0xF) * 17, ((v >> 8) & 0xF) * 17,
+                                  ((v >> 4) & 0xF) * 17, (v & 0xF) * 17);
+            }
+            break;
+        }
+
+        case PixelFormat::RGB444:
+            // 每 3 字节两个像素：像素0 = 低 12 位，像素1 = 高 12 位
+            for (int x = 0; x < w; x += 2) {
+                const uint8_t* q = p + (x / 2) * 3;
+                uint32_t v = q[0] | (q[1] << 8) | (q[2] << 16);
+                for (int k = 0; k < 2; k++) {
+                    uint32_t px = (v >> (12 * k)) & 0xFFF;
+                    out[x + k] = makeArgb(0xFF, ((px >> 8) & 0xF) * 17,
+                                          ((px >> 4) & 0xF) * 17, (px & 0xF) * 17);
+                }
+            }
+            break;
+
+        case PixelFormat::NV12:
+        case PixelFormat::NV21: {
+            const uint8_t* uv = planes[1] + (size_t)strides[1] * (row / 2);
+            const uint8_t* u = (src_format_ == PixelFormat::NV12) ? uv : uv + 1;
+            const uint8_t* v = (src_format_ == PixelFormat::NV12) ? uv + 1 : uv;
+            rowKernels().yuv_to_argb(p, u, v, 2, out, w, coeffs_.y_offset, coeffs_.y_mul,
+                                     coeffs_.v_to_r, coeffs_.u_to_g, coeffs_.v_to_g, coeffs_.u_to_b);
+            break;
+        }
+
+        case PixelFormat::I420: {
+            const uint8_t* u = planes[1] + (size_t)strides[1] * (row / 2);
+            const uint8_t* v = planes[2] + (size_t)strides[2] * (row / 2);
+            rowKernels().yuv_to_argb(p, u, v, 1, out, w, coeffs_.y_offset, coeffs_.y_mul,
+                                     coeffs_.v_to_r, coeffs_.u_to_g, coeffs_.v_to_g, coeffs_.u_to_b);
+            break;
+        }
+
+        case PixelFormat::YUYV:
+        case PixelFormat::UYVY: {
+            // 打包 4:2:2：每 4 字节两个像素
+            int y_pos = (src_format_ == PixelFormat::YUYV) ? 0 : 1;
+            int u_pos = (src_format_ == PixelFormat::YUYV) ? 1 : 0;
+            for (int x = 0; x < w; x++) {
+                const uint8_t* q = p + (x / 2) * 4;
+                int yt = (q[y_pos + (x & 1) * 2] - coeffs_.y_offset) * coeffs_.y_mul + 32;
+                int d = q[u_pos] - 128;
+                int e = q[u_pos + 2] - 128;
+                out[x] = makeArgb(0xFF,
+                                  clamp255((yt + e * coeffs_.v_to_r) >> 6),
+                                  clamp255((yt - d * coeffs_.u_to_g - e * coeffs_.v_to_g) >> 6),
+                                  clamp255((yt + d * coeffs_.u_to_b) >> 6));
+            }
+            break;
+        }
+
+        default:
+            memset(out, 0, (size_t)w * 4);
+            break;
+    }
+}
+
+// ============ 行打包：ARGB8888 → RGB 格式 ============
+
+void PixelConverter::packRow(const uint32_t* in, uint8_t* out) {
+    const int w = width_;
+
+    switch (dst_format_) {
+        case PixelFormat::ARGB8888:
+            memcpy(out, in, (size_t)w * 4);
+            break;
+
+        case PixelFormat::XRGB8888: {
+            uint32_t* o = reinterpret_cast<uint32_t*>(out);
+            for (int x = 0; x < w; x++) {
+                o[x] = in[x] | 0xFF000000u;
+            }
+            break;
+        }
+
+        case PixelFormat::ABGR8888: {
+            uint32_t* o = reinterpret_cast<uint32_t*>(out);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                o[x] = (v & 0xFF00FF00u) | ((v & 0xFF) << 16) | ((v >> 16) & 0xFF);
+            }
+            break;
+        }
+
+        case PixelFormat::BGR24:
+            rowKernels().argb_to_bgr24(in, out, w);
+            break;
+
+        case PixelFormat::RGB24:
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                out[x * 3] = (uint8_t)(v >> 16);
+                out[x * 3 + 1] = (uint8_t)(v >> 8);
+                out[x * 3 + 2] = (uint8_t)v;
+            }
+            break;
+
+        case PixelFormat::RGB565:
+            rowKernels().argb_to_rgb565(in, reinterpret_cast<uint16_t*>(out), w);
+            break;
+
+        case PixelFormat::BGR565: {
+            uint16_t* o = reinterpret_cast<uint16_t*>(out);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                o[x] = (uint16_t)(((v << 8) & 0xF800) | ((v >> 5) & 0x07E0) | ((v >> 19) & 0x001F));
+            }
+            break;
+        }
+
+        case PixelFormat::ARGB4444: {
+            uint16_t* o = reinterpret_cast<uint16_t*>(out);
+            for (int x = 0; x < w; x++) {
+                uint32_t v = in[x];
+                o[x] = (uint16_t)(((v >> 16) & 0xF000) | ((v >> 12) & 0x0F00) |
+                                  ((v >> 8) & 0x00F0) | ((v >> 4) & 0x000F));
+            }
+            break;
+        }
+
+        case PixelFormat::RGB444:
+            for (int x = 0; x < w; x += 2) {
+                uint32_t v0 = in[x], v1 = in[x + 1];
+                uint32_t p0 = ((v0 >> 12) & 0xF00) | ((v0 >> 8) & 0x0F0) | ((v0 >> 4) & 0x00F);
+                uint32_t p1 = ((v1 >> 12) & 0xF00) | ((v1 >> 8) & 0x0F0) | ((v1 >> 4) & 0x00F);
+                uint32_t packed = p0 | (p1 << 12);
+                uint8_t* q = out + (x / 2) * 3;
+                q[0] = (uint8_t)packed;
+                q[1] = (uint8_t)(packed >> 8);
+                q[2] = (uint8_t)(packed >> 16);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ============ 格式工具函数 ============
+
+int PixelConverter::bitsPerPixel(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::ARGB8888:
+        case PixelFormat::XRGB8888:
+        case PixelFormat::ABGR8888:
+            return 32;
+        case PixelFormat::BGR24:
+        case PixelFormat::RGB24:
+            return 24;
+        case PixelFormat::RGB565:
+        case PixelFormat::BGR565:
+        case PixelFormat::ARGB4444:
+        case PixelFormat::YUYV:
+        case PixelFormat::UYVY:
+            return 16;
+        case PixelFormat::RGB444:
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+        case PixelFormat::I420:
+            return 12;
+        default:
+            return 0;
+    }
+}
+
+size_t PixelConverter::rowBytes(PixelFormat format, int width) {
+    switch (format) {
+        case PixelFormat::RGB444:
+            return ((size_t)width * 12 + 7) / 8;
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+        case PixelFormat::I420:
+            return (size_t)width;                   // Y 平面
+        case PixelFormat::YUYV:
+        case PixelFormat::UYVY:
+            return (size_t)((width + 1) / 2) * 4;
+        default:
+            return (size_t)width * (bitsPerPixel(format) / 8);
+    }
+}
+
+size_t PixelConverter::frameSize(PixelFormat format, int width, int height) {
+    size_t chroma_w = (size_t)(width + 1) / 2;
+    size_t chroma_h = (size_t)(height + 1) / 2;
+
+    switch (format) {
+        case PixelFormat::RGB444:
+            return ((size_t)width * height * 12 + 7) / 8;
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+            return (size_t)width * height + chroma_w * 2 * chroma_h;
+        case PixelFormat::I420:
+            return (size_t)width * height + chroma_w * chroma_h * 2;
+        default:
+            return rowBytes(format, width) * height;
+    }
+}
+
+bool PixelConverter::isYuv(PixelFormat format) {
+    return format == PixelFormat::NV12 || format == PixelFormat::NV21 ||
+           format == PixelFormat::I420 || format == PixelFormat::YUYV ||
+           format == PixelFormat::UYVY;
+}
+
+const char* PixelConverter::formatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::ARGB8888: return "ARGB8888";
+        case PixelFormat::XRGB8888: return "XRGB8888";
+        case PixelFormat::ABGR8888: return "ABGR8888";
+        case PixelFormat::BGR24:    return "BGR24";
+        case PixelFormat::RGB24:    return "RGB24";
+        case PixelFormat::RGB565:   return "RGB565";
+        case PixelFormat::BGR565:   return "BGR565";
+        case PixelFormat::ARGB4444: return "ARGB4444";
+        case PixelFormat::RGB444:   return "RGB444";
+        case PixelFormat::NV12:     return "NV12";
+        case PixelFormat::NV21:     return "NV21";
+        case PixelFormat::I420:     return "I420";
+        case PixelFormat::YUYV:     return "YUYV";
+        case PixelFormat::UYVY:     return "UYVY";
+        default:                    return "UNKNOWN";
+    }
+}
+
+PixelFormat PixelConverter::formatFromName(const char* name) {
+    if (!name) {
+        return PixelFormat::UNKNOWN;
+    }
+    static const PixelFormat all[] = {
+        PixelFormat::ARGB8888, PixelFormat::XRGB8888, PixelFormat::ABGR8888,
+        PixelFormat::BGR24, PixelFormat::RGB24, PixelFormat::RGB565, PixelFormat::BGR565,
+        PixelFormat::ARGB4444, PixelFormat::RGB444, PixelFormat::NV12, PixelFormat::NV21,
+        PixelFormat::I420, PixelFormat::YUYV, PixelFormat::UYVY
+    };
+    for (PixelFormat f : all) {
+        if (strcasecmp(name, formatName(f)) == 0) {
+            return f;
+        }
+    }
+    return PixelFormat::UNKNOWN;
+}
+
+PixelFormat PixelConverter::fromBitfields(int bits_per_pixel,
+                                          ChannelLayout red, ChannelLayout green,
+                                          ChannelLayout blue, ChannelLayout transp) {
+    switch (bits_per_pixel) {
+        case 32:
+            if (red.offset == 16 && green.offset == 8 && blue.offset == 0) {
+                return transp.length > 0 ? PixelFormat::ARGB8888 : PixelFormat::XRGB8888;
+            }
+            if (red.offset == 0 && green.offset == 8 && blue.offset == 16) {
+                return PixelFormat::ABGR8888;
+            }
+            break;
+
+        case 24:
+            if (red.offset == 16 && blue.offset == 0) {
+                return PixelFormat::BGR24;
+            }
+            if (red.offset == 0 && blue.offset == 16) {
+                return PixelFormat::RGB24;
+            }
+            break;
+
+        case 16:
+            if (red.length == 5 && green.length == 6 && blue.length == 5) {
+                return (red.offset == 11) ? PixelFormat::RGB565 : PixelFormat::BGR565;
+            }
+            if (red.length == 4 && green.length == 4 && blue.length == 4 && red.offset == 8) {
+                return PixelFormat::ARGB4444;
+            }
+            break;
+
+        case 12:
+            if (red.length == 4 && green.length == 4 && blue.length == 4) {
+                return PixelFormat::RGB444;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    PixelFormat guess = fromBitsPerPixel(bits_per_pixel);
+    printf("⚠️  Warning: Unrecognized fb bitfields (bpp=%d, R=%u/%u G=%u/%u B=%u/%u A=%u/%u), assuming %s\n",
+           bits_per_pixel, red.offset, red.length, green.offset, green.length,
+           blue.offset, blue.length, transp.offset, transp.length, formatName(guess));
+    return guess;
+}
+
+PixelFormat PixelConverter::fromBitsPerPixel(int bits_per_pixel) {
+    switch (bits_per_pixel) {
+        case 32: return PixelFormat::ARGB8888;
+        case 24: return PixelFormat::BGR24;
+        case 16: return PixelFormat::RGB565;
+        case 12: return PixelFormat::RGB444;
+        default: return PixelFormat::UNKNOWN;
+    }
+}
+
+const char* PixelConverter::getKernelName() {
+    return rowKernels().name;
+}
+
+PixelConverter::YuvCoefficients PixelConverter::coefficientsFor(ColorSpace color_space) {
+    // 系数 × 64（6 位小数）
+    switch (color_space) {
+        case ColorSpace::BT601_FULL:
+            return YuvCoefficients{0, 64, 90, 22, 46, 113};
+        case ColorSpace::BT709_LIMITED:
+            return YuvCoefficients{16, 74, 115, 14, 34, 135};
+        case ColorSpace::BT709_FULL:
+            return YuvCoefficients{0, 64, 101, 12, 30, 119};
+        case ColorSpace::BT601_LIMITED:
+        default:
+            return YuvCoefficients{16, 74, 102, 25, 52, 129};
+    }
+}
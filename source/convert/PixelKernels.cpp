@@ -0,0 +1,107 @@
+#include "../../include/convert/PixelKernels.hpp"
+
+namespace {
+
+struct KernelEntry {
+    PixelFormat src;
+    PixelFormat dst;
+    const char* name;
+    PixelKernels::RowKernel unaligned;
+    PixelKernels::RowKernel aligned;
+};
+
+#define PIXEL_KERNEL(S, D)                                                  \
+    { PixelFormat::S, PixelFormat::D, #S "→" #D,                            \
+      &PixelRowKernel<PixelFormat::S, PixelFormat::D, false>::run,          \
+      &PixelRowKernel<PixelFormat::S, PixelFormat::D, true>::run }
+
+/**
+ * 实例化的格式对：解码器 / 读取器常见输出（32bpp、24bpp、RGB565）
+ * → framebuffer 常见格式
+ *
+ * 不在表中的组合：
+ * - ARGB8888 → RGB565：PixelConverter 有手写 SSE2 / NEON 行内核；
+ *   有 SIMD 时其余 → RGB565 也走"解包 + SIMD 打包"，比逐像素特化内核快
+ * - BGR24 ↔ ARGB8888（仅 NEON）：PixelConverter 的 vld3/vst4 内核更快
+ */
+#if defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXEL_KERNEL_TO_RGB565(S)
+#else
+#define PIXEL_KERNEL_TO_RGB565(S) PIXEL_KERNEL(S, RGB565),
+#endif
+
+const KernelEntry kKernels[] = {
+    // 32bpp 源
+    PIXEL_KERNEL(ARGB8888, XRGB8888),
+    PIXEL_KERNEL(ARGB8888, ABGR8888),
+#if !(defined(__ARM_NEON) || defined(__ARM_NEON__))
+    PIXEL_KERNEL(ARGB8888, BGR24),
+#endif
+    PIXEL_KERNEL(ARGB8888, RGB24),
+    PIXEL_KERNEL(ARGB8888, BGR565),
+    PIXEL_KERNEL(ARGB8888, ARGB4444),
+    PIXEL_KERNEL(XRGB8888, ARGB8888),
+    PIXEL_KERNEL(XRGB8888, ABGR8888),
+    PIXEL_KERNEL(XRGB8888, BGR24),
+    PIXEL_KERNEL_TO_RGB565(XRGB8888)
+    PIXEL_KERNEL(ABGR8888, ARGB8888),
+    PIXEL_KERNEL(ABGR8888, XRGB8888),
+    PIXEL_KERNEL(ABGR8888, BGR24),
+    PIXEL_KERNEL(ABGR8888, RGB24),
+    PIXEL_KERNEL_TO_RGB565(ABGR8888)
+    PIXEL_KERNEL(ABGR8888, BGR565),
+
+    // 24bpp 源
+#if !(defined(__ARM_NEON) || defined(__ARM_NEON__))
+    PIXEL_KERNEL(BGR24, ARGB8888),
+#endif
+    PIXEL_KERNEL(BGR24, XRGB8888),
+    PIXEL_KERNEL(BGR24, ABGR8888),
+    PIXEL_KERNEL(BGR24, RGB24),
+    PIXEL_KERNEL_TO_RGB565(BGR24)
+    PIXEL_KERNEL(RGB24, ARGB8888),
+    PIXEL_KERNEL(RGB24, XRGB8888),
+    PIXEL_KERNEL(RGB24, BGR24),
+    PIXEL_KERNEL_TO_RGB565(RGB24)
+
+    // 16bpp 源
+    PIXEL_KERNEL(RGB565, ARGB8888),
+    PIXEL_KERNEL(RGB565, XRGB8888),
+    PIXEL_KERNEL(RGB565, ABGR8888),
+    PIXEL_KERNEL(RGB565, BGR24),
+    PIXEL_KERNEL(RGB565, BGR565),
+    PIXEL_KERNEL(BGR565, ARGB8888),
+    PIXEL_KERNEL_TO_RGB565(BGR565)
+    PIXEL_KERNEL(ARGB4444, ARGB8888),
+};
+
+#undef PIXEL_KERNEL_TO_RGB565
+#undef PIXEL_KERNEL
+
+const KernelEntry* findEntry(PixelFormat src, PixelFormat dst) {
+    for (const KernelEntry& entry : kKernels) {
+        if (entry.src == src && entry.dst == dst) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+PixelKernels::RowKernel PixelKernels::find(PixelFormat src, PixelFormat dst, bool aligned) {
+    const KernelEntry* entry = findEntry(src, dst);
+    if (!entry) {
+        return nullptr;
+    }
+    return aligned ? entry->aligned : entry->unaligned;
+}
+
+const char* PixelKernels::name(PixelFormat src, PixelFormat dst) {
+    const KernelEntry* entry = findEntry(src, dst);
+    return entry ? entry->name : nullptr;
+}
+
+int PixelKernels::count() {
+    return static_cast<int>(sizeof(kKernels) / sizeof(kKernels[0]));
+}
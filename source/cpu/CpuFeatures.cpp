@@ -0,0 +1,200 @@
+#include "../../include/cpu/CpuFeatures.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#if defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+bool isArmLevel(SimdLevel level) {
+    return level == SimdLevel::NEON || level == SimdLevel::SVE;
+}
+
+// 同一架构内的能力次序（SCALAR 为 0）
+int rankOf(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return 0;
+        case SimdLevel::SSE2:   return 1;
+        case SimdLevel::SSE42:  return 2;
+        case SimdLevel::AVX2:   return 3;
+        case SimdLevel::AVX512: return 4;
+        case SimdLevel::NEON:   return 1;
+        case SimdLevel::SVE:    return 2;
+    }
+    return 0;
+}
+
+} // namespace
+
+// ============ 单例 ============
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures instance;
+    return instance;
+}
+
+CpuFeatures::CpuFeatures()
+    : detected_(SimdLevel::SCALAR)
+    , level_(SimdLevel::SCALAR)
+{
+    detect();
+    applyOverride();
+}
+
+// ============ 检测 ============
+
+void CpuFeatures::detect() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    flags_.sse2 = __builtin_cpu_supports("sse2");
+    flags_.sse42 = __builtin_cpu_supports("sse4.2");
+    flags_.avx2 = __builtin_cpu_supports("avx2");
+    flags_.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+
+    if (flags_.avx512 && flags_.avx2) {
+        detected_ = SimdLevel::AVX512;
+    } else if (flags_.avx2 && flags_.sse42) {
+        detected_ = SimdLevel::AVX2;
+    } else if (flags_.sse42) {
+        detected_ = SimdLevel::SSE42;
+    } else if (flags_.sse2) {
+        detected_ = SimdLevel::SSE2;
+    }
+#elif defined(__aarch64__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    flags_.neon = (hwcap & HWCAP_ASIMD) != 0;
+    flags_.crc32 = (hwcap & HWCAP_CRC32) != 0;
+#if defined(HWCAP_SVE)
+    flags_.sve = (hwcap & HWCAP_SVE) != 0;
+#endif
+
+    if (flags_.sve && flags_.neon) {
+        detected_ = SimdLevel::SVE;
+    } else if (flags_.neon) {
+        detected_ = SimdLevel::NEON;
+    }
+#elif defined(__arm__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    flags_.neon = (hwcap & HWCAP_NEON) != 0;
+#if defined(HWCAP2_CRC32)
+    flags_.crc32 = (getauxval(AT_HWCAP2) & HWCAP2_CRC32) != 0;
+#endif
+
+    if (flags_.neon) {
+        detected_ = SimdLevel::NEON;
+    }
+#endif
+
+    level_ = detected_;
+}
+
+void CpuFeatures::applyOverride() {
+    const char* env = getenv(kEnvOverride);
+    if (!env || env[0] == '\0') {
+        return;
+    }
+
+    SimdLevel requested;
+    if (!parseLevel(env, &requested)) {
+        printf("⚠️  Warning: Unknown %s=%s, using %s\n", kEnvOverride, env, levelName(detected_));
+        return;
+    }
+
+    if (requested == SimdLevel::SCALAR) {
+        level_ = SimdLevel::SCALAR;
+        return;
+    }
+    if (isArmLevel(requested) != isArmLevel(detected_) || detected_ == SimdLevel::SCALAR) {
+        printf("⚠️  Warning: %s=%s not available on this CPU, using %s\n",
+               kEnvOverride, env, levelName(detected_));
+        return;
+    }
+    if (rankOf(requested) > rankOf(detected_)) {
+        printf("⚠️  Warning: %s=%s exceeds detected %s, clamped\n",
+               kEnvOverride, env, levelName(detected_));
+        return;
+    }
+
+    level_ = requested;
+}
+
+// ============ 查询 ============
+
+bool CpuFeatures::allows(SimdLevel level) const {
+    if (level == SimdLevel::SCALAR) {
+        return true;
+    }
+    if (level_ == SimdLevel::SCALAR || isArmLevel(level) != isArmLevel(level_)) {
+        return false;
+    }
+    return rankOf(level) <= rankOf(level_);
+}
+
+bool CpuFeatures::allowsHardwareCrc() const {
+#if defined(__aarch64__) || defined(__arm__)
+    return flags_.crc32 && allows(SimdLevel::NEON);
+#else
+    return allows(SimdLevel::SSE42);
+#endif
+}
+
+void CpuFeatures::print() const {
+    printf("🖥️  CPU SIMD: %s", levelName(level_));
+    if (isOverridden()) {
+        printf(" (forced by %s, detected %s)", kEnvOverride, levelName(detected_));
+    }
+    printf("\n");
+
+#if defined(__aarch64__) || defined(__arm__)
+    printf("   neon=%d sve=%d crc32=%d\n", flags_.neon, flags_.sve, flags_.crc32);
+#else
+    printf("   sse2=%d sse4.2=%d avx2=%d avx512=%d\n",
+           flags_.sse2, flags_.sse42, flags_.avx2, flags_.avx512);
+#endif
+}
+
+const char* CpuFeatures::levelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "Scalar";
+        case SimdLevel::SSE2:   return "SSE2";
+        case SimdLevel::SSE42:  return "SSE4.2";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::NEON:   return "NEON";
+        case SimdLevel::SVE:    return "SVE";
+    }
+    return "Unknown";
+}
+
+bool CpuFeatures::parseLevel(const char* name, SimdLevel* level) {
+    static const struct {
+        const char* name;
+        SimdLevel level;
+    } kNames[] = {
+        { "scalar", SimdLevel::SCALAR },
+        { "none",   SimdLevel::SCALAR },
+        { "sse2",   SimdLevel::SSE2 },
+        { "sse4.2", SimdLevel::SSE42 },
+        { "sse42",  SimdLevel::SSE42 },
+        { "avx2",   SimdLevel::AVX2 },
+        { "avx512", SimdLevel::AVX512 },
+        { "avx-512", SimdLevel::AVX512 },
+        { "neon",   SimdLevel::NEON },
+        { "sve",    SimdLevel::SVE },
+    };
+
+    if (!name) {
+        return false;
+    }
+    for (const auto& entry : kNames) {
+        if (strcasecmp(name, entry.name) == 0) {
+            *level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
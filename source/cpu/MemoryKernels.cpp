@@ -0,0 +1,207 @@
+#include "../../include/cpu/MemoryKernels.hpp"
+#include "../../include/cpu/CpuFeatures.hpp"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MEMORY_KERNELS_X86 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// ============ 标量 ============
+
+void copyScalar(void* dst, const void* src, size_t size) {
+    memcpy(dst, src, size);
+}
+
+size_t mismatchScalar(const uint8_t* a, const uint8_t* b, size_t size, size_t i) {
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        if (x != y) {
+            break;
+        }
+    }
+    for (; i < size; i++) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t mismatchScalar(const void* a, const void* b, size_t size) {
+    return mismatchScalar(static_cast<const uint8_t*>(a), static_cast<const uint8_t*>(b), size, 0);
+}
+
+// ============ x86 ============
+
+#if defined(MEMORY_KERNELS_X86)
+
+/**
+ * 非临时存储拷贝：先用 memcpy 补齐到目标对齐，主体每次 128 字节，尾部 memcpy
+ */
+__attribute__((target("avx2")))
+void copyStreamAvx2(void* dst, const void* src, size_t size) {
+    if (size < MemoryKernels::kStreamingThreshold) {
+        memcpy(dst, src, size);
+        return;
+    }
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    size_t head = (32 - (reinterpret_cast<uintptr_t>(d) & 31)) & 31;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    size -= head;
+
+    for (; size >= 128; size -= 128, d += 128, s += 128) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64));
+        __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d), v0);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), v1);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), v2);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), v3);
+    }
+    _mm_sfence();
+    memcpy(d, s, size);
+}
+
+__attribute__((target("sse2")))
+void copyStreamSse2(void* dst, const void* src, size_t size) {
+    if (size < MemoryKernels::kStreamingThreshold) {
+        memcpy(dst, src, size);
+        return;
+    }
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    size -= head;
+
+    for (; size >= 64; size -= 64, d += 64, s += 64) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), v3);
+    }
+    _mm_sfence();
+    memcpy(d, s, size);
+}
+
+__attribute__((target("avx2")))
+size_t mismatchAvx2(const void* a, const void* b, size_t size) {
+    const uint8_t* pa = static_cast<const uint8_t*>(a);
+    const uint8_t* pb = static_cast<const uint8_t*>(b);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb + i));
+        uint32_t eq = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (eq != 0xFFFFFFFFu) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    return mismatchScalar(pa, pb, size, i);
+}
+
+__attribute__((target("sse2")))
+size_t mismatchSse2(const void* a, const void* b, size_t size) {
+    const uint8_t* pa = static_cast<const uint8_t*>(a);
+    const uint8_t* pb = static_cast<const uint8_t*>(b);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i));
+        uint32_t eq = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (eq != 0xFFFFu) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    return mismatchScalar(pa, pb, size, i);
+}
+
+#endif // MEMORY_KERNELS_X86
+
+// ============ ARM ============
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+size_t mismatchNeon(const void* a, const void* b, size_t size) {
+    const uint8_t* pa = static_cast<const uint8_t*>(a);
+    const uint8_t* pb = static_cast<const uint8_t*>(b);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(pa + i), vld1q_u8(pb + i));
+        uint64x2_t lanes = vreinterpretq_u64_u8(eq);
+        if ((vgetq_lane_u64(lanes, 0) & vgetq_lane_u64(lanes, 1)) != ~0ULL) {
+            break;      // 块内逐字节定位
+        }
+    }
+    return mismatchScalar(pa, pb, size, i);
+}
+
+#endif
+
+// ============ 分发表 ============
+
+struct MemoryKernelTable {
+    void (*copy)(void* dst, const void* src, size_t size);
+    size_t (*mismatch)(const void* a, const void* b, size_t size);
+    const char* name;
+};
+
+MemoryKernelTable selectKernels() {
+    const CpuFeatures& cpu = CpuFeatures::get();
+#if defined(MEMORY_KERNELS_X86)
+    if (cpu.allows(SimdLevel::AVX2)) {
+        return MemoryKernelTable{ &copyStreamAvx2, &mismatchAvx2, "AVX2" };
+    }
+    if (cpu.allows(SimdLevel::SSE2)) {
+        return MemoryKernelTable{ &copyStreamSse2, &mismatchSse2, "SSE2" };
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // libc memcpy 在 ARM 上已是 NEON 实现，拷贝不再另做分发
+    if (cpu.allows(SimdLevel::NEON)) {
+        return MemoryKernelTable{ &copyScalar, &mismatchNeon, "NEON" };
+    }
+#else
+    (void)cpu;
+#endif
+    return MemoryKernelTable{ &copyScalar, &mismatchScalar, "Scalar" };
+}
+
+const MemoryKernelTable& kernels() {
+    static const MemoryKernelTable table = selectKernels();
+    return table;
+}
+
+} // namespace
+
+void MemoryKernels::copy(void* dst, const void* src, size_t size) {
+    kernels().copy(dst, src, size);
+}
+
+size_t MemoryKernels::mismatch(const void* a, const void* b, size_t size) {
+    return kernels().mismatch(a, b, size);
+}
+
+const char* MemoryKernels::getKernelName() {
+    return kernels().name;
+}
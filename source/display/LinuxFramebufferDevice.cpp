@@ -1,4 +1,5 @@
 #include "../../include/display/LinuxFramebufferDevice.hpp"
+#include "../../include/cpu/MemoryKernels.hpp"
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -41,6 +42,9 @@ LinuxFramebufferDevice::LinuxFramebufferDevice()
     , height_(0)
     , bits_per_pixel_(0)
     , buffer_size_(0)
+    , pixel_format_(PixelFormat::UNKNOWN)
+    , converter_color_space_(ColorSpace::BT601_LIMITED)
+    , frame_verifier_(nullptr)
     , is_initialized_(false)
 {
     // BufferPool 会在 initialize() 中创建
@@ -119,6 +123,7 @@ void LinuxFramebufferDevice::cleanup() {
     
     // 3. 重置 BufferPool
     buffer_pool_.reset();
+    converter_.reset();
     
     // 4. 重置状态
     is_initialized_ = false;
@@ -300,6 +305,14 @@ bool LinuxFramebufferDevice::queryHardwareDisplayParameters() {
     height_ = var_info.yres;
     bits_per_pixel_ = var_info.bits_per_pixel;
     
+    // 根据位域识别像素格式（同为 16bpp 可能是 RGB565 / BGR565 / ARGB4444）
+    pixel_format_ = PixelConverter::fromBitfields(
+        bits_per_pixel_,
+        PixelConverter::ChannelLayout{var_info.red.offset, var_info.red.length},
+        PixelConverter::ChannelLayout{var_info.green.offset, var_info.green.length},
+        PixelConverter::ChannelLayout{var_info.blue.offset, var_info.blue.length},
+        PixelConverter::ChannelLayout{var_info.transp.offset, var_info.transp.length});
+    
     // 计算buffer大小：总位数 / 8 向上取整
     // 对于非整数字节的像素格式（如12bit），这样可以确保分配足够的内存
     size_t total_bits = static_cast<size_t>(width_) * height_ * bits_per_pixel_;
@@ -311,6 +324,12 @@ bool LinuxFramebufferDevice::queryHardwareDisplayParameters() {
     printf("📊 Framebuffer info:\n");
     printf("   xres=%d, yres=%d, bits_per_pixel=%d\n", 
            var_info.xres, var_info.yres, var_info.bits_per_pixel);
+    printf("   pixel_format=%s (R=%u/%u G=%u/%u B=%u/%u A=%u/%u)\n",
+           PixelConverter::formatName(pixel_format_),
+           var_info.red.offset, var_info.red.length,
+           var_info.green.offset, var_info.green.length,
+           var_info.blue.offset, var_info.blue.length,
+           var_info.transp.offset, var_info.transp.length);
     printf("   yres_virtual=%d, buffer_count=%d\n", 
            var_info.yres_virtual, buffer_count);
     
@@ -442,6 +461,10 @@ bool LinuxFramebufferDevice::displayBufferByDMA(Buffer* buffer) {
         return false;
     }
     
+    if (frame_verifier_) {
+        frame_verifier_->verify(VerifyPoint::PRE_DISPLAY, buffer);
+    }
+    
     // 静态计数器，用于日志节流（避免过度打印）
     static int display_count = 0;
     
@@ -521,6 +544,10 @@ bool LinuxFramebufferDevice::displayFilledFramebuffer(Buffer* buffer) {
         return false;
     }
     
+    if (frame_verifier_) {
+        frame_verifier_->verify(VerifyPoint::PRE_DISPLAY, buffer);
+    }
+    
     // 静态计数器，用于日志节流
     static int display_count = 0;
     
@@ -586,10 +613,15 @@ bool LinuxFramebufferDevice::displayBufferByMemcpyToFramebuffer(Buffer* buffer)
     
     size_t copy_size = (buffer->size() < fb_buffer->size()) ? buffer->size() : fb_buffer->size();
     
-    // 执行 memcpy
-    memcpy(fb_buffer->getVirtualAddress(), 
-           buffer->getVirtualAddress(), 
-           copy_size);
+    // 执行拷贝（大帧走非临时存储，不污染缓存）
+    MemoryKernels::copy(fb_buffer->getVirtualAddress(),
+                        buffer->getVirtualAddress(),
+                        copy_size);
+    
+    if (frame_verifier_) {
+        frame_verifier_->verify(VerifyPoint::PRE_DISPLAY, fb_buffer,
+                                frame_verifier_->lookupFrameIndex(buffer));
+    }
     
     // 显示这个 framebuffer buffer
     uint32_t fb_buffer_id = fb_buffer->id();
@@ -629,3 +661,97 @@ bool LinuxFramebufferDevice::displayBufferByMemcpyToFramebuffer(Buffer* buffer)
     return true;
 }
 
+bool LinuxFramebufferDevice::displayBufferByConvertToFramebuffer(Buffer* buffer, PixelFormat src_format,
+                                                                 ColorSpace color_space) {
+    if (!is_initialized_) {
+        printf("❌ ERROR: Device not initialized\n");
+        return false;
+    }
+    
+    if (!buffer) {
+        printf("❌ ERROR: Null buffer pointer\n");
+        return false;
+    }
+    
+    // 格式相同：退化为普通 memcpy 显示
+    if (src_format == pixel_format_) {
+        return displayBufferByMemcpyToFramebuffer(buffer);
+    }
+    
+    // 按需创建转换器（源格式或色彩空间变化时重建）
+    if (!converter_ || converter_->getSourceFormat() != src_format ||
+        converter_->getDestFormat() != pixel_format_ || converter_color_space_ != color_space) {
+        converter_.reset(new PixelConverter(src_format, pixel_format_, width_, height_, color_space));
+        converter_color_space_ = color_space;
+        printf("🎨 Display conversion: %s -> %s (%dx%d, kernel=%s)\n",
+               PixelConverter::formatName(src_format), PixelConverter::formatName(pixel_format_),
+               width_, height_, PixelConverter::getKernelName());
+    }
+    
+    if (!converter_->isSupported()) {
+        printf("❌ ERROR: Unsupported conversion %s -> %s\n",
+               PixelConverter::formatName(src_format), PixelConverter::formatName(pixel_format_));
+        return false;
+    }
+    
+    // 获取一个空闲的 framebuffer buffer 作为转换目标
+    Buffer* fb_buffer = buffer_pool_->acquireFree(false, 0);  // 非阻塞获取
+    if (!fb_buffer) {
+        printf("❌ ERROR: No free framebuffer buffer available\n");
+        return false;
+    }
+    
+    if (!converter_->convert(*buffer, *fb_buffer)) {
+        buffer_pool_->releaseFilled(fb_buffer);  // 归还 buffer
+        return false;
+    }
+    
+    if (frame_verifier_) {
+        int frame_index = frame_verifier_->lookupFrameIndex(buffer);
+        frame_verifier_->verify(VerifyPoint::POST_CONVERT, fb_buffer, frame_index);
+        frame_verifier_->verify(VerifyPoint::PRE_DISPLAY, fb_buffer, frame_index);
+    }
+    
+    uint32_t fb_buffer_id = fb_buffer->id();
+    buffer_pool_->releaseFilled(fb_buffer);
+    
+    return displayBuffer(fb_buffer_id);
+}
+
+bool LinuxFramebufferDevice::displayByWritingToFramebuffer(const FramebufferWriter& writer, int frame_index) {
+    if (!is_initialized_) {
+        printf("❌ ERROR: Device not initialized\n");
+        return false;
+    }
+    
+    if (!writer) {
+        printf("❌ ERROR: Null framebuffer writer\n");
+        return false;
+    }
+    
+    if (!buffer_pool_) {
+        printf("❌ ERROR: BufferPool not initialized\n");
+        return false;
+    }
+    
+    // 获取一个空闲的 framebuffer buffer 作为写入目标（不在扫描输出的后台 buffer）
+    Buffer* fb_buffer = buffer_pool_->acquireFree(false, 0);  // 非阻塞获取
+    if (!fb_buffer) {
+        printf("❌ ERROR: No free framebuffer buffer available\n");
+        return false;
+    }
+    
+    if (!writer(*fb_buffer)) {
+        buffer_pool_->releaseFilled(fb_buffer);  // 归还 buffer
+        return false;
+    }
+    
+    if (frame_verifier_) {
+        frame_verifier_->verify(VerifyPoint::PRE_DISPLAY, fb_buffer, frame_index);
+    }
+    
+    uint32_t fb_buffer_id = fb_buffer->id();
+    buffer_pool_->releaseFilled(fb_buffer);
+    
+    return displayBuffer(fb_buffer_id);
+}
@@ -0,0 +1,134 @@
+#include "../../include/monitor/StartupTimeline.hpp"
+#include <stdio.h>
+#include <algorithm>
+
+// 时间线条形图宽度（字符）
+static const int kBarWidth = 40;
+
+StartupTimeline::StartupTimeline()
+    : origin_(std::chrono::steady_clock::now())
+{
+}
+
+void StartupTimeline::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    origin_ = std::chrono::steady_clock::now();
+    stages_.clear();
+    marks_.clear();
+    threads_.clear();
+}
+
+double StartupTimeline::nowMs() const {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(now - origin_).count();
+}
+
+int StartupTimeline::threadSlotLocked() {
+    std::thread::id self = std::this_thread::get_id();
+    for (size_t i = 0; i < threads_.size(); i++) {
+        if (threads_[i] == self) {
+            return static_cast<int>(i);
+        }
+    }
+    threads_.push_back(self);
+    return static_cast<int>(threads_.size() - 1);
+}
+
+int StartupTimeline::begin(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stage stage;
+    stage.name = name;
+    stage.begin_ms = nowMs();
+    stage.end_ms = -1.0;
+    stage.thread_slot = threadSlotLocked();
+    stage.ok = true;
+    stages_.push_back(stage);
+    return static_cast<int>(stages_.size() - 1);
+}
+
+void StartupTimeline::end(int stage_id, bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stage_id < 0 || stage_id >= static_cast<int>(stages_.size())) {
+        return;
+    }
+    stages_[stage_id].end_ms = nowMs();
+    stages_[stage_id].ok = ok;
+}
+
+void StartupTimeline::mark(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& m : marks_) {
+        if (m.first == name) {
+            return;
+        }
+    }
+    marks_.emplace_back(name, nowMs());
+}
+
+double StartupTimeline::getMarkMs(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& m : marks_) {
+        if (m.first == name) {
+            return m.second;
+        }
+    }
+    return -1.0;
+}
+
+double StartupTimeline::elapsedMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nowMs();
+}
+
+std::vector<StartupTimeline::Stage> StartupTimeline::getStages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_;
+}
+
+void StartupTimeline::print(double target_ms) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 时间轴总长：最后结束的阶段或最后一个事件
+    double total_ms = 0.0;
+    for (const auto& s : stages_) {
+        total_ms = std::max(total_ms, s.end_ms >= 0 ? s.end_ms : nowMs());
+    }
+    for (const auto& m : marks_) {
+        total_ms = std::max(total_ms, m.second);
+    }
+    if (total_ms <= 0.0) {
+        total_ms = 1.0;
+    }
+
+    printf("\n⏱️  Startup timeline (%.1f ms, %zu thread(s)):\n", total_ms, threads_.size());
+    for (const auto& s : stages_) {
+        double end_ms = s.end_ms >= 0 ? s.end_ms : nowMs();
+        int from = static_cast<int>(s.begin_ms / total_ms * kBarWidth);
+        int to = static_cast<int>(end_ms / total_ms * kBarWidth + 0.5);
+        to = std::min(std::max(to, from + 1), kBarWidth);
+        from = std::min(from, to - 1);
+
+        char bar[kBarWidth + 1];
+        for (int i = 0; i < kBarWidth; i++) {
+            bar[i] = (i >= from && i < to) ? '#' : '.';
+        }
+        bar[kBarWidth] = '\0';
+
+        printf("   T%d |%s| %7.1f → %7.1f ms (%6.1f) %s%s\n",
+               s.thread_slot, bar, s.begin_ms, end_ms, end_ms - s.begin_ms,
+               s.name.c_str(), s.ok ? "" : " ❌");
+    }
+    for (const auto& m : marks_) {
+        printf("   ◆ %-30s %7.1f ms\n", m.first.c_str(), m.second);
+    }
+
+    if (target_ms > 0.0 && !marks_.empty()) {
+        double last = marks_.back().second;
+        if (last <= target_ms) {
+            printf("   ✅ %s in %.1f ms (target %.0f ms)\n", marks_.back().first.c_str(), last, target_ms);
+        } else {
+            printf("   ⚠️  %s in %.1f ms exceeds target %.0f ms\n",
+                   marks_.back().first.c_str(), last, target_ms);
+        }
+    }
+}
@@ -0,0 +1,564 @@
+#include "../../include/overlay/OsdOverlay.hpp"
+#include "../../include/cpu/CpuFeatures.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define OSD_OVERLAY_X86 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// 行内两个非透明区间间隔小于该值时合并（减少小 span 的调用开销）
+static const int SPAN_MERGE_GAP = 16;
+
+// ============ SIMD 混合内核（运行时分发） ============
+
+namespace {
+
+#if defined(OSD_OVERLAY_X86)
+/**
+ * SSE2：每次 4 像素，尾部交给标量实现
+ */
+__attribute__((target("sse2")))
+void blendRowSse2(uint32_t* dst, const uint32_t* src, int count) {
+    int i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c128 = _mm_set1_epi16(128);
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+        // 16 位展开，广播每个像素的 alpha（第 3 个 word）
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i inv_lo = _mm_sub_epi16(c255,
+            _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF));
+        __m128i inv_hi = _mm_sub_epi16(c255,
+            _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF));
+
+        // t = d * inv + 128; t / 255 ≈ (t + (t >> 8)) >> 8
+        __m128i t_lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv_lo), c128);
+        __m128i t_hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv_hi), c128);
+        t_lo = _mm_srli_epi16(_mm_add_epi16(t_lo, _mm_srli_epi16(t_lo, 8)), 8);
+        t_hi = _mm_srli_epi16(_mm_add_epi16(t_hi, _mm_srli_epi16(t_hi, 8)), 8);
+
+        __m128i out = _mm_adds_epu8(s, _mm_packus_epi16(t_lo, t_hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+    }
+
+    if (i < count) {
+        OsdOverlay::blendRowScalar(dst + i, src + i, count - i);
+    }
+}
+
+/**
+ * AVX2：每次 8 像素（lane 内展开，算法与 SSE2 相同），余数交给 SSE2
+ */
+__attribute__((target("avx2")))
+void blendRowAvx2(uint32_t* dst, const uint32_t* src, int count) {
+    int i = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c255 = _mm256_set1_epi16(255);
+    const __m256i c128 = _mm256_set1_epi16(128);
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+
+        __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+        __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+        __m256i inv_lo = _mm256_sub_epi16(c255,
+            _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, 0xFF), 0xFF));
+        __m256i inv_hi = _mm256_sub_epi16(c255,
+            _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, 0xFF), 0xFF));
+
+        __m256i t_lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv_lo), c128);
+        __m256i t_hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv_hi), c128);
+        t_lo = _mm256_srli_epi16(_mm256_add_epi16(t_lo, _mm256_srli_epi16(t_lo, 8)), 8);
+        t_hi = _mm256_srli_epi16(_mm256_add_epi16(t_hi, _mm256_srli_epi16(t_hi, 8)), 8);
+
+        __m256i out = _mm256_adds_epu8(s, _mm256_packus_epi16(t_lo, t_hi));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+    }
+
+    if (i < count) {
+        blendRowSse2(dst + i, src + i, count - i);
+    }
+}
+#endif // OSD_OVERLAY_X86
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+void blendRowNeon(uint32_t* dst, const uint32_t* src, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // vld4 按通道解交织：val[0]=B, val[1]=G, val[2]=R, val[3]=A
+        uint8x8x4_t s = vld4_u8(reinterpret_cast<const uint8_t*>(src + i));
+        uint8x8x4_t d = vld4_u8(reinterpret_cast<const uint8_t*>(dst + i));
+        uint8x8_t inv = vmvn_u8(s.val[3]);
+        for (int c = 0; c < 4; c++) {
+            uint16x8_t t = vmull_u8(d.val[c], inv);
+            // (t + 128 + ((t + 128) >> 8)) >> 8，与标量实现一致
+            uint8x8_t scaled = vraddhn_u16(t, vrshrq_n_u16(t, 8));
+            d.val[c] = vqadd_u8(s.val[c], scaled);
+        }
+        vst4_u8(reinterpret_cast<uint8_t*>(dst + i), d);
+    }
+
+    if (i < count) {
+        OsdOverlay::blendRowScalar(dst + i, src + i, count - i);
+    }
+}
+#endif
+
+struct BlendKernel {
+    void (*row)(uint32_t* dst, const uint32_t* src, int count);
+    const char* name;
+};
+
+BlendKernel selectBlendKernel() {
+    const CpuFeatures& cpu = CpuFeatures::get();
+#if defined(OSD_OVERLAY_X86)
+    if (cpu.allows(SimdLevel::AVX2)) {
+        return BlendKernel{ &blendRowAvx2, "AVX2" };
+    }
+    if (cpu.allows(SimdLevel::SSE2)) {
+        return BlendKernel{ &blendRowSse2, "SSE2" };
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    if (cpu.allows(SimdLevel::NEON)) {
+        return BlendKernel{ &blendRowNeon, "NEON" };
+    }
+#else
+    (void)cpu;
+#endif
+    return BlendKernel{ &OsdOverlay::blendRowScalar, "Scalar" };
+}
+
+const BlendKernel& blendKernel() {
+    static const BlendKernel kernel = selectBlendKernel();
+    return kernel;
+}
+
+} // namespace
+
+// ============ 构造/析构 ============
+
+OsdOverlay::OsdOverlay(int frame_width, int frame_height, size_t frame_stride)
+    : frame_width_(frame_width)
+    , frame_height_(frame_height)
+    , frame_stride_(frame_stride ? frame_stride : (size_t)frame_width * 4)
+    , next_layer_id_(0)
+    , dirty_{0, 0, 0, 0}
+    , stats_{0, 0, 0, 0}
+{
+    if (frame_width <= 0 || frame_height <= 0) {
+        throw std::invalid_argument("OsdOverlay: invalid frame size");
+    }
+    if (frame_stride_ < (size_t)frame_width * 4) {
+        throw std::invalid_argument("OsdOverlay: stride smaller than width * 4");
+    }
+
+    canvas_.assign((size_t)frame_width * frame_height, 0);
+    row_spans_.resize(frame_height);
+
+    printf("🖌️  OsdOverlay created: %dx%d, stride=%zu, kernel=%s\n",
+           frame_width_, frame_height_, frame_stride_, getKernelName());
+}
+
+OsdOverlay::~OsdOverlay() {
+}
+
+// ============ 图层管理 ============
+
+int OsdOverlay::addLayer(int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        printf("❌ ERROR: Invalid OSD layer size %dx%d\n", width, height);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer layer;
+    layer.id = next_layer_id_++;
+    layer.x = x;
+    layer.y = y;
+    layer.width = width;
+    layer.height = height;
+    layer.visible = true;
+    layer.alpha = 255;
+    layer.pixels.assign((size_t)width * height, 0);
+    layers_.push_back(std::move(layer));
+
+    // 全透明图层不影响画布，无需标记脏区域
+    return layers_.back().id;
+}
+
+bool OsdOverlay::removeLayer(int layer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = layers_.begin(); it != layers_.end(); ++it) {
+        if (it->id == layer_id) {
+            markLayerDirty(*it);
+            layers_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OsdOverlay::updateLayer(int layer_id, const uint32_t* argb, int stride_pixels) {
+    if (!argb) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer* layer = findLayer(layer_id);
+    if (!layer) {
+        return false;
+    }
+
+    int stride = stride_pixels > 0 ? stride_pixels : layer->width;
+    for (int row = 0; row < layer->height; row++) {
+        const uint32_t* src = argb + (size_t)row * stride;
+        uint32_t* dst = layer->pixels.data() + (size_t)row * layer->width;
+        for (int col = 0; col < layer->width; col++) {
+            dst[col] = premultiply(src[col], layer->alpha);
+        }
+    }
+
+    markLayerDirty(*layer);
+    return true;
+}
+
+bool OsdOverlay::fillLayerRect(int layer_id, int x, int y, int width, int height, uint32_t argb) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer* layer = findLayer(layer_id);
+    if (!layer) {
+        return false;
+    }
+
+    // 裁剪到图层范围
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + width, layer->width);
+    int y1 = std::min(y + height, layer->height);
+    if (x0 >= x1 || y0 >= y1) {
+        return true;
+    }
+
+    uint32_t value = premultiply(argb, layer->alpha);
+    for (int row = y0; row < y1; row++) {
+        uint32_t* dst = layer->pixels.data() + (size_t)row * layer->width;
+        std::fill(dst + x0, dst + x1, value);
+    }
+
+    markDirty(layer->x + x0, layer->y + y0, x1 - x0, y1 - y0);
+    return true;
+}
+
+bool OsdOverlay::moveLayer(int layer_id, int x, int y) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer* layer = findLayer(layer_id);
+    if (!layer) {
+        return false;
+    }
+    if (layer->x == x && layer->y == y) {
+        return true;
+    }
+
+    markLayerDirty(*layer);   // 旧位置
+    layer->x = x;
+    layer->y = y;
+    markLayerDirty(*layer);   // 新位置
+    return true;
+}
+
+bool OsdOverlay::setLayerVisible(int layer_id, bool visible) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer* layer = findLayer(layer_id);
+    if (!layer) {
+        return false;
+    }
+    if (layer->visible != visible) {
+        layer->visible = visible;
+        markLayerDirty(*layer);
+    }
+    return true;
+}
+
+bool OsdOverlay::setLayerAlpha(int layer_id, uint8_t alpha) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Layer* layer = findLayer(layer_id);
+    if (!layer) {
+        return false;
+    }
+    if (layer->alpha == alpha) {
+        return true;
+    }
+
+    // 像素以预乘格式保存：按新旧 alpha 比例重新缩放
+    // 旧 alpha 为 0 时信息已丢失，只能保持透明（需调用者重新 updateLayer）
+    uint8_t old_alpha = layer->alpha;
+    layer->alpha = alpha;
+    if (old_alpha != 0) {
+        for (auto& px : layer->pixels) {
+            uint32_t out = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                uint32_t c = (px >> shift) & 0xFF;
+                c = std::min<uint32_t>(255, (c * alpha + old_alpha / 2) / old_alpha);
+                out |= c << shift;
+            }
+            px = out;
+        }
+    }
+    markLayerDirty(*layer);
+    return true;
+}
+
+// ============ 混合 ============
+
+bool OsdOverlay::apply(Buffer* frame) {
+    if (!frame || !frame->data()) {
+        printf("❌ ERROR: OsdOverlay::apply() invalid frame buffer\n");
+        return false;
+    }
+    return apply(frame->data(), frame->size());
+}
+
+bool OsdOverlay::apply(void* frame_data, size_t frame_size) {
+    if (!frame_data) {
+        return false;
+    }
+
+    size_t required = frame_stride_ * (frame_height_ - 1) + (size_t)frame_width_ * 4;
+    if (frame_size < required) {
+        printf("❌ ERROR: OsdOverlay frame too small (%zu < %zu bytes)\n", frame_size, required);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!dirty_.empty()) {
+        recomposeDirtyRegion();
+    }
+    return blendInto(static_cast<uint8_t*>(frame_data));
+}
+
+bool OsdOverlay::hasVisibleContent() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!dirty_.empty()) {
+        recomposeDirtyRegion();
+    }
+    for (const auto& spans : row_spans_) {
+        if (!spans.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============ 统计 ============
+
+OsdOverlay::Stats OsdOverlay::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void OsdOverlay::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = Stats{0, 0, 0, 0};
+}
+
+void OsdOverlay::printStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    printf("\n📊 OsdOverlay Statistics:\n");
+    printf("   Frame size: %dx%d (kernel: %s)\n", frame_width_, frame_height_, getKernelName());
+    printf("   Layers: %zu\n", layers_.size());
+    printf("   Frames blended: %llu\n", (unsigned long long)stats_.frames_blended);
+    printf("   Recompose count: %llu\n", (unsigned long long)stats_.recompose_count);
+    if (stats_.frames_blended > 0) {
+        printf("   Avg blended pixels/frame: %.0f (%.2f%% of frame)\n",
+               (double)stats_.blended_pixels / stats_.frames_blended,
+               100.0 * stats_.blended_pixels / stats_.frames_blended /
+               ((double)frame_width_ * frame_height_));
+    }
+    printf("   Recomposed pixels: %llu\n", (unsigned long long)stats_.recomposed_pixels);
+}
+
+const char* OsdOverlay::getKernelName() {
+    return blendKernel().name;
+}
+
+// ============ 混合内核 ============
+
+void OsdOverlay::blendRowScalar(uint32_t* dst, const uint32_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t s = src[i];
+        uint32_t inv = 255 - (s >> 24);
+        if (inv == 255) {
+            continue;               // 全透明
+        }
+        if (inv == 0) {
+            dst[i] = s;             // 全不透明
+            continue;
+        }
+        uint32_t d = dst[i];
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t t = ((d >> shift) & 0xFF) * inv + 128;
+            uint32_t c = ((s >> shift) & 0xFF) + ((t + (t >> 8)) >> 8);
+            out |= (c > 255 ? 255 : c) << shift;
+        }
+        dst[i] = out;
+    }
+}
+
+void OsdOverlay::blendRow(uint32_t* dst, const uint32_t* src, int count) {
+    blendKernel().row(dst, src, count);
+}
+
+// ============ 内部辅助方法 ============
+
+OsdOverlay::Layer* OsdOverlay::findLayer(int layer_id) {
+    for (auto& layer : layers_) {
+        if (layer.id == layer_id) {
+            return &layer;
+        }
+    }
+    return nullptr;
+}
+
+void OsdOverlay::markDirty(int x, int y, int width, int height) {
+    Rect r = { std::max(x, 0), std::max(y, 0),
+               std::min(x + width, frame_width_), std::min(y + height, frame_height_) };
+    if (r.empty()) {
+        return;   // 完全在帧外
+    }
+
+    if (dirty_.empty()) {
+        dirty_ = r;
+    } else {
+        dirty_.x0 = std::min(dirty_.x0, r.x0);
+        dirty_.y0 = std::min(dirty_.y0, r.y0);
+        dirty_.x1 = std::max(dirty_.x1, r.x1);
+        dirty_.y1 = std::max(dirty_.y1, r.y1);
+    }
+}
+
+void OsdOverlay::markLayerDirty(const Layer& layer) {
+    markDirty(layer.x, layer.y, layer.width, layer.height);
+}
+
+void OsdOverlay::recomposeDirtyRegion() {
+    const Rect r = dirty_;
+    const int width = r.x1 - r.x0;
+
+    // 1. 清空脏矩形
+    for (int row = r.y0; row < r.y1; row++) {
+        uint32_t* dst = canvas_.data() + (size_t)row * frame_width_;
+        std::fill(dst + r.x0, dst + r.x1, 0u);
+    }
+
+    // 2. 自底向上合成与脏矩形相交的可见图层
+    for (const auto& layer : layers_) {
+        if (!layer.visible || layer.alpha == 0) {
+            continue;
+        }
+        int x0 = std::max(r.x0, layer.x);
+        int y0 = std::max(r.y0, layer.y);
+        int x1 = std::min(r.x1, layer.x + layer.width);
+        int y1 = std::min(r.y1, layer.y + layer.height);
+        if (x0 >= x1 || y0 >= y1) {
+            continue;
+        }
+        for (int row = y0; row < y1; row++) {
+            const uint32_t* src = layer.pixels.data()
+                                + (size_t)(row - layer.y) * layer.width + (x0 - layer.x);
+            uint32_t* dst = canvas_.data() + (size_t)row * frame_width_ + x0;
+            blendRow(dst, src, x1 - x0);
+        }
+    }
+
+    // 3. 重建受影响行的 span
+    for (int row = r.y0; row < r.y1; row++) {
+        rebuildRowSpans(row);
+    }
+
+    stats_.recompose_count++;
+    stats_.recomposed_pixels += (uint64_t)width * (r.y1 - r.y0);
+    dirty_ = Rect{0, 0, 0, 0};
+}
+
+void OsdOverlay::rebuildRowSpans(int row) {
+    std::vector<Span>& spans = row_spans_[row];
+    spans.clear();
+
+    const uint32_t* line = canvas_.data() + (size_t)row * frame_width_;
+    int col = 0;
+    while (col < frame_width_) {
+        // 跳过透明像素
+        while (col < frame_width_ && line[col] == 0) {
+            col++;
+        }
+        if (col >= frame_width_) {
+            break;
+        }
+        int begin = col;
+        while (col < frame_width_ && line[col] != 0) {
+            col++;
+        }
+
+        if (!spans.empty() && begin - spans.back().end < SPAN_MERGE_GAP) {
+            spans.back().end = col;
+        } else {
+            spans.push_back(Span{begin, col});
+        }
+    }
+}
+
+bool OsdOverlay::blendInto(uint8_t* frame_base) {
+    uint64_t pixels = 0;
+
+    for (int row = 0; row < frame_height_; row++) {
+        const std::vector<Span>& spans = row_spans_[row];
+        if (spans.empty()) {
+            continue;
+        }
+        uint32_t* dst = reinterpret_cast<uint32_t*>(frame_base + frame_stride_ * row);
+        const uint32_t* src = canvas_.data() + (size_t)row * frame_width_;
+        for (const Span& span : spans) {
+            blendRow(dst + span.begin, src + span.begin, span.end - span.begin);
+            pixels += span.end - span.begin;
+        }
+    }
+
+    stats_.frames_blended++;
+    stats_.blended_pixels += pixels;
+    return true;
+}
+
+uint32_t OsdOverlay::premultiply(uint32_t argb, uint8_t extra_alpha) {
+    uint32_t a = argb >> 24;
+    if (extra_alpha != 255) {
+        a = (a * extra_alpha + 127) / 255;
+    }
+    if (a == 0) {
+        return 0;
+    }
+    uint32_t r = (((argb >> 16) & 0xFF) * a + 127) / 255;
+    uint32_t g = (((argb >> 8) & 0xFF) * a + 127) / 255;
+    uint32_t b = ((argb & 0xFF) * a + 127) / 255;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
@@ -0,0 +1,1068 @@
+#include "../../include/pipeline/Pipeline.hpp"
+#include "../../include/videoFile/AvioBackend.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fstream>
+#include <sstream>
+
+// ============ 配置解析辅助函数 ============
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+/**
+ * 去掉注释：行首的 # / ;，或前面是空白的 # / ;（路径 / URL 中的字符保留）
+ */
+static std::string stripComment(const std::string& line) {
+    for (size_t i = 0; i < line.size(); i++) {
+        if ((line[i] == '#' || line[i] == ';') &&
+            (i == 0 || line[i - 1] == ' ' || line[i - 1] == '\t')) {
+            return line.substr(0, i);
+        }
+    }
+    return line;
+}
+
+static bool parseBool(const std::string& value, bool* out) {
+    const char* v = value.c_str();
+    if (strcasecmp(v, "true") == 0 || strcasecmp(v, "yes") == 0 ||
+        strcasecmp(v, "on") == 0 || strcmp(v, "1") == 0) {
+        *out = true;
+        return true;
+    }
+    if (strcasecmp(v, "false") == 0 || strcasecmp(v, "no") == 0 ||
+        strcasecmp(v, "off") == 0 || strcmp(v, "0") == 0) {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+static bool parseInt(const std::string& value, int min_value, int* out) {
+    char* end = nullptr;
+    long v = strtol(value.c_str(), &end, 0);
+    if (value.empty() || *end != '\0' || v < min_value || v > 0x7fffffffL) {
+        return false;
+    }
+    *out = static_cast<int>(v);
+    return true;
+}
+
+static bool parseReaderType(const std::string& value, VideoReaderFactory::ReaderType* out) {
+    using RT = VideoReaderFactory::ReaderType;
+    static const struct { const char* name; RT type; } kReaders[] = {
+        { "auto",    RT::AUTO },
+        { "mmap",    RT::MMAP },
+        { "iouring", RT::IOURING },
+        { "direct",  RT::DIRECT_READ },
+        { "rtsp",    RT::RTSP },
+        { "ffmpeg",  RT::FFMPEG },
+        { "rtp",     RT::RTP },
+        { "images",  RT::IMAGE_SEQUENCE },
+        { "v4l2",    RT::V4L2 },
+    };
+    for (const auto& entry : kReaders) {
+        if (strcasecmp(value.c_str(), entry.name) == 0) {
+            *out = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static PixelFormat pixelFormatForBpp(int bits_per_pixel) {
+    switch (bits_per_pixel) {
+        case 32: return PixelFormat::ARGB8888;
+        case 24: return PixelFormat::BGR24;
+        case 16: return PixelFormat::RGB565;
+        default: return PixelFormat::UNKNOWN;
+    }
+}
+
+// ============ PipelineConfig ============
+
+bool PipelineConfig::loadFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        printf("❌ ERROR: Cannot open pipeline config: %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    printf("📄 Loading pipeline config: %s\n", path.c_str());
+    return parse(ss.str());
+}
+
+bool PipelineConfig::parse(const std::string& text) {
+    std::istringstream in(text);
+    std::string raw_line;
+    std::string section;
+    int line_no = 0;
+    bool ok = true;
+
+    auto fail = [&](const char* what, const std::string& detail) {
+        printf("❌ ERROR: Pipeline config line %d: %s '%s'\n", line_no, what, detail.c_str());
+        ok = false;
+    };
+
+    while (std::getline(in, raw_line)) {
+        line_no++;
+        std::string line = trim(stripComment(raw_line));
+        if (line.empty()) {
+            continue;
+        }
+
+        // [section]
+        if (line[0] == '[') {
+            if (line.back() != ']') {
+                fail("malformed section", line);
+                continue;
+            }
+            section = trim(line.substr(1, line.size() - 2));
+            if (section == "osd") {
+                osd.push_back(OsdBox());
+            } else if (section != "source" && section != "pool" && section != "sink" &&
+                       section != "startup") {
+                fail("unknown section", section);
+            }
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            fail("expected key = value, got", line);
+            continue;
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        bool valid = true;
+
+        if (section == "source") {
+            if (key == "reader") {
+                valid = parseReaderType(value, &source.reader_type);
+            } else if (key == "path") {
+                source.path = value;
+                valid = !value.empty();
+            } else if (key == "loop") {
+                valid = parseBool(value, &source.loop);
+            } else if (key == "threads") {
+                valid = parseInt(value, 1, &source.thread_count);
+            } else if (key == "schedule") {
+                if (value == "interleaved") {
+                    source.schedule = VideoProducer::Schedule::INTERLEAVED;
+                } else if (value == "chunked") {
+                    source.schedule = VideoProducer::Schedule::CHUNKED;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "chunk") {
+                valid = parseInt(value, 1, &source.chunk_frames);
+            } else if (key == "format") {
+                valid = sscanf(value.c_str(), "%dx%d@%d", &source.width, &source.height,
+                               &source.bits_per_pixel) == 3 &&
+                        source.width > 0 && source.height > 0 && source.bits_per_pixel > 0;
+            } else if (key == "fast_open") {
+                bool fast = false;
+                valid = parseBool(value, &fast);
+                if (valid && fast) {
+                    StreamProbeConfig low = StreamProbeConfig::lowLatency();
+                    source.probe.probesize = low.probesize;
+                    source.probe.analyzeduration_us = low.analyzeduration_us;
+                    source.probe.fpsprobesize = low.fpsprobesize;
+                }
+            } else if (key == "codec") {
+                char codec_name[32];
+                int w = 0;
+                int h = 0;
+                valid = sscanf(value.c_str(), "%31[^:]:%dx%d", codec_name, &w, &h) == 3 &&
+                        w > 0 && h > 0;
+                if (valid) {
+                    source.probe.codec_name = codec_name;
+                    source.probe.width = w;
+                    source.probe.height = h;
+                }
+            } else if (key == "io") {
+                valid = AvioBackend::parseType(value.c_str(), &source.probe.io_backend);
+            } else if (key == "map_window") {
+                if (value == "auto") {
+                    source.probe.map_window_frames = 0;
+                } else if (value == "full") {
+                    source.probe.map_window_frames = -1;
+                } else {
+                    valid = parseInt(value, 1, &source.probe.map_window_frames);
+                }
+            } else {
+                fail("unknown [source] key", key);
+                continue;
+            }
+        } else if (section == "pool") {
+            if (key == "type") {
+                if (value == "display") {
+                    pool.mode = PoolMode::DISPLAY;
+                } else if (value == "own") {
+                    pool.mode = PoolMode::OWN;
+                } else if (value == "dynamic") {
+                    pool.mode = PoolMode::DYNAMIC;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "count") {
+                valid = parseInt(value, 2, &pool.buffer_count);
+            } else if (key == "allocator") {
+                if (value == "normal") {
+                    pool.use_cma = false;
+                    pool.use_udmabuf = false;
+                } else if (value == "cma") {
+                    pool.use_cma = true;
+                    pool.use_udmabuf = false;
+                } else if (value == "udmabuf") {
+                    pool.use_cma = false;
+                    pool.use_udmabuf = true;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "heap") {
+                if (value == "auto") {
+                    pool.heap.kind = DmaHeapOptions::Kind::AUTO;
+                } else if (value == "cma") {
+                    pool.heap.kind = DmaHeapOptions::Kind::CMA;
+                } else if (value == "system") {
+                    pool.heap.kind = DmaHeapOptions::Kind::SYSTEM;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "cached") {
+                valid = parseBool(value, &pool.heap.cached);
+            } else if (key == "hugetlb") {
+                valid = parseBool(value, &pool.hugetlb);
+            } else if (key == "capacity") {
+                valid = parseInt(value, 1, &pool.max_capacity);
+            } else if (key == "name") {
+                pool.name = value;
+                valid = !value.empty();
+            } else {
+                fail("unknown [pool] key", key);
+                continue;
+            }
+        } else if (section == "osd") {
+            OsdBox& box = osd.back();
+            if (key == "rect") {
+                valid = sscanf(value.c_str(), "%d,%d,%d,%d", &box.x, &box.y,
+                               &box.width, &box.height) == 4 &&
+                        box.width > 0 && box.height > 0;
+            } else if (key == "color") {
+                char* end = nullptr;
+                unsigned long color = strtoul(value.c_str(), &end, 0);
+                valid = !value.empty() && *end == '\0' && color <= 0xffffffffUL;
+                box.argb = static_cast<uint32_t>(color);
+            } else {
+                fail("unknown [osd] key", key);
+                continue;
+            }
+        } else if (section == "sink") {
+            if (key == "display") {
+                if (value == "auto") {
+                    sink.display_mode = DisplayMode::AUTO;
+                } else if (value == "flip") {
+                    sink.display_mode = DisplayMode::FLIP;
+                } else if (value == "dma") {
+                    sink.display_mode = DisplayMode::DMA;
+                } else if (value == "memcpy") {
+                    sink.display_mode = DisplayMode::MEMCPY;
+                } else if (value == "none") {
+                    sink.display_mode = DisplayMode::NONE;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "device") {
+                valid = parseInt(value, 0, &sink.device_index);
+            } else if (key == "policy") {
+                if (value == "fifo") {
+                    sink.policy = QueuePolicy::FIFO;
+                } else if (value == "latest") {
+                    sink.policy = QueuePolicy::LATEST;
+                } else {
+                    valid = false;
+                }
+            } else if (key == "vsync") {
+                valid = parseBool(value, &sink.vsync);
+            } else if (key == "timeout_ms") {
+                valid = parseInt(value, 1, &sink.acquire_timeout_ms);
+            } else if (key == "record") {
+                sink.record_path = value;
+            } else if (key == "dump") {
+                sink.dump_path = value;
+            } else if (key == "golden") {
+                sink.golden_path = value;
+            } else if (key == "max_frames") {
+                valid = parseInt(value, 0, &sink.max_frames);
+            } else {
+                fail("unknown [sink] key", key);
+                continue;
+            }
+        } else if (section == "startup") {
+            if (key == "parallel") {
+                valid = parseBool(value, &startup.parallel);
+            } else if (key == "target_ms") {
+                int target = 0;
+                valid = parseInt(value, 0, &target);
+                startup.target_ms = target;
+            } else {
+                fail("unknown [startup] key", key);
+                continue;
+            }
+        } else {
+            fail("key outside of a section", key);
+            continue;
+        }
+
+        if (!valid) {
+            fail(("invalid value for " + key + ":").c_str(), value);
+        }
+    }
+
+    return ok;
+}
+
+bool PipelineConfig::validate(std::string* error) const {
+    const char* reason = nullptr;
+
+    if (source.path.empty()) {
+        reason = "source path is empty";
+    } else if (source.thread_count < 1) {
+        reason = "producer thread count must be >= 1";
+    } else if (pool.mode == PoolMode::DISPLAY && sink.display_mode == DisplayMode::NONE) {
+        reason = "display pool requires a display sink";
+    } else if (sink.display_mode == DisplayMode::FLIP && pool.mode != PoolMode::DISPLAY) {
+        reason = "flip display requires the display pool";
+    } else if (sink.display_mode == DisplayMode::DMA && pool.mode == PoolMode::DISPLAY) {
+        reason = "dma display requires an own (cma) or dynamic pool";
+    } else if (sink.display_mode == DisplayMode::DMA && pool.mode == PoolMode::OWN && !pool.use_cma) {
+        reason = "dma display requires allocator = cma";
+    } else if (sink.display_mode == DisplayMode::NONE &&
+               (source.width <= 0 || source.height <= 0 || source.bits_per_pixel <= 0)) {
+        reason = "display = none requires an explicit source format (WxH@bpp)";
+    } else if (pool.mode == PoolMode::OWN && pool.buffer_count < 2) {
+        reason = "own pool needs at least 2 buffers";
+    } else if (pool.mode == PoolMode::DYNAMIC && pool.max_capacity < 1) {
+        reason = "dynamic pool capacity must be >= 1";
+    }
+
+    if (reason) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    }
+    return true;
+}
+
+void PipelineConfig::print() const {
+    printf("\n🧩 Pipeline:\n");
+    printf("   Source: %s [%s] loop=%s threads=%d", source.path.c_str(),
+           VideoReaderFactory::typeToString(source.reader_type),
+           source.loop ? "yes" : "no", source.thread_count);
+    if (source.width > 0) {
+        printf(" format=%dx%d@%d", source.width, source.height, source.bits_per_pixel);
+    }
+    if (source.schedule == VideoProducer::Schedule::CHUNKED) {
+        printf(" schedule=chunked/%d", source.chunk_frames);
+    }
+    if (source.executor) {
+        printf(" executor=shared/%d", source.executor->getWorkerCount());
+    }
+    printf("\n");
+    if (source.probe.hasCodecParams()) {
+        printf("   Probe: codec %s %dx%d (no probing)\n", source.probe.codec_name.c_str(),
+               source.probe.width, source.probe.height);
+    } else if (source.probe.probesize >= 0) {
+        printf("   Probe: %lld bytes / %lld us\n", (long long)source.probe.probesize,
+               (long long)source.probe.analyzeduration_us);
+    }
+    if (source.probe.io_backend != AvioBackendType::DEFAULT) {
+        printf("   Demux I/O: %s\n", AvioBackend::typeToString(source.probe.io_backend));
+    }
+    if (source.probe.map_window_frames != 0) {
+        if (source.probe.map_window_frames < 0) {
+            printf("   Map: whole file\n");
+        } else {
+            printf("   Map: %d-frame windows\n", source.probe.map_window_frames);
+        }
+    }
+
+    printf("   Pool: %s", poolModeToString(pool.mode));
+    if (pool.mode == PoolMode::OWN) {
+        printf(" count=%d allocator=%s", pool.buffer_count,
+               pool.use_cma ? "cma" : (pool.use_udmabuf ? "udmabuf" : "normal"));
+        if (pool.use_cma) {
+            printf(" heap=%s/%s", DmaHeapOptions::kindToString(pool.heap.kind),
+                   pool.heap.cached ? "cached" : "uncached");
+        } else if (pool.use_udmabuf && pool.hugetlb) {
+            printf(" hugetlb");
+        }
+    } else if (pool.mode == PoolMode::DYNAMIC) {
+        printf(" capacity=%d", pool.max_capacity);
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < osd.size(); i++) {
+        printf("   OSD #%zu: %d,%d %dx%d color=0x%08X\n", i, osd[i].x, osd[i].y,
+               osd[i].width, osd[i].height, osd[i].argb);
+    }
+
+    printf("   Sink: display=%s fb%d policy=%s vsync=%s timeout=%dms\n",
+           displayModeToString(sink.display_mode), sink.device_index,
+           queuePolicyToString(sink.policy), sink.vsync ? "on" : "off",
+           sink.acquire_timeout_ms);
+    if (!sink.record_path.empty()) printf("   Record: %s\n", sink.record_path.c_str());
+    if (!sink.dump_path.empty()) printf("   Dump: %s\n", sink.dump_path.c_str());
+    if (!sink.golden_path.empty()) printf("   Golden: %s\n", sink.golden_path.c_str());
+    if (sink.max_frames > 0) printf("   Max frames: %d\n", sink.max_frames);
+    printf("   Startup: %s", startup.parallel ? "parallel" : "serial");
+    if (startup.target_ms > 0) printf(", first frame target %.0f ms", startup.target_ms);
+    printf("\n");
+}
+
+const char* PipelineConfig::poolModeToString(PoolMode mode) {
+    switch (mode) {
+        case PoolMode::DISPLAY: return "display";
+        case PoolMode::OWN:     return "own";
+        case PoolMode::DYNAMIC: return "dynamic";
+        default:                return "unknown";
+    }
+}
+
+const char* PipelineConfig::displayModeToString(DisplayMode mode) {
+    switch (mode) {
+        case DisplayMode::AUTO:   return "auto";
+        case DisplayMode::FLIP:   return "flip";
+        case DisplayMode::DMA:    return "dma";
+        case DisplayMode::MEMCPY: return "memcpy";
+        case DisplayMode::NONE:   return "none";
+        default:                  return "unknown";
+    }
+}
+
+const char* PipelineConfig::queuePolicyToString(QueuePolicy policy) {
+    switch (policy) {
+        case QueuePolicy::FIFO:   return "fifo";
+        case QueuePolicy::LATEST: return "latest";
+        default:                  return "unknown";
+    }
+}
+
+// ============ Pipeline 构造/析构 ============
+
+Pipeline::Pipeline(const PipelineConfig& config)
+    : config_(config)
+    , pool_(nullptr)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , started_(false)
+    , stop_requested_(false)
+    , producer_failed_(false)
+    , consumed_frames_(0)
+    , dropped_frames_(0)
+    , display_errors_(0)
+{
+}
+
+Pipeline::~Pipeline() {
+    stop();
+}
+
+// ============ 生命周期 ============
+
+bool Pipeline::start() {
+    if (started_) {
+        printf("⚠️  Warning: Pipeline already started\n");
+        return false;
+    }
+
+    std::string reason;
+    if (!config_.validate(&reason)) {
+        setError("Invalid pipeline: " + reason);
+        return false;
+    }
+    config_.print();
+
+    timeline_.reset();
+    width_ = config_.source.width;
+    height_ = config_.source.height;
+    bits_per_pixel_ = config_.source.bits_per_pixel;
+
+    // 源的打开/探测不依赖 BufferPool，可与显示设备 / pool 初始化并行
+    std::string source_error;
+    auto open_source = [this, &source_error](VideoProducer::Config config) {
+        StartupTimeline::Scope scope(timeline_, "source.open");
+        std::shared_ptr<VideoFile> source = VideoProducer::openSource(config, &source_error);
+        scope.setOk(source != nullptr);
+        return source;
+    };
+
+    std::future<std::shared_ptr<VideoFile>> source_future;
+    std::future<bool> pool_future;
+    bool parallel = config_.startup.parallel;
+    if (parallel && sourceIndependentOfDisplay()) {
+        source_future = std::async(std::launch::async, open_source, makeProducerConfig());
+    }
+    if (parallel && hasExplicitFormat() && config_.pool.mode != PipelineConfig::PoolMode::DISPLAY) {
+        // 自有 / 动态 pool 的大小已知，分配（含清零）与显示设备初始化并行
+        pool_future = std::async(std::launch::async, [this]() { return createPool(); });
+    }
+
+    bool ok = createDisplay();
+    if (ok && parallel && !source_future.valid()) {
+        // 格式来自显示设备：设备就绪后再开始，与 pool 分配并行
+        source_future = std::async(std::launch::async, open_source, makeProducerConfig());
+    }
+    if (pool_future.valid()) {
+        bool pool_ok = pool_future.get();
+        ok = ok && pool_ok;
+    } else if (ok) {
+        ok = createPool();
+    }
+
+    // 无论成败都要等待后台打开结束（lambda 引用了 source_error）
+    std::shared_ptr<VideoFile> source;
+    if (source_future.valid()) {
+        source = source_future.get();
+    } else if (ok) {
+        source = open_source(makeProducerConfig());
+    }
+    if (ok && !source) {
+        setError(source_error);
+        ok = false;
+    }
+    if (!ok) {
+        stop();
+        return false;
+    }
+
+    // 校验器须在生产者启动前挂接（POST_READ）
+    if (!config_.sink.golden_path.empty()) {
+        verifier_.reset(new FrameVerifier());
+        verifier_->enablePoint(VerifyPoint::POST_READ);
+        verifier_->enablePoint(VerifyPoint::PRE_DISPLAY);
+        if (!verifier_->loadGolden(config_.sink.golden_path)) {
+            printf("📝 No golden at %s, recording this run\n", config_.sink.golden_path.c_str());
+        }
+    }
+
+    if (!startProducer(source)) {
+        stop();
+        return false;
+    }
+
+    // 旁路 sink 依赖 pool 的 buffer 大小（动态 pool 在生产者 open 后才确定）
+    {
+        StartupTimeline::Scope scope(timeline_, "sinks.start");
+        createSinks();
+        createTransforms();
+    }
+
+    stop_requested_ = false;
+    started_ = true;
+    timeline_.mark("pipeline started");
+    printf("✅ Pipeline started in %.1f ms\n", timeline_.elapsedMs());
+    return true;
+}
+
+std::future<bool> Pipeline::startAsync() {
+    return std::async(std::launch::async, [this]() { return start(); });
+}
+
+bool Pipeline::startAll(const std::vector<Pipeline*>& pipelines) {
+    std::vector<std::future<bool>> results;
+    results.reserve(pipelines.size());
+    for (Pipeline* pipeline : pipelines) {
+        results.push_back(pipeline->startAsync());
+    }
+
+    bool all_ok = true;
+    for (auto& result : results) {
+        if (!result.get()) {
+            all_ok = false;
+        }
+    }
+    return all_ok;
+}
+
+void Pipeline::stop() {
+    if (recorder_) {
+        recorder_->stop();
+    }
+    if (dump_sink_) {
+        dump_sink_->stop();
+    }
+    if (producer_) {
+        producer_->stop();
+    }
+    if (display_) {
+        display_->setFrameVerifier(nullptr);
+    }
+
+    if (started_) {
+        started_ = false;
+        printStats();
+        if (verifier_) {
+            verifier_->printStats();
+            if (!verifier_->hasGolden()) {
+                verifier_->saveGolden(config_.sink.golden_path);
+            }
+        }
+    }
+
+    // 逆序销毁：producer 先于 pool，pool 先于 display
+    producer_.reset();
+    osd_.reset();
+    dump_sink_.reset();
+    recorder_.reset();
+    owned_pool_.reset();
+    pool_ = nullptr;
+    display_.reset();
+}
+
+// ============ 实例化 ============
+
+bool Pipeline::createDisplay() {
+    if (config_.sink.display_mode == PipelineConfig::DisplayMode::NONE) {
+        return true;
+    }
+
+    StartupTimeline::Scope scope(timeline_, "display.initialize");
+    display_.reset(new LinuxFramebufferDevice());
+    if (!display_->initialize(config_.sink.device_index)) {
+        scope.setOk(false);
+        setError("Failed to initialize framebuffer device " +
+                 std::to_string(config_.sink.device_index));
+        return false;
+    }
+
+    // 未指定格式时使用显示设备格式
+    if (width_ <= 0 || height_ <= 0 || bits_per_pixel_ <= 0) {
+        width_ = display_->getWidth();
+        height_ = display_->getHeight();
+        bits_per_pixel_ = display_->getBitsPerPixel();
+    }
+    return true;
+}
+
+bool Pipeline::createPool() {
+    const PipelineConfig::PoolConfig& pc = config_.pool;
+    StartupTimeline::Scope scope(timeline_, "pool.create");
+
+    switch (pc.mode) {
+        case PipelineConfig::PoolMode::DISPLAY:
+            pool_ = &display_->getBufferPool();
+            break;
+
+        case PipelineConfig::PoolMode::OWN: {
+            size_t frame_size = (size_t)width_ * height_ * ((bits_per_pixel_ + 7) / 8);
+            try {
+                if (pc.use_cma) {
+                    owned_pool_.reset(new BufferPool(pc.buffer_count, frame_size, pc.heap,
+                                                     pc.name, "Pipeline"));
+                } else if (pc.use_udmabuf) {
+                    owned_pool_.reset(new BufferPool(pc.buffer_count, frame_size,
+                                                     std::make_unique<UdmabufAllocator>(pc.hugetlb),
+                                                     pc.name, "Pipeline"));
+                } else {
+                    owned_pool_.reset(new BufferPool(pc.buffer_count, frame_size, false,
+                                                     pc.name, "Pipeline"));
+                }
+            } catch (const std::exception& e) {
+                setError(std::string("Failed to allocate pipeline pool: ") + e.what());
+                scope.setOk(false);
+                return false;
+            }
+            pool_ = owned_pool_.get();
+            break;
+        }
+
+        case PipelineConfig::PoolMode::DYNAMIC:
+            owned_pool_.reset(new BufferPool(pc.name, "Pipeline", pc.max_capacity));
+            pool_ = owned_pool_.get();
+            break;
+    }
+
+    pool_->printStats();
+    return true;
+}
+
+void Pipeline::createSinks() {
+    const PipelineConfig::SinkConfig& sc = config_.sink;
+
+    if (!sc.record_path.empty()) {
+        PixelFormat format = display_ ? display_->getPixelFormat() : pixelFormatForBpp(bits_per_pixel_);
+        recorder_.reset(new VideoRecorder());
+        VideoRecorder::Config rec_config(sc.record_path, width_, height_, format);
+        if (!recorder_->start(rec_config) || !recorder_->attach(*pool_)) {
+            printf("⚠️  Warning: Recording disabled (%s)\n", sc.record_path.c_str());
+            recorder_.reset();
+        }
+    }
+
+    if (!sc.dump_path.empty()) {
+        dump_sink_.reset(new RawDumpSink());
+        if (!dump_sink_->start(RawDumpSink::Config(sc.dump_path), *pool_)) {
+            printf("⚠️  Warning: Raw dump disabled (%s)\n", sc.dump_path.c_str());
+            dump_sink_.reset();
+        }
+    }
+}
+
+void Pipeline::createTransforms() {
+    if (config_.osd.empty()) {
+        return;
+    }
+    if (bits_per_pixel_ != 32) {
+        printf("⚠️  Warning: OSD requires 32bpp frames, %zu layer(s) ignored\n", config_.osd.size());
+        return;
+    }
+
+    osd_.reset(new OsdOverlay(width_, height_));
+    for (const PipelineConfig::OsdBox& box : config_.osd) {
+        int layer = osd_->addLayer(box.x, box.y, box.width, box.height);
+        if (layer < 0 || !osd_->fillLayerRect(layer, 0, 0, box.width, box.height, box.argb)) {
+            printf("⚠️  Warning: OSD box %d,%d %dx%d rejected\n", box.x, box.y, box.width, box.height);
+        }
+    }
+    printf("🎨 OSD: %zu layer(s), kernel %s\n", config_.osd.size(), OsdOverlay::getKernelName());
+
+    // 带缓存的 DMA-BUF pool：消费者在 CPU 上读改写 OSD 区域，也要包住同步
+    // （按 pool 的缓存属性判断：设备生产的源生产者同步为 NONE，但缓存仍需维护）
+    if (owned_pool_ && pool_ == owned_pool_.get() && pool_->isCpuCached()) {
+        pool_->setCpuAccessSync(pool_->getProducerCpuAccess(), Buffer::CpuAccess::READ_WRITE);
+    }
+}
+
+VideoProducer::Config Pipeline::makeProducerConfig() const {
+    const PipelineConfig::SourceConfig& src = config_.source;
+    VideoProducer::Config config(src.path, width_, height_, bits_per_pixel_,
+                                 src.loop, src.thread_count, src.reader_type);
+    config.probe = src.probe;
+    config.schedule = src.schedule;
+    config.chunk_frames = src.chunk_frames;
+    config.executor = src.executor;
+    return config;
+}
+
+bool Pipeline::hasExplicitFormat() const {
+    const PipelineConfig::SourceConfig& src = config_.source;
+    return src.width > 0 && src.height > 0 && src.bits_per_pixel > 0;
+}
+
+bool Pipeline::sourceIndependentOfDisplay() const {
+    const PipelineConfig::SourceConfig& src = config_.source;
+    if (hasExplicitFormat()) {
+        return true;
+    }
+    // 编码流读取器按码流分辨率输出，忽略 open 的格式参数
+    return src.reader_type == VideoReaderFactory::ReaderType::RTSP ||
+           src.reader_type == VideoReaderFactory::ReaderType::FFMPEG ||
+           src.reader_type == VideoReaderFactory::ReaderType::RTP;
+}
+
+bool Pipeline::startProducer(std::shared_ptr<VideoFile> source) {
+    StartupTimeline::Scope scope(timeline_, "producer.start");
+
+    producer_.reset(new VideoProducer(*pool_));
+    producer_->setErrorCallback([this](const std::string& error) {
+        printf("\n❌ Producer Error: %s\n", error.c_str());
+        producer_failed_ = true;
+    });
+    if (verifier_) {
+        producer_->setFrameVerifier(verifier_.get());
+        if (display_) {
+            display_->setFrameVerifier(verifier_.get());
+        }
+    }
+
+    if (!producer_->start(makeProducerConfig(), source)) {
+        setError("Failed to start video producer: " + producer_->getLastError());
+        scope.setOk(false);
+        return false;
+    }
+    return true;
+}
+
+// ============ 消费者循环 ============
+
+int Pipeline::run(const volatile bool* keep_running) {
+    if (!started_) {
+        printf("❌ ERROR: Pipeline not started\n");
+        return 0;
+    }
+
+    const PipelineConfig::SinkConfig& sc = config_.sink;
+    printf("\n▶️  Pipeline running (Ctrl+C to stop)\n\n");
+
+    while (!stop_requested_ && !producer_failed_ && (!keep_running || *keep_running)) {
+        Buffer* buffer = pool_->acquireFilled(true, sc.acquire_timeout_ms);
+        if (buffer == nullptr) {
+            if (reachedEndOfStream()) {
+                printf("🏁 Pipeline source finished\n");
+                break;
+            }
+            continue;  // 超时，继续等待
+        }
+
+        // LATEST：丢弃积压的旧帧，只显示最新一帧
+        if (sc.policy == PipelineConfig::QueuePolicy::LATEST) {
+            Buffer* newer;
+            while ((newer = pool_->acquireFilled(false)) != nullptr) {
+                pool_->releaseFilled(buffer);
+                buffer = newer;
+                dropped_frames_++;
+            }
+        }
+
+        if (osd_) {
+            osd_->apply(buffer);
+        }
+
+        if (!presentFrame(buffer)) {
+            display_errors_++;
+        }
+        pool_->releaseFilled(buffer);
+
+        int consumed = ++consumed_frames_;
+        if (consumed == 1) {
+            timeline_.mark(display_ ? "first frame on screen" : "first frame consumed");
+            timeline_.print(config_.startup.target_ms);
+        }
+        if (consumed % 100 == 0) {
+            printf("   Frames displayed: %d (%.1f fps, dropped %d)\n",
+                   consumed, producer_->getAverageFPS(), dropped_frames_.load());
+        }
+        if (sc.max_frames > 0 && consumed >= sc.max_frames) {
+            printf("🏁 Pipeline reached max_frames (%d)\n", sc.max_frames);
+            break;
+        }
+    }
+
+    return consumed_frames_.load();
+}
+
+bool Pipeline::presentFrame(Buffer* buffer) {
+    if (!display_) {
+        return true;
+    }
+
+    PipelineConfig::DisplayMode mode = config_.sink.display_mode;
+    if (mode == PipelineConfig::DisplayMode::AUTO) {
+        if (config_.pool.mode == PipelineConfig::PoolMode::DISPLAY) {
+            mode = PipelineConfig::DisplayMode::FLIP;
+        } else if (buffer->getPhysicalAddress() != 0) {
+            mode = PipelineConfig::DisplayMode::DMA;
+        } else {
+            mode = PipelineConfig::DisplayMode::MEMCPY;
+        }
+    }
+
+    if (config_.sink.vsync) {
+        display_->waitVerticalSync();
+    }
+
+    switch (mode) {
+        case PipelineConfig::DisplayMode::FLIP:
+            return display_->displayFilledFramebuffer(buffer);
+        case PipelineConfig::DisplayMode::DMA:
+            if (display_->displayBufferByDMA(buffer)) {
+                return true;
+            }
+            // DMA 失败（无物理地址等）时退回 memcpy
+            return display_->displayBufferByMemcpyToFramebuffer(buffer);
+        case PipelineConfig::DisplayMode::MEMCPY:
+            return display_->displayBufferByMemcpyToFramebuffer(buffer);
+        default:
+            return true;
+    }
+}
+
+bool Pipeline::reachedEndOfStream() const {
+    if (config_.source.loop || !producer_) {
+        return false;
+    }
+    int total = producer_->getTotalFrames();
+    if (total <= 0) {
+        return false;  // 实时流：帧数未知
+    }
+    return producer_->getProducedFrames() + producer_->getSkippedFrames() >= total &&
+           pool_->getFilledCount() == 0;
+}
+
+// ============ 查询 / 统计 ============
+
+uint64_t Pipeline::getVerifyMismatches() const {
+    return verifier_ ? verifier_->getTotalMismatches() : 0;
+}
+
+std::string Pipeline::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void Pipeline::printStats() const {
+    printf("\n📊 Pipeline statistics:\n");
+    printf("   Frames displayed: %d\n", consumed_frames_.load());
+    printf("   Frames dropped (latest policy): %d\n", dropped_frames_.load());
+    printf("   Display errors: %d\n", display_errors_.load());
+    if (producer_) {
+        printf("   Frames produced: %d (skipped %d, %.2f fps)\n",
+               producer_->getProducedFrames(), producer_->getSkippedFrames(),
+               producer_->getAverageFPS());
+    }
+    if (pool_) {
+        pool_->printStats();
+    }
+}
+
+void Pipeline::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = error;
+    printf("❌ ERROR: %s\n", error.c_str());
+}
+
+// ============ PipelineBuilder ============
+
+PipelineBuilder& PipelineBuilder::source(const std::string& path, VideoReaderFactory::ReaderType type) {
+    config_.source.path = path;
+    config_.source.reader_type = type;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::loop(bool enable) {
+    config_.source.loop = enable;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::producerThreads(int count) {
+    config_.source.thread_count = count;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::schedule(VideoProducer::Schedule schedule, int chunk_frames) {
+    config_.source.schedule = schedule;
+    config_.source.chunk_frames = chunk_frames;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::executor(std::shared_ptr<ProducerExecutor> executor) {
+    config_.source.executor = std::move(executor);
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::format(int width, int height, int bits_per_pixel) {
+    config_.source.width = width;
+    config_.source.height = height;
+    config_.source.bits_per_pixel = bits_per_pixel;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::probe(const StreamProbeConfig& probe) {
+    config_.source.probe = probe;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::displayPool() {
+    config_.pool.mode = PipelineConfig::PoolMode::DISPLAY;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::ownPool(int count, bool use_cma) {
+    config_.pool.mode = PipelineConfig::PoolMode::OWN;
+    config_.pool.buffer_count = count;
+    config_.pool.use_cma = use_cma;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::dmaHeap(DmaHeapOptions::Kind kind, bool cached) {
+    config_.pool.use_cma = true;
+    config_.pool.use_udmabuf = false;
+    config_.pool.heap = DmaHeapOptions(kind, cached);
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::udmabuf(bool hugetlb) {
+    config_.pool.use_cma = false;
+    config_.pool.use_udmabuf = true;
+    config_.pool.hugetlb = hugetlb;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::dynamicPool(int max_capacity) {
+    config_.pool.mode = PipelineConfig::PoolMode::DYNAMIC;
+    config_.pool.max_capacity = max_capacity;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::osdBox(int x, int y, int width, int height, uint32_t argb) {
+    config_.osd.push_back(PipelineConfig::OsdBox(x, y, width, height, argb));
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::display(PipelineConfig::DisplayMode mode, int device_index) {
+    config_.sink.display_mode = mode;
+    config_.sink.device_index = device_index;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::policy(PipelineConfig::QueuePolicy policy) {
+    config_.sink.policy = policy;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::vsync(bool enable) {
+    config_.sink.vsync = enable;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::record(const std::string& path) {
+    config_.sink.record_path = path;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::dump(const std::string& path) {
+    config_.sink.dump_path = path;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::golden(const std::string& path) {
+    config_.sink.golden_path = path;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::maxFrames(int count) {
+    config_.sink.max_frames = count;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::parallelInit(bool enable) {
+    config_.startup.parallel = enable;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::firstFrameTarget(double target_ms) {
+    config_.startup.target_ms = target_ms;
+    return *this;
+}
+
+std::unique_ptr<Pipeline> PipelineBuilder::build() const {
+    std::string reason;
+    if (!config_.validate(&reason)) {
+        printf("❌ ERROR: Invalid pipeline: %s\n", reason.c_str());
+        return nullptr;
+    }
+    return std::unique_ptr<Pipeline>(new Pipeline(config_));
+}
@@ -0,0 +1,257 @@
+#include "../../include/producer/ProducerExecutor.hpp"
+#include <stdio.h>
+#include <algorithm>
+
+namespace {
+
+// 当前线程所属的执行器和 worker 序号（非 worker 线程为 nullptr）
+thread_local const ProducerExecutor* tls_executor = nullptr;
+thread_local int tls_worker_index = -1;
+
+} // namespace
+
+// ============================================================
+// 构造函数和析构函数
+// ============================================================
+
+ProducerExecutor::ProducerExecutor(int worker_count)
+    : worker_count_(worker_count)
+    , running_(true)
+    , next_worker_(0)
+    , queued_(0)
+    , next_source_id_(0)
+    , executed_tasks_(0)
+    , stolen_tasks_(0)
+    , no_buffer_tasks_(0)
+{
+    if (worker_count_ <= 0) {
+        worker_count_ = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    workers_.reset(new Worker[worker_count_]);
+
+    threads_.reserve(worker_count_);
+    for (int i = 0; i < worker_count_; i++) {
+        threads_.emplace_back(&ProducerExecutor::workerLoop, this, i);
+    }
+    printf("🧵 ProducerExecutor created: %d worker(s)\n", worker_count_);
+}
+
+ProducerExecutor::~ProducerExecutor() {
+    printf("🧹 Destroying ProducerExecutor...\n");
+
+    // 仍注册的源：先断开空闲监听，避免 pool 回调到已销毁的执行器
+    std::map<int, std::shared_ptr<Source>> sources;
+    {
+        std::lock_guard<std::mutex> lock(sources_mutex_);
+        sources.swap(sources_);
+    }
+    for (auto& entry : sources) {
+        printf("⚠️  Warning: ProducerExecutor source #%d still registered\n", entry.first);
+        entry.second->pool->removeFreeListener(entry.second->listener_id);
+        std::lock_guard<std::mutex> lock(entry.second->mutex);
+        entry.second->active = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_ = false;
+    }
+    sleep_cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+// ============================================================
+// 源管理
+// ============================================================
+
+int ProducerExecutor::addSource(BufferPool& pool, int max_parallel, StepFunction step) {
+    if (!step || max_parallel < 1) {
+        printf("❌ ERROR: ProducerExecutor: invalid source (max_parallel=%d)\n", max_parallel);
+        return -1;
+    }
+
+    auto source = std::make_shared<Source>();
+    source->pool = &pool;
+    source->max_parallel = max_parallel;
+    source->step = std::move(step);
+    {
+        std::lock_guard<std::mutex> lock(sources_mutex_);
+        source->id = next_source_id_++;
+        sources_[source->id] = source;
+    }
+
+    // 消费者归还 buffer 时重新派发（监听者持有源，removeSource 时注销）
+    source->listener_id = pool.addFreeListener([this, source]() {
+        schedule(source);
+    });
+
+    printf("🧵 ProducerExecutor: source #%d attached to pool '%s' (max %d parallel)\n",
+           source->id, pool.getName().c_str(), max_parallel);
+
+    schedule(source);
+    return source->id;
+}
+
+void ProducerExecutor::removeSource(int source_id) {
+    std::shared_ptr<Source> source;
+    {
+        std::lock_guard<std::mutex> lock(sources_mutex_);
+        auto it = sources_.find(source_id);
+        if (it == sources_.end()) {
+            return;
+        }
+        source = it->second;
+        sources_.erase(it);
+    }
+
+    source->pool->removeFreeListener(source->listener_id);
+
+    // 排队中的任务由 worker 取出后直接丢弃（active = false），执行中的任务等其返回
+    std::unique_lock<std::mutex> lock(source->mutex);
+    source->active = false;
+    source->idle_cv.wait(lock, [&source]() { return source->in_flight == 0; });
+
+    printf("🧵 ProducerExecutor: source #%d detached\n", source_id);
+}
+
+int ProducerExecutor::getSourceCount() const {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    return (int)sources_.size();
+}
+
+void ProducerExecutor::printStats() const {
+    printf("\n📊 ProducerExecutor Statistics:\n");
+    printf("   Workers: %d\n", worker_count_);
+    printf("   Sources: %d\n", getSourceCount());
+    printf("   Tasks executed: %llu (stolen %llu, no buffer %llu)\n",
+           (unsigned long long)executed_tasks_.load(),
+           (unsigned long long)stolen_tasks_.load(),
+           (unsigned long long)no_buffer_tasks_.load());
+}
+
+// ============================================================
+// 派发
+// ============================================================
+
+void ProducerExecutor::schedule(const std::shared_ptr<Source>& source) {
+    // 已取得 buffer 的在途任务也计入 in_flight，这里偏保守（少派发），
+    // 任务完成时会再次派发，不会停顿
+    int free_count = source->pool->getFreeCount();
+    int count = 0;
+    {
+        std::lock_guard<std::mutex> lock(source->mutex);
+        if (!source->active) {
+            return;
+        }
+        count = std::min(source->max_parallel, free_count) - source->in_flight;
+        if (count <= 0) {
+            return;
+        }
+        source->in_flight += count;
+    }
+    for (int i = 0; i < count; i++) {
+        push(source);
+    }
+}
+
+void ProducerExecutor::push(std::shared_ptr<Source> source) {
+    int index = (tls_executor == this) ? tls_worker_index
+                                       : (int)(next_worker_.fetch_add(1) % worker_count_);
+    {
+        std::lock_guard<std::mutex> lock(workers_[index].mutex);
+        workers_[index].tasks.push_back(std::move(source));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        queued_++;
+    }
+    sleep_cv_.notify_one();
+}
+
+bool ProducerExecutor::popTask(int index, std::shared_ptr<Source>* source) {
+    {
+        std::lock_guard<std::mutex> lock(workers_[index].mutex);
+        if (!workers_[index].tasks.empty()) {
+            *source = std::move(workers_[index].tasks.front());
+            workers_[index].tasks.pop_front();
+            queued_--;
+            return true;
+        }
+    }
+
+    // 偷取：从下一个 worker 开始，取队列尾部（最晚派发的任务）
+    for (int i = 1; i < worker_count_; i++) {
+        Worker& victim = workers_[(index + i) % worker_count_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *source = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            queued_--;
+            stolen_tasks_.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================
+// Worker
+// ============================================================
+
+void ProducerExecutor::runTask(const std::shared_ptr<Source>& source) {
+    bool active = false;
+    {
+        std::lock_guard<std::mutex> lock(source->mutex);
+        active = source->active;
+    }
+
+    StepResult result = StepResult::FINISHED;
+    if (active) {
+        result = source->step();
+        executed_tasks_.fetch_add(1);
+        if (result == StepResult::NO_BUFFER) {
+            no_buffer_tasks_.fetch_add(1);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(source->mutex);
+        source->in_flight--;
+        if (result == StepResult::FINISHED) {
+            source->active = false;
+        }
+    }
+    source->idle_cv.notify_all();
+
+    // NO_BUFFER 也重新检查一次：buffer 可能在本任务计入 in_flight 期间被归还
+    if (result != StepResult::FINISHED) {
+        schedule(source);
+    }
+}
+
+void ProducerExecutor::workerLoop(int index) {
+    tls_executor = this;
+    tls_worker_index = index;
+
+    while (true) {
+        std::shared_ptr<Source> source;
+        if (popTask(index, &source)) {
+            runTask(source);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this]() { return !running_ || queued_.load() > 0; });
+        if (!running_) {
+            break;
+        }
+    }
+
+    tls_executor = nullptr;
+    tls_worker_index = -1;
+}
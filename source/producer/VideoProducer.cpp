@@ -1,6 +1,8 @@
 #include "../../include/producer/VideoProducer.hpp"
 #include <stdio.h>
+#include <stdint.h>
 #include <chrono>
+#include <algorithm>
 
 // ============================================================
 // 构造函数和析构函数
@@ -12,7 +14,24 @@ VideoProducer::VideoProducer(BufferPool& pool)
     , produced_frames_(0)
     , skipped_frames_(0)
     , next_frame_index_(0)
+    , lane_count_(0)
+    , chunk_frames_(0)
+    , next_chunk_(0)
+    , claimed_chunks_(0)
+    , stolen_ranges_(0)
+    , ordered_submit_(false)
+    , reorder_window_(0)
+    , next_submit_ticket_(0)
+    , executor_source_(-1)
+    , needs_external_buffer_(false)
+    , next_ticket_(0)
+    , consecutive_failures_(0)
     , total_frames_(0)
+    , frame_verifier_(nullptr)
+    , push_source_(false)
+    , pending_frames_(0)
+    , pending_drops_(0)
+    , end_of_stream_(false)
 {
     printf("🎬 VideoProducer created (dependent on BufferPool)\n");
 }
@@ -29,6 +48,31 @@ VideoProducer::~VideoProducer() {
 // ============================================================
 
 bool VideoProducer::start(const Config& config) {
+    return start(config, nullptr);
+}
+
+std::shared_ptr<VideoFile> VideoProducer::openSource(const Config& config, std::string* error) {
+    auto video_file = std::make_shared<VideoFile>(config.reader_type);
+    
+    // 探测预算 / 调用方编码参数（编码视频 Reader 使用）、映射窗口（MMAP 使用）
+    video_file->setProbeConfig(config.probe);
+    
+    // 🎯 统一的open接口（传入所有参数，门面类内部智能判断）
+    // - 对于编码视频（FFMPEG, RTSP）：自动检测格式，width/height/bpp 被忽略
+    // - 对于raw视频（MMAP, IOURING）：使用 width/height/bpp 参数
+    if (!video_file->open(config.file_path.c_str(), 
+                          config.width, 
+                          config.height, 
+                          config.bits_per_pixel)) {
+        if (error) {
+            *error = "Failed to open video file: " + config.file_path;
+        }
+        return nullptr;
+    }
+    return video_file;
+}
+
+bool VideoProducer::start(const Config& config, std::shared_ptr<VideoFile> source) {
     // 检查是否已经在运行
     if (running_) {
         printf("⚠️  Warning: VideoProducer already running\n");
@@ -46,36 +90,60 @@ bool VideoProducer::start(const Config& config) {
         return false;
     }
     
+    if (config.schedule == Schedule::CHUNKED && config.chunk_frames < 1) {
+        setError("Chunk size must be >= 1");
+        return false;
+    }
+    
     printf("\n🎬 Starting VideoProducer...\n");
     printf("   File: %s\n", config.file_path.c_str());
     printf("   Resolution: %dx%d\n", config.width, config.height);
     printf("   Bits per pixel: %d\n", config.bits_per_pixel);
     printf("   Loop mode: %s\n", config.loop ? "enabled" : "disabled");
-    printf("   Thread count: %d\n", config.thread_count);
+    printf("   Thread count: %d%s\n", config.thread_count,
+           config.executor ? " (max parallel reads on shared executor)" : "");
+    printf("   Schedule: %s\n", scheduleToString(config.schedule));
     
     // 保存配置
     config_ = config;
     
-    // 创建共享的 VideoFile 对象
-    video_file_ = std::make_shared<VideoFile>(config.reader_type);
-    printf("   Reader type: %s\n", video_file_->getReaderType());
+    // 创建共享的 VideoFile 对象（已预先打开时直接复用）
+    if (source && source->isOpen()) {
+        video_file_ = source;
+        printf("   Reader type: %s (pre-opened)\n", video_file_->getReaderType());
+    } else {
+        std::string error;
+        video_file_ = openSource(config, &error);
+        if (!video_file_) {
+            setError(error);
+            return false;
+        }
+        printf("   Reader type: %s\n", video_file_->getReaderType());
+    }
     
-    // 🎯 统一的open接口（传入所有参数，门面类内部智能判断）
-    // - 对于编码视频（FFMPEG, RTSP）：自动检测格式，width/height/bpp 被忽略
-    // - 对于raw视频（MMAP, IOURING）：使用 width/height/bpp 参数
-    if (!video_file_->open(config.file_path.c_str(), 
-                           config.width, 
-                           config.height, 
-                           config.bits_per_pixel)) {
-        setError("Failed to open video file: " + config.file_path);
-        video_file_.reset();
-        return false;
+    // 推送源：注册事件回调，按事件计数，不再轮询读取接口
+    // 必须先于 setBufferPool() 注册：推送源在注入 BufferPool 时即启动内部线程，
+    // 晚注册会丢失最先发出的事件。是否为推送源要等注入后才能判定，
+    // 因此先无条件注册（拉取型 Reader 忽略回调），判定后再按需注销
+    {
+        std::lock_guard<std::mutex> lock(event_mutex_);
+        pending_frames_ = 0;
+        pending_drops_ = 0;
+        end_of_stream_ = false;
     }
+    video_file_->setSourceEventCallback([this](IVideoReader::SourceEvent event) {
+        onSourceEvent(event);
+    });
     
     // ✨ 注入BufferPool（统一处理，所有Reader都调用）
     // 特殊Reader（如RTSP）会利用此优化，普通Reader会忽略
     video_file_->setBufferPool(&buffer_pool_);
     
+    push_source_ = video_file_->isPushSource();
+    if (!push_source_) {
+        video_file_->setSourceEventCallback(nullptr);
+    }
+    
     total_frames_ = video_file_->getTotalFrames();
     size_t frame_size = video_file_->getFrameSize();
     
@@ -90,7 +158,7 @@ bool VideoProducer::start(const Config& config) {
         printf("   Dynamic injection mode detected, setting buffer size...\n");
         if (!buffer_pool_.setBufferSize(frame_size)) {
             setError("Failed to set buffer size for dynamic injection mode");
-            video_file_.reset();
+            closeSource();
             return false;
         }
     } else if (frame_size != pool_buffer_size) {
@@ -100,13 +168,31 @@ bool VideoProducer::start(const Config& config) {
                 "Frame size mismatch: video=%zu, buffer=%zu",
                 frame_size, pool_buffer_size);
         setError(error_msg);
-        video_file_.reset();
+        closeSource();
         return false;
     } else {
         // 大小匹配
         printf("   Frame size matches BufferPool size: %zu bytes\n", frame_size);
     }
     
+    // 导入的 DMA-BUF pool 默认不建立 CPU 映射：CPU 读取写入 buffer 的 Reader 需要生产者 WRITE 同步
+    // （acquireFree 时映射），否则拿到的虚拟地址为空；只读 fd 永远无法写入，启动时一次性拒绝
+    bool producer_writes = (static_cast<int>(buffer_pool_.getProducerCpuAccess()) &
+                            static_cast<int>(Buffer::CpuAccess::WRITE)) != 0;
+    if (buffer_pool_.isDmaBufImport() && video_file_->requiresExternalBuffer()) {
+        if (!buffer_pool_.isCpuWritable()) {
+            setError("DMA-BUF import pool has read-only fds; CPU readers cannot fill it");
+            closeSource();
+            return false;
+        }
+        if (!producer_writes) {
+            setError("DMA-BUF import pool is device-producer only; "
+                     "call setCpuAccessSync(WRITE, ...) for CPU readers");
+            closeSource();
+            return false;
+        }
+    }
+    
     // 重置状态
     running_ = true;
     produced_frames_ = 0;
@@ -114,11 +200,80 @@ bool VideoProducer::start(const Config& config) {
     next_frame_index_ = 0;
     start_time_ = std::chrono::steady_clock::now();
     
+    // 推送源只需一个事件等待线程（帧由 Reader 线程注入）
+    int thread_count = config.thread_count;
+    if (push_source_) {
+        if (thread_count > 1) {
+            printf("   Push source: using 1 event-driven thread instead of %d\n", thread_count);
+        }
+        thread_count = 1;
+    }
+    
+    // CHUNKED：每个线程一个帧范围；预分配模式按帧序提交，块大小受重排窗口限制
+    lanes_.reset();
+    lane_count_ = 0;
+    parked_.clear();
+    next_submit_ticket_ = 0;
+    next_chunk_ = 0;
+    claimed_chunks_ = 0;
+    stolen_ranges_ = 0;
+    ordered_submit_ = false;
+    
+    // 共享执行器：推送源仍使用自己的事件线程（帧由 Reader 线程注入，不需要读取任务）
+    needs_external_buffer_ = video_file_->requiresExternalBuffer();
+    if (config.executor && !push_source_) {
+        if (total_frames_ <= 0) {
+            setError("Shared executor requires a source with known frame count");
+            running_ = false;
+            closeSource();
+            return false;
+        }
+        if (config.schedule == Schedule::CHUNKED) {
+            printf("   Schedule ignored on shared executor (tasks claim frames in order)\n");
+        }
+        executor_ = config.executor;
+        ordered_submit_ = needs_external_buffer_;
+        next_ticket_ = 0;
+        consecutive_failures_ = 0;
+        executor_source_ = executor_->addSource(buffer_pool_, thread_count,
+                                                [this]() { return executorStep(); });
+        if (executor_source_ < 0) {
+            setError("Failed to register with shared executor");
+            executor_.reset();
+            running_ = false;
+            closeSource();
+            return false;
+        }
+        printf("✅ Producer attached to shared executor (%d workers, source #%d)\n",
+               executor_->getWorkerCount(), executor_source_);
+        return true;
+    }
+    
+    if (config.schedule == Schedule::CHUNKED && !push_source_ && total_frames_ > 0) {
+        lane_count_ = thread_count;
+        lanes_.reset(new Lane[lane_count_]);
+        chunk_frames_ = config.chunk_frames;
+        ordered_submit_ = video_file_->requiresExternalBuffer();
+        if (ordered_submit_) {
+            reorder_window_ = std::max(1, buffer_pool_.getTotalCount() - kConsumerReserve);
+            chunk_frames_ = std::max(1, std::min(chunk_frames_, (int)(reorder_window_ / lane_count_)));
+            printf("   Chunk: %d frames (requested %d), ordered submit, reorder window %lld\n",
+                   chunk_frames_, config.chunk_frames, (long long)reorder_window_);
+        } else {
+            printf("   Chunk: %d frames (self-inject reader, submit order not enforced)\n",
+                   chunk_frames_);
+        }
+    }
+    
     // 启动生产者线程
-    threads_.reserve(config.thread_count);
-    for (int i = 0; i < config.thread_count; i++) {
+    threads_.reserve(thread_count);
+    for (int i = 0; i < thread_count; i++) {
         try {
-            threads_.emplace_back(&VideoProducer::producerThreadFunc, this, i);
+            if (push_source_) {
+                threads_.emplace_back(&VideoProducer::pushSourceThreadFunc, this);
+            } else {
+                threads_.emplace_back(&VideoProducer::producerThreadFunc, this, i);
+            }
             printf("   ✅ Producer thread #%d started\n", i);
         } catch (const std::exception& e) {
             printf("❌ ERROR: Failed to start thread #%d: %s\n", i, e.what());
@@ -130,13 +285,13 @@ bool VideoProducer::start(const Config& config) {
                 }
             }
             threads_.clear();
-            video_file_.reset();
+            closeSource();
             setError(std::string("Failed to start producer thread: ") + e.what());
             return false;
         }
     }
     
-    printf("✅ All %d producer thread(s) started successfully\n", config.thread_count);
+    printf("✅ All %d producer thread(s) started successfully\n", thread_count);
     
     return true;
 }
@@ -149,7 +304,22 @@ void VideoProducer::stop() {
     printf("\n🛑 Stopping VideoProducer...\n");
     
     // 设置停止标志
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(event_mutex_);
+        running_ = false;
+    }
+    event_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(order_mutex_);
+    }
+    order_cv_.notify_all();
+    
+    // 共享执行器：停止派发并等待在途任务结束
+    if (executor_) {
+        executor_->removeSource(executor_source_);
+        executor_source_ = -1;
+        executor_.reset();
+    }
     
     // 等待所有线程退出
     for (auto& thread : threads_) {
@@ -159,15 +329,25 @@ void VideoProducer::stop() {
     }
     threads_.clear();
     
-    // 关闭视频文件
-    if (video_file_) {
-        video_file_.reset();
+    // 归还按序提交暂存的 buffer（前面的帧已不会再来）
+    for (auto& parked : parked_) {
+        if (parked.second) {
+            buffer_pool_.releaseFilled(parked.second);
+        }
     }
+    parked_.clear();
+    
+    // 关闭视频文件（先注销事件回调）
+    closeSource();
     
     printf("✅ VideoProducer stopped\n");
     printf("   Total produced: %d frames\n", produced_frames_.load());
     printf("   Total skipped: %d frames\n", skipped_frames_.load());
     printf("   Average FPS: %.2f\n", getAverageFPS());
+    if (lanes_) {
+        printf("   Chunks: %d claimed, %d stolen ranges\n",
+               claimed_chunks_.load(), stolen_ranges_.load());
+    }
 }
 
 // ============================================================
@@ -197,6 +377,14 @@ int VideoProducer::getTotalFrames() const {
     return total_frames_;
 }
 
+const char* VideoProducer::scheduleToString(Schedule schedule) {
+    switch (schedule) {
+        case Schedule::INTERLEAVED: return "interleaved";
+        case Schedule::CHUNKED:     return "chunked";
+    }
+    return "unknown";
+}
+
 std::string VideoProducer::getLastError() const {
     std::lock_guard<std::mutex> lock(error_mutex_);
     return last_error_;
@@ -209,7 +397,16 @@ void VideoProducer::printStats() const {
     printf("   Skipped frames: %d\n", skipped_frames_.load());
     printf("   Total frames: %d\n", total_frames_);
     printf("   Average FPS: %.2f\n", getAverageFPS());
-    printf("   Thread count: %zu\n", threads_.size());
+    if (usesExecutor()) {
+        printf("   Shared executor: source #%d, up to %d parallel reads\n",
+               executor_source_, config_.thread_count);
+    } else {
+        printf("   Thread count: %zu\n", threads_.size());
+    }
+    if (lanes_) {
+        printf("   Schedule: chunked (%d frames), %d chunks claimed, %d stolen ranges\n",
+               chunk_frames_, claimed_chunks_.load(), stolen_ranges_.load());
+    }
 }
 
 // ============================================================
@@ -230,27 +427,13 @@ void VideoProducer::producerThreadFunc(int thread_id) {
     int consecutive_failures = 0;
     
     while (running_) {
-        // 1. 原子地获取下一个帧索引
-        int frame_index = next_frame_index_.fetch_add(1);
-        
-        // 2. 处理循环模式和文件边界
-        if (frame_index >= total_frames_) {
-            if (config_.loop) {
-                // 循环模式：归一化到 0-total_frames 范围
-                frame_index = frame_index % total_frames_;
-                
-                // 尝试重置计数器，避免整数溢出
-                int current = next_frame_index_.load();
-                if (current > total_frames_ * 2) {
-                    int expected = current;
-                    int new_value = frame_index + 1;
-                    next_frame_index_.compare_exchange_strong(expected, new_value);
-                }
-            } else {
-                // 非循环模式：没有更多帧可读
-                break;
-            }
+        // 1-2. 领取下一帧（INTERLEAVED：原子递增；CHUNKED：本线程的帧范围），处理循环和文件边界
+        int64_t ticket = 0;
+        if (!claimTicket(thread_id, &ticket)) {
+            // 非循环模式：没有更多帧可读（或已停止）
+            break;
         }
+        int frame_index = (int)(ticket % total_frames_);
         
         // 3. 根据 Reader 能力选择不同的流程
         bool read_success = false;
@@ -264,11 +447,27 @@ void VideoProducer::producerThreadFunc(int thread_id) {
                 if (buffer == nullptr && running_) {
                     // 超时但仍在运行，继续等待
                     // printf("   [Thread #%d] Waiting for free buffer...\n", thread_id);
+                    if (poolExhaustedByMapFailures()) {
+                        break;  // 所有 buffer 都无法映射：再等也不会有
+                    }
                 }
             }
             
+            if (running_ && buffer == nullptr) {
+                // 所有线程都会走到这里，只报告一次
+                const char* error_msg = "No BufferPool buffer can be mapped for CPU access";
+                if (getLastError() != error_msg) {
+                    setError(error_msg);
+                }
+                abandonLane(thread_id);
+                break;
+            }
+            
             // 检查是否因为停止信号退出循环
             if (!running_) {
+                if (buffer) {
+                    buffer_pool_.releaseFilled(buffer);
+                }
                 break;
             }
             
@@ -277,12 +476,22 @@ void VideoProducer::producerThreadFunc(int thread_id) {
                 frame_index, buffer->getVirtualAddress(), buffer->size());
             
             if (read_success) {
-                // 读取成功，提交填充好的 buffer
-                buffer_pool_.submitFilled(buffer);
+                if (frame_verifier_) {
+                    frame_verifier_->verify(VerifyPoint::POST_READ, buffer, frame_index);
+                }
             } else {
                 // 读取失败，归还 buffer 到 free 队列
                 // 注意：releaseFilled 会把 buffer 归还到 free 队列（循环利用）
                 buffer_pool_.releaseFilled(buffer);
+                buffer = nullptr;
+            }
+            
+            if (ordered_submit_) {
+                // CHUNKED：按帧序提交（失败的帧只推进序号）
+                submitInOrder(ticket, buffer);
+            } else if (buffer) {
+                // 读取成功，提交填充好的 buffer
+                buffer_pool_.submitFilled(buffer);
             }
             
         } else {
@@ -312,6 +521,7 @@ void VideoProducer::producerThreadFunc(int thread_id) {
                         "Thread #%d: Too many consecutive read failures (%d)",
                         thread_id, consecutive_failures);
                 setError(error_msg);
+                abandonLane(thread_id);
                 break;
             }
             continue;
@@ -335,6 +545,312 @@ void VideoProducer::producerThreadFunc(int thread_id) {
            thread_id, thread_produced, thread_skipped);
 }
 
+ProducerExecutor::StepResult VideoProducer::executorStep() {
+    if (!running_) {
+        return ProducerExecutor::StepResult::FINISHED;
+    }
+    
+    // 先取 buffer 再领 ticket：所有更早的 ticket 都已持有 buffer，按序提交的暂存总能排空
+    Buffer* buffer = nullptr;
+    if (needs_external_buffer_) {
+        buffer = buffer_pool_.acquireFree(false, 0);
+        if (buffer == nullptr) {
+            if (poolExhaustedByMapFailures()) {
+                setError("No BufferPool buffer can be mapped for CPU access");
+                return ProducerExecutor::StepResult::FINISHED;
+            }
+            return ProducerExecutor::StepResult::NO_BUFFER;
+        }
+    }
+    
+    int64_t ticket = next_ticket_.fetch_add(1);
+    if (!config_.loop && ticket >= total_frames_) {
+        if (buffer) {
+            buffer_pool_.releaseFilled(buffer);
+        }
+        return ProducerExecutor::StepResult::FINISHED;
+    }
+    int frame_index = (int)(ticket % total_frames_);
+    
+    bool read_success = false;
+    if (needs_external_buffer_) {
+        read_success = video_file_->readFrameAtThreadSafe(
+            frame_index, buffer->getVirtualAddress(), buffer->size());
+        if (read_success) {
+            if (frame_verifier_) {
+                frame_verifier_->verify(VerifyPoint::POST_READ, buffer, frame_index);
+            }
+        } else {
+            buffer_pool_.releaseFilled(buffer);
+            buffer = nullptr;
+        }
+        submitInOrder(ticket, buffer);
+    } else {
+        // 动态注入模式：Reader 内部注入 buffer
+        read_success = video_file_->readFrameAtThreadSafe(frame_index, nullptr, 0);
+    }
+    
+    if (!read_success) {
+        skipped_frames_.fetch_add(1);
+        printf("⚠️  Executor: Failed to read frame %d/%d\n", frame_index, total_frames_);
+        
+        int failures = consecutive_failures_.fetch_add(1) + 1;
+        if (failures > 10) {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg),
+                    "Too many consecutive read failures (%d)", failures);
+            setError(error_msg);
+            return ProducerExecutor::StepResult::FINISHED;
+        }
+        return ProducerExecutor::StepResult::CONTINUE;
+    }
+    
+    consecutive_failures_ = 0;
+    int produced = produced_frames_.fetch_add(1) + 1;
+    
+    // 定期打印进度（每100帧）
+    if (produced % 100 == 0) {
+        printf("   [Executor] Produced %d frames (%.1f fps)\n", produced, getAverageFPS());
+    }
+    return ProducerExecutor::StepResult::CONTINUE;
+}
+
+bool VideoProducer::claimTicket(int thread_id, int64_t* ticket) {
+    if (!lanes_) {
+        // INTERLEAVED：原子地获取下一个帧索引
+        int frame_index = next_frame_index_.fetch_add(1);
+        if (frame_index >= total_frames_) {
+            if (!config_.loop) {
+                return false;
+            }
+            // 循环模式：归一化到 0-total_frames 范围
+            frame_index = frame_index % total_frames_;
+            
+            // 尝试重置计数器，避免整数溢出
+            int current = next_frame_index_.load();
+            if (current > total_frames_ * 2) {
+                int expected = current;
+                int new_value = frame_index + 1;
+                next_frame_index_.compare_exchange_strong(expected, new_value);
+            }
+        }
+        *ticket = frame_index;
+        return true;
+    }
+    
+    // CHUNKED：从本线程范围的头部取，空了再补充
+    Lane& lane = lanes_[thread_id];
+    while (running_) {
+        bool claimed = false;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            if (lane.begin < lane.end) {
+                *ticket = lane.begin++;
+                claimed = true;
+            }
+        }
+        if (claimed) {
+            return !ordered_submit_ || waitForWindow(*ticket);
+        }
+        if (!refillLane(thread_id)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool VideoProducer::refillLane(int thread_id) {
+    int64_t begin = 0;
+    int64_t end = 0;
+    
+    // 1. 偷取：落后最多（头部 ticket 最小）且剩余不少于半块的线程，取其剩余帧的后一半。
+    //    按序提交时只偷能立即开始的范围：对方若是卡在重排窗口上（消费者慢）而不是读得慢，
+    //    偷过来同样要等，只会把块切碎
+    int64_t min_remaining = std::max(2, chunk_frames_ / 2);
+    int64_t steal_limit = INT64_MAX;
+    if (ordered_submit_) {
+        std::lock_guard<std::mutex> lock(order_mutex_);
+        steal_limit = next_submit_ticket_ + reorder_window_;
+    }
+    int victim = -1;
+    int64_t victim_begin = INT64_MAX;
+    for (int i = 0; i < lane_count_; i++) {
+        if (i == thread_id) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(lanes_[i].mutex);
+        if (lanes_[i].end - lanes_[i].begin >= min_remaining && lanes_[i].begin < victim_begin) {
+            victim = i;
+            victim_begin = lanes_[i].begin;
+        }
+    }
+    if (victim >= 0) {
+        Lane& v = lanes_[victim];
+        std::lock_guard<std::mutex> lock(v.mutex);
+        if (v.end - v.begin >= min_remaining && v.begin + (v.end - v.begin) / 2 < steal_limit) {
+            begin = v.begin + (v.end - v.begin) / 2;
+            end = v.end;
+            v.end = begin;
+            stolen_ranges_.fetch_add(1);
+        }
+    }
+    
+    // 2. 领新块
+    if (begin == end) {
+        int64_t chunk = next_chunk_.fetch_add(1);
+        begin = chunk * chunk_frames_;
+        end = begin + chunk_frames_;
+        if (!config_.loop) {
+            if (begin >= total_frames_) {
+                return false;
+            }
+            end = std::min<int64_t>(end, total_frames_);
+        }
+        claimed_chunks_.fetch_add(1);
+    }
+    
+    hintRange(begin, end);
+    
+    std::lock_guard<std::mutex> lock(lanes_[thread_id].mutex);
+    lanes_[thread_id].begin = begin;
+    lanes_[thread_id].end = end;
+    return true;
+}
+
+void VideoProducer::hintRange(int64_t begin, int64_t end) const {
+    // 循环模式下 ticket 范围可能跨过文件末尾，拆成两段
+    while (begin < end) {
+        int frame = (int)(begin % total_frames_);
+        int count = (int)std::min<int64_t>(end - begin, total_frames_ - frame);
+        video_file_->readaheadHint(frame, count);
+        begin += count;
+    }
+}
+
+bool VideoProducer::waitForWindow(int64_t ticket) {
+    std::unique_lock<std::mutex> lock(order_mutex_);
+    while (running_ && ticket >= next_submit_ticket_ + reorder_window_) {
+        order_cv_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    return running_;
+}
+
+void VideoProducer::submitInOrder(int64_t ticket, Buffer* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(order_mutex_);
+        if (ticket != next_submit_ticket_) {
+            parked_[ticket] = buffer;
+            return;
+        }
+        
+        // 在锁内提交，两个线程先后刷新时不会交错
+        if (buffer) {
+            buffer_pool_.submitFilled(buffer);
+        }
+        next_submit_ticket_++;
+        auto it = parked_.begin();
+        while (it != parked_.end() && it->first == next_submit_ticket_) {
+            if (it->second) {
+                buffer_pool_.submitFilled(it->second);
+            }
+            next_submit_ticket_++;
+            it = parked_.erase(it);
+        }
+    }
+    order_cv_.notify_all();
+}
+
+void VideoProducer::abandonLane(int thread_id) {
+    if (!lanes_) {
+        return;
+    }
+    int64_t begin = 0;
+    int64_t end = 0;
+    {
+        std::lock_guard<std::mutex> lock(lanes_[thread_id].mutex);
+        begin = lanes_[thread_id].begin;
+        end = lanes_[thread_id].end;
+        lanes_[thread_id].begin = end;
+    }
+    if (ordered_submit_) {
+        for (int64_t ticket = begin; ticket < end; ticket++) {
+            submitInOrder(ticket, nullptr);
+        }
+    }
+}
+
+void VideoProducer::pushSourceThreadFunc() {
+    printf("🚀 Push-source thread: waiting for frames from %s\n", video_file_->getReaderType());
+    
+    int last_report = 0;
+    std::unique_lock<std::mutex> lock(event_mutex_);
+    
+    while (running_) {
+        // 睡眠直到 Reader 注入帧、流结束或停止
+        event_cv_.wait_for(lock, std::chrono::milliseconds(500), [this] {
+            return pending_frames_ > 0 || pending_drops_ > 0 || end_of_stream_ || !running_;
+        });
+        
+        int frames = pending_frames_;
+        int drops = pending_drops_;
+        bool eos = end_of_stream_;
+        pending_frames_ = 0;
+        pending_drops_ = 0;
+        
+        lock.unlock();
+        if (frames > 0) {
+            int produced = produced_frames_.fetch_add(frames) + frames;
+            // 定期打印进度（每100帧）
+            if (produced / 100 != last_report / 100) {
+                printf("   [Push] Produced %d frames (%.1f fps)\n", produced, getAverageFPS());
+            }
+            last_report = produced;
+        }
+        if (drops > 0) {
+            skipped_frames_.fetch_add(drops);
+        }
+        if (eos) {
+            printf("🏁 Push source reached end of stream\n");
+            break;
+        }
+        lock.lock();
+    }
+    
+    printf("🏁 Push-source thread finished: produced=%d, dropped=%d\n",
+           produced_frames_.load(), skipped_frames_.load());
+}
+
+bool VideoProducer::poolExhaustedByMapFailures() const {
+    int unmappable = buffer_pool_.getUnmappableCount();
+    return unmappable > 0 && unmappable >= buffer_pool_.getTotalCount();
+}
+
+void VideoProducer::closeSource() {
+    if (!video_file_) {
+        return;
+    }
+    video_file_->setSourceEventCallback(nullptr);
+    video_file_.reset();
+}
+
+void VideoProducer::onSourceEvent(IVideoReader::SourceEvent event) {
+    {
+        std::lock_guard<std::mutex> lock(event_mutex_);
+        switch (event) {
+            case IVideoReader::SourceEvent::FRAME_AVAILABLE:
+                pending_frames_++;
+                break;
+            case IVideoReader::SourceEvent::FRAME_DROPPED:
+                pending_drops_++;
+                break;
+            case IVideoReader::SourceEvent::END_OF_STREAM:
+                end_of_stream_ = true;
+                break;
+        }
+    }
+    event_cv_.notify_one();
+}
+
 void VideoProducer::setError(const std::string& error_msg) {
     // 保存错误消息
     {
@@ -0,0 +1,410 @@
+#include "../../include/sink/RawDumpSink.hpp"
+#include "../../include/cpu/MemoryKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// O_DIRECT 要求的地址/长度/偏移对齐（覆盖常见设备的逻辑块大小）
+static const size_t kDirectIoAlignment = 4096;
+
+// ============ 构造/析构 ============
+
+RawDumpSink::RawDumpSink()
+    : frame_size_(0)
+    , block_size_(kDirectIoAlignment)
+    , direct_io_(false)
+    , fd_(-1)
+    , ring_initialized_(false)
+    , inflight_(0)
+    , pool_(nullptr)
+    , observer_id_(-1)
+    , next_frame_index_(0)
+    , outstanding_(0)
+    , running_(false)
+    , frames_written_(0)
+    , frames_dropped_(0)
+    , bytes_written_(0)
+    , zero_copy_frames_(0)
+    , bounce_frames_(0)
+    , submit_calls_(0)
+    , write_errors_(0)
+    , write_time_us_(0)
+    , peak_inflight_(0)
+{
+    memset(&ring_, 0, sizeof(ring_));
+}
+
+RawDumpSink::~RawDumpSink() {
+    stop();
+}
+
+// ============ 生命周期 ============
+
+bool RawDumpSink::start(const Config& config, BufferPool& pool) {
+    if (running_) {
+        printf("⚠️  Warning: RawDumpSink already running\n");
+        return false;
+    }
+
+    if (config.output_path.empty() || config.max_inflight < 1 ||
+        config.batch_size < 1 || config.bounce_buffers < 0) {
+        printf("❌ ERROR: Invalid RawDumpSink configuration\n");
+        return false;
+    }
+
+    config_ = config;
+    frame_size_ = config_.frame_size > 0 ? config_.frame_size : pool.getBufferSize();
+    if (frame_size_ == 0) {
+        printf("❌ ERROR: Frame size unknown (pool buffer size not set, specify Config::frame_size)\n");
+        return false;
+    }
+    if (pool.getBufferSize() != 0 && pool.getBufferSize() < frame_size_) {
+        printf("❌ ERROR: Frame size %zu exceeds pool buffer size %zu\n",
+               frame_size_, pool.getBufferSize());
+        return false;
+    }
+
+    // 1. 打开输出文件（帧大小不是块大小整数倍时无法使用 O_DIRECT）
+    direct_io_ = config_.use_direct_io && (frame_size_ % block_size_ == 0);
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    fd_ = ::open(config_.output_path.c_str(), flags | (direct_io_ ? O_DIRECT : 0), 0644);
+    if (fd_ < 0 && direct_io_ && errno == EINVAL) {
+        // 文件系统不支持 O_DIRECT（如 tmpfs），退回缓冲 I/O
+        direct_io_ = false;
+        fd_ = ::open(config_.output_path.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        printf("❌ ERROR: Cannot open %s: %s\n", config_.output_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    // 2. 初始化 io_uring（在途请求数不超过 max_inflight）
+    int ret = io_uring_queue_init(config_.max_inflight, &ring_, 0);
+    if (ret < 0) {
+        printf("❌ ERROR: io_uring_queue_init failed: %s\n", strerror(-ret));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    ring_initialized_ = true;
+
+    // 3. 预分配请求对象和对齐 bounce buffer
+    requests_.assign(config_.max_inflight, WriteRequest());
+    free_requests_.clear();
+    for (auto& request : requests_) {
+        free_requests_.push_back(&request);
+    }
+    pending_.clear();
+
+    bounce_.clear();
+    free_bounce_.clear();
+    for (int i = 0; i < config_.bounce_buffers; i++) {
+        void* addr = nullptr;
+        ret = posix_memalign(&addr, block_size_, frame_size_);
+        if (ret != 0) {
+            printf("⚠️  Warning: bounce buffer allocation failed: %s\n", strerror(ret));
+            break;
+        }
+        free_bounce_.push_back(static_cast<int>(bounce_.size()));
+        bounce_.push_back(addr);
+    }
+
+    next_frame_index_ = 0;
+    outstanding_ = 0;
+    inflight_ = 0;
+    frames_written_ = 0;
+    frames_dropped_ = 0;
+    bytes_written_ = 0;
+    zero_copy_frames_ = 0;
+    bounce_frames_ = 0;
+    submit_calls_ = 0;
+    write_errors_ = 0;
+    write_time_us_ = 0;
+    peak_inflight_ = 0;
+    start_time_ = std::chrono::steady_clock::now();
+
+    // 4. 启动写盘线程并挂接到 pool
+    running_ = true;
+    writer_thread_ = std::thread(&RawDumpSink::writerThreadFunc, this);
+
+    pool_ = &pool;
+    observer_id_ = pool.addFrameObserver([this](const Buffer* buffer) {
+        onFrame(buffer);
+    });
+
+    printf("✅ RawDumpSink started: %s\n", config_.output_path.c_str());
+    printf("   Frame size: %zu bytes, O_DIRECT: %s\n", frame_size_, direct_io_ ? "yes" : "no");
+    printf("   Max inflight: %d, batch: %d, bounce buffers: %zu\n",
+           config_.max_inflight, config_.batch_size, bounce_.size());
+    return true;
+}
+
+void RawDumpSink::stop() {
+    // 1. 分离观察者（返回后 onFrame 不再被调用）
+    if (pool_ && observer_id_ >= 0) {
+        pool_->removeFrameObserver(observer_id_);
+        observer_id_ = -1;
+    }
+
+    if (!running_) {
+        return;
+    }
+
+    // 2. 通知写盘线程：写完 pending 和在途请求后退出
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    stop_time_ = std::chrono::steady_clock::now();
+
+    // 3. 释放资源
+    if (ring_initialized_) {
+        io_uring_queue_exit(&ring_);
+        ring_initialized_ = false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    for (void* addr : bounce_) {
+        free(addr);
+    }
+    bounce_.clear();
+    free_bounce_.clear();
+    pool_ = nullptr;
+
+    printStats();
+}
+
+// ============ 帧输入（显示线程） ============
+
+void RawDumpSink::onFrame(const Buffer* buffer) {
+    if (!running_ || !buffer || !buffer->data() || buffer->size() < frame_size_) {
+        return;
+    }
+
+    WriteRequest* request = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (config_.max_frames > 0 && next_frame_index_ >= (uint64_t)config_.max_frames) {
+            return;
+        }
+
+        // 背压：在途帧数达到上限时丢帧，不阻塞显示线程
+        if (outstanding_ >= config_.max_inflight || free_requests_.empty()) {
+            frames_dropped_++;
+            return;
+        }
+
+        request = free_requests_.back();
+        request->retained = nullptr;
+        request->bounce_index = -1;
+
+        // 优先零拷贝：保留 pool buffer 直接写盘
+        if ((!direct_io_ || isAligned(buffer->data())) && pool_->retainBuffer(buffer)) {
+            request->retained = buffer;
+            request->data = static_cast<const uint8_t*>(buffer->data());
+        } else if (!free_bounce_.empty()) {
+            request->bounce_index = free_bounce_.back();
+            free_bounce_.pop_back();
+            request->data = static_cast<const uint8_t*>(bounce_[request->bounce_index]);
+        } else {
+            frames_dropped_++;
+            return;
+        }
+
+        free_requests_.pop_back();
+        request->length = frame_size_;
+        request->offset = (off_t)(next_frame_index_++ * frame_size_);
+        outstanding_++;
+        if (outstanding_ > peak_inflight_) {
+            peak_inflight_ = outstanding_;
+        }
+    }
+
+    // bounce 拷贝在锁外进行（回调返回后 buffer 即被回收）
+    if (request->bounce_index >= 0) {
+        MemoryKernels::copy(bounce_[request->bounce_index], buffer->data(), frame_size_);
+        bounce_frames_++;
+    } else {
+        zero_copy_frames_++;
+    }
+    request->enqueue_time = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(request);
+    }
+    cv_.notify_one();
+}
+
+bool RawDumpSink::isAligned(const void* addr) const {
+    return (reinterpret_cast<uintptr_t>(addr) % block_size_) == 0;
+}
+
+// ============ 写盘线程 ============
+
+void RawDumpSink::writerThreadFunc() {
+    std::deque<WriteRequest*> batch;   // 待提交（含短写后需续写的请求）
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (pending_.empty() && batch.empty() && inflight_ == 0) {
+                if (!running_) {
+                    break;   // 已停止且全部写完
+                }
+                cv_.wait_for(lock, std::chrono::milliseconds(100),
+                             [this] { return !pending_.empty() || !running_; });
+                continue;
+            }
+
+            while (!pending_.empty() && (int)batch.size() < config_.batch_size) {
+                batch.push_back(pending_.front());
+                pending_.pop_front();
+            }
+        }
+
+        // 批量提交：多个写请求共用一次 io_uring_submit
+        bool submitted = !batch.empty();
+        if (submitted) {
+            submitBatch(batch);
+        }
+
+        // 没有新请求可提交时阻塞等待完成，否则只收割已完成的
+        if (inflight_ > 0) {
+            reapCompletions(batch, !submitted);
+        }
+    }
+}
+
+void RawDumpSink::submitBatch(std::deque<WriteRequest*>& batch) {
+    int prepared = 0;
+    while (!batch.empty()) {
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            break;   // SQ 已满，剩余请求下轮提交
+        }
+        WriteRequest* request = batch.front();
+        batch.pop_front();
+
+        io_uring_prep_write(sqe, fd_, request->data, request->length, request->offset);
+        io_uring_sqe_set_data(sqe, request);
+        prepared++;
+    }
+
+    if (prepared == 0) {
+        return;
+    }
+
+    inflight_ += prepared;
+    int ret = io_uring_submit(&ring_);
+    submit_calls_++;
+    if (ret < 0) {
+        // 未被内核接收的 SQE 留在 SQ 中，由 reapCompletions 的 submit_and_wait 重试
+        printf("⚠️  Warning: io_uring_submit failed: %s\n", strerror(-ret));
+    }
+}
+
+void RawDumpSink::reapCompletions(std::deque<WriteRequest*>& batch, bool wait) {
+    if (wait) {
+        int ret = io_uring_submit_and_wait(&ring_, 1);
+        if (ret < 0 && ret != -EINTR) {
+            printf("⚠️  Warning: io_uring_submit_and_wait failed: %s\n", strerror(-ret));
+        }
+    }
+
+    struct io_uring_cqe* cqe;
+    while (io_uring_peek_cqe(&ring_, &cqe) == 0) {
+        WriteRequest* request = static_cast<WriteRequest*>(io_uring_cqe_get_data(cqe));
+        int res = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        inflight_--;
+
+        if (res < 0) {
+            printf("❌ ERROR: Dump write failed at offset %lld: %s\n",
+                   (long long)request->offset, strerror(-res));
+            completeRequest(request, false);
+        } else if ((size_t)res < request->length) {
+            // 短写：续写剩余部分
+            request->data += res;
+            request->length -= res;
+            request->offset += res;
+            batch.push_front(request);
+        } else {
+            completeRequest(request, true);
+        }
+    }
+}
+
+void RawDumpSink::completeRequest(WriteRequest* request, bool success) {
+    if (success) {
+        frames_written_++;
+        bytes_written_ += frame_size_;
+        write_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - request->enqueue_time).count();
+    } else {
+        write_errors_++;
+    }
+
+    // 零拷贝：写完才把 buffer 还给 pool
+    if (request->retained) {
+        pool_->releaseRetained(request->retained);
+        request->retained = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (request->bounce_index >= 0) {
+        free_bounce_.push_back(request->bounce_index);
+        request->bounce_index = -1;
+    }
+    free_requests_.push_back(request);
+    outstanding_--;
+}
+
+// ============ 统计 ============
+
+RawDumpSink::Stats RawDumpSink::getStats() const {
+    Stats stats;
+    stats.frames_written = frames_written_.load();
+    stats.frames_dropped = frames_dropped_.load();
+    stats.bytes_written = bytes_written_.load();
+    stats.zero_copy_frames = zero_copy_frames_.load();
+    stats.bounce_frames = bounce_frames_.load();
+    stats.submit_calls = submit_calls_.load();
+    stats.write_errors = write_errors_.load();
+    stats.peak_inflight = peak_inflight_.load();
+    stats.avg_write_ms = stats.frames_written > 0
+        ? write_time_us_.load() / 1000.0 / stats.frames_written : 0.0;
+
+    auto end = running_ ? std::chrono::steady_clock::now() : stop_time_;
+    double seconds = std::chrono::duration<double>(end - start_time_).count();
+    stats.throughput_mbps = seconds > 0 ? stats.bytes_written / (1024.0 * 1024.0) / seconds : 0.0;
+    return stats;
+}
+
+void RawDumpSink::printStats() const {
+    Stats stats = getStats();
+    uint64_t offered = stats.frames_written + stats.frames_dropped + stats.write_errors;
+
+    printf("\n📊 RawDumpSink Statistics:\n");
+    printf("   Output: %s (O_DIRECT: %s)\n", config_.output_path.c_str(), direct_io_ ? "yes" : "no");
+    printf("   Frames written: %llu (zero-copy %llu, bounce %llu)\n",
+           (unsigned long long)stats.frames_written,
+           (unsigned long long)stats.zero_copy_frames,
+           (unsigned long long)stats.bounce_frames);
+    printf("   Frames dropped: %llu (%.1f%%)\n", (unsigned long long)stats.frames_dropped,
+           offered > 0 ? 100.0 * stats.frames_dropped / offered : 0.0);
+    printf("   Write errors: %llu\n", (unsigned long long)stats.write_errors);
+    printf("   Written: %.2f MB, throughput %.1f MB/s\n",
+           stats.bytes_written / (1024.0 * 1024.0), stats.throughput_mbps);
+    printf("   Avg write latency: %.2f ms, peak inflight: %d, submits: %llu\n",
+           stats.avg_write_ms, stats.peak_inflight, (unsigned long long)stats.submit_calls);
+}
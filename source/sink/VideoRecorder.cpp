@@ -0,0 +1,534 @@
+#include "../../include/sink/VideoRecorder.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/dict.h>
+#include <libswscale/swscale.h>
+}
+
+/**
+ * 将 PixelFormat 映射为 FFmpeg 像素格式
+ * @return AV_PIX_FMT_NONE 表示 FFmpeg 无对应格式（需先转换为 ARGB8888）
+ */
+static AVPixelFormat toAVPixelFormat(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::ARGB8888: return AV_PIX_FMT_BGRA;
+        case PixelFormat::XRGB8888: return AV_PIX_FMT_BGR0;
+        case PixelFormat::ABGR8888: return AV_PIX_FMT_RGBA;
+        case PixelFormat::BGR24:    return AV_PIX_FMT_BGR24;
+        case PixelFormat::RGB24:    return AV_PIX_FMT_RGB24;
+        case PixelFormat::RGB565:   return AV_PIX_FMT_RGB565LE;
+        case PixelFormat::BGR565:   return AV_PIX_FMT_BGR565LE;
+        case PixelFormat::ARGB4444: return AV_PIX_FMT_RGB444LE;   // alpha 位忽略
+        case PixelFormat::NV12:     return AV_PIX_FMT_NV12;
+        case PixelFormat::NV21:     return AV_PIX_FMT_NV21;
+        case PixelFormat::I420:     return AV_PIX_FMT_YUV420P;
+        case PixelFormat::YUYV:     return AV_PIX_FMT_YUYV422;
+        case PixelFormat::UYVY:     return AV_PIX_FMT_UYVY422;
+        default:                    return AV_PIX_FMT_NONE;      // 如 12bpp 紧凑 RGB444
+    }
+}
+
+// ============ 构造/析构 ============
+
+VideoRecorder::VideoRecorder()
+    : frame_size_(0)
+    , format_ctx_(nullptr)
+    , codec_ctx_(nullptr)
+    , stream_(nullptr)
+    , yuv_frame_(nullptr)
+    , packet_(nullptr)
+    , sws_ctx_(nullptr)
+    , sws_src_format_(AV_PIX_FMT_NONE)
+    , last_pts_(-1)
+    , first_frame_(true)
+    , running_(false)
+    , captured_frames_(0)
+    , dropped_frames_(0)
+    , encoded_frames_(0)
+    , written_packets_(0)
+    , written_bytes_(0)
+    , encode_time_us_(0)
+{
+}
+
+VideoRecorder::~VideoRecorder() {
+    stop();
+}
+
+// ============ 生命周期 ============
+
+bool VideoRecorder::start(const Config& config) {
+    if (running_) {
+        printf("⚠️  Warning: VideoRecorder already running\n");
+        return false;
+    }
+
+    if (config.output_path.empty() || config.width <= 0 || config.height <= 0 ||
+        config.fps <= 0 || config.queue_depth < 1) {
+        setError("Invalid recorder configuration");
+        return false;
+    }
+
+    config_ = config;
+    frame_size_ = PixelConverter::frameSize(config_.input_format, config_.width, config_.height);
+    if (frame_size_ == 0) {
+        setError("Unsupported input pixel format");
+        return false;
+    }
+
+    printf("\n🎥 Starting VideoRecorder...\n");
+    printf("   Output: %s\n", config_.output_path.c_str());
+    printf("   Input: %dx%d %s (%zu bytes/frame)\n", config_.width, config_.height,
+           PixelConverter::formatName(config_.input_format), frame_size_);
+    printf("   Rate: %d fps, %lld bps, GOP %d\n", config_.fps,
+           (long long)config_.bit_rate, config_.gop_size);
+    printf("   Queue depth: %d frames (drop when full)\n", config_.queue_depth);
+
+    if (!openOutput()) {
+        closeOutput();
+        return false;
+    }
+
+    // 一次性分配所有槽位，运行期不再分配内存
+    slots_.clear();
+    free_slots_.clear();
+    pending_.clear();
+    for (int i = 0; i < config_.queue_depth; i++) {
+        std::unique_ptr<FrameSlot> slot(new FrameSlot());
+        slot->data.resize(frame_size_);
+        free_slots_.push_back(slot.get());
+        slots_.push_back(std::move(slot));
+    }
+
+    captured_frames_ = 0;
+    dropped_frames_ = 0;
+    encoded_frames_ = 0;
+    written_packets_ = 0;
+    written_bytes_ = 0;
+    encode_time_us_ = 0;
+    last_pts_ = -1;
+    first_frame_ = true;
+
+    running_ = true;
+    encoder_thread_ = std::thread(&VideoRecorder::encoderThreadFunc, this);
+
+    printf("✅ VideoRecorder started (encoder: %s)\n", codec_ctx_->codec->name);
+    return true;
+}
+
+void VideoRecorder::stop() {
+    // 1. 分离所有 pool（返回后观察者回调不再被调用）
+    {
+        std::lock_guard<std::mutex> lock(attach_mutex_);
+        for (auto& entry : attached_pools_) {
+            entry.first->removeFrameObserver(entry.second);
+        }
+        attached_pools_.clear();
+    }
+
+    if (!running_) {
+        return;
+    }
+
+    printf("\n🛑 Stopping VideoRecorder...\n");
+
+    // 2. 通知编码线程：处理完 pending 队列后退出
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (encoder_thread_.joinable()) {
+        encoder_thread_.join();
+    }
+
+    // 3. 刷新编码器并写文件尾
+    if (codec_ctx_) {
+        avcodec_send_frame(codec_ctx_, nullptr);
+        drainPackets();
+    }
+    if (format_ctx_) {
+        av_write_trailer(format_ctx_);
+    }
+
+    closeOutput();
+    printStats();
+}
+
+// ============ 帧输入 ============
+
+bool VideoRecorder::attach(BufferPool& pool) {
+    std::lock_guard<std::mutex> lock(attach_mutex_);
+    for (auto& entry : attached_pools_) {
+        if (entry.first == &pool) {
+            return true;
+        }
+    }
+
+    if (pool.getBufferSize() != 0 && pool.getBufferSize() < frame_size_) {
+        setError("Pool buffer size smaller than recorder frame size");
+        return false;
+    }
+
+    int id = pool.addFrameObserver([this](const Buffer* buffer) {
+        submitFrame(buffer);
+    });
+    if (id < 0) {
+        return false;
+    }
+    attached_pools_.emplace_back(&pool, id);
+    return true;
+}
+
+bool VideoRecorder::detach(BufferPool& pool) {
+    std::lock_guard<std::mutex> lock(attach_mutex_);
+    for (auto it = attached_pools_.begin(); it != attached_pools_.end(); ++it) {
+        if (it->first == &pool) {
+            pool.removeFrameObserver(it->second);
+            attached_pools_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VideoRecorder::submitFrame(const Buffer* buffer) {
+    if (!buffer || !buffer->data()) {
+        return false;
+    }
+    return submitFrame(buffer->data(), buffer->size());
+}
+
+bool VideoRecorder::submitFrame(const void* data, size_t size) {
+    if (!running_ || !data || size < frame_size_) {
+        return false;
+    }
+
+    // 1. 取空闲槽位（无空闲 = 编码跟不上 → 丢帧，不阻塞调用者）
+    FrameSlot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (free_slots_.empty()) {
+            dropped_frames_++;
+            return false;
+        }
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    // 2. 锁外拷贝
+    memcpy(slot->data.data(), data, frame_size_);
+    slot->capture_time = std::chrono::steady_clock::now();
+
+    // 3. 入队
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending_.push_back(slot);
+    }
+    queue_cv_.notify_one();
+    captured_frames_++;
+    return true;
+}
+
+// ============ 编码线程 ============
+
+void VideoRecorder::encoderThreadFunc() {
+    while (true) {
+        FrameSlot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !pending_.empty() || !running_; });
+            if (pending_.empty()) {
+                break;   // 已停止且队列清空
+            }
+            slot = pending_.front();
+            pending_.pop_front();
+        }
+
+        encodeSlot(slot);
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            free_slots_.push_back(slot);
+        }
+    }
+}
+
+bool VideoRecorder::encodeSlot(FrameSlot* slot) {
+    auto t0 = std::chrono::steady_clock::now();
+
+    // 1. FFmpeg 无对应格式时先转换为 ARGB8888
+    const uint8_t* src = slot->data.data();
+    if (pre_converter_) {
+        if (!pre_converter_->convert(src, frame_size_, staging_.data(), staging_.size())) {
+            return false;
+        }
+        src = staging_.data();
+    }
+
+    // 2. 转换为编码器像素格式（写入复用的 yuv_frame_）
+    uint8_t* src_planes[4];
+    int src_linesize[4];
+    av_image_fill_arrays(src_planes, src_linesize, src, (AVPixelFormat)sws_src_format_,
+                         config_.width, config_.height, 1);
+
+    int ret = av_frame_make_writable(yuv_frame_);   // 编码器可能仍引用上一帧
+    if (ret < 0) {
+        setError("av_frame_make_writable failed", ret);
+        return false;
+    }
+    sws_scale(sws_ctx_, src_planes, src_linesize, 0, config_.height,
+              yuv_frame_->data, yuv_frame_->linesize);
+
+    // 3. PTS 取自捕获时刻，保证单调递增
+    if (first_frame_) {
+        start_time_ = slot->capture_time;
+        first_frame_ = false;
+    }
+    double seconds = std::chrono::duration<double>(slot->capture_time - start_time_).count();
+    int64_t pts = llround(seconds * config_.fps);
+    if (pts <= last_pts_) {
+        pts = last_pts_ + 1;
+    }
+    last_pts_ = pts;
+    yuv_frame_->pts = pts;
+
+    // 4. 编码并写入
+    ret = avcodec_send_frame(codec_ctx_, yuv_frame_);
+    if (ret < 0) {
+        setError("avcodec_send_frame failed", ret);
+        return false;
+    }
+    bool ok = drainPackets();
+
+    encoded_frames_++;
+    encode_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    return ok;
+}
+
+bool VideoRecorder::drainPackets() {
+    while (true) {
+        int ret = avcodec_receive_packet(codec_ctx_, packet_);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            return true;
+        }
+        if (ret < 0) {
+            setError("avcodec_receive_packet failed", ret);
+            return false;
+        }
+
+        av_packet_rescale_ts(packet_, codec_ctx_->time_base, stream_->time_base);
+        packet_->stream_index = stream_->index;
+        written_packets_++;
+        written_bytes_ += packet_->size;
+
+        // av_interleaved_write_frame 接管包内容并重置 packet_
+        ret = av_interleaved_write_frame(format_ctx_, packet_);
+        if (ret < 0) {
+            setError("av_interleaved_write_frame failed", ret);
+            return false;
+        }
+    }
+}
+
+// ============ FFmpeg 初始化/清理 ============
+
+bool VideoRecorder::openOutput() {
+    const char* path = config_.output_path.c_str();
+
+    // 1. 输出容器（由扩展名推断：.mp4 / .mkv / ...）
+    int ret = avformat_alloc_output_context2(&format_ctx_, nullptr, nullptr, path);
+    if (ret < 0 || !format_ctx_) {
+        setError("Cannot deduce output format from file name", ret);
+        return false;
+    }
+
+    // 2. 编码器
+    const AVCodec* codec = nullptr;
+    if (!config_.codec_name.empty()) {
+        codec = avcodec_find_encoder_by_name(config_.codec_name.c_str());
+    } else {
+        codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+        if (!codec) {
+            codec = avcodec_find_encoder(format_ctx_->oformat->video_codec);
+        }
+    }
+    if (!codec) {
+        setError("Video encoder not found");
+        return false;
+    }
+
+    stream_ = avformat_new_stream(format_ctx_, nullptr);
+    if (!stream_) {
+        setError("avformat_new_stream failed");
+        return false;
+    }
+
+    // 3. 打开编码器：优先 YUV420P，失败时尝试 NV12（部分硬件编码器只支持 NV12）
+    const AVPixelFormat candidates[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12 };
+    for (AVPixelFormat pix_fmt : candidates) {
+        avcodec_free_context(&codec_ctx_);
+        codec_ctx_ = avcodec_alloc_context3(codec);
+        if (!codec_ctx_) {
+            setError("avcodec_alloc_context3 failed");
+            return false;
+        }
+
+        codec_ctx_->width = config_.width;
+        codec_ctx_->height = config_.height;
+        codec_ctx_->pix_fmt = pix_fmt;
+        codec_ctx_->time_base = AVRational{1, config_.fps};
+        codec_ctx_->framerate = AVRational{config_.fps, 1};
+        codec_ctx_->bit_rate = config_.bit_rate;
+        codec_ctx_->gop_size = config_.gop_size;
+        codec_ctx_->max_b_frames = 0;            // 低延迟，PTS 与 DTS 一致
+        codec_ctx_->thread_count = config_.encoder_threads;
+        if (format_ctx_->oformat->flags & AVFMT_GLOBALHEADER) {
+            codec_ctx_->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+
+        AVDictionary* opts = nullptr;
+        if (!config_.encoder_options.empty()) {
+            av_dict_parse_string(&opts, config_.encoder_options.c_str(), "=", ":", 0);
+        }
+        ret = avcodec_open2(codec_ctx_, codec, &opts);
+        av_dict_free(&opts);
+        if (ret >= 0) {
+            break;
+        }
+    }
+    if (ret < 0) {
+        setError("avcodec_open2 failed", ret);
+        return false;
+    }
+
+    stream_->time_base = codec_ctx_->time_base;
+    ret = avcodec_parameters_from_context(stream_->codecpar, codec_ctx_);
+    if (ret < 0) {
+        setError("avcodec_parameters_from_context failed", ret);
+        return false;
+    }
+
+    // 4. 打开文件并写文件头
+    if (!(format_ctx_->oformat->flags & AVFMT_NOFILE)) {
+        ret = avio_open(&format_ctx_->pb, path, AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            setError("avio_open failed", ret);
+            return false;
+        }
+    }
+    ret = avformat_write_header(format_ctx_, nullptr);
+    if (ret < 0) {
+        setError("avformat_write_header failed", ret);
+        return false;
+    }
+
+    // 5. 复用的编码输入帧和输出包
+    yuv_frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!yuv_frame_ || !packet_) {
+        setError("Failed to allocate AVFrame/AVPacket");
+        return false;
+    }
+    yuv_frame_->format = codec_ctx_->pix_fmt;
+    yuv_frame_->width = config_.width;
+    yuv_frame_->height = config_.height;
+    ret = av_frame_get_buffer(yuv_frame_, 0);
+    if (ret < 0) {
+        setError("av_frame_get_buffer failed", ret);
+        return false;
+    }
+
+    // 6. 输入格式转换
+    AVPixelFormat src_fmt = toAVPixelFormat(config_.input_format);
+    if (src_fmt == AV_PIX_FMT_NONE) {
+        pre_converter_.reset(new PixelConverter(config_.input_format, PixelFormat::ARGB8888,
+                                                config_.width, config_.height));
+        if (!pre_converter_->isSupported()) {
+            setError("Unsupported recorder input format");
+            return false;
+        }
+        staging_.resize(PixelConverter::frameSize(PixelFormat::ARGB8888, config_.width, config_.height));
+        src_fmt = AV_PIX_FMT_BGRA;
+    }
+    sws_src_format_ = src_fmt;
+
+    sws_ctx_ = sws_getContext(config_.width, config_.height, src_fmt,
+                              config_.width, config_.height, codec_ctx_->pix_fmt,
+                              SWS_POINT, nullptr, nullptr, nullptr);
+    if (!sws_ctx_) {
+        setError("sws_getContext failed");
+        return false;
+    }
+
+    return true;
+}
+
+void VideoRecorder::closeOutput() {
+    if (sws_ctx_) {
+        sws_freeContext(sws_ctx_);
+        sws_ctx_ = nullptr;
+    }
+    av_frame_free(&yuv_frame_);
+    av_packet_free(&packet_);
+    avcodec_free_context(&codec_ctx_);
+
+    if (format_ctx_) {
+        if (!(format_ctx_->oformat->flags & AVFMT_NOFILE) && format_ctx_->pb) {
+            avio_closep(&format_ctx_->pb);
+        }
+        avformat_free_context(format_ctx_);
+        format_ctx_ = nullptr;
+    }
+    stream_ = nullptr;
+    pre_converter_.reset();
+    staging_.clear();
+}
+
+// ============ 统计 ============
+
+VideoRecorder::Stats VideoRecorder::getStats() const {
+    Stats stats;
+    stats.captured_frames = captured_frames_.load();
+    stats.dropped_frames = dropped_frames_.load();
+    stats.encoded_frames = encoded_frames_.load();
+    stats.written_packets = written_packets_.load();
+    stats.written_bytes = written_bytes_.load();
+    stats.avg_encode_ms = stats.encoded_frames > 0
+        ? encode_time_us_.load() / 1000.0 / stats.encoded_frames : 0.0;
+    return stats;
+}
+
+void VideoRecorder::printStats() const {
+    Stats stats = getStats();
+    uint64_t offered = stats.captured_frames + stats.dropped_frames;
+
+    printf("\n📊 VideoRecorder Statistics:\n");
+    printf("   Output: %s\n", config_.output_path.c_str());
+    printf("   Captured frames: %llu\n", (unsigned long long)stats.captured_frames);
+    printf("   Dropped frames: %llu (%.1f%%)\n", (unsigned long long)stats.dropped_frames,
+           offered > 0 ? 100.0 * stats.dropped_frames / offered : 0.0);
+    printf("   Encoded frames: %llu (avg %.2f ms/frame)\n",
+           (unsigned long long)stats.encoded_frames, stats.avg_encode_ms);
+    printf("   Written: %llu packets, %.2f MB\n", (unsigned long long)stats.written_packets,
+           stats.written_bytes / (1024.0 * 1024.0));
+}
+
+void VideoRecorder::setError(const std::string& error, int ffmpeg_error) {
+    last_error_ = error;
+
+    if (ffmpeg_error != 0) {
+        char err_buf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ffmpeg_error, err_buf, sizeof(err_buf));
+        printf("❌ VideoRecorder Error: %s (FFmpeg: %s)\n", error.c_str(), err_buf);
+    } else {
+        printf("❌ VideoRecorder Error: %s\n", error.c_str());
+    }
+}
@@ -0,0 +1,511 @@
+#include "../../include/verify/FrameVerifier.hpp"
+#include "../../include/cpu/CpuFeatures.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// 硬件 CRC32C 内核以 target 属性单独编译，运行时由 CpuFeatures 决定是否使用
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define FRAME_VERIFIER_HW_CRC 1
+#define FRAME_VERIFIER_HW_TARGET __attribute__((target("sse4.2")))
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#include <arm_acle.h>
+#define FRAME_VERIFIER_HW_CRC 1
+#define FRAME_VERIFIER_HW_TARGET __attribute__((target("+crc")))
+#endif
+
+// 每个校验点最多打印的不匹配条数（之后只计数）
+static const uint64_t kMaxReportedMismatches = 10;
+
+// 帧哈希的 lane 数
+static const int kHashLanes = 4;
+
+// ============ CRC32C 查表实现（slicing-by-8） ============
+
+namespace {
+
+struct Crc32cTables {
+    uint32_t t[8][256];
+
+    Crc32cTables() {
+        const uint32_t poly = 0x82F63B78;   // Castagnoli，反射形式
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; k++) {
+                crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+            }
+            t[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int k = 1; k < 8; k++) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables& tables() {
+    static const Crc32cTables instance;
+    return instance;
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+struct SoftCrc {
+    static inline uint32_t step8(uint32_t crc, uint8_t byte) {
+        return (crc >> 8) ^ tables().t[0][(crc ^ byte) & 0xFF];
+    }
+
+    static inline uint32_t step64(uint32_t crc, uint64_t v) {
+        const Crc32cTables& tb = tables();
+        uint32_t lo = crc ^ (uint32_t)v;
+        uint32_t hi = (uint32_t)(v >> 32);
+        return tb.t[7][lo & 0xFF] ^ tb.t[6][(lo >> 8) & 0xFF] ^
+               tb.t[5][(lo >> 16) & 0xFF] ^ tb.t[4][lo >> 24] ^
+               tb.t[3][hi & 0xFF] ^ tb.t[2][(hi >> 8) & 0xFF] ^
+               tb.t[1][(hi >> 16) & 0xFF] ^ tb.t[0][hi >> 24];
+    }
+
+    // 查表实现按 lane 顺序推进（每条 lane 内部已是 slicing-by-8）
+    static constexpr bool kInterleave = false;
+};
+
+#if defined(FRAME_VERIFIER_HW_CRC)
+struct HwCrc {
+    FRAME_VERIFIER_HW_TARGET static inline uint32_t step8(uint32_t crc, uint8_t byte) {
+#if defined(__x86_64__)
+        return _mm_crc32_u8(crc, byte);
+#else
+        return __crc32cb(crc, byte);
+#endif
+    }
+
+    FRAME_VERIFIER_HW_TARGET static inline uint32_t step64(uint32_t crc, uint64_t v) {
+#if defined(__x86_64__)
+        return (uint32_t)_mm_crc32_u64(crc, v);
+#else
+        return __crc32cd(crc, v);
+#endif
+    }
+
+    // crc32 指令延迟 3 周期、吞吐 1 周期，单条依赖链只能用到 1/3 的吞吐
+    static constexpr bool kInterleave = true;
+};
+#endif
+
+/**
+ * CRC 寄存器更新（不做初值/结果取反）
+ *
+ * always_inline：实例化体被内联进带 target 属性的外层函数，
+ * 硬件指令只出现在运行时选中的路径里
+ */
+template <class Crc>
+inline __attribute__((always_inline))
+uint32_t crcUpdate(uint32_t crc, const uint8_t* p, size_t size) {
+    while (size >= 8) {
+        crc = Crc::step64(crc, load64(p));
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = Crc::step8(crc, *p);
+        p++;
+    }
+    return crc;
+}
+
+/**
+ * 4 lane 帧哈希
+ *
+ * 硬件版本交错推进 4 条 lane，查表版本逐条 lane 计算，结果相同
+ */
+template <class Crc>
+inline __attribute__((always_inline))
+uint32_t hashLanes(const uint8_t* p, size_t size) {
+    size_t lane_len = (size / kHashLanes) & ~(size_t)7;
+    if (lane_len == 0) {
+        return ~crcUpdate<Crc>(0xFFFFFFFF, p, size);
+    }
+
+    uint32_t crc[kHashLanes] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+    if (Crc::kInterleave) {
+        for (size_t off = 0; off < lane_len; off += 8) {
+            crc[0] = Crc::step64(crc[0], load64(p + off));
+            crc[1] = Crc::step64(crc[1], load64(p + lane_len + off));
+            crc[2] = Crc::step64(crc[2], load64(p + 2 * lane_len + off));
+            crc[3] = Crc::step64(crc[3], load64(p + 3 * lane_len + off));
+        }
+    } else {
+        for (int lane = 0; lane < kHashLanes; lane++) {
+            crc[lane] = crcUpdate<Crc>(crc[lane], p + lane * lane_len, lane_len);
+        }
+    }
+
+    // 余数归最后一条 lane
+    size_t tail = size - kHashLanes * lane_len;
+    crc[kHashLanes - 1] = crcUpdate<Crc>(crc[kHashLanes - 1], p + kHashLanes * lane_len, tail);
+
+    uint8_t combined[kHashLanes * 4];
+    for (int lane = 0; lane < kHashLanes; lane++) {
+        uint32_t v = ~crc[lane];
+        combined[lane * 4 + 0] = (uint8_t)v;
+        combined[lane * 4 + 1] = (uint8_t)(v >> 8);
+        combined[lane * 4 + 2] = (uint8_t)(v >> 16);
+        combined[lane * 4 + 3] = (uint8_t)(v >> 24);
+    }
+    return ~crcUpdate<Crc>(0xFFFFFFFF, combined, sizeof(combined));
+}
+
+// ============ 分发表 ============
+
+uint32_t crcUpdateSoft(uint32_t crc, const uint8_t* p, size_t size) {
+    return crcUpdate<SoftCrc>(crc, p, size);
+}
+
+uint32_t hashLanesSoft(const uint8_t* p, size_t size) {
+    return hashLanes<SoftCrc>(p, size);
+}
+
+#if defined(FRAME_VERIFIER_HW_CRC)
+FRAME_VERIFIER_HW_TARGET uint32_t crcUpdateHw(uint32_t crc, const uint8_t* p, size_t size) {
+    return crcUpdate<HwCrc>(crc, p, size);
+}
+
+FRAME_VERIFIER_HW_TARGET uint32_t hashLanesHw(const uint8_t* p, size_t size) {
+    return hashLanes<HwCrc>(p, size);
+}
+#endif
+
+struct CrcKernel {
+    uint32_t (*update)(uint32_t crc, const uint8_t* p, size_t size);
+    uint32_t (*hash)(const uint8_t* p, size_t size);
+    const char* name;
+};
+
+CrcKernel selectCrcKernel() {
+#if defined(FRAME_VERIFIER_HW_CRC)
+    if (CpuFeatures::get().allowsHardwareCrc()) {
+#if defined(__x86_64__)
+        return CrcKernel{ &crcUpdateHw, &hashLanesHw, "SSE4.2" };
+#else
+        return CrcKernel{ &crcUpdateHw, &hashLanesHw, "ARMv8 CRC" };
+#endif
+    }
+#endif
+    return CrcKernel{ &crcUpdateSoft, &hashLanesSoft, "Scalar" };
+}
+
+const CrcKernel& crcKernel() {
+    static const CrcKernel kernel = selectCrcKernel();
+    return kernel;
+}
+
+} // namespace
+
+// ============ 构造 ============
+
+FrameVerifier::FrameVerifier()
+    : frame_size_(0)
+    , loop_length_(0)
+    , has_golden_(false)
+{
+    resetStats();
+    for (PointState& state : points_) {
+        state.enabled = false;
+    }
+}
+
+// ============ 配置 ============
+
+void FrameVerifier::enablePoint(VerifyPoint point, bool enable) {
+    points_[static_cast<int>(point)].enabled = enable;
+}
+
+bool FrameVerifier::isEnabled(VerifyPoint point) const {
+    return points_[static_cast<int>(point)].enabled.load();
+}
+
+void FrameVerifier::setMismatchCallback(MismatchCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mismatch_callback_ = callback;
+}
+
+// ============ golden 文件 ============
+
+bool FrameVerifier::loadGolden(const std::string& path) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (PointState& state : points_) {
+        state.golden.clear();
+    }
+
+    char line[256];
+    int line_number = 0;
+    size_t entries = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_number++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || line[0] == '\0') {
+            continue;
+        }
+
+        char name[32];
+        int frame_index;
+        unsigned int crc;
+        VerifyPoint point;
+        if (sscanf(line, "%31s %d %x", name, &frame_index, &crc) != 3 ||
+            !pointFromName(name, &point) || frame_index < 0) {
+            printf("⚠️  Warning: %s:%d: malformed golden entry\n", path.c_str(), line_number);
+            continue;
+        }
+        points_[static_cast<int>(point)].golden[frame_index] = crc;
+        entries++;
+    }
+    fclose(fp);
+
+    has_golden_ = entries > 0;
+    printf("✅ Golden loaded: %s (%zu entries)\n", path.c_str(), entries);
+    return has_golden_;
+}
+
+bool FrameVerifier::saveGolden(const std::string& path) const {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("❌ ERROR: Cannot write golden file %s\n", path.c_str());
+        return false;
+    }
+
+    fprintf(fp, "# frame golden (hash: crc32c x%d lanes)\n", kHashLanes);
+    fprintf(fp, "# <point> <frame_index> <crc32c>\n");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t entries = 0;
+    for (int i = 0; i < kPointCount; i++) {
+        std::vector<std::pair<int, uint32_t>> sorted(points_[i].recorded.begin(),
+                                                     points_[i].recorded.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (const auto& entry : sorted) {
+            fprintf(fp, "%s %d %08x\n", pointName(static_cast<VerifyPoint>(i)),
+                    entry.first, entry.second);
+        }
+        entries += sorted.size();
+    }
+    fclose(fp);
+
+    printf("✅ Golden saved: %s (%zu entries)\n", path.c_str(), entries);
+    return true;
+}
+
+bool FrameVerifier::hasGolden() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return has_golden_;
+}
+
+// ============ 校验 ============
+
+bool FrameVerifier::verify(VerifyPoint point, const Buffer* buffer, int frame_index) {
+    if (!buffer || !buffer->data()) {
+        return true;
+    }
+
+    frame_index = resolveFrameIndex(buffer, frame_index);
+    if (!isEnabled(point)) {
+        return true;
+    }
+
+    size_t size = buffer->size();
+    if (frame_size_ > 0 && frame_size_ < size) {
+        size = frame_size_;
+    }
+    return verify(point, buffer->data(), size, frame_index);
+}
+
+bool FrameVerifier::verify(VerifyPoint point, const void* data, size_t size, int frame_index) {
+    PointState& state = points_[static_cast<int>(point)];
+    if (!state.enabled || !data || size == 0) {
+        return true;
+    }
+
+    if (frame_index < 0) {
+        frame_index = state.sequence.fetch_add(1);
+    }
+    if (loop_length_ > 0) {
+        frame_index %= loop_length_;
+    }
+
+    // 1. 哈希
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t actual = hashFrame(data, size);
+    state.hash_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    state.hashed++;
+    state.bytes += size;
+
+    // 2. 比对（无 golden 时记录）
+    bool mismatch = false;
+    uint32_t expected = 0;
+    MismatchCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!has_golden_) {
+            state.recorded.emplace(frame_index, actual);
+            state.missing++;
+            return true;
+        }
+
+        auto it = state.golden.find(frame_index);
+        if (it == state.golden.end()) {
+            state.missing++;
+            return true;
+        }
+        expected = it->second;
+        mismatch = (expected != actual);
+        if (mismatch) {
+            callback = mismatch_callback_;
+        }
+    }
+
+    if (!mismatch) {
+        state.matched++;
+        return true;
+    }
+
+    uint64_t count = ++state.mismatched;
+    if (count <= kMaxReportedMismatches) {
+        printf("❌ Frame verify mismatch [%s] frame %d: expected %08x, got %08x%s\n",
+               pointName(point), frame_index, expected, actual,
+               count == kMaxReportedMismatches ? " (further mismatches not printed)" : "");
+    }
+    if (callback) {
+        callback(point, frame_index, expected, actual);
+    }
+    return false;
+}
+
+int FrameVerifier::resolveFrameIndex(const Buffer* buffer, int frame_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frame_index >= 0) {
+        // 记录关联，供后续校验点查回
+        frame_tags_[buffer] = frame_index;
+        return frame_index;
+    }
+    auto it = frame_tags_.find(buffer);
+    return (it != frame_tags_.end()) ? it->second : -1;
+}
+
+int FrameVerifier::lookupFrameIndex(const Buffer* buffer) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = frame_tags_.find(buffer);
+    return (it != frame_tags_.end()) ? it->second : -1;
+}
+
+// ============ 统计 ============
+
+FrameVerifier::PointStats FrameVerifier::getStats(VerifyPoint point) const {
+    const PointState& state = points_[static_cast<int>(point)];
+    PointStats stats;
+    stats.hashed_frames = state.hashed.load();
+    stats.matched_frames = state.matched.load();
+    stats.mismatched_frames = state.mismatched.load();
+    stats.missing_frames = state.missing.load();
+
+    uint64_t ns = state.hash_ns.load();
+    stats.avg_hash_us = stats.hashed_frames > 0 ? ns / 1000.0 / stats.hashed_frames : 0.0;
+    stats.hash_gbps = ns > 0 ? (double)state.bytes.load() / ns : 0.0;   // 字节/纳秒 = GB/s
+    return stats;
+}
+
+uint64_t FrameVerifier::getTotalMismatches() const {
+    uint64_t total = 0;
+    for (const PointState& state : points_) {
+        total += state.mismatched.load();
+    }
+    return total;
+}
+
+void FrameVerifier::printStats() const {
+    printf("\n📊 FrameVerifier Statistics (kernel: %s, mode: %s):\n",
+           getKernelName(), hasGolden() ? "verify" : "record");
+    for (int i = 0; i < kPointCount; i++) {
+        VerifyPoint point = static_cast<VerifyPoint>(i);
+        if (!isEnabled(point)) {
+            continue;
+        }
+        PointStats stats = getStats(point);
+        printf("   [%-12s] hashed %llu, matched %llu, mismatched %llu, no golden %llu\n",
+               pointName(point),
+               (unsigned long long)stats.hashed_frames,
+               (unsigned long long)stats.matched_frames,
+               (unsigned long long)stats.mismatched_frames,
+               (unsigned long long)stats.missing_frames);
+        printf("   %-14s avg %.1f us/frame, %.2f GB/s\n", "", stats.avg_hash_us, stats.hash_gbps);
+    }
+    uint64_t mismatches = getTotalMismatches();
+    if (mismatches > 0) {
+        printf("   ❌ %llu mismatched frame(s)\n", (unsigned long long)mismatches);
+    }
+}
+
+void FrameVerifier::resetStats() {
+    for (PointState& state : points_) {
+        state.sequence = 0;
+        state.hashed = 0;
+        state.matched = 0;
+        state.mismatched = 0;
+        state.missing = 0;
+        state.hash_ns = 0;
+        state.bytes = 0;
+    }
+}
+
+// ============ 哈希工具函数 ============
+
+uint32_t FrameVerifier::crc32c(const void* data, size_t size, uint32_t crc) {
+    return ~crcKernel().update(~crc, static_cast<const uint8_t*>(data), size);
+}
+
+uint32_t FrameVerifier::hashFrame(const void* data, size_t size) {
+    return crcKernel().hash(static_cast<const uint8_t*>(data), size);
+}
+
+uint32_t FrameVerifier::hashFrameScalar(const void* data, size_t size) {
+    return hashLanesSoft(static_cast<const uint8_t*>(data), size);
+}
+
+const char* FrameVerifier::pointName(VerifyPoint point) {
+    switch (point) {
+        case VerifyPoint::POST_READ:    return "post-read";
+        case VerifyPoint::POST_CONVERT: return "post-convert";
+        case VerifyPoint::PRE_DISPLAY:  return "pre-display";
+        default:                        return "unknown";
+    }
+}
+
+bool FrameVerifier::pointFromName(const char* name, VerifyPoint* point) {
+    if (!name || !point) {
+        return false;
+    }
+    for (int i = 0; i < kPointCount; i++) {
+        VerifyPoint candidate = static_cast<VerifyPoint>(i);
+        if (strcasecmp(name, pointName(candidate)) == 0) {
+            *point = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* FrameVerifier::getKernelName() {
+    return crcKernel().name;
+}
@@ -0,0 +1,549 @@
+#include "../../include/videoFile/AvioBackend.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <liburing.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/mem.h>
+#include <libavutil/error.h>
+}
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ============ DEFAULT：libavformat file: 协议 ============
+
+/**
+ * 不接管 I/O，只在打开时记下 /proc/self/io，用增量近似 file: 协议的读取量和 read() 次数
+ */
+class DefaultAvioBackend : public AvioBackend {
+public:
+    explicit DefaultAvioBackend(const Options& options)
+        : AvioBackend(options), rchar_start_(0), syscr_start_(0) {}
+
+    bool open(const char* path) override {
+        (void)path;
+        readProcIo(&rchar_start_, &syscr_start_);
+        open_time_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void close() override {}
+
+    AvioBackendType type() const override { return AvioBackendType::DEFAULT; }
+
+    Stats getStats() const override {
+        Stats stats;
+        uint64_t rchar = 0;
+        uint64_t syscr = 0;
+        if (readProcIo(&rchar, &syscr)) {
+            stats.bytes = rchar - rchar_start_;
+            stats.syscalls = syscr - syscr_start_;
+        }
+        stats.elapsed_s = secondsSince(open_time_);
+        return stats;
+    }
+
+protected:
+    int readPacket(uint8_t* buf, int size) override {
+        (void)buf;
+        (void)size;
+        return AVERROR_EOF;
+    }
+
+    int64_t seekTo(int64_t offset, int whence) override {
+        (void)offset;
+        (void)whence;
+        return -1;
+    }
+
+private:
+    static bool readProcIo(uint64_t* rchar, uint64_t* syscr) {
+        FILE* fp = fopen("/proc/self/io", "r");
+        if (!fp) {
+            return false;
+        }
+        char line[128];
+        unsigned long long value = 0;
+        while (fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "rchar: %llu", &value) == 1) {
+                *rchar = value;
+            } else if (sscanf(line, "syscr: %llu", &value) == 1) {
+                *syscr = value;
+            }
+        }
+        fclose(fp);
+        return true;
+    }
+
+    uint64_t rchar_start_;
+    uint64_t syscr_start_;
+};
+
+// ============ MMAP ============
+
+class MmapAvioBackend : public AvioBackend {
+public:
+    explicit MmapAvioBackend(const Options& options)
+        : AvioBackend(options), fd_(-1), data_(nullptr) {}
+
+    ~MmapAvioBackend() override { close(); }
+
+    bool open(const char* path) override {
+        close();
+        open_time_ = std::chrono::steady_clock::now();
+
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        stats_.syscalls++;
+        if (fd_ < 0) {
+            printf("❌ ERROR: AvioBackend(mmap): cannot open %s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        stats_.syscalls++;
+        if (fstat(fd_, &st) != 0 || st.st_size <= 0) {
+            printf("❌ ERROR: AvioBackend(mmap): cannot stat %s\n", path);
+            close();
+            return false;
+        }
+        file_size_ = st.st_size;
+
+        // 映射不受 AVIO 缓冲大小限制，32 位平台上超过地址空间的文件会在这里失败
+        void* addr = mmap(NULL, (size_t)file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        stats_.syscalls++;
+        if (addr == MAP_FAILED) {
+            printf("❌ ERROR: AvioBackend(mmap): mmap %lld bytes failed: %s\n",
+                   (long long)file_size_, strerror(errno));
+            close();
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(addr);
+        madvise(addr, (size_t)file_size_, MADV_SEQUENTIAL);
+        stats_.syscalls++;
+
+        if (!createContext(true)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() override {
+        freeContext();
+        if (data_) {
+            munmap(const_cast<uint8_t*>(data_), (size_t)file_size_);
+            data_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    AvioBackendType type() const override { return AvioBackendType::MMAP; }
+
+protected:
+    int readPacket(uint8_t* buf, int size) override {
+        if (pos_ >= file_size_) {
+            return AVERROR_EOF;
+        }
+        int64_t remaining = file_size_ - pos_;
+        int n = remaining < size ? (int)remaining : size;
+        memcpy(buf, data_ + pos_, (size_t)n);
+        pos_ += n;
+        stats_.bytes += (uint64_t)n;
+        return n;
+    }
+
+    int64_t seekTo(int64_t offset, int whence) override {
+        int64_t target = resolveSeek(offset, whence);
+        if (target < 0) {
+            return -1;
+        }
+        pos_ = target;
+        stats_.seeks++;
+        return pos_;
+    }
+
+private:
+    int fd_;
+    const uint8_t* data_;
+};
+
+// ============ IOURING ============
+
+/**
+ * 预读窗口：readahead_blocks 个块按文件顺序排成环，head_ 指向覆盖当前读位置的块。
+ * 消费完 head_ 块后立即为它提交窗口末尾的下一块，保证内核侧始终有 N 个读请求在途。
+ */
+class IoUringAvioBackend : public AvioBackend {
+public:
+    explicit IoUringAvioBackend(const Options& options)
+        : AvioBackend(options), fd_(-1), ring_ready_(false)
+        , head_(0), next_offset_(0), inflight_(0) {}
+
+    ~IoUringAvioBackend() override { close(); }
+
+    bool open(const char* path) override {
+        close();
+        open_time_ = std::chrono::steady_clock::now();
+
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        stats_.syscalls++;
+        if (fd_ < 0) {
+            printf("❌ ERROR: AvioBackend(iouring): cannot open %s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        stats_.syscalls++;
+        if (fstat(fd_, &st) != 0 || st.st_size <= 0) {
+            printf("❌ ERROR: AvioBackend(iouring): cannot stat %s\n", path);
+            close();
+            return false;
+        }
+        file_size_ = st.st_size;
+
+        int depth = options_.readahead_blocks > 0 ? options_.readahead_blocks : 1;
+        int ret = io_uring_queue_init((unsigned)depth, &ring_, 0);
+        stats_.syscalls++;
+        if (ret < 0) {
+            printf("❌ ERROR: AvioBackend(iouring): io_uring_queue_init failed: %s\n", strerror(-ret));
+            close();
+            return false;
+        }
+        ring_ready_ = true;
+
+        blocks_.resize((size_t)depth);
+        for (Block& block : blocks_) {
+            void* mem = nullptr;
+            if (posix_memalign(&mem, 4096, options_.block_size) != 0) {
+                printf("❌ ERROR: AvioBackend(iouring): cannot allocate %zu byte block\n",
+                       options_.block_size);
+                close();
+                return false;
+            }
+            block.data = static_cast<uint8_t*>(mem);
+        }
+
+        if (!createContext(false)) {
+            close();
+            return false;
+        }
+
+        restartWindow(0);
+        return true;
+    }
+
+    void close() override {
+        freeContext();
+        if (ring_ready_) {
+            drain();
+            io_uring_queue_exit(&ring_);
+            ring_ready_ = false;
+        }
+        for (Block& block : blocks_) {
+            free(block.data);
+        }
+        blocks_.clear();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    AvioBackendType type() const override { return AvioBackendType::IOURING; }
+
+protected:
+    int readPacket(uint8_t* buf, int size) override {
+        if (pos_ >= file_size_) {
+            return AVERROR_EOF;
+        }
+
+        Block* block = &blocks_[head_];
+        if (!block->covers(pos_, options_.block_size)) {
+            restartWindow(pos_);
+            block = &blocks_[head_];
+        }
+
+        while (block->inflight) {
+            if (!harvest(true)) {
+                return AVERROR(EIO);
+            }
+        }
+        if (block->result < 0) {
+            printf("❌ ERROR: AvioBackend(iouring): read at %lld failed: %s\n",
+                   (long long)block->offset, strerror(-block->result));
+            int err = block->result;
+            restartWindow(pos_);        // 下次重试
+            return AVERROR(-err);
+        }
+
+        int64_t available = block->offset + block->result - pos_;
+        if (available <= 0) {
+            return AVERROR_EOF;         // 文件在读取期间被截短
+        }
+        int n = available < size ? (int)available : size;
+        memcpy(buf, block->data + (pos_ - block->offset), (size_t)n);
+        pos_ += n;
+        stats_.bytes += (uint64_t)n;
+
+        // 整块消费完：回收为窗口末尾的下一块
+        if (pos_ >= block->offset + (int64_t)options_.block_size) {
+            issue(*block);
+            submit();
+            head_ = (head_ + 1) % blocks_.size();
+        }
+        return n;
+    }
+
+    int64_t seekTo(int64_t offset, int whence) override {
+        int64_t target = resolveSeek(offset, whence);
+        if (target < 0) {
+            return -1;
+        }
+        // 窗口在下一次 readPacket 时按需重建（窗口内的小幅回退不会触发重建）
+        pos_ = target;
+        stats_.seeks++;
+        return pos_;
+    }
+
+private:
+    struct Block {
+        uint8_t* data;
+        int64_t offset;                 // 文件偏移（block_size 对齐）
+        int result;                     // 读取字节数或 -errno
+        bool inflight;
+
+        Block() : data(nullptr), offset(-1), result(0), inflight(false) {}
+
+        bool covers(int64_t pos, size_t block_size) const {
+            return offset >= 0 && pos >= offset && pos < offset + (int64_t)block_size;
+        }
+    };
+
+    void issue(Block& block) {
+        block.offset = next_offset_;
+        block.result = 0;
+        block.inflight = false;
+        if (next_offset_ >= file_size_) {
+            return;                     // 超出文件末尾：空块
+        }
+        next_offset_ += (int64_t)options_.block_size;
+
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            block.result = -EBUSY;
+            return;
+        }
+        int64_t remaining = file_size_ - block.offset;
+        unsigned len = remaining < (int64_t)options_.block_size ? (unsigned)remaining
+                                                                : (unsigned)options_.block_size;
+        io_uring_prep_read(sqe, fd_, block.data, len, (unsigned long long)block.offset);
+        io_uring_sqe_set_data(sqe, &block);
+        block.inflight = true;
+        inflight_++;
+    }
+
+    void submit() {
+        int ret = io_uring_submit(&ring_);
+        if (ret > 0) {
+            stats_.syscalls++;
+        }
+    }
+
+    /**
+     * 收割完成事件；blocking 时至少等到一个
+     */
+    bool harvest(bool blocking) {
+        struct io_uring_cqe* cqe = nullptr;
+        int ret = io_uring_peek_cqe(&ring_, &cqe);
+        if (ret == -EAGAIN && blocking) {
+            ret = io_uring_wait_cqe(&ring_, &cqe);
+            stats_.syscalls++;
+        }
+        if (ret < 0) {
+            return ret == -EAGAIN;
+        }
+        while (ret == 0 && cqe) {
+            Block* block = static_cast<Block*>(io_uring_cqe_get_data(cqe));
+            if (block) {
+                block->result = cqe->res;
+                block->inflight = false;
+                inflight_--;
+            }
+            io_uring_cqe_seen(&ring_, cqe);
+            cqe = nullptr;
+            ret = io_uring_peek_cqe(&ring_, &cqe);
+        }
+        return true;
+    }
+
+    void drain() {
+        while (inflight_ > 0) {
+            if (!harvest(true)) {
+                break;
+            }
+        }
+    }
+
+    void restartWindow(int64_t pos) {
+        drain();
+        next_offset_ = pos / (int64_t)options_.block_size * (int64_t)options_.block_size;
+        head_ = 0;
+        for (Block& block : blocks_) {
+            issue(block);
+        }
+        submit();
+        stats_.refills++;
+    }
+
+    int fd_;
+    struct io_uring ring_;
+    bool ring_ready_;
+    std::vector<Block> blocks_;
+    size_t head_;
+    int64_t next_offset_;               // 下一个待提交块的文件偏移
+    int inflight_;
+};
+
+} // namespace
+
+// ============ AvioBackend ============
+
+AvioBackend::AvioBackend(const Options& options)
+    : options_(options)
+    , avio_ctx_(nullptr)
+    , file_size_(0)
+    , pos_(0)
+    , open_time_(std::chrono::steady_clock::now())
+{
+}
+
+AvioBackend::~AvioBackend() {
+    freeContext();
+}
+
+std::unique_ptr<AvioBackend> AvioBackend::create(AvioBackendType type, const Options& options) {
+    switch (type) {
+        case AvioBackendType::MMAP:
+            return std::unique_ptr<AvioBackend>(new MmapAvioBackend(options));
+        case AvioBackendType::IOURING:
+            return std::unique_ptr<AvioBackend>(new IoUringAvioBackend(options));
+        case AvioBackendType::DEFAULT:
+        default:
+            return std::unique_ptr<AvioBackend>(new DefaultAvioBackend(options));
+    }
+}
+
+const char* AvioBackend::typeToString(AvioBackendType type) {
+    switch (type) {
+        case AvioBackendType::DEFAULT: return "file";
+        case AvioBackendType::MMAP:    return "mmap";
+        case AvioBackendType::IOURING: return "iouring";
+    }
+    return "unknown";
+}
+
+bool AvioBackend::parseType(const char* name, AvioBackendType* type) {
+    if (!name) {
+        return false;
+    }
+    if (strcasecmp(name, "default") == 0 || strcasecmp(name, "file") == 0) {
+        *type = AvioBackendType::DEFAULT;
+    } else if (strcasecmp(name, "mmap") == 0) {
+        *type = AvioBackendType::MMAP;
+    } else if (strcasecmp(name, "iouring") == 0 || strcasecmp(name, "io_uring") == 0) {
+        *type = AvioBackendType::IOURING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool AvioBackend::createContext(bool direct) {
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(options_.avio_buffer_size));
+    if (!buffer) {
+        printf("❌ ERROR: AvioBackend: cannot allocate AVIO buffer\n");
+        return false;
+    }
+    avio_ctx_ = avio_alloc_context(buffer, (int)options_.avio_buffer_size, 0, this,
+                                   &AvioBackend::readPacketThunk, nullptr,
+                                   &AvioBackend::seekThunk);
+    if (!avio_ctx_) {
+        av_free(buffer);
+        printf("❌ ERROR: AvioBackend: avio_alloc_context failed\n");
+        return false;
+    }
+    avio_ctx_->seekable = AVIO_SEEKABLE_NORMAL;
+    avio_ctx_->direct = direct ? 1 : 0;
+    pos_ = 0;
+    return true;
+}
+
+void AvioBackend::freeContext() {
+    if (avio_ctx_) {
+        // AVIO 可能重新分配过缓冲区，以上下文里的为准
+        av_freep(&avio_ctx_->buffer);
+        avio_context_free(&avio_ctx_);
+    }
+}
+
+int AvioBackend::readPacketThunk(void* opaque, uint8_t* buf, int size) {
+    return static_cast<AvioBackend*>(opaque)->readPacket(buf, size);
+}
+
+int64_t AvioBackend::seekThunk(void* opaque, int64_t offset, int whence) {
+    AvioBackend* self = static_cast<AvioBackend*>(opaque);
+    if (whence & AVSEEK_SIZE) {
+        return self->file_size_;
+    }
+    return self->seekTo(offset, whence & ~AVSEEK_FORCE);
+}
+
+int64_t AvioBackend::resolveSeek(int64_t offset, int whence) const {
+    int64_t target;
+    switch (whence) {
+        case SEEK_SET: target = offset; break;
+        case SEEK_CUR: target = pos_ + offset; break;
+        case SEEK_END: target = file_size_ + offset; break;
+        default:       return -1;
+    }
+    if (target < 0 || target > file_size_) {
+        return -1;
+    }
+    return target;
+}
+
+AvioBackend::Stats AvioBackend::getStats() const {
+    Stats stats = stats_;
+    stats.elapsed_s = secondsSince(open_time_);
+    return stats;
+}
+
+void AvioBackend::printStats() const {
+    Stats stats = getStats();
+    printf("📂 AVIO backend: %s\n", name());
+    printf("   Read: %.1f MB (%.1f MB/s)\n", stats.bytes / (1024.0 * 1024.0),
+           stats.bytesPerSec() / (1024.0 * 1024.0));
+    printf("   Syscalls: %llu (%.0f/s)%s\n", (unsigned long long)stats.syscalls,
+           stats.syscallsPerSec(), type() == AvioBackendType::DEFAULT ? " [process-wide read()]" : "");
+    if (stats.seeks > 0 || stats.refills > 0) {
+        printf("   Seeks: %llu, window refills: %llu\n",
+               (unsigned long long)stats.seeks, (unsigned long long)stats.refills);
+    }
+}
@@ -25,12 +25,15 @@ FfmpegVideoReader::FfmpegVideoReader()
     , codec_ctx_(nullptr)
     , sws_ctx_(nullptr)
     , video_stream_index_(-1)
+    , packet_(nullptr)
+    , frame_(nullptr)
     , width_(0)
     , height_(0)
     , output_width_(0)
     , output_height_(0)
     , output_bpp_(32)  // 默认ARGB888
     , output_pixel_format_(AV_PIX_FMT_BGRA)
+    , output_format_fixed_(false)
     , total_frames_(-1)
     , current_frame_index_(0)
     , is_open_(false)
@@ -40,8 +43,10 @@ FfmpegVideoReader::FfmpegVideoReader()
     , use_hardware_decoder_(true)  // 默认启用硬件解码
     , decoder_name_(nullptr)
     , codec_options_(nullptr)
+    , first_frame_pending_(false)
     , decoded_frames_(0)
     , decode_errors_(0)
+    , decode_allocations_(0)
     , last_ffmpeg_error_(0)
 {
     memset(file_path_, 0, sizeof(file_path_));
@@ -86,6 +91,7 @@ bool FfmpegVideoReader::open(const char* path) {
     printf("✅ FfmpegVideoReader: Opened '%s'\n", path);
     printf("   Resolution: %dx%d → %dx%d\n", width_, height_, output_width_, output_height_);
     printf("   Codec: %s\n", codec_ctx_->codec->name);
+    printf("   Demux I/O: %s\n", io_backend_ ? io_backend_->name() : "file");
     printf("   Total frames (estimated): %d\n", total_frames_);
     printf("   Zero-copy: %s\n", supports_zero_copy_ ? "YES" : "NO");
     
@@ -116,27 +122,73 @@ bool FfmpegVideoReader::isOpen() const {
 // ============================================================================
 
 bool FfmpegVideoReader::openVideo() {
-    // 1. 打开输入文件
+    open_timings_ = OpenTimings();
+    open_start_ = std::chrono::steady_clock::now();
+    first_frame_pending_ = false;
+    
+    // 1. 打开输入文件（探测预算通过格式选项传入）
     format_ctx_ = avformat_alloc_context();
     if (!format_ctx_) {
         setError("Failed to allocate AVFormatContext");
         return false;
     }
     
-    int ret = avformat_open_input(&format_ctx_, file_path_, nullptr, nullptr);
+    AVDictionary* format_options = nullptr;
+    if (probe_config_.probesize >= 0) {
+        av_dict_set_int(&format_options, "probesize", probe_config_.probesize, 0);
+    }
+    if (probe_config_.analyzeduration_us >= 0) {
+        av_dict_set_int(&format_options, "analyzeduration", probe_config_.analyzeduration_us, 0);
+    }
+    if (probe_config_.fpsprobesize >= 0) {
+        av_dict_set_int(&format_options, "fpsprobesize", probe_config_.fpsprobesize, 0);
+    }
+    
+    // 自定义 I/O 后端（mmap / io_uring）：由 AVIOContext 接管读取，失败时回退到 file: 协议
+    io_backend_ = AvioBackend::create(probe_config_.io_backend);
+    if (!io_backend_->open(file_path_)) {
+        printf("⚠️  Warning: AVIO backend '%s' unavailable, using file protocol\n", io_backend_->name());
+        io_backend_ = AvioBackend::create(AvioBackendType::DEFAULT);
+        io_backend_->open(file_path_);
+    }
+    if (io_backend_->getContext()) {
+        format_ctx_->pb = io_backend_->getContext();
+        format_ctx_->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+    
+    int ret = avformat_open_input(&format_ctx_, file_path_, nullptr, &format_options);
+    av_dict_free(&format_options);
     if (ret < 0) {
         setError("Failed to open video file", ret);
         format_ctx_ = nullptr;
+        io_backend_.reset();    // 失败时 avformat_open_input 已释放上下文，但不释放自定义 pb
         return false;
     }
     
-    // 2. 读取流信息
-    ret = avformat_find_stream_info(format_ctx_, nullptr);
-    if (ret < 0) {
-        setError("Failed to find stream info", ret);
-        closeVideo();
-        return false;
+    auto connected = std::chrono::steady_clock::now();
+    open_timings_.connect_ms = std::chrono::duration<double, std::milli>(connected - open_start_).count();
+    
+    // 2. 读取流信息（调用方提供了编码参数时跳过）
+    bool skip_probe = false;
+    if (probe_config_.hasCodecParams()) {
+        skip_probe = findVideoStream() &&
+                     applyCodecParams(format_ctx_->streams[video_stream_index_]->codecpar);
+        if (!skip_probe) {
+            printf("⚠️  Warning: Supplied codec parameters not usable, probing stream\n");
+        }
     }
+    if (!skip_probe) {
+        ret = avformat_find_stream_info(format_ctx_, nullptr);
+        if (ret < 0) {
+            setError("Failed to find stream info", ret);
+            closeVideo();
+            return false;
+        }
+    }
+    
+    auto probed = std::chrono::steady_clock::now();
+    open_timings_.probe_ms = std::chrono::duration<double, std::milli>(probed - connected).count();
+    open_timings_.probe_skipped = skip_probe;
     
     // 3. 查找视频流
     if (!findVideoStream()) {
@@ -170,10 +222,22 @@ bool FfmpegVideoReader::openVideo() {
         }
     }
     
+    open_done_ = std::chrono::steady_clock::now();
+    open_timings_.decoder_ms = std::chrono::duration<double, std::milli>(open_done_ - probed).count();
+    first_frame_pending_ = true;
+    
     return true;
 }
 
 void FfmpegVideoReader::closeVideo() {
+    // 释放复用的包 / 帧
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+    if (frame_) {
+        av_frame_free(&frame_);
+    }
+    
     // 释放格式转换器
     if (sws_ctx_) {
         sws_freeContext(sws_ctx_);
@@ -192,6 +256,12 @@ void FfmpegVideoReader::closeVideo() {
         format_ctx_ = nullptr;
     }
     
+    // 自定义 AVIOContext 不随 avformat_close_input 释放
+    if (io_backend_) {
+        io_backend_->close();
+        io_backend_.reset();
+    }
+    
     // 释放解码器选项
     if (codec_options_) {
         av_dict_free(&codec_options_);
@@ -224,6 +294,46 @@ bool FfmpegVideoReader::findVideoStream() {
     return true;
 }
 
+bool FfmpegVideoReader::applyCodecParams(AVCodecParameters* codecpar) {
+    const AVCodec* codec = avcodec_find_decoder_by_name(probe_config_.codec_name.c_str());
+    if (!codec) {
+        setError("Unknown codec in probe config: " + probe_config_.codec_name);
+        return false;
+    }
+    
+    if (probe_config_.width <= 0 || probe_config_.height <= 0) {
+        setError("Probe config codec parameters require width/height");
+        return false;
+    }
+    
+    // 容器已识别出不同的编码类型：参数不可信
+    if (codecpar->codec_id != AV_CODEC_ID_NONE && codecpar->codec_id != codec->id) {
+        return false;
+    }
+    
+    codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+    codecpar->codec_id = codec->id;
+    codecpar->width = probe_config_.width;
+    codecpar->height = probe_config_.height;
+    
+    if (!probe_config_.extradata.empty()) {
+        size_t size = probe_config_.extradata.size();
+        uint8_t* extradata = (uint8_t*)av_mallocz(size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!extradata) {
+            return false;
+        }
+        memcpy(extradata, probe_config_.extradata.data(), size);
+        av_freep(&codecpar->extradata);
+        codecpar->extradata = extradata;
+        codecpar->extradata_size = (int)size;
+    }
+    
+    width_ = codecpar->width;
+    height_ = codecpar->height;
+    
+    return true;
+}
+
 bool FfmpegVideoReader::initializeDecoder() {
     AVCodecParameters* codecpar = format_ctx_->streams[video_stream_index_]->codecpar;
     
@@ -326,9 +436,11 @@ bool FfmpegVideoReader::configureSpecialDecoder() {
 }
 
 bool FfmpegVideoReader::initializeSwsContext() {
-    // 确定输出像素格式
+    // 确定输出像素格式（setOutputFormat 指定时直接使用）
     AVPixelFormat dst_pix_fmt;
-    if (output_bpp_ == 32) {
+    if (output_format_fixed_) {
+        dst_pix_fmt = (AVPixelFormat)output_pixel_format_;
+    } else if (output_bpp_ == 32) {
         dst_pix_fmt = AV_PIX_FMT_BGRA;  // ARGB888 (4 bytes)
     } else if (output_bpp_ == 24) {
         dst_pix_fmt = AV_PIX_FMT_BGR24; // RGB888 (3 bytes)
@@ -339,6 +451,11 @@ bool FfmpegVideoReader::initializeSwsContext() {
     
     output_pixel_format_ = dst_pix_fmt;
     
+    // 跳过探测时像素格式要到首帧才确定，转换器延迟到 convertFrameTo 创建
+    if (codec_ctx_->pix_fmt == AV_PIX_FMT_NONE) {
+        return true;
+    }
+    
     // 创建格式转换器
     sws_ctx_ = sws_getContext(
         codec_ctx_->width, codec_ctx_->height, codec_ctx_->pix_fmt,
@@ -459,20 +576,33 @@ int FfmpegVideoReader::estimateTotalFrames() {
 // 读取帧（核心逻辑）
 // ============================================================================
 
+bool FfmpegVideoReader::ensureDecodeObjects() {
+    if (!packet_) {
+        packet_ = av_packet_alloc();
+        decode_allocations_++;
+    }
+    if (!frame_) {
+        frame_ = av_frame_alloc();
+        decode_allocations_++;
+    }
+    return packet_ && frame_;
+}
+
 AVFrame* FfmpegVideoReader::decodeOneFrame() {
     if (!is_open_ || eof_reached_) {
         return nullptr;
     }
     
-    AVPacket* packet = av_packet_alloc();
-    AVFrame* frame = av_frame_alloc();
-    
-    if (!packet || !frame) {
-        if (packet) av_packet_free(&packet);
-        if (frame) av_frame_free(&frame);
+    if (!ensureDecodeObjects()) {
+        setError("Failed to allocate packet/frame");
         return nullptr;
     }
     
+    // 上一帧的引用在这里才释放（调用者可能仍在使用 frame_）
+    AVPacket* packet = packet_;
+    AVFrame* frame = frame_;
+    av_frame_unref(frame);
+    
     // 读取并解码一帧
     while (true) {
         int ret = av_read_frame(format_ctx_, packet);
@@ -484,8 +614,6 @@ AVFrame* FfmpegVideoReader::decodeOneFrame() {
                 setError("Failed to read frame", ret);
                 decode_errors_++;
             }
-            av_packet_free(&packet);
-            av_frame_free(&frame);
             return nullptr;
         }
         
@@ -513,22 +641,25 @@ AVFrame* FfmpegVideoReader::decodeOneFrame() {
             continue;
         } else if (ret == AVERROR_EOF) {
             eof_reached_ = true;
-            av_packet_free(&packet);
-            av_frame_free(&frame);
             return nullptr;
         } else if (ret < 0) {
             setError("Failed to receive frame from decoder", ret);
             decode_errors_++;
-            av_packet_free(&packet);
-            av_frame_free(&frame);
             return nullptr;
         }
         
         // 解码成功
         decoded_frames_++;
         current_frame_index_++;
-        av_packet_free(&packet);
-        return frame;  // 调用者负责释放
+        
+        if (first_frame_pending_) {
+            first_frame_pending_ = false;
+            auto now = std::chrono::steady_clock::now();
+            open_timings_.first_frame_ms = std::chrono::duration<double, std::milli>(now - open_done_).count();
+            open_timings_.total_ms = std::chrono::duration<double, std::milli>(now - open_start_).count();
+            open_timings_.print("FfmpegVideoReader");
+        }
+        return frame;  // reader 持有，下一次解码前有效
     }
 }
 
@@ -559,14 +690,26 @@ bool FfmpegVideoReader::readFrameTo(void* dest_buffer, size_t buffer_size) {
     // 转换并拷贝到目标buffer
     bool success = convertFrameTo(frame, dest_buffer, buffer_size);
     
-    // 释放 AVFrame
-    av_frame_free(&frame);
+    // 解码帧缓冲尽早还给解码器的帧池（AVFrame 本身留给下一帧复用）
+    av_frame_unref(frame);
     
     return success;
 }
 
 bool FfmpegVideoReader::convertFrameTo(AVFrame* src_frame, void* dest, size_t dest_size) {
-    if (!src_frame || !dest || !sws_ctx_) {
+    if (!src_frame || !dest) {
+        return false;
+    }
+    
+    // 按实际帧参数获取转换器（参数未变时直接返回现有的）
+    sws_ctx_ = sws_getCachedContext(
+        sws_ctx_,
+        src_frame->width, src_frame->height, (AVPixelFormat)src_frame->format,
+        output_width_, output_height_, (AVPixelFormat)output_pixel_format_,
+        SWS_BILINEAR, nullptr, nullptr, nullptr
+    );
+    if (!sws_ctx_) {
+        setError("Failed to create SwsContext");
         return false;
     }
     
@@ -761,6 +904,36 @@ void FfmpegVideoReader::setOutputBitsPerPixel(int bpp) {
     }
 }
 
+bool FfmpegVideoReader::setOutputFormat(PixelFormat format, int width, int height) {
+    AVPixelFormat pix_fmt;
+    int bpp;
+    switch (format) {
+        case PixelFormat::ARGB8888: pix_fmt = AV_PIX_FMT_BGRA;   bpp = 32; break;
+        case PixelFormat::XRGB8888: pix_fmt = AV_PIX_FMT_BGR0;   bpp = 32; break;
+        case PixelFormat::ABGR8888: pix_fmt = AV_PIX_FMT_RGBA;   bpp = 32; break;
+        case PixelFormat::BGR24:    pix_fmt = AV_PIX_FMT_BGR24;  bpp = 24; break;
+        case PixelFormat::RGB24:    pix_fmt = AV_PIX_FMT_RGB24;  bpp = 24; break;
+        case PixelFormat::RGB565:   pix_fmt = AV_PIX_FMT_RGB565; bpp = 16; break;
+        case PixelFormat::BGR565:   pix_fmt = AV_PIX_FMT_BGR565; bpp = 16; break;
+        default:
+            printf("⚠️  Warning: FFmpeg output format %s not supported\n",
+                   PixelConverter::formatName(format));
+            return false;
+    }
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    
+    // convertFrameTo 每帧按 output_* 取缓存转换器，修改后下一帧生效
+    std::lock_guard<std::mutex> lock(mutex_);
+    output_pixel_format_ = pix_fmt;
+    output_bpp_ = bpp;
+    output_width_ = width;
+    output_height_ = height;
+    output_format_fixed_ = true;
+    return true;
+}
+
 void FfmpegVideoReader::setDecoderName(const char* decoder_name) {
     if (!is_open_) {
         decoder_name_ = decoder_name;
@@ -773,6 +946,28 @@ void FfmpegVideoReader::setHardwareDecoder(bool enable) {
     }
 }
 
+void FfmpegVideoReader::setProbeConfig(const StreamProbeConfig& config) {
+    if (!is_open_) {
+        probe_config_ = config;
+    }
+}
+
+void FfmpegVideoReader::setIoBackend(AvioBackendType type) {
+    if (!is_open_) {
+        probe_config_.io_backend = type;
+    }
+}
+
+AvioBackend::Stats FfmpegVideoReader::getIoStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return io_backend_ ? io_backend_->getStats() : AvioBackend::Stats();
+}
+
+OpenTimings FfmpegVideoReader::getOpenTimings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_timings_;
+}
+
 // ============================================================================
 // 辅助方法
 // ============================================================================
@@ -810,8 +1005,14 @@ void FfmpegVideoReader::printStats() const {
     printf("   Current frame: %d\n", current_frame_index_);
     printf("   Decoded frames: %d\n", decoded_frames_.load());
     printf("   Decode errors: %d\n", decode_errors_.load());
+    printf("   Decode allocations: %llu (packet/frame objects, reused across frames)\n",
+           (unsigned long long)decode_allocations_.load());
     printf("   Zero-copy: %s\n", supports_zero_copy_ ? "YES" : "NO");
     printf("   EOF: %s\n", eof_reached_ ? "YES" : "NO");
+    if (io_backend_) {
+        io_backend_->printStats();
+    }
+    open_timings_.print("FfmpegVideoReader");
 }
 
 void FfmpegVideoReader::printVideoInfo() const {
@@ -0,0 +1,811 @@
+#include "../../include/videoFile/ImageSequenceReader.hpp"
+#include "../../include/cpu/MemoryKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+
+// FFmpeg headers
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+
+/**
+ * 根据扩展名选择图片解码器
+ */
+AVCodecID codecForFile(const std::string& file) {
+    size_t dot = file.rfind('.');
+    if (dot == std::string::npos) {
+        return AV_CODEC_ID_NONE;
+    }
+    const char* ext = file.c_str() + dot + 1;
+    if (strcasecmp(ext, "png") == 0) {
+        return AV_CODEC_ID_PNG;
+    } else if (strcasecmp(ext, "jpg") == 0 || strcasecmp(ext, "jpeg") == 0) {
+        return AV_CODEC_ID_MJPEG;
+    } else if (strcasecmp(ext, "bmp") == 0) {
+        return AV_CODEC_ID_BMP;
+    }
+    return AV_CODEC_ID_NONE;
+}
+
+/**
+ * 自然序比较（frame2.png < frame10.png）
+ */
+bool naturalLess(const std::string& a, const std::string& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isdigit((unsigned char)a[i]) && isdigit((unsigned char)b[j])) {
+            size_t ia = i, jb = j;
+            while (ia < a.size() && a[ia] == '0') ia++;
+            while (jb < b.size() && b[jb] == '0') jb++;
+            size_t ea = ia, eb = jb;
+            while (ea < a.size() && isdigit((unsigned char)a[ea])) ea++;
+            while (eb < b.size() && isdigit((unsigned char)b[eb])) eb++;
+            if (ea - ia != eb - jb) {
+                return ea - ia < eb - jb;
+            }
+            int cmp = a.compare(ia, ea - ia, b, jb, eb - jb);
+            if (cmp != 0) {
+                return cmp < 0;
+            }
+            i = ea;
+            j = eb;
+        } else {
+            if (a[i] != b[j]) {
+                return a[i] < b[j];
+            }
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
+
+/**
+ * 模板中是否恰好有一个整数转换（%d / %0Nd / %Nd），其余 % 必须是 %%
+ */
+bool isValidPattern(const char* pattern) {
+    int conversions = 0;
+    for (const char* p = pattern; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            continue;
+        }
+        while (isdigit((unsigned char)*p)) {
+            p++;
+        }
+        if (*p != 'd') {
+            return false;
+        }
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+bool fileExists(const char* path, long* size) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    if (size) {
+        *size = (long)st.st_size;
+    }
+    return true;
+}
+
+}  // namespace
+
+// ============ 构造/析构 ============
+
+ImageSequenceReader::ImageSequenceReader()
+    : total_file_size_(0)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(32)
+    , output_pixel_format_(AV_PIX_FMT_BGRA)
+    , prefetch_depth_(0)
+    , worker_count_(0)
+    , stop_workers_(false)
+    , current_frame_index_(0)
+    , is_open_(false)
+    , decoded_frames_(0)
+    , decode_errors_(0)
+    , prefetch_hits_(0)
+    , prefetch_misses_(0)
+    , decode_time_us_(0)
+{
+    path_[0] = '\0';
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    worker_count_ = std::max(1, std::min((int)cores, 4));
+}
+
+ImageSequenceReader::~ImageSequenceReader() {
+    close();
+}
+
+// ============ IVideoReader 接口实现 ============
+
+bool ImageSequenceReader::open(const char* path) {
+    // 使用第一张图片的分辨率，32bpp
+    return openRaw(path, 0, 0, 32);
+}
+
+bool ImageSequenceReader::openRaw(const char* path, int width, int height, int bits_per_pixel) {
+    if (!path) {
+        printf("❌ ERROR: Invalid image sequence path (nullptr)\n");
+        return false;
+    }
+
+    if (is_open_) {
+        printf("⚠️  Warning: Sequence already open, closing previous sequence\n");
+        close();
+    }
+
+    switch (bits_per_pixel) {
+        case 24:
+            output_pixel_format_ = AV_PIX_FMT_BGR24;
+            break;
+        case 32:
+            output_pixel_format_ = AV_PIX_FMT_BGRA;
+            break;
+        default:
+            printf("❌ ERROR: Unsupported bits_per_pixel: %d\n", bits_per_pixel);
+            return false;
+    }
+    bits_per_pixel_ = bits_per_pixel;
+
+    strncpy(path_, path, MAX_IMAGE_SEQUENCE_PATH_LENGTH - 1);
+    path_[MAX_IMAGE_SEQUENCE_PATH_LENGTH - 1] = '\0';
+
+    if (!resolveFiles(path)) {
+        return false;
+    }
+
+    int source_width = 0;
+    int source_height = 0;
+    if (!probeFirstImage(&source_width, &source_height)) {
+        printf("❌ ERROR: Failed to decode first image: %s\n", files_[0].c_str());
+        files_.clear();
+        return false;
+    }
+    width_ = width > 0 ? width : source_width;
+    height_ = height > 0 ? height : source_height;
+
+    // 预取缓存
+    int depth = prefetch_depth_ > 0 ? prefetch_depth_ : std::max(2, worker_count_ * 2);
+    slots_.clear();
+    slots_.resize(depth);
+    for (auto& slot : slots_) {
+        slot.frame_index = -1;
+        slot.state = SlotState::EMPTY;
+        slot.pinned = false;
+        slot.data.resize(getFrameSize());
+    }
+    prefetch_depth_ = depth;
+    decode_queue_.clear();
+
+    current_frame_index_ = 0;
+    decoded_frames_ = 0;
+    decode_errors_ = 0;
+    prefetch_hits_ = 0;
+    prefetch_misses_ = 0;
+    decode_time_us_ = 0;
+
+    is_open_ = true;
+    startWorkers();
+
+    // 立即开始预取开头的帧
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        scheduleLocked(0);
+    }
+
+    printf("✅ ImageSequenceReader: Opened '%s'\n", path_);
+    printf("   Images: %zu (%s ... %s)\n", files_.size(),
+           files_.front().c_str(), files_.back().c_str());
+    printf("   Resolution: %dx%d → %dx%d@%dbpp\n",
+           source_width, source_height, width_, height_, bits_per_pixel_);
+    printf("   Decode workers: %d, prefetch depth: %d\n", worker_count_, prefetch_depth_);
+
+    return true;
+}
+
+void ImageSequenceReader::close() {
+    stopWorkers();
+
+    slots_.clear();
+    decode_queue_.clear();
+
+    if (is_open_) {
+        is_open_ = false;
+        printf("✅ ImageSequenceReader: Closed '%s'\n", path_);
+        printStats();
+    }
+    files_.clear();
+    total_file_size_ = 0;
+}
+
+bool ImageSequenceReader::isOpen() const {
+    return is_open_;
+}
+
+bool ImageSequenceReader::readFrameTo(Buffer& dest_buffer) {
+    return readFrameTo(dest_buffer.getVirtualAddress(), dest_buffer.size());
+}
+
+bool ImageSequenceReader::readFrameTo(void* dest_buffer, size_t buffer_size) {
+    int frame_index = current_frame_index_.load();
+    if (frame_index >= getTotalFrames()) {
+        return false;
+    }
+    // 损坏的图片不阻塞播放：游标照常前进
+    current_frame_index_ = frame_index + 1;
+    return fetchFrame(frame_index, dest_buffer, buffer_size);
+}
+
+bool ImageSequenceReader::readFrameAt(int frame_index, Buffer& dest_buffer) {
+    return readFrameAt(frame_index, dest_buffer.getVirtualAddress(), dest_buffer.size());
+}
+
+bool ImageSequenceReader::readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) {
+    bool ok = fetchFrame(frame_index, dest_buffer, buffer_size);
+    if (frame_index >= 0 && frame_index < getTotalFrames()) {
+        current_frame_index_ = frame_index + 1;
+    }
+    return ok;
+}
+
+bool ImageSequenceReader::readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const {
+    // 预取缓存内部加锁，不修改播放游标
+    return const_cast<ImageSequenceReader*>(this)->fetchFrame(frame_index, dest_buffer, buffer_size);
+}
+
+bool ImageSequenceReader::seek(int frame_index) {
+    if (!is_open_ || frame_index < 0 || frame_index >= getTotalFrames()) {
+        printf("❌ ERROR: Invalid frame index %d (total: %d)\n", frame_index, getTotalFrames());
+        return false;
+    }
+
+    current_frame_index_ = frame_index;
+
+    // 从新位置开始预取
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    scheduleLocked(frame_index);
+    return true;
+}
+
+bool ImageSequenceReader::seekToBegin() {
+    return seek(0);
+}
+
+bool ImageSequenceReader::seekToEnd() {
+    if (!is_open_) {
+        return false;
+    }
+    current_frame_index_ = getTotalFrames();
+    return true;
+}
+
+bool ImageSequenceReader::skip(int frame_count) {
+    int target = current_frame_index_.load() + frame_count;
+    target = std::max(0, std::min(target, getTotalFrames() - 1));
+    return seek(target);
+}
+
+int ImageSequenceReader::getTotalFrames() const {
+    return (int)files_.size();
+}
+
+int ImageSequenceReader::getCurrentFrameIndex() const {
+    return current_frame_index_.load();
+}
+
+size_t ImageSequenceReader::getFrameSize() const {
+    return (size_t)width_ * height_ * getBytesPerPixel();
+}
+
+long ImageSequenceReader::getFileSize() const {
+    return total_file_size_;
+}
+
+int ImageSequenceReader::getWidth() const {
+    return width_;
+}
+
+int ImageSequenceReader::getHeight() const {
+    return height_;
+}
+
+int ImageSequenceReader::getBytesPerPixel() const {
+    return bits_per_pixel_ / 8;
+}
+
+const char* ImageSequenceReader::getPath() const {
+    return path_;
+}
+
+bool ImageSequenceReader::hasMoreFrames() const {
+    return current_frame_index_.load() < getTotalFrames();
+}
+
+bool ImageSequenceReader::isAtEnd() const {
+    return current_frame_index_.load() >= getTotalFrames();
+}
+
+const char* ImageSequenceReader::getReaderType() const {
+    return "ImageSequenceReader";
+}
+
+// ============ 图片序列特有接口 ============
+
+void ImageSequenceReader::setWorkerCount(int count) {
+    if (!is_open_ && count > 0) {
+        worker_count_ = count;
+    }
+}
+
+void ImageSequenceReader::setPrefetchDepth(int depth) {
+    if (!is_open_ && depth > 0) {
+        prefetch_depth_ = depth;
+    }
+}
+
+ImageSequenceReader::SequenceStats ImageSequenceReader::getSequenceStats() const {
+    SequenceStats stats;
+    stats.decoded_frames = decoded_frames_.load();
+    stats.decode_errors = decode_errors_.load();
+    stats.prefetch_hits = prefetch_hits_.load();
+    stats.prefetch_misses = prefetch_misses_.load();
+    stats.avg_decode_ms = stats.decoded_frames > 0
+        ? decode_time_us_.load() / 1000.0 / stats.decoded_frames : 0.0;
+    return stats;
+}
+
+void ImageSequenceReader::printStats() const {
+    SequenceStats stats = getSequenceStats();
+    int requests = stats.prefetch_hits + stats.prefetch_misses;
+
+    printf("\n📊 ImageSequenceReader Statistics:\n");
+    printf("   Decoded frames: %d (errors: %d)\n", stats.decoded_frames, stats.decode_errors);
+    printf("   Avg decode time: %.2f ms/frame (%d workers → ~%.1f fps)\n",
+           stats.avg_decode_ms, worker_count_,
+           stats.avg_decode_ms > 0 ? 1000.0 * worker_count_ / stats.avg_decode_ms : 0.0);
+    printf("   Prefetch: %d hits, %d misses (%.1f%% hit rate)\n",
+           stats.prefetch_hits, stats.prefetch_misses,
+           requests > 0 ? 100.0 * stats.prefetch_hits / requests : 0.0);
+}
+
+// ============ 文件列表 ============
+
+bool ImageSequenceReader::resolveFiles(const char* path) {
+    files_.clear();
+    total_file_size_ = 0;
+
+    bool ok;
+    struct stat st;
+    if (strchr(path, '%')) {
+        ok = resolvePattern(path);
+    } else if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+        ok = resolveDirectory(path);
+    } else if (codecForFile(path) != AV_CODEC_ID_NONE && fileExists(path, &total_file_size_)) {
+        // 单张图片：长度为 1 的序列
+        files_.push_back(path);
+        ok = true;
+    } else {
+        printf("❌ ERROR: '%s' is neither an image pattern, a directory nor an image\n", path);
+        return false;
+    }
+
+    if (!ok) {
+        return false;
+    }
+    if (files_.empty()) {
+        printf("❌ ERROR: No images found for '%s'\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool ImageSequenceReader::resolvePattern(const char* pattern) {
+    if (!isValidPattern(pattern)) {
+        printf("❌ ERROR: Invalid image pattern '%s' (expected one %%d / %%0Nd)\n", pattern);
+        return false;
+    }
+    if (codecForFile(pattern) == AV_CODEC_ID_NONE) {
+        printf("❌ ERROR: Unsupported image format: %s (png/jpg/jpeg/bmp)\n", pattern);
+        return false;
+    }
+
+    char file[MAX_IMAGE_SEQUENCE_PATH_LENGTH];
+    long size = 0;
+
+    // 起始编号：0~4 中第一个存在的文件（与 FFmpeg image2 的 start_number_range 一致）
+    int start = -1;
+    for (int n = 0; n < 5; n++) {
+        snprintf(file, sizeof(file), pattern, n);
+        if (fileExists(file, nullptr)) {
+            start = n;
+            break;
+        }
+    }
+    if (start < 0) {
+        return true;  // 由调用方报告“未找到”
+    }
+
+    for (int n = start; ; n++) {
+        snprintf(file, sizeof(file), pattern, n);
+        if (!fileExists(file, &size)) {
+            break;
+        }
+        files_.push_back(file);
+        total_file_size_ += size;
+    }
+    return true;
+}
+
+bool ImageSequenceReader::resolveDirectory(const char* dir) {
+    DIR* d = opendir(dir);
+    if (!d) {
+        printf("❌ ERROR: Cannot open directory '%s'\n", dir);
+        return false;
+    }
+
+    std::string prefix(dir);
+    if (!prefix.empty() && prefix.back() != '/') {
+        prefix += '/';
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string file = prefix + entry->d_name;
+        long size = 0;
+        if (codecForFile(file) != AV_CODEC_ID_NONE && fileExists(file.c_str(), &size)) {
+            files_.push_back(file);
+            total_file_size_ += size;
+        }
+    }
+    closedir(d);
+
+    std::sort(files_.begin(), files_.end(), naturalLess);
+    return true;
+}
+
+// ============ 解码 ============
+
+bool ImageSequenceReader::probeFirstImage(int* width, int* height) {
+    WorkerContext ctx;
+    ctx.codec_ctx = nullptr;
+    ctx.codec_id = AV_CODEC_ID_NONE;
+    ctx.packet = av_packet_alloc();
+    ctx.frame = av_frame_alloc();
+    ctx.sws_ctx = nullptr;
+
+    bool ok = ctx.packet && ctx.frame && loadImage(ctx, files_[0]);
+    if (ok) {
+        *width = ctx.frame->width;
+        *height = ctx.frame->height;
+    }
+
+    releaseWorkerContext(ctx);
+    return ok;
+}
+
+bool ImageSequenceReader::loadImage(WorkerContext& ctx, const std::string& file) {
+    AVCodecID codec_id = codecForFile(file);
+    if (codec_id == AV_CODEC_ID_NONE) {
+        return false;
+    }
+
+    // 读入整个文件（尾部补零，FFmpeg 解析器可能越界读取）
+    FILE* fp = fopen(file.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(fp);
+        return false;
+    }
+    ctx.file_data.resize((size_t)size + AV_INPUT_BUFFER_PADDING_SIZE);
+    size_t read_bytes = fread(ctx.file_data.data(), 1, (size_t)size, fp);
+    fclose(fp);
+    if (read_bytes != (size_t)size) {
+        return false;
+    }
+    memset(ctx.file_data.data() + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    // 解码上下文按编码类型复用（混合格式的目录才会重建）
+    if (!ctx.codec_ctx || ctx.codec_id != codec_id) {
+        avcodec_free_context(&ctx.codec_ctx);
+
+        const AVCodec* codec = avcodec_find_decoder(codec_id);
+        if (!codec) {
+            return false;
+        }
+        ctx.codec_ctx = avcodec_alloc_context3(codec);
+        if (!ctx.codec_ctx) {
+            return false;
+        }
+        ctx.codec_ctx->thread_count = 1;  // 并行度来自多张图片同时解码
+        if (avcodec_open2(ctx.codec_ctx, codec, nullptr) < 0) {
+            avcodec_free_context(&ctx.codec_ctx);
+            return false;
+        }
+        ctx.codec_id = codec_id;
+    }
+
+    ctx.packet->data = ctx.file_data.data();
+    ctx.packet->size = (int)size;
+    ctx.packet->flags = AV_PKT_FLAG_KEY;
+
+    if (avcodec_send_packet(ctx.codec_ctx, ctx.packet) < 0) {
+        avcodec_flush_buffers(ctx.codec_ctx);
+        return false;
+    }
+
+    int ret = avcodec_receive_frame(ctx.codec_ctx, ctx.frame);
+    if (ret == AVERROR(EAGAIN)) {
+        // 解码器缓存了输入：刷新取出，再复位以便下一张图片
+        avcodec_send_packet(ctx.codec_ctx, nullptr);
+        ret = avcodec_receive_frame(ctx.codec_ctx, ctx.frame);
+        avcodec_flush_buffers(ctx.codec_ctx);
+    }
+    return ret >= 0;
+}
+
+bool ImageSequenceReader::decodeImageTo(WorkerContext& ctx, const std::string& file, uint8_t* dest) {
+    if (!loadImage(ctx, file)) {
+        return false;
+    }
+
+    AVFrame* frame = ctx.frame;
+    ctx.sws_ctx = sws_getCachedContext(ctx.sws_ctx,
+        frame->width, frame->height, (AVPixelFormat)frame->format,
+        width_, height_, (AVPixelFormat)output_pixel_format_,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!ctx.sws_ctx) {
+        av_frame_unref(frame);
+        return false;
+    }
+
+    uint8_t* dest_data[1] = { dest };
+    int dest_linesize[1] = { width_ * getBytesPerPixel() };
+    sws_scale(ctx.sws_ctx, frame->data, frame->linesize, 0, frame->height,
+              dest_data, dest_linesize);
+
+    av_frame_unref(frame);
+    return true;
+}
+
+void ImageSequenceReader::releaseWorkerContext(WorkerContext& ctx) {
+    avcodec_free_context(&ctx.codec_ctx);
+    av_packet_free(&ctx.packet);
+    av_frame_free(&ctx.frame);
+    if (ctx.sws_ctx) {
+        sws_freeContext(ctx.sws_ctx);
+        ctx.sws_ctx = nullptr;
+    }
+}
+
+// ============ 工作线程 ============
+
+void ImageSequenceReader::startWorkers() {
+    stop_workers_ = false;
+    workers_.reserve(worker_count_);
+    for (int i = 0; i < worker_count_; i++) {
+        workers_.emplace_back(&ImageSequenceReader::workerThreadFunc, this, i);
+    }
+}
+
+void ImageSequenceReader::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        stop_workers_ = true;
+    }
+    queue_cv_.notify_all();
+    cache_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void ImageSequenceReader::workerThreadFunc(int worker_id) {
+    (void)worker_id;
+
+    WorkerContext ctx;
+    ctx.codec_ctx = nullptr;
+    ctx.codec_id = AV_CODEC_ID_NONE;
+    ctx.packet = av_packet_alloc();
+    ctx.frame = av_frame_alloc();
+    ctx.sws_ctx = nullptr;
+
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    while (true) {
+        queue_cv_.wait(lock, [this] {
+            return stop_workers_ || !decode_queue_.empty();
+        });
+        if (stop_workers_) {
+            break;
+        }
+
+        int slot_index = decode_queue_.front();
+        decode_queue_.pop_front();
+
+        // 槽位可能已被消费或重复入队（同一槽位重新分配时会再次排队）
+        Slot& slot = slots_[slot_index];
+        if (slot.state != SlotState::QUEUED) {
+            continue;
+        }
+        int frame_index = slot.frame_index;
+        slot.state = SlotState::DECODING;
+
+        // 解码期间不持锁：DECODING 状态的槽不会被复用或读取
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        bool ok = ctx.packet && ctx.frame &&
+                  decodeImageTo(ctx, files_[frame_index], slot.data.data());
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        lock.lock();
+
+        if (ok) {
+            decoded_frames_++;
+            decode_time_us_ += elapsed;
+            slot.state = SlotState::READY;
+        } else {
+            decode_errors_++;
+            slot.state = SlotState::FAILED;
+            printf("⚠️  Warning: Failed to decode image %s\n", files_[frame_index].c_str());
+        }
+        cache_cv_.notify_all();
+    }
+    lock.unlock();
+
+    releaseWorkerContext(ctx);
+}
+
+// ============ 预取缓存 ============
+
+int ImageSequenceReader::findSlotLocked(int frame_index) const {
+    for (size_t i = 0; i < slots_.size(); i++) {
+        if (slots_[i].frame_index == frame_index && slots_[i].state != SlotState::EMPTY) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool ImageSequenceReader::scheduleLocked(int frame_index) {
+    int total = getTotalFrames();
+    if (total == 0 || prefetch_depth_ == 0) {
+        return false;
+    }
+    frame_index %= total;
+
+    // 预取窗口：循环播放时在末尾回绕到开头，帧数少于深度时每帧只出现一次
+    int window = std::min(prefetch_depth_, total);
+    auto in_window = [&](int index) {
+        return index >= 0 && (index - frame_index + total) % total < window;
+    };
+
+    bool target_scheduled = false;
+    for (int k = 0; k < window; k++) {
+        int index = (frame_index + k) % total;
+        if (findSlotLocked(index) >= 0) {
+            if (k == 0) {
+                target_scheduled = true;
+            }
+            continue;  // 已在缓存中或已排队
+        }
+
+        // 复用空闲槽，其次是持有窗口外过期帧（seek 之后）的槽；
+        // 窗口内的帧不覆盖，否则回绕处两帧会互相抢占同一槽位
+        int reuse = -1;
+        for (size_t i = 0; i < slots_.size(); i++) {
+            const Slot& slot = slots_[i];
+            if (slot.state == SlotState::DECODING || slot.pinned) {
+                continue;
+            }
+            if (slot.state == SlotState::EMPTY) {
+                reuse = (int)i;
+                break;
+            }
+            if (reuse < 0 && !in_window(slot.frame_index)) {
+                reuse = (int)i;
+            }
+        }
+        if (reuse < 0) {
+            continue;  // 槽位忙，稍后重试
+        }
+
+        Slot& slot = slots_[reuse];
+        slot.frame_index = index;
+        slot.state = SlotState::QUEUED;
+        decode_queue_.push_back(reuse);
+        queue_cv_.notify_one();
+        if (k == 0) {
+            target_scheduled = true;
+        }
+    }
+    return target_scheduled;
+}
+
+bool ImageSequenceReader::fetchFrame(int frame_index, void* dest, size_t size) {
+    if (!is_open_ || frame_index < 0 || frame_index >= getTotalFrames()) {
+        return false;
+    }
+    size_t frame_size = getFrameSize();
+    if (size < frame_size) {
+        printf("❌ ERROR: Buffer too small: %zu < %zu\n", size, frame_size);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    Slot* found = nullptr;
+
+    bool waited = false;
+    while (true) {
+        if (stop_workers_) {
+            return false;
+        }
+        scheduleLocked(frame_index);
+        int index = findSlotLocked(frame_index);
+        if (index >= 0) {
+            found = &slots_[index];
+            if ((found->state == SlotState::READY || found->state == SlotState::FAILED) &&
+                !found->pinned) {
+                break;
+            }
+        }
+        waited = true;
+        cache_cv_.wait(lock);
+    }
+    Slot& slot = *found;
+
+    if (waited) {
+        prefetch_misses_++;
+    } else {
+        prefetch_hits_++;
+    }
+
+    bool ok = slot.state == SlotState::READY;
+    if (ok) {
+        // 拷贝期间不持锁，pinned 防止槽位被复用
+        slot.pinned = true;
+        lock.unlock();
+        MemoryKernels::copy(dest, slot.data.data(), frame_size);
+        lock.lock();
+        slot.pinned = false;
+    }
+
+    // 消费后释放槽位，继续向前预取
+    slot.frame_index = -1;
+    slot.state = SlotState::EMPTY;
+    scheduleLocked(frame_index + 1);
+    cache_cv_.notify_all();
+
+    return ok;
+}
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <errno.h>
 #include <stdio.h>
+#include <algorithm>
 
 // ============ 构造/析构 ============
 
@@ -289,6 +290,15 @@ const char* IoUringVideoReader::getReaderType() const {
     return "IoUringVideoReader";
 }
 
+void IoUringVideoReader::readaheadHint(int frame_index, int frame_count) const {
+    if (!is_open_ || frame_index < 0 || frame_index >= total_frames_ || frame_count <= 0) {
+        return;
+    }
+    int count = std::min(frame_count, total_frames_ - frame_index);
+    posix_fadvise(video_fd_, (off_t)frame_index * frame_size_, (off_t)count * frame_size_,
+                  POSIX_FADV_WILLNEED);
+}
+
 // ============ IoUring 专有接口（保留原有功能）TODO: 需要重新实现 ============
 
 void IoUringVideoReader::asyncProducerThread(int thread_id,
@@ -1,4 +1,5 @@
 #include "../../include/videoFile/MmapVideoReader.hpp"
+#include "../../include/cpu/MemoryKernels.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
@@ -7,6 +8,8 @@
 #include <sys/mman.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
+#include <algorithm>
 
 // ============ 构造函数 ============
 
@@ -21,6 +24,15 @@ MmapVideoReader::MmapVideoReader()
     , file_size_(0)
     , total_frames_(0)
     , current_frame_index_(0)
+    , requested_window_(0)
+    , window_frames_(0)
+    , window_count_(0)
+    , window_clock_(0)
+    , prefetch_index_(-1)
+    , mapping_index_(-1)
+    , prefetch_stop_(false)
+    , window_maps_(0)
+    , window_stalls_(0)
     , is_open_(false)
     , detected_format_(FileFormat::UNKNOWN)
 {
@@ -127,7 +139,7 @@ bool MmapVideoReader::open(const char* path) {
     printf("   Resolution: %dx%d\n", width_, height_);
     printf("   Bits per pixel: %d\n", bits_per_pixel_);
     printf("   Frame size: %zu bytes\n", frame_size_);
-    printf("   File size: %ld bytes\n", file_size_);
+    printf("   File size: %lld bytes\n", (long long)file_size_);
     printf("   Total frames: %d\n", total_frames_);
     
     return true;
@@ -185,7 +197,7 @@ bool MmapVideoReader::openRaw(const char* path, int width, int height, int bits_
     current_frame_index_ = 0;
     
     printf("✅ Raw video file opened successfully\n");
-    printf("   File size: %ld bytes\n", file_size_);
+    printf("   File size: %lld bytes\n", (long long)file_size_);
     printf("   Total frames: %d\n", total_frames_);
     
     return true;
@@ -239,10 +251,9 @@ bool MmapVideoReader::readFrameTo(void* dest_buffer, size_t buffer_size) {
         return false;
     }
     
-    size_t frame_offset = (size_t)current_frame_index_ * frame_size_;
-    const char* frame_addr = (const char*)mapped_file_ + frame_offset;
-    
-    memcpy(dest_buffer, frame_addr, frame_size_);
+    if (!copyFrame(current_frame_index_, dest_buffer)) {
+        return false;
+    }
     
     current_frame_index_++;
     return true;
@@ -261,7 +272,7 @@ bool MmapVideoReader::readFrameAt(int frame_index, void* dest_buffer, size_t buf
 }
 
 bool MmapVideoReader::readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const {
-    if (!is_open_ || mapped_file_ == nullptr) {
+    if (!is_open_ || (mapped_file_ == nullptr && window_frames_ == 0)) {
         return false;
     }
     
@@ -273,11 +284,7 @@ bool MmapVideoReader::readFrameAtThreadSafe(int frame_index, void* dest_buffer,
         return false;
     }
     
-    size_t frame_offset = (size_t)frame_index * frame_size_;
-    const char* frame_addr = (const char*)mapped_file_ + frame_offset;
-    
-    memcpy(dest_buffer, frame_addr, frame_size_);
-    return true;
+    return copyFrame(frame_index, dest_buffer);
 }
 
 bool MmapVideoReader::seek(int frame_index) {
@@ -328,7 +335,7 @@ size_t MmapVideoReader::getFrameSize() const {
 }
 
 long MmapVideoReader::getFileSize() const {
-    return file_size_;
+    return (long)file_size_;
 }
 
 int MmapVideoReader::getWidth() const {
@@ -359,6 +366,29 @@ const char* MmapVideoReader::getReaderType() const {
     return "MmapVideoReader";
 }
 
+void MmapVideoReader::readaheadHint(int frame_index, int frame_count) const {
+    if (!is_open_ || frame_index < 0 || frame_index >= total_frames_ || frame_count <= 0) {
+        return;
+    }
+    // 走 fd 而不是 madvise：窗口模式下目标帧可能还没有映射
+    int count = std::min(frame_count, total_frames_ - frame_index);
+    posix_fadvise(fd_, (off_t)frame_index * (off_t)frame_size_, (off_t)count * (off_t)frame_size_,
+                  POSIX_FADV_WILLNEED);
+}
+
+void MmapVideoReader::setProbeConfig(const StreamProbeConfig& config) {
+    setMapWindow(config.map_window_frames);
+}
+
+// ============ 映射方式 ============
+
+void MmapVideoReader::setMapWindow(int window_frames) {
+    if (is_open_) {
+        printf("⚠️  Warning: Map window takes effect on next open\n");
+    }
+    requested_window_ = window_frames;
+}
+
 // ============ 内部辅助方法 ============
 
 bool MmapVideoReader::validateFile() {
@@ -368,24 +398,24 @@ bool MmapVideoReader::validateFile() {
         return false;
     }
     
-    file_size_ = st.st_size;
+    file_size_ = (int64_t)st.st_size;
     
     if (file_size_ == 0) {
         printf("❌ ERROR: File is empty\n");
         return false;
     }
     
-    total_frames_ = file_size_ / frame_size_;
+    total_frames_ = (int)std::min<int64_t>(file_size_ / (int64_t)frame_size_, INT_MAX);
     
     if (total_frames_ == 0) {
-        printf("❌ ERROR: File too small (size=%ld, frame_size=%zu)\n",
-               file_size_, frame_size_);
+        printf("❌ ERROR: File too small (size=%lld, frame_size=%zu)\n",
+               (long long)file_size_, frame_size_);
         return false;
     }
     
-    if (file_size_ % frame_size_ != 0) {
-        printf("⚠️  Warning: File size (%ld) not aligned to frame size (%zu)\n",
-               file_size_, frame_size_);
+    if (file_size_ % (int64_t)frame_size_ != 0) {
+        printf("⚠️  Warning: File size (%lld) not aligned to frame size (%zu)\n",
+               (long long)file_size_, frame_size_);
         printf("   Last frame may be incomplete\n");
     }
     
@@ -476,29 +506,88 @@ bool MmapVideoReader::mapFile() {
     }
     
     if (file_size_ <= 0) {
-        printf("❌ ERROR: Invalid file size: %ld\n", file_size_);
+        printf("❌ ERROR: Invalid file size: %lld\n", (long long)file_size_);
         return false;
     }
     
-    mapped_file_ = mmap(NULL, file_size_, 
-                        PROT_READ, MAP_PRIVATE, 
-                        fd_, 0);
+    int auto_window = (int)std::max<size_t>(1, kDefaultWindowBytes / frame_size_);
+    int window = requested_window_;
+    if (window == 0) {
+        window = file_size_ > kAutoWindowThreshold ? auto_window : -1;
+    }
     
-    if (mapped_file_ == MAP_FAILED) {
-        printf("❌ ERROR: mmap failed: %s\n", strerror(errno));
+    if (window < 0) {
+        if ((uint64_t)file_size_ <= (uint64_t)SIZE_MAX) {
+            mapped_file_ = mmap(NULL, (size_t)file_size_,
+                                PROT_READ, MAP_PRIVATE,
+                                fd_, 0);
+            if (mapped_file_ != MAP_FAILED) {
+                mapped_size_ = (size_t)file_size_;
+                window_frames_ = 0;
+                printf("🗺️  File mapped to memory: address=%p, size=%zu bytes\n",
+                       mapped_file_, mapped_size_);
+                return true;
+            }
+            printf("⚠️  Warning: mmap of whole file failed: %s\n", strerror(errno));
+        }
         mapped_file_ = nullptr;
+        printf("   Falling back to windowed mapping\n");
+        window = auto_window;
+    }
+    
+    // 滑动窗口：先同步映射窗口 0（同时验证文件可映射），之后由后台线程预读
+    window_frames_ = std::min(window, total_frames_);
+    window_count_ = (total_frames_ + window_frames_ - 1) / window_frames_;
+    window_clock_ = 0;
+    prefetch_index_ = -1;
+    mapping_index_ = -1;
+    prefetch_stop_ = false;
+    
+    std::shared_ptr<MapWindow> first = mapWindow(0, false);
+    if (!first) {
+        window_frames_ = 0;
+        window_count_ = 0;
         return false;
     }
+    std::vector<std::shared_ptr<MapWindow>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(window_mutex_);
+        insertWindowLocked(first, &evicted);
+    }
+    if (window_count_ > 1) {
+        prefetch_thread_ = std::thread(&MmapVideoReader::prefetchLoop, this);
+    }
     
-    mapped_size_ = file_size_;
-    
-    printf("🗺️  File mapped to memory: address=%p, size=%zu bytes\n", 
-           mapped_file_, mapped_size_);
+    printf("🗺️  File mapped in windows: %d frames (%.1f MB) per window, %d windows, "
+           "up to %d resident\n", window_frames_,
+           (double)window_frames_ * frame_size_ / (1024.0 * 1024.0),
+           window_count_, kMaxResidentWindows);
     
     return true;
 }
 
 void MmapVideoReader::unmapFile() {
+    if (prefetch_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(window_mutex_);
+            prefetch_stop_ = true;
+        }
+        window_cv_.notify_all();
+        prefetch_thread_.join();
+    }
+    
+    if (window_frames_ > 0) {
+        printf("🗺️  Map windows: %llu mapped, %llu on demand (prefetch missed)\n",
+               (unsigned long long)window_maps_.load(),
+               (unsigned long long)window_stalls_.load());
+        std::lock_guard<std::mutex> lock(window_mutex_);
+        windows_.clear();
+        window_frames_ = 0;
+        window_count_ = 0;
+        window_maps_ = 0;
+        window_stalls_ = 0;
+    }
+    
     if (mapped_file_ != nullptr && mapped_size_ > 0) {
         if (munmap(mapped_file_, mapped_size_) < 0) {
             printf("⚠️  Warning: munmap failed: %s\n", strerror(errno));
@@ -508,9 +597,157 @@ void MmapVideoReader::unmapFile() {
     }
 }
 
+// ============ 滑动窗口 ============
 
+MmapVideoReader::MapWindow::~MapWindow() {
+    if (base) {
+        munmap(base, length);
+    }
+}
 
+std::shared_ptr<MmapVideoReader::MapWindow> MmapVideoReader::mapWindow(int index, bool populate) const {
+    static const int64_t page_size = sysconf(_SC_PAGESIZE);
+    
+    int first_frame = index * window_frames_;
+    int frames = std::min(window_frames_, total_frames_ - first_frame);
+    int64_t start = (int64_t)first_frame * (int64_t)frame_size_;
+    int64_t aligned = start - start % page_size;
+    
+    auto window = std::make_shared<MapWindow>();
+    window->index = index;
+    window->first_frame = first_frame;
+    window->delta = (size_t)(start - aligned);
+    window->length = window->delta + (size_t)frames * frame_size_;
+    
+    int flags = MAP_PRIVATE | (populate ? MAP_POPULATE : 0);
+    void* base = mmap(NULL, window->length, PROT_READ, flags, fd_, (off_t)aligned);
+    if (base == MAP_FAILED) {
+        printf("❌ ERROR: mmap of window %d (offset %lld, %zu bytes) failed: %s\n",
+               index, (long long)aligned, window->length, strerror(errno));
+        return nullptr;
+    }
+    if (!populate) {
+        madvise(base, window->length, MADV_WILLNEED);
+    }
+    window->base = base;
+    window_maps_++;
+    return window;
+}
 
+std::shared_ptr<MmapVideoReader::MapWindow> MmapVideoReader::insertWindowLocked(
+        const std::shared_ptr<MapWindow>& window,
+        std::vector<std::shared_ptr<MapWindow>>* evicted) const {
+    for (const auto& resident : windows_) {
+        if (resident->index == window->index) {
+            evicted->push_back(window);     // 其他线程已映射同一窗口，丢弃本次映射
+            return resident;
+        }
+    }
+    
+    window->last_used = ++window_clock_;
+    windows_.push_back(window);
+    while ((int)windows_.size() > kMaxResidentWindows) {
+        auto lru = std::min_element(windows_.begin(), windows_.end(),
+            [](const std::shared_ptr<MapWindow>& a, const std::shared_ptr<MapWindow>& b) {
+                return a->last_used < b->last_used;
+            });
+        evicted->push_back(*lru);
+        windows_.erase(lru);
+    }
+    return window;
+}
 
+std::shared_ptr<MmapVideoReader::MapWindow> MmapVideoReader::acquireWindow(int index) const {
+    std::vector<std::shared_ptr<MapWindow>> evicted;   // 在锁外析构（munmap）
+    std::shared_ptr<MapWindow> window;
+    
+    std::unique_lock<std::mutex> lock(window_mutex_);
+    while (!window) {
+        for (const auto& resident : windows_) {
+            if (resident->index == index) {
+                window = resident;
+                break;
+            }
+        }
+        if (window) {
+            break;
+        }
+        if (mapping_index_ == index) {
+            window_cv_.wait(lock);          // 后台线程正在映射，等它完成
+            continue;
+        }
+        
+        lock.unlock();
+        std::shared_ptr<MapWindow> mapped = mapWindow(index, false);
+        window_stalls_++;
+        lock.lock();
+        if (!mapped) {
+            return nullptr;
+        }
+        window = insertWindowLocked(mapped, &evicted);
+    }
+    window->last_used = ++window_clock_;
+    
+    // 安排后台映射下一个窗口（末尾回绕到 0，循环播放时无缝衔接）
+    int next = (index + 1) % window_count_;
+    if (next != index && next != mapping_index_ && next != prefetch_index_) {
+        bool resident = false;
+        for (const auto& w : windows_) {
+            if (w->index == next) {
+                resident = true;
+                break;
+            }
+        }
+        if (!resident) {
+            prefetch_index_ = next;
+            window_cv_.notify_all();
+        }
+    }
+    
+    lock.unlock();
+    return window;
+}
 
+void MmapVideoReader::prefetchLoop() {
+    std::vector<std::shared_ptr<MapWindow>> evicted;
+    std::unique_lock<std::mutex> lock(window_mutex_);
+    while (!prefetch_stop_) {
+        if (prefetch_index_ < 0) {
+            window_cv_.wait(lock);
+            continue;
+        }
+        int index = prefetch_index_;
+        prefetch_index_ = -1;
+        
+        mapping_index_ = index;
+        lock.unlock();
+        std::shared_ptr<MapWindow> window = mapWindow(index, true);
+        lock.lock();
+        mapping_index_ = -1;
+        if (window) {
+            insertWindowLocked(window, &evicted);
+        }
+        window_cv_.notify_all();
+        
+        lock.unlock();
+        evicted.clear();
+        lock.lock();
+    }
+}
 
+bool MmapVideoReader::copyFrame(int frame_index, void* dest_buffer) const {
+    if (window_frames_ == 0) {
+        const char* frame_addr = (const char*)mapped_file_ + (size_t)frame_index * frame_size_;
+        MemoryKernels::copy(dest_buffer, frame_addr, frame_size_);
+        return true;
+    }
+    
+    std::shared_ptr<MapWindow> window = acquireWindow(frame_index / window_frames_);
+    if (!window) {
+        return false;
+    }
+    const char* frame_addr = (const char*)window->base + window->delta +
+                             (size_t)(frame_index - window->first_frame) * frame_size_;
+    MemoryKernels::copy(dest_buffer, frame_addr, frame_size_);
+    return true;
+}
@@ -1,10 +1,12 @@
 #include "../../include/videoFile/RtspVideoReader.hpp"
 #include "../../include/buffer/BufferPool.hpp"
 #include "../../include/buffer/BufferHandle.hpp"
+#include "../../include/buffer/StagingPool.hpp"
 #include <stdio.h>
 #include <string.h>
 #include <chrono>
 #include <climits>  // for INT_MAX
+#include <algorithm>
 
 // FFmpeg headers
 extern "C" {
@@ -22,6 +24,8 @@ RtspVideoReader::RtspVideoReader()
     , codec_ctx_(nullptr)
     , sws_ctx_(nullptr)
     , video_stream_index_(-1)
+    , packet_(nullptr)
+    , frame_(nullptr)
     , width_(0)
     , height_(0)
     , output_pixel_format_(AV_PIX_FMT_BGRA)
@@ -30,8 +34,24 @@ RtspVideoReader::RtspVideoReader()
     , write_index_(0)
     , read_index_(0)
     , buffer_pool_(nullptr)
+    , eos_signaled_(false)
+    , cached_codecpar_(nullptr)
+    , abort_request_(false)
+    , last_read_error_(0)
+    , waiting_keyframe_(false)
+    , ttff_pending_(false)
+    , first_frame_pending_(false)
     , decoded_frames_(0)
     , dropped_frames_(0)
+    , reconnects_(0)
+    , failed_attempts_(0)
+    , fast_reconnects_(0)
+    , skipped_packets_(0)
+    , last_connect_us_(0)
+    , last_ttff_us_(0)
+    , total_ttff_us_(0)
+    , ttff_samples_(0)
+    , decode_allocations_(0)
     , is_open_(false)
     , eof_reached_(false)
 {
@@ -50,6 +70,16 @@ RtspVideoReader::RtspVideoReader()
 RtspVideoReader::~RtspVideoReader() {
     printf("🧹 Destroying RtspVideoReader...\n");
     close();
+    
+    if (cached_codecpar_) {
+        avcodec_parameters_free(&cached_codecpar_);
+    }
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+    if (frame_) {
+        av_frame_free(&frame_);
+    }
 }
 
 // ============ IVideoReader 接口实现 ============
@@ -97,12 +127,34 @@ bool RtspVideoReader::openRaw(const char* path, int width, int height, int bits_
         slot.filled = false;
     }
     
-    // 连接RTSP流
-    if (!connectRTSP()) {
+    // 新的流：丢弃上一次缓存的流参数
+    if (cached_codecpar_) {
+        avcodec_parameters_free(&cached_codecpar_);
+    }
+    abort_request_ = false;
+    waiting_keyframe_ = false;
+    ttff_pending_ = false;
+    
+    // 连接RTSP流（记录打开耗时分解）
+    {
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        open_timings_ = OpenTimings();
+    }
+    OpenTimings timings;
+    open_start_ = std::chrono::steady_clock::now();
+    if (!connectRTSP(&timings)) {
         return false;
     }
+    open_done_ = std::chrono::steady_clock::now();
+    first_frame_pending_ = true;
+    {
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        open_timings_ = timings;
+    }
     
     // 启动解码线程
+    eof_reached_ = false;
+    eos_signaled_ = false;
     running_ = true;
     decode_thread_ = std::thread(&RtspVideoReader::decodeThreadFunc, this);
     
@@ -119,8 +171,9 @@ void RtspVideoReader::close() {
     
     printf("\n🛑 Closing RTSP stream...\n");
     
-    // 停止解码线程
+    // 停止解码线程（同时中断阻塞中的 av_read_frame / 重连）
     running_ = false;
+    abort_request_ = true;
     buffer_cv_.notify_all();
     
     if (decode_thread_.joinable()) {
@@ -136,6 +189,10 @@ void RtspVideoReader::close() {
     printf("✅ RTSP stream closed\n");
     printf("   Decoded frames: %d\n", decoded_frames_.load());
     printf("   Dropped frames: %d\n", dropped_frames_.load());
+    if (reconnects_.load() > 0 || failed_attempts_.load() > 0) {
+        printf("   Reconnects: %d (failed attempts: %d)\n",
+               reconnects_.load(), failed_attempts_.load());
+    }
 }
 
 bool RtspVideoReader::isOpen() const {
@@ -273,12 +330,88 @@ void RtspVideoReader::printStats() const {
     printf("   Connected: %s\n", connected_.load() ? "Yes" : "No");
     printf("   Decoded frames: %d\n", decoded_frames_.load());
     printf("   Dropped frames: %d\n", dropped_frames_.load());
+    printf("   Decode allocations: %llu (packet/frame objects, staging frames; reused in steady state)\n",
+           (unsigned long long)decode_allocations_.load());
     printf("   Zero-copy mode: %s\n", buffer_pool_ ? "Enabled" : "Disabled");
+    getOpenTimings().print("RtspVideoReader");
+    
+    ReconnectStats stats = getReconnectStats();
+    printf("   Auto reconnect: %s\n", reconnect_config_.enabled ? "Enabled" : "Disabled");
+    if (stats.reconnects > 0 || stats.failed_attempts > 0) {
+        printf("   Reconnects: %d (fast path: %d, failed attempts: %d)\n",
+               stats.reconnects, stats.fast_reconnects, stats.failed_attempts);
+        printf("   Packets skipped waiting for IDR: %d\n", stats.skipped_packets);
+        printf("   Last reconnect: session %.1f ms, first frame %.1f ms\n",
+               stats.last_connect_ms, stats.last_ttff_ms);
+        printf("   Average time-to-first-frame: %.1f ms\n", stats.avg_ttff_ms);
+    }
+}
+
+void RtspVideoReader::setProbeConfig(const StreamProbeConfig& config) {
+    if (!is_open_) {
+        probe_config_ = config;
+    }
+}
+
+OpenTimings RtspVideoReader::getOpenTimings() const {
+    std::lock_guard<std::mutex> lock(timing_mutex_);
+    return open_timings_;
+}
+
+RtspVideoReader::ReconnectStats RtspVideoReader::getReconnectStats() const {
+    ReconnectStats stats;
+    stats.reconnects = reconnects_.load();
+    stats.failed_attempts = failed_attempts_.load();
+    stats.fast_reconnects = fast_reconnects_.load();
+    stats.skipped_packets = skipped_packets_.load();
+    stats.last_connect_ms = last_connect_us_.load() / 1000.0;
+    stats.last_ttff_ms = last_ttff_us_.load() / 1000.0;
+    int samples = ttff_samples_.load();
+    stats.avg_ttff_ms = samples > 0 ? total_ttff_us_.load() / 1000.0 / samples : 0.0;
+    return stats;
 }
 
 // ============ 内部实现 ============
 
-bool RtspVideoReader::connectRTSP() {
+bool RtspVideoReader::connectRTSP(OpenTimings* timings) {
+    // 1. 打开 RTSP 会话（按探测预算探测，或使用调用方参数）
+    if (!openInput(false, timings)) {
+        return false;
+    }
+    
+    // 2. 创建解码器和格式转换上下文
+    auto decoder_start = std::chrono::steady_clock::now();
+    if (!openDecoder()) {
+        avformat_close_input(&format_ctx_);
+        return false;
+    }
+    if (timings) {
+        timings->decoder_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - decoder_start).count();
+    }
+    
+    // 3. 缓存流参数（含 SPS/PPS extradata），重连时跳过探测
+    AVCodecParameters* codecpar = format_ctx_->streams[video_stream_index_]->codecpar;
+    if (!cached_codecpar_) {
+        cached_codecpar_ = avcodec_parameters_alloc();
+    }
+    if (cached_codecpar_ && avcodec_parameters_copy(cached_codecpar_, codecpar) < 0) {
+        avcodec_parameters_free(&cached_codecpar_);
+    }
+    
+    connected_ = true;
+    
+    printf("✅ Connected to RTSP stream\n");
+    printf("   Codec: %s\n", codec_ctx_->codec->long_name);
+    printf("   Stream resolution: %dx%d\n", codec_ctx_->width, codec_ctx_->height);
+    printf("   Output resolution: %dx%d\n", width_, height_);
+    
+    return true;
+}
+
+bool RtspVideoReader::openInput(bool fast, OpenTimings* timings) {
+    auto start = std::chrono::steady_clock::now();
+    
     // 1. 分配格式上下文
     format_ctx_ = avformat_alloc_context();
     if (!format_ctx_) {
@@ -286,11 +419,31 @@ bool RtspVideoReader::connectRTSP() {
         return false;
     }
     
+    // close() 时中断阻塞中的 DESCRIBE/SETUP/PLAY 和 av_read_frame
+    format_ctx_->interrupt_callback.callback = &RtspVideoReader::interruptCallback;
+    format_ctx_->interrupt_callback.opaque = this;
+    
     // 2. 设置RTSP选项（超时、传输协议等）
     AVDictionary* options = nullptr;
     av_dict_set(&options, "rtsp_transport", "tcp", 0);  // 使用TCP传输
     av_dict_set(&options, "stimeout", "5000000", 0);    // 5秒超时
     av_dict_set(&options, "max_delay", "500000", 0);    // 最大延迟0.5秒
+    if (fast) {
+        // 流参数已知：不读取探测数据
+        av_dict_set(&options, "probesize", "32", 0);
+        av_dict_set(&options, "analyzeduration", "0", 0);
+        av_dict_set(&options, "fpsprobesize", "0", 0);
+    } else {
+        if (probe_config_.probesize >= 0) {
+            av_dict_set_int(&options, "probesize", probe_config_.probesize, 0);
+        }
+        if (probe_config_.analyzeduration_us >= 0) {
+            av_dict_set_int(&options, "analyzeduration", probe_config_.analyzeduration_us, 0);
+        }
+        if (probe_config_.fpsprobesize >= 0) {
+            av_dict_set_int(&options, "fpsprobesize", probe_config_.fpsprobesize, 0);
+        }
+    }
     
     // 3. 打开RTSP流
     int ret = avformat_open_input(&format_ctx_, rtsp_url_, nullptr, &options);
@@ -300,20 +453,14 @@ bool RtspVideoReader::connectRTSP() {
         char errbuf[128];
         av_strerror(ret, errbuf, sizeof(errbuf));
         setError(std::string("Failed to open RTSP stream: ") + errbuf);
-        avformat_free_context(format_ctx_);
+        // avformat_open_input 失败时已释放上下文
         format_ctx_ = nullptr;
         return false;
     }
     
-    // 4. 获取流信息
-    ret = avformat_find_stream_info(format_ctx_, nullptr);
-    if (ret < 0) {
-        setError("Failed to find stream information");
-        avformat_close_input(&format_ctx_);
-        return false;
-    }
+    auto connected = std::chrono::steady_clock::now();
     
-    // 5. 查找视频流
+    // 4. 查找视频流（SDP 已给出各流的编码类型）
     video_stream_index_ = -1;
     for (unsigned int i = 0; i < format_ctx_->nb_streams; i++) {
         if (format_ctx_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
@@ -322,48 +469,122 @@ bool RtspVideoReader::connectRTSP() {
         }
     }
     
+    // 5. 获取流信息（快速路径 / 调用方提供了可用的编码参数时跳过）
+    bool skip_probe = fast;
+    if (!fast && probe_config_.hasCodecParams() && video_stream_index_ != -1) {
+        skip_probe = applyCodecParams(format_ctx_->streams[video_stream_index_]->codecpar);
+        if (!skip_probe) {
+            printf("⚠️  Warning: Supplied codec parameters not usable, probing stream\n");
+        }
+    }
+    
+    if (!skip_probe) {
+        ret = avformat_find_stream_info(format_ctx_, nullptr);
+        if (ret < 0) {
+            setError("Failed to find stream information");
+            avformat_close_input(&format_ctx_);
+            return false;
+        }
+    }
+    
     if (video_stream_index_ == -1) {
         setError("No video stream found in RTSP source");
         avformat_close_input(&format_ctx_);
         return false;
     }
     
-    // 6. 获取解码器
+    if (timings) {
+        auto now = std::chrono::steady_clock::now();
+        timings->connect_ms = std::chrono::duration<double, std::milli>(connected - start).count();
+        timings->probe_ms = std::chrono::duration<double, std::milli>(now - connected).count();
+        timings->probe_skipped = skip_probe;
+    }
+    
+    // 6. 快速路径：SDP 未携带完整参数时用缓存补齐（extradata、分辨率）
+    if (fast && cached_codecpar_) {
+        AVCodecParameters* codecpar = format_ctx_->streams[video_stream_index_]->codecpar;
+        if (codecpar->codec_id == cached_codecpar_->codec_id &&
+            (codecpar->extradata_size == 0 || codecpar->width == 0)) {
+            avcodec_parameters_copy(codecpar, cached_codecpar_);
+        }
+    }
+    
+    return true;
+}
+
+bool RtspVideoReader::applyCodecParams(AVCodecParameters* codecpar) {
+    const AVCodec* codec = avcodec_find_decoder_by_name(probe_config_.codec_name.c_str());
+    if (!codec) {
+        setError("Unknown codec in probe config: " + probe_config_.codec_name);
+        return false;
+    }
+    
+    if (probe_config_.width <= 0 || probe_config_.height <= 0) {
+        setError("Probe config codec parameters require width/height");
+        return false;
+    }
+    
+    // SDP 声明了不同的编码类型：参数不可信
+    if (codecpar->codec_id != AV_CODEC_ID_NONE && codecpar->codec_id != codec->id) {
+        return false;
+    }
+    
+    codecpar->codec_id = codec->id;
+    codecpar->width = probe_config_.width;
+    codecpar->height = probe_config_.height;
+    
+    // SDP 的 sprop-parameter-sets 优先；没有时使用调用方提供的 extradata
+    if (codecpar->extradata_size == 0 && !probe_config_.extradata.empty()) {
+        size_t size = probe_config_.extradata.size();
+        uint8_t* extradata = (uint8_t*)av_mallocz(size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!extradata) {
+            return false;
+        }
+        memcpy(extradata, probe_config_.extradata.data(), size);
+        codecpar->extradata = extradata;
+        codecpar->extradata_size = (int)size;
+    }
+    
+    return true;
+}
+
+bool RtspVideoReader::openDecoder() {
+    // 1. 获取解码器
     AVCodecParameters* codecpar = format_ctx_->streams[video_stream_index_]->codecpar;
     const AVCodec* codec = avcodec_find_decoder(codecpar->codec_id);
     if (!codec) {
         setError("Codec not found");
-        avformat_close_input(&format_ctx_);
         return false;
     }
     
-    // 7. 分配解码器上下文
+    // 2. 分配解码器上下文
     codec_ctx_ = avcodec_alloc_context3(codec);
     if (!codec_ctx_) {
         setError("Failed to allocate codec context");
-        avformat_close_input(&format_ctx_);
         return false;
     }
     
-    // 8. 复制编解码器参数
-    ret = avcodec_parameters_to_context(codec_ctx_, codecpar);
+    // 3. 复制编解码器参数
+    int ret = avcodec_parameters_to_context(codec_ctx_, codecpar);
     if (ret < 0) {
         setError("Failed to copy codec parameters");
         avcodec_free_context(&codec_ctx_);
-        avformat_close_input(&format_ctx_);
         return false;
     }
     
-    // 9. 打开解码器
+    // 4. 打开解码器
     ret = avcodec_open2(codec_ctx_, codec, nullptr);
     if (ret < 0) {
         setError("Failed to open codec");
         avcodec_free_context(&codec_ctx_);
-        avformat_close_input(&format_ctx_);
         return false;
     }
     
-    // 10. 初始化格式转换上下文
+    // 5. 初始化格式转换上下文（跳过探测时像素格式要到首帧才确定，由解码线程创建）
+    if (codec_ctx_->pix_fmt == AV_PIX_FMT_NONE) {
+        return true;
+    }
+    
     sws_ctx_ = sws_getContext(
         codec_ctx_->width, codec_ctx_->height, codec_ctx_->pix_fmt,
         width_, height_, (AVPixelFormat)output_pixel_format_,
@@ -373,17 +594,9 @@ bool RtspVideoReader::connectRTSP() {
     if (!sws_ctx_) {
         setError("Failed to initialize SwsContext");
         avcodec_free_context(&codec_ctx_);
-        avformat_close_input(&format_ctx_);
         return false;
     }
     
-    connected_ = true;
-    
-    printf("✅ Connected to RTSP stream\n");
-    printf("   Codec: %s\n", codec->long_name);
-    printf("   Stream resolution: %dx%d\n", codec_ctx_->width, codec_ctx_->height);
-    printf("   Output resolution: %dx%d\n", width_, height_);
-    
     return true;
 }
 
@@ -407,6 +620,95 @@ void RtspVideoReader::disconnectRTSP() {
     connected_ = false;
 }
 
+bool RtspVideoReader::reconnectRTSP() {
+    auto disconnect_time = std::chrono::steady_clock::now();
+    connected_ = false;
+    
+    // 只关闭会话；解码器和 SwsContext 保温
+    if (format_ctx_) {
+        avformat_close_input(&format_ctx_);
+        format_ctx_ = nullptr;
+    }
+    
+    printf("🔌 RTSP connection lost, reconnecting...\n");
+    
+    int backoff_ms = reconnect_config_.initial_backoff_ms;
+    int attempt = 0;
+    
+    while (running_) {
+        attempt++;
+        
+        bool fast = reconnect_config_.reuse_stream_params &&
+                    cached_codecpar_ != nullptr && codec_ctx_ != nullptr;
+        bool ok = false;
+        
+        if (fast) {
+            ok = openInput(true);
+            if (ok && format_ctx_->streams[video_stream_index_]->codecpar->codec_id !=
+                      codec_ctx_->codec_id) {
+                // 编码类型变化：保温的解码器不可用，回退到完整连接
+                printf("⚠️  Warning: RTSP codec changed, falling back to full reconnect\n");
+                avformat_close_input(&format_ctx_);
+                ok = false;
+                fast = false;
+            }
+            if (ok) {
+                // 丢弃断线前残留的参考帧，从下一个 IDR 开始解码
+                avcodec_flush_buffers(codec_ctx_);
+            }
+        }
+        
+        if (!fast) {
+            disconnectRTSP();
+            ok = connectRTSP();
+        }
+        
+        if (ok) {
+            auto now = std::chrono::steady_clock::now();
+            last_connect_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                now - disconnect_time).count();
+            disconnect_time_ = disconnect_time;
+            waiting_keyframe_ = true;
+            ttff_pending_ = true;
+            connected_ = true;
+            reconnects_++;
+            if (fast) {
+                fast_reconnects_++;
+            }
+            
+            printf("✅ RTSP reconnected (%s path, attempt %d, %.1f ms)\n",
+                   fast ? "fast" : "full", attempt, last_connect_us_.load() / 1000.0);
+            return true;
+        }
+        
+        failed_attempts_++;
+        
+        if (reconnect_config_.max_attempts > 0 && attempt >= reconnect_config_.max_attempts) {
+            setError("RTSP reconnect gave up after " + std::to_string(attempt) + " attempts");
+            return false;
+        }
+        
+        printf("⚠️  Warning: RTSP reconnect attempt %d failed, retrying in %d ms\n",
+               attempt, backoff_ms);
+        
+        // 退避等待（close() 通过 buffer_cv_ 唤醒）
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            buffer_cv_.wait_for(lock, std::chrono::milliseconds(backoff_ms),
+                                [this] { return !running_; });
+        }
+        
+        backoff_ms = std::min(backoff_ms * 2, reconnect_config_.max_backoff_ms);
+    }
+    
+    return false;
+}
+
+int RtspVideoReader::interruptCallback(void* opaque) {
+    RtspVideoReader* self = static_cast<RtspVideoReader*>(opaque);
+    return self->abort_request_.load() ? 1 : 0;
+}
+
 void RtspVideoReader::decodeThreadFunc() {
     printf("🚀 RTSP decode thread started\n");
     
@@ -414,98 +716,179 @@ void RtspVideoReader::decodeThreadFunc() {
         // 解码一帧
         AVFrame* frame = decodeOneFrame();
         if (!frame) {
+            // 网络错误 / 服务端关闭：自动重连
+            if (last_read_error_ < 0 && last_read_error_ != AVERROR(EAGAIN) &&
+                reconnect_config_.enabled && running_) {
+                if (reconnectRTSP()) {
+                    continue;
+                }
+                if (!running_) {
+                    break;
+                }
+                // 重连失败：视为流结束，解码线程退出
+                eof_reached_ = true;
+                eos_signaled_ = true;
+                emitSourceEvent(SourceEvent::END_OF_STREAM);
+                break;
+            }
+            if (eof_reached_ && !eos_signaled_) {
+                eos_signaled_ = true;
+                emitSourceEvent(SourceEvent::END_OF_STREAM);
+            }
             // 解码失败或超时
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
         
+        if (first_frame_pending_) {
+            // 打开后的首帧：补全打开耗时分解
+            first_frame_pending_ = false;
+            auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(timing_mutex_);
+            open_timings_.first_frame_ms = std::chrono::duration<double, std::milli>(now - open_done_).count();
+            open_timings_.total_ms = std::chrono::duration<double, std::milli>(now - open_start_).count();
+            open_timings_.print("RtspVideoReader");
+        }
+        
+        if (ttff_pending_) {
+            // 重连后的首帧：记录 断开 → 首帧 耗时
+            ttff_pending_ = false;
+            uint64_t ttff_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - disconnect_time_).count();
+            last_ttff_us_ = ttff_us;
+            total_ttff_us_ += ttff_us;
+            ttff_samples_++;
+            printf("🎞️  First frame after reconnect: %.1f ms\n", ttff_us / 1000.0);
+        }
+        
+        // 解码输出尺寸/格式变化（如重连后）时重建转换上下文，未变化时原样返回
+        sws_ctx_ = sws_getCachedContext(sws_ctx_,
+            frame->width, frame->height, (AVPixelFormat)frame->format,
+            width_, height_, (AVPixelFormat)output_pixel_format_,
+            SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!sws_ctx_) {
+            setError("Failed to update SwsContext");
+            av_frame_unref(frame);
+            continue;
+        }
+        
         if (buffer_pool_) {
             // ✨ 零拷贝模式：直接注入BufferPool
-            
-            // 分配目标buffer（临时，用于转换）
-            size_t frame_size = width_ * height_ * getBytesPerPixel();
-            std::unique_ptr<uint8_t[]> temp_buffer(new uint8_t[frame_size]);
-            
-            // 转换格式到临时buffer
-            uint8_t* dest_data[1] = { temp_buffer.get() };
-            int dest_linesize[1] = { width_ * getBytesPerPixel() };
-            
-            sws_scale(sws_ctx_,
-                     frame->data, frame->linesize, 0, frame->height,
-                     dest_data, dest_linesize);
-            
-            // 包装为BufferHandle并注入
-            auto handle = std::make_unique<BufferHandle>(
-                temp_buffer.release(),  // 转移所有权
-                0,  // 物理地址（暂时不可用）
-                frame_size,
-                [](void* ptr) {
-                    // Deleter: 释放临时buffer
-                    delete[] reinterpret_cast<uint8_t*>(ptr);
-                }
-            );
-            
-            buffer_pool_->injectFilledBuffer(std::move(handle));
-            decoded_frames_++;
-            
+            injectFrame(frame);
         } else {
             // 传统模式：存储到内部缓冲区
             storeToInternalBuffer(frame);
             decoded_frames_++;
         }
         
-        // 释放AVFrame
-        av_frame_free(&frame);
+        // 解码帧缓冲还给解码器的帧池（AVFrame 本身留给下一帧复用）
+        av_frame_unref(frame);
     }
     
     printf("🏁 RTSP decode thread finished\n");
 }
 
-AVFrame* RtspVideoReader::decodeOneFrame() {
-    AVPacket* packet = av_packet_alloc();
-    AVFrame* frame = av_frame_alloc();
+void RtspVideoReader::injectFrame(AVFrame* frame) {
+    size_t frame_size = width_ * height_ * getBytesPerPixel();
+    if (!staging_pool_ || staging_pool_->frame_size != frame_size) {
+        staging_pool_ = std::make_shared<StagingPool>(frame_size);
+        decode_allocations_++;
+    }
+    
+    // 暂存内存：优先复用消费者已归还的
+    bool allocated = false;
+    uint8_t* staging = staging_pool_->acquire(&allocated);
+    if (allocated) {
+        decode_allocations_++;
+    }
+    
+    // 转换格式到暂存内存
+    uint8_t* dest_data[1] = { staging };
+    int dest_linesize[1] = { width_ * getBytesPerPixel() };
+    
+    sws_scale(sws_ctx_,
+             frame->data, frame->linesize, 0, frame->height,
+             dest_data, dest_linesize);
+    
+    // 包装为BufferHandle并注入（释放时回到暂存池）
+    std::shared_ptr<StagingPool> pool = staging_pool_;
+    auto handle = std::make_unique<BufferHandle>(
+        staging,
+        0,  // 物理地址（暂时不可用）
+        frame_size,
+        [pool](void* ptr) {
+            pool->recycle(reinterpret_cast<uint8_t*>(ptr));
+        }
+    );
     
-    if (!packet || !frame) {
-        if (packet) av_packet_free(&packet);
-        if (frame) av_frame_free(&frame);
+    decoded_frames_++;
+    if (buffer_pool_->injectFilledBuffer(std::move(handle))) {
+        emitSourceEvent(SourceEvent::FRAME_AVAILABLE);
+    } else {
+        // 注入失败：handle 已随之释放（内存回到暂存池）
+        dropped_frames_++;
+        emitSourceEvent(SourceEvent::FRAME_DROPPED);
+    }
+}
+
+AVFrame* RtspVideoReader::decodeOneFrame() {
+    if (!packet_) {
+        packet_ = av_packet_alloc();
+        decode_allocations_++;
+    }
+    if (!frame_) {
+        frame_ = av_frame_alloc();
+        decode_allocations_++;
+    }
+    if (!packet_ || !frame_) {
         return nullptr;
     }
     
+    AVPacket* packet = packet_;
+    AVFrame* frame = frame_;
+    av_frame_unref(frame);
+    
     // 读取包
     int ret = av_read_frame(format_ctx_, packet);
+    last_read_error_ = ret < 0 ? ret : 0;
     if (ret < 0) {
-        if (ret == AVERROR_EOF) {
+        if (ret == AVERROR_EOF && !reconnect_config_.enabled) {
             eof_reached_ = true;
         }
-        av_packet_free(&packet);
-        av_frame_free(&frame);
         return nullptr;
     }
     
     // 只处理视频流的包
     if (packet->stream_index != video_stream_index_) {
-        av_packet_free(&packet);
-        av_frame_free(&frame);
+        av_packet_unref(packet);
         return nullptr;
     }
     
+    // 重连后从关键帧恢复：之前的包缺少参考帧，解码只会产生花屏
+    if (waiting_keyframe_) {
+        if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+            skipped_packets_++;
+            av_packet_unref(packet);
+            return nullptr;
+        }
+        waiting_keyframe_ = false;
+    }
+    
     // 发送包到解码器
     ret = avcodec_send_packet(codec_ctx_, packet);
-    av_packet_free(&packet);
+    av_packet_unref(packet);
     
     if (ret < 0) {
-        av_frame_free(&frame);
         return nullptr;
     }
     
     // 接收解码后的帧
     ret = avcodec_receive_frame(codec_ctx_, frame);
     if (ret < 0) {
-        av_frame_free(&frame);
         return nullptr;
     }
     
-    return frame;  // 调用者负责释放
+    return frame;  // reader 持有，下一次解码前有效
 }
 
 void RtspVideoReader::storeToInternalBuffer(AVFrame* frame) {
@@ -567,6 +950,18 @@ bool RtspVideoReader::copyFromInternalBuffer(void* dest, size_t size) {
     return true;
 }
 
+void RtspVideoReader::setSourceEventCallback(SourceEventCallback callback) {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    event_callback_ = callback;
+}
+
+void RtspVideoReader::emitSourceEvent(SourceEvent event) {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    if (event_callback_) {
+        event_callback_(event);
+    }
+}
+
 void RtspVideoReader::setError(const std::string& error) {
     std::lock_guard<std::mutex> lock(error_mutex_);
     last_error_ = error;
@@ -0,0 +1,970 @@
+#include "../../include/videoFile/V4l2CaptureReader.hpp"
+#include "../../include/buffer/BufferPool.hpp"
+#include "../../include/buffer/BufferHandle.hpp"
+#include "../../include/cpu/MemoryKernels.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <climits>
+#include <algorithm>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+inline int64_t monotonicMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * ioctl 包装：被信号打断时重试
+ */
+int xioctl(int fd, unsigned long request, void* arg) {
+    int ret;
+    do {
+        ret = ioctl(fd, request, arg);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+void fourccToString(uint32_t fourcc, char out[5]) {
+    out[0] = (char)(fourcc & 0xff);
+    out[1] = (char)((fourcc >> 8) & 0xff);
+    out[2] = (char)((fourcc >> 16) & 0xff);
+    out[3] = (char)((fourcc >> 24) & 0xff);
+    out[4] = '\0';
+}
+
+}  // namespace
+
+// ============ MmapState ============
+
+V4l2CaptureReader::MmapState::~MmapState() {
+    for (size_t i = 0; i < addrs.size(); i++) {
+        if (addrs[i] && addrs[i] != MAP_FAILED) {
+            munmap(addrs[i], lengths[i]);
+        }
+    }
+    for (int dma_fd : dma_fds) {
+        if (dma_fd >= 0) {
+            ::close(dma_fd);
+        }
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool V4l2CaptureReader::MmapState::queue(int index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!streaming) {
+        return false;  // 已停止采集（Reader 关闭后才被释放的 buffer）
+    }
+
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    return xioctl(fd, VIDIOC_QBUF, &buf) == 0;
+}
+
+// ============ 构造/析构 ============
+
+V4l2CaptureReader::V4l2CaptureReader()
+    : fd_(-1)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(32)
+    , pixel_format_(0)
+    , bytes_per_line_(0)
+    , size_image_(0)
+    , requested_mode_(MemoryMode::AUTO)
+    , memory_mode_(MemoryMode::MMAP)
+    , buffer_count_(4)
+    , streaming_(false)
+    , running_(false)
+    , buffer_pool_(nullptr)
+    , pool_is_dynamic_(false)
+    , observer_id_(-1)
+    , display_latency_sum_us_(0)
+    , display_latency_min_us_(0)
+    , display_latency_max_us_(0)
+    , display_samples_(0)
+    , dequeue_latency_sum_us_(0)
+    , captured_frames_(0)
+    , dropped_frames_(0)
+    , sequence_gaps_(0)
+    , last_sequence_(0)
+    , has_sequence_(false)
+    , current_frame_index_(0)
+    , is_open_(false)
+{
+    device_path_[0] = '\0';
+}
+
+V4l2CaptureReader::~V4l2CaptureReader() {
+    close();
+}
+
+// ============ IVideoReader 接口实现 ============
+
+bool V4l2CaptureReader::open(const char* path) {
+    // 使用设备当前分辨率
+    return openRaw(path, 0, 0, 32);
+}
+
+bool V4l2CaptureReader::openRaw(const char* path, int width, int height, int bits_per_pixel) {
+    if (!path) {
+        setError("Invalid device path (nullptr)");
+        return false;
+    }
+
+    if (is_open_) {
+        printf("⚠️  Warning: Device already open, closing previous device\n");
+        close();
+    }
+
+    strncpy(device_path_, path, MAX_V4L2_PATH_LENGTH - 1);
+    device_path_[MAX_V4L2_PATH_LENGTH - 1] = '\0';
+
+    printf("\n📷 Opening V4L2 device: %s\n", device_path_);
+
+    fd_ = ::open(device_path_, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        setError(std::string("Cannot open ") + device_path_ + ": " + strerror(errno));
+        return false;
+    }
+
+    if (!configureDevice(width, height, bits_per_pixel)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    captured_frames_ = 0;
+    dropped_frames_ = 0;
+    sequence_gaps_ = 0;
+    dequeue_latency_sum_us_ = 0;
+    display_latency_sum_us_ = 0;
+    display_latency_min_us_ = 0;
+    display_latency_max_us_ = 0;
+    display_samples_ = 0;
+    has_sequence_ = false;
+    current_frame_index_ = 0;
+    is_open_ = true;
+
+    char fourcc[5];
+    fourccToString(pixel_format_, fourcc);
+    printf("✅ V4L2 device opened: %s (%s)\n", card_name_.c_str(), driver_name_.c_str());
+    printf("   Format: %dx%d %s, stride %u, image %u bytes\n",
+           width_, height_, fourcc, bytes_per_line_, size_image_);
+    return true;
+}
+
+void V4l2CaptureReader::close() {
+    running_ = false;
+    if (capture_thread_.joinable()) {
+        capture_thread_.join();
+    }
+
+    if (buffer_pool_ && observer_id_ >= 0) {
+        buffer_pool_->removeFrameObserver(observer_id_);
+        observer_id_ = -1;
+    }
+
+    stopStreaming();
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    if (is_open_) {
+        is_open_ = false;
+        printf("✅ V4L2 device closed: %s\n", device_path_);
+        printStats();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        capture_times_.clear();
+    }
+    buffer_pool_ = nullptr;
+}
+
+bool V4l2CaptureReader::isOpen() const {
+    return is_open_;
+}
+
+bool V4l2CaptureReader::readFrameTo(Buffer& dest_buffer) {
+    return readFrameTo(dest_buffer.getVirtualAddress(), dest_buffer.size());
+}
+
+bool V4l2CaptureReader::readFrameTo(void* dest_buffer, size_t buffer_size) {
+    if (!is_open_) {
+        return false;
+    }
+    if (buffer_pool_) {
+        // 推送模式：帧已由采集线程提交/注入 BufferPool
+        return true;
+    }
+
+    // 传统模式：首次读取时以 MMAP 方式开始采集
+    if (!streaming_) {
+        memory_mode_ = MemoryMode::MMAP;
+        if (!startStreaming()) {
+            return false;
+        }
+    }
+
+    struct v4l2_buffer buf;
+    int ret = dequeueBuffer(&buf, 1000);
+    if (ret <= 0) {
+        if (ret == 0) {
+            printf("⚠️  Warning: V4L2 capture timeout\n");
+        }
+        return false;
+    }
+
+    recordCapture(buf);
+
+    // 按行拷贝（驱动的 bytesperline 可能有对齐填充）
+    const uint8_t* src = static_cast<const uint8_t*>(mmap_state_->addrs[buf.index]);
+    uint8_t* dst = static_cast<uint8_t*>(dest_buffer);
+    size_t row_bytes = (size_t)width_ * getBytesPerPixel();
+    size_t rows = std::min((size_t)height_, buffer_size / row_bytes);
+    if (bytes_per_line_ == row_bytes) {
+        MemoryKernels::copy(dst, src, rows * row_bytes);
+    } else {
+        for (size_t y = 0; y < rows; y++) {
+            memcpy(dst + y * row_bytes, src + y * bytes_per_line_, row_bytes);
+        }
+    }
+
+    mmap_state_->queue(buf.index);
+    current_frame_index_++;
+    return true;
+}
+
+bool V4l2CaptureReader::readFrameAt(int frame_index, Buffer& dest_buffer) {
+    (void)frame_index;
+    return readFrameTo(dest_buffer);
+}
+
+bool V4l2CaptureReader::readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) {
+    (void)frame_index;
+    return readFrameTo(dest_buffer, buffer_size);
+}
+
+bool V4l2CaptureReader::readFrameAtThreadSafe(int frame_index, void* dest_buffer, size_t buffer_size) const {
+    // 实时采集不支持随机访问，忽略frame_index
+    (void)frame_index;
+    return const_cast<V4l2CaptureReader*>(this)->readFrameTo(dest_buffer, buffer_size);
+}
+
+bool V4l2CaptureReader::seek(int frame_index) {
+    (void)frame_index;
+    printf("⚠️  Warning: V4L2 capture does not support seeking\n");
+    return false;
+}
+
+bool V4l2CaptureReader::seekToBegin() {
+    return seek(0);
+}
+
+bool V4l2CaptureReader::seekToEnd() {
+    return seek(0);
+}
+
+bool V4l2CaptureReader::skip(int frame_count) {
+    (void)frame_count;
+    printf("⚠️  Warning: V4L2 capture does not support frame skipping\n");
+    return false;
+}
+
+int V4l2CaptureReader::getTotalFrames() const {
+    // 实时采集无总帧数
+    return INT_MAX;
+}
+
+int V4l2CaptureReader::getCurrentFrameIndex() const {
+    return buffer_pool_ ? captured_frames_.load() : current_frame_index_;
+}
+
+size_t V4l2CaptureReader::getFrameSize() const {
+    return (size_t)width_ * height_ * getBytesPerPixel();
+}
+
+long V4l2CaptureReader::getFileSize() const {
+    return -1;
+}
+
+int V4l2CaptureReader::getWidth() const {
+    return width_;
+}
+
+int V4l2CaptureReader::getHeight() const {
+    return height_;
+}
+
+int V4l2CaptureReader::getBytesPerPixel() const {
+    return bits_per_pixel_ / 8;
+}
+
+const char* V4l2CaptureReader::getPath() const {
+    return device_path_;
+}
+
+bool V4l2CaptureReader::hasMoreFrames() const {
+    return is_open_;
+}
+
+bool V4l2CaptureReader::isAtEnd() const {
+    return !is_open_;
+}
+
+const char* V4l2CaptureReader::getReaderType() const {
+    return "V4l2CaptureReader";
+}
+
+// ============ 零拷贝 / 推送源 ============
+
+void V4l2CaptureReader::setBufferPool(void* pool) {
+    if (!is_open_ || !pool) {
+        buffer_pool_ = static_cast<BufferPool*>(pool);
+        return;
+    }
+
+    // 传统模式已开始采集：切换到推送模式前先停止
+    running_ = false;
+    if (capture_thread_.joinable()) {
+        capture_thread_.join();
+    }
+    stopStreaming();
+
+    buffer_pool_ = static_cast<BufferPool*>(pool);
+    pool_is_dynamic_ = buffer_pool_->getTotalCount() == 0;
+
+    // 选择内存类型：预分配且足够大的 pool 优先 DMABUF 导入
+    bool dmabuf_capable = !pool_is_dynamic_ && buffer_pool_->getBufferSize() >= size_image_;
+    MemoryMode mode = requested_mode_;
+    if (mode == MemoryMode::AUTO) {
+        mode = dmabuf_capable ? MemoryMode::DMABUF : MemoryMode::MMAP;
+    } else if (mode == MemoryMode::DMABUF && !dmabuf_capable) {
+        printf("⚠️  Warning: DMABUF needs a pre-allocated pool with buffers >= %u bytes, using MMAP\n",
+               size_image_);
+        mode = MemoryMode::MMAP;
+    }
+
+    memory_mode_ = mode;
+    bool started = startStreaming();
+    if (!started && mode == MemoryMode::DMABUF && requested_mode_ == MemoryMode::AUTO) {
+        printf("⚠️  Warning: DMABUF import failed, falling back to MMAP\n");
+        memory_mode_ = MemoryMode::MMAP;
+        started = startStreaming();
+    }
+    if (!started) {
+        buffer_pool_ = nullptr;
+        return;
+    }
+
+    // 消费者释放 buffer 时统计采集到显示延迟
+    observer_id_ = buffer_pool_->addFrameObserver([this](const Buffer* buffer) {
+        onBufferReleased(buffer);
+    });
+
+    running_ = true;
+    capture_thread_ = std::thread(&V4l2CaptureReader::captureThreadFunc, this);
+
+    const char* path_desc = memory_mode_ == MemoryMode::DMABUF ? "DMABUF import (zero-copy)"
+                          : pool_is_dynamic_ ? "MMAP inject (zero-copy, no phys_addr)"
+                          : "MMAP + memcpy into pool";
+    printf("✅ V4l2CaptureReader: Push mode enabled, %s\n", path_desc);
+}
+
+void V4l2CaptureReader::setSourceEventCallback(SourceEventCallback callback) {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    event_callback_ = callback;
+}
+
+// ============ V4L2 特有接口 ============
+
+void V4l2CaptureReader::setMemoryMode(MemoryMode mode) {
+    if (!streaming_) {
+        requested_mode_ = mode;
+    }
+}
+
+void V4l2CaptureReader::setBufferCount(int count) {
+    if (!streaming_ && count >= 2) {
+        buffer_count_ = count;
+    }
+}
+
+const char* V4l2CaptureReader::memoryModeToString(MemoryMode mode) {
+    switch (mode) {
+        case MemoryMode::AUTO:   return "AUTO";
+        case MemoryMode::MMAP:   return "MMAP";
+        case MemoryMode::DMABUF: return "DMABUF";
+        default:                 return "UNKNOWN";
+    }
+}
+
+// ============ 设备配置 ============
+
+bool V4l2CaptureReader::configureDevice(int width, int height, int bits_per_pixel) {
+    struct v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (xioctl(fd_, VIDIOC_QUERYCAP, &cap) < 0) {
+        setError(std::string("VIDIOC_QUERYCAP failed: ") + strerror(errno));
+        return false;
+    }
+    driver_name_ = (const char*)cap.driver;
+    card_name_ = (const char*)cap.card;
+
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE)) {
+        setError("Device is not a single-planar video capture device");
+        return false;
+    }
+    if (!(caps & V4L2_CAP_STREAMING)) {
+        setError("Device does not support streaming I/O");
+        return false;
+    }
+
+    // 候选像素格式（内存序与 framebuffer 一致）
+    std::vector<uint32_t> candidates;
+    switch (bits_per_pixel) {
+        case 32:
+            candidates = { V4L2_PIX_FMT_XBGR32, V4L2_PIX_FMT_ABGR32, V4L2_PIX_FMT_BGR32 };
+            break;
+        case 24:
+            candidates = { V4L2_PIX_FMT_BGR24 };
+            break;
+        default:
+            setError("Unsupported bits_per_pixel: " + std::to_string(bits_per_pixel));
+            return false;
+    }
+
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_G_FMT, &fmt) < 0) {
+        setError(std::string("VIDIOC_G_FMT failed: ") + strerror(errno));
+        return false;
+    }
+    if (width <= 0 || height <= 0) {
+        width = fmt.fmt.pix.width;
+        height = fmt.fmt.pix.height;
+    }
+
+    bool accepted = false;
+    for (uint32_t pixfmt : candidates) {
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = width;
+        fmt.fmt.pix.height = height;
+        fmt.fmt.pix.pixelformat = pixfmt;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+        if (xioctl(fd_, VIDIOC_S_FMT, &fmt) == 0 && fmt.fmt.pix.pixelformat == pixfmt) {
+            accepted = true;
+            break;
+        }
+    }
+    if (!accepted) {
+        setError("Device supports none of the requested " + std::to_string(bits_per_pixel) +
+                 "bpp BGR formats");
+        return false;
+    }
+
+    width_ = fmt.fmt.pix.width;
+    height_ = fmt.fmt.pix.height;
+    bits_per_pixel_ = bits_per_pixel;
+    pixel_format_ = fmt.fmt.pix.pixelformat;
+    bytes_per_line_ = fmt.fmt.pix.bytesperline;
+    size_image_ = fmt.fmt.pix.sizeimage;
+
+    if (width_ != width || height_ != height) {
+        printf("⚠️  Warning: Driver adjusted resolution %dx%d → %dx%d\n", width, height, width_, height_);
+    }
+    if (bytes_per_line_ != (uint32_t)(width_ * getBytesPerPixel())) {
+        printf("⚠️  Warning: Padded stride (%u bytes/line), zero-copy display expects packed rows\n",
+               bytes_per_line_);
+    }
+    return true;
+}
+
+// ============ 流式 I/O ============
+
+bool V4l2CaptureReader::startStreaming() {
+    bool ok = memory_mode_ == MemoryMode::DMABUF ? setupDmabufBuffers() : setupMmapBuffers();
+    if (!ok) {
+        stopStreaming();
+        return false;
+    }
+
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+        setError(std::string("VIDIOC_STREAMON failed: ") + strerror(errno));
+        stopStreaming();
+        return false;
+    }
+
+    streaming_ = true;
+    has_sequence_ = false;
+    printf("🚀 V4L2 streaming started (%s, %d buffers)\n",
+           memoryModeToString(memory_mode_),
+           memory_mode_ == MemoryMode::DMABUF ? (int)dmabuf_slots_.size()
+                                              : (int)mmap_state_->addrs.size());
+    return true;
+}
+
+bool V4l2CaptureReader::setupMmapBuffers() {
+    struct v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = buffer_count_;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        setError(std::string("VIDIOC_REQBUFS (MMAP) failed: ") + strerror(errno));
+        return false;
+    }
+
+    auto state = std::make_shared<MmapState>();
+    state->fd = dup(fd_);
+
+    for (uint32_t i = 0; i < req.count; i++) {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0) {
+            setError(std::string("VIDIOC_QUERYBUF failed: ") + strerror(errno));
+            return false;
+        }
+
+        void* addr = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+        if (addr == MAP_FAILED) {
+            setError(std::string("mmap failed: ") + strerror(errno));
+            return false;
+        }
+        state->addrs.push_back(addr);
+        state->lengths.push_back(buf.length);
+
+        // 导出 DMA-BUF fd，供下游（编码器/GPU）导入；驱动不支持时为 -1
+        struct v4l2_exportbuffer expbuf;
+        memset(&expbuf, 0, sizeof(expbuf));
+        expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        expbuf.index = i;
+        expbuf.flags = O_RDONLY | O_CLOEXEC;
+        state->dma_fds.push_back(xioctl(fd_, VIDIOC_EXPBUF, &expbuf) == 0 ? expbuf.fd : -1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->streaming = true;
+    }
+    for (uint32_t i = 0; i < req.count; i++) {
+        if (!state->queue(i)) {
+            setError(std::string("VIDIOC_QBUF failed: ") + strerror(errno));
+            return false;
+        }
+    }
+
+    mmap_state_ = state;
+    return true;
+}
+
+bool V4l2CaptureReader::setupDmabufBuffers() {
+    struct v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = buffer_count_;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_DMABUF;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        setError(std::string("VIDIOC_REQBUFS (DMABUF) failed: ") + strerror(errno));
+        return false;
+    }
+
+    dmabuf_slots_.assign(req.count, nullptr);
+
+    // 采集设备直接写入 buffer，生产侧没有 CPU 写入，不需要 cache flush；
+    // 带缓存的 buffer 上 CPU 消费者（memcpy 显示、录制、转储、校验）读取前必须 invalidate，
+    // 消费侧至少 READ
+    Buffer::CpuAccess consumer = buffer_pool_->getConsumerCpuAccess();
+    if (buffer_pool_->isCpuCached()) {
+        consumer = static_cast<Buffer::CpuAccess>(static_cast<int>(consumer) |
+                                                  static_cast<int>(Buffer::CpuAccess::READ));
+    }
+    buffer_pool_->setCpuAccessSync(Buffer::CpuAccess::NONE, consumer);
+
+    // 驱动槽位多于 pool 空闲 buffer 时剩余槽位留空，消费者释放后再补充
+    int queued = 0;
+    for (uint32_t i = 0; i < req.count; i++) {
+        Buffer* buffer = buffer_pool_->acquireFree(true, 100);
+        if (!buffer) {
+            break;
+        }
+        if (!queueDmabufSlot(i, buffer)) {
+            buffer_pool_->releaseFilled(buffer);
+            return false;
+        }
+        queued++;
+    }
+
+    if (queued < 2) {
+        setError("Not enough free BufferPool buffers for DMABUF capture (need >= 2)");
+        return false;
+    }
+    return true;
+}
+
+bool V4l2CaptureReader::queueDmabufSlot(int index, Buffer* buffer) {
+    int dma_fd = buffer->getDmaBufFd();
+    if (dma_fd < 0) {
+        dma_fd = buffer_pool_->exportBufferAsDmaBuf(buffer->id());
+    }
+    if (dma_fd < 0) {
+        setError("Buffer #" + std::to_string(buffer->id()) + " cannot be exported as DMA-BUF");
+        return false;
+    }
+
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_DMABUF;
+    buf.index = index;
+    buf.m.fd = dma_fd;
+    buf.length = buffer->size();
+    if (xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+        setError(std::string("VIDIOC_QBUF (DMABUF) failed: ") + strerror(errno));
+        return false;
+    }
+
+    dmabuf_slots_[index] = buffer;
+    return true;
+}
+
+void V4l2CaptureReader::refillDmabufSlots(int timeout_ms) {
+    for (size_t i = 0; i < dmabuf_slots_.size(); i++) {
+        if (dmabuf_slots_[i]) {
+            continue;
+        }
+        Buffer* buffer = buffer_pool_->acquireFree(timeout_ms > 0, timeout_ms);
+        if (!buffer) {
+            return;  // 消费者仍持有所有 buffer
+        }
+        if (!queueDmabufSlot((int)i, buffer)) {
+            buffer_pool_->releaseFilled(buffer);
+            return;
+        }
+    }
+}
+
+void V4l2CaptureReader::stopStreaming() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    // 先让 MMAP deleter 停止 QBUF，映射由共享状态在最后一个引用释放时解除
+    if (mmap_state_) {
+        std::lock_guard<std::mutex> lock(mmap_state_->mutex);
+        mmap_state_->streaming = false;
+    }
+
+    if (streaming_) {
+        int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd_, VIDIOC_STREAMOFF, &type);
+        streaming_ = false;
+    }
+
+    // 归还仍在驱动队列中的 pool buffer
+    for (Buffer*& buffer : dmabuf_slots_) {
+        if (buffer) {
+            buffer_pool_->releaseFilled(buffer);
+            buffer = nullptr;
+        }
+    }
+    if (!dmabuf_slots_.empty()) {
+        dmabuf_slots_.clear();
+        struct v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_DMABUF;
+        xioctl(fd_, VIDIOC_REQBUFS, &req);
+    }
+
+    mmap_state_.reset();
+}
+
+int V4l2CaptureReader::dequeueBuffer(struct v4l2_buffer* buf, int timeout_ms) {
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    int ret = poll(&pfd, 1, timeout_ms);
+    if (ret < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (ret == 0) {
+        return 0;
+    }
+    if (pfd.revents & POLLERR) {
+        // 驱动队列为空（所有 buffer 都在消费者手里）：稍后重试
+        usleep(2000);
+        return 0;
+    }
+
+    memset(buf, 0, sizeof(*buf));
+    buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf->memory = memory_mode_ == MemoryMode::DMABUF ? V4L2_MEMORY_DMABUF : V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_DQBUF, buf) < 0) {
+        if (errno == EAGAIN) {
+            return 0;
+        }
+        setError(std::string("VIDIOC_DQBUF failed: ") + strerror(errno));
+        return -1;
+    }
+    return 1;
+}
+
+// ============ 采集线程 ============
+
+void V4l2CaptureReader::captureThreadFunc() {
+    printf("🚀 V4L2 capture thread started\n");
+
+    while (running_) {
+        if (memory_mode_ == MemoryMode::DMABUF) {
+            bool any_queued = std::any_of(dmabuf_slots_.begin(), dmabuf_slots_.end(),
+                                          [](Buffer* b) { return b != nullptr; });
+            // 驱动队列空时阻塞等待消费者归还，否则只做非阻塞补充
+            refillDmabufSlots(any_queued ? 0 : 100);
+            if (!any_queued && std::none_of(dmabuf_slots_.begin(), dmabuf_slots_.end(),
+                                            [](Buffer* b) { return b != nullptr; })) {
+                continue;
+            }
+        }
+
+        struct v4l2_buffer buf;
+        int ret = dequeueBuffer(&buf, 200);
+        if (ret == 0) {
+            continue;
+        }
+        if (ret < 0) {
+            emitSourceEvent(SourceEvent::END_OF_STREAM);
+            break;
+        }
+
+        if (memory_mode_ == MemoryMode::DMABUF) {
+            handleDmabufFrame(buf);
+        } else {
+            handleMmapFrame(buf);
+        }
+    }
+
+    printf("🏁 V4L2 capture thread finished\n");
+}
+
+void V4l2CaptureReader::handleDmabufFrame(const struct v4l2_buffer& buf) {
+    Buffer* buffer = dmabuf_slots_[buf.index];
+    dmabuf_slots_[buf.index] = nullptr;
+    if (!buffer) {
+        return;
+    }
+
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        // 采集出错的帧直接重新排队
+        dropped_frames_++;
+        emitSourceEvent(SourceEvent::FRAME_DROPPED);
+        if (!queueDmabufSlot(buf.index, buffer)) {
+            buffer_pool_->releaseFilled(buffer);
+        }
+        return;
+    }
+
+    int64_t capture_us = recordCapture(buf);
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        capture_times_[buffer] = capture_us;
+    }
+
+    // ✨ 驱动直接写入了 pool buffer（带物理地址），无需拷贝
+    buffer_pool_->submitFilled(buffer);
+    emitSourceEvent(SourceEvent::FRAME_AVAILABLE);
+}
+
+void V4l2CaptureReader::handleMmapFrame(const struct v4l2_buffer& buf) {
+    int index = buf.index;
+
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        dropped_frames_++;
+        emitSourceEvent(SourceEvent::FRAME_DROPPED);
+        mmap_state_->queue(index);
+        return;
+    }
+
+    int64_t capture_us = recordCapture(buf);
+    void* addr = mmap_state_->addrs[index];
+    size_t frame_size = getFrameSize();
+
+    if (pool_is_dynamic_) {
+        // 零拷贝注入：消费者 releaseFilled() 时 deleter 重新 QBUF
+        std::shared_ptr<MmapState> state = mmap_state_;
+        auto handle = std::make_unique<BufferHandle>(
+            addr,
+            0,  // 驱动 vmalloc/MMAP 内存无可用物理地址
+            frame_size,
+            [state, index](void*) {
+                state->queue(index);
+            }
+        );
+
+        // 先记录时间再注入，避免消费者先于记录释放
+        std::unique_lock<std::mutex> lock(latency_mutex_);
+        Buffer* injected = buffer_pool_->injectFilledBuffer(std::move(handle));
+        if (injected) {
+            capture_times_[injected] = capture_us;
+            lock.unlock();
+            if (state->dma_fds[index] >= 0) {
+                injected->setDmaBufFd(state->dma_fds[index]);
+            }
+            emitSourceEvent(SourceEvent::FRAME_AVAILABLE);
+        } else {
+            lock.unlock();
+            // 注入失败时 handle 已被销毁，deleter 已重新 QBUF
+            dropped_frames_++;
+            emitSourceEvent(SourceEvent::FRAME_DROPPED);
+        }
+        return;
+    }
+
+    // 预分配但不可导入的 pool：拷贝一次
+    Buffer* buffer = buffer_pool_->acquireFree(false);
+    if (!buffer) {
+        dropped_frames_++;
+        emitSourceEvent(SourceEvent::FRAME_DROPPED);
+        mmap_state_->queue(index);
+        return;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(addr);
+    uint8_t* dst = static_cast<uint8_t*>(buffer->getVirtualAddress());
+    size_t row_bytes = (size_t)width_ * getBytesPerPixel();
+    if (bytes_per_line_ == row_bytes) {
+        MemoryKernels::copy(dst, src, std::min(frame_size, buffer->size()));
+    } else {
+        size_t rows = std::min((size_t)height_, buffer->size() / row_bytes);
+        for (size_t y = 0; y < rows; y++) {
+            memcpy(dst + y * row_bytes, src + y * bytes_per_line_, row_bytes);
+        }
+    }
+    mmap_state_->queue(index);
+
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        capture_times_[buffer] = capture_us;
+    }
+    buffer_pool_->submitFilled(buffer);
+    emitSourceEvent(SourceEvent::FRAME_AVAILABLE);
+}
+
+// ============ 延迟统计 ============
+
+int64_t V4l2CaptureReader::recordCapture(const struct v4l2_buffer& buf) {
+    captured_frames_++;
+
+    if (has_sequence_ && buf.sequence != last_sequence_ + 1) {
+        sequence_gaps_ += (int)(buf.sequence - last_sequence_ - 1);
+    }
+    last_sequence_ = buf.sequence;
+    has_sequence_ = true;
+
+    int64_t now_us = monotonicMicros();
+    int64_t capture_us = now_us;
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        capture_us = (int64_t)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec;
+    }
+    dequeue_latency_sum_us_ += now_us - capture_us;
+    return capture_us;
+}
+
+void V4l2CaptureReader::onBufferReleased(const Buffer* buffer) {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    auto it = capture_times_.find(buffer);
+    if (it == capture_times_.end()) {
+        return;
+    }
+
+    int64_t latency_us = monotonicMicros() - it->second;
+    capture_times_.erase(it);
+
+    if (display_samples_ == 0 || latency_us < display_latency_min_us_) {
+        display_latency_min_us_ = latency_us;
+    }
+    if (display_samples_ == 0 || latency_us > display_latency_max_us_) {
+        display_latency_max_us_ = latency_us;
+    }
+    display_latency_sum_us_ += latency_us;
+    display_samples_++;
+}
+
+V4l2CaptureReader::CaptureStats V4l2CaptureReader::getCaptureStats() const {
+    CaptureStats stats;
+    stats.captured_frames = captured_frames_.load();
+    stats.dropped_frames = dropped_frames_.load();
+    stats.sequence_gaps = sequence_gaps_.load();
+    stats.avg_dequeue_ms = stats.captured_frames > 0
+        ? dequeue_latency_sum_us_.load() / 1000.0 / stats.captured_frames : 0.0;
+
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    stats.display_samples = display_samples_;
+    stats.avg_display_ms = display_samples_ > 0
+        ? display_latency_sum_us_ / 1000.0 / display_samples_ : 0.0;
+    stats.min_display_ms = display_latency_min_us_ / 1000.0;
+    stats.max_display_ms = display_latency_max_us_ / 1000.0;
+    return stats;
+}
+
+void V4l2CaptureReader::printStats() const {
+    CaptureStats stats = getCaptureStats();
+
+    printf("\n📊 V4l2CaptureReader Statistics:\n");
+    printf("   Memory mode: %s\n", memoryModeToString(memory_mode_));
+    printf("   Captured frames: %d, dropped: %d, driver sequence gaps: %d\n",
+           stats.captured_frames, stats.dropped_frames, stats.sequence_gaps);
+    printf("   Capture → dequeue: %.2f ms avg\n", stats.avg_dequeue_ms);
+    if (stats.display_samples > 0) {
+        printf("   Capture → display: %.2f ms avg, %.2f min, %.2f max (%d samples)\n",
+               stats.avg_display_ms, stats.min_display_ms, stats.max_display_ms,
+               stats.display_samples);
+    }
+}
+
+// ============ 事件 / 错误 ============
+
+void V4l2CaptureReader::emitSourceEvent(SourceEvent event) {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    if (event_callback_) {
+        event_callback_(event);
+    }
+}
+
+void V4l2CaptureReader::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = error;
+    printf("❌ V4l2CaptureReader Error: %s\n", error.c_str());
+}
+
+std::string V4l2CaptureReader::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
@@ -0,0 +1,143 @@
+#include "../../include/videoFile/VideoCursor.hpp"
+#include "../../include/videoFile/VideoFile.hpp"
+#include <stdio.h>
+#include <algorithm>
+
+// ============ 构造 ============
+
+VideoCursor::VideoCursor(std::shared_ptr<const VideoFile> file, int start_frame)
+    : VideoCursor(file.get(), start_frame)
+{
+    if (file_) {
+        owner_ = std::move(file);
+    }
+}
+
+VideoCursor::VideoCursor(const VideoFile* file, int start_frame)
+    : file_(file)
+    , position_(start_frame)
+    , readahead_frames_(kDefaultReadaheadFrames)
+    , last_index_(-1)
+    , sequential_run_(0)
+    , readahead_end_(0)
+{
+    // 与 VideoFile::createCursor 相同的检查：只有支持并发按帧号读取的 Reader 可以共享
+    if (file_ && (!file_->isOpen() || !file_->supportsCursors())) {
+        printf("❌ ERROR: Cannot create cursor, %s\n",
+               file_->isOpen() ? "reader does not support cursors" : "file not opened");
+        file_ = nullptr;
+    }
+}
+
+std::unique_ptr<VideoCursor> VideoCursor::clone() const {
+    std::unique_ptr<VideoCursor> copy(new VideoCursor(file_, position_));
+    copy->owner_ = owner_;
+    copy->readahead_frames_ = readahead_frames_;
+    return copy;
+}
+
+// ============ 读取操作 ============
+
+bool VideoCursor::readFrameTo(Buffer& dest_buffer) {
+    return readFrameTo(dest_buffer.data(), dest_buffer.size());
+}
+
+bool VideoCursor::readFrameTo(void* dest_buffer, size_t buffer_size) {
+    if (!file_ || position_ < 0 || position_ >= file_->getTotalFrames()) {
+        return false;
+    }
+
+    updateReadahead(position_);
+    if (!file_->readFrameAtThreadSafe(position_, dest_buffer, buffer_size)) {
+        return false;
+    }
+    position_++;
+    return true;
+}
+
+bool VideoCursor::readFrameAt(int frame_index, Buffer& dest_buffer) {
+    return readFrameAt(frame_index, dest_buffer.data(), dest_buffer.size());
+}
+
+bool VideoCursor::readFrameAt(int frame_index, void* dest_buffer, size_t buffer_size) {
+    if (!seek(frame_index)) {
+        return false;
+    }
+    return readFrameTo(dest_buffer, buffer_size);
+}
+
+// ============ 导航操作 ============
+
+bool VideoCursor::seek(int frame_index) {
+    if (!file_ || frame_index < 0 || frame_index >= file_->getTotalFrames()) {
+        return false;
+    }
+    position_ = frame_index;
+    return true;
+}
+
+bool VideoCursor::seekToBegin() {
+    return seek(0);
+}
+
+bool VideoCursor::seekToEnd() {
+    if (!file_) {
+        return false;
+    }
+    position_ = file_->getTotalFrames();
+    return true;
+}
+
+bool VideoCursor::skip(int frame_count) {
+    return seek(position_ + frame_count);
+}
+
+// ============ 信息查询 ============
+
+int VideoCursor::getTotalFrames() const {
+    return file_ ? file_->getTotalFrames() : 0;
+}
+
+size_t VideoCursor::getFrameSize() const {
+    return file_ ? file_->getFrameSize() : 0;
+}
+
+bool VideoCursor::hasMoreFrames() const {
+    return position_ < getTotalFrames();
+}
+
+bool VideoCursor::isAtEnd() const {
+    return position_ >= getTotalFrames();
+}
+
+// ============ 预读 ============
+
+void VideoCursor::setReadahead(int frames) {
+    readahead_frames_ = std::max(0, frames);
+    readahead_end_ = 0;
+}
+
+void VideoCursor::updateReadahead(int frame_index) {
+    if (frame_index == last_index_ + 1) {
+        sequential_run_++;
+    } else {
+        sequential_run_ = 0;
+        readahead_end_ = frame_index + 1;
+    }
+    last_index_ = frame_index;
+
+    if (readahead_frames_ <= 0 || sequential_run_ < 1) {
+        return;
+    }
+
+    // 已提示范围剩余不足一半时推进（与内核异步预读的触发方式相同）
+    if (readahead_end_ - frame_index > readahead_frames_ / 2) {
+        return;
+    }
+    int start = std::max(readahead_end_, frame_index + 1);
+    int end = std::min(frame_index + 1 + readahead_frames_, file_->getTotalFrames());
+    if (end > start) {
+        file_->readaheadHint(start, end - start);
+        readahead_end_ = end;
+    }
+}
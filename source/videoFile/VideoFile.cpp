@@ -46,11 +46,15 @@ bool VideoFile::open(const char* path, int width, int height, int bits_per_pixel
     
     // 🎯 智能判断：根据Reader类型选择合适的open方法
     // - Raw视频Reader（MMAP, IOURING, DIRECT_READ）：需要格式参数，调用 openRaw()
-    // - 编码视频Reader（FFMPEG, RTSP）：自动检测格式，调用 open()
+    // - 图片序列Reader（IMAGE_SEQUENCE）：按格式参数缩放输出，同样调用 openRaw()
+    // - 采集Reader（V4L2）：按格式参数协商采集分辨率/像素格式，同样调用 openRaw()
+    // - 编码视频Reader（FFMPEG, RTSP, RTP）：自动检测格式，调用 open()
     
     bool is_raw_reader = (preferred_type_ == VideoReaderFactory::ReaderType::MMAP ||
                           preferred_type_ == VideoReaderFactory::ReaderType::IOURING ||
-                          preferred_type_ == VideoReaderFactory::ReaderType::DIRECT_READ);
+                          preferred_type_ == VideoReaderFactory::ReaderType::DIRECT_READ ||
+                          preferred_type_ == VideoReaderFactory::ReaderType::IMAGE_SEQUENCE ||
+                          preferred_type_ == VideoReaderFactory::ReaderType::V4L2);
     
     if (is_raw_reader) {
         // Raw视频Reader：使用传入的格式参数
@@ -220,3 +224,58 @@ void VideoFile::setBufferPool(void* pool) {
     }
 }
 
+// ============ 推送源接口（转发） ============
+
+bool VideoFile::isPushSource() const {
+    if (reader_) {
+        return reader_->isPushSource();
+    }
+    return false;
+}
+
+void VideoFile::setSourceEventCallback(IVideoReader::SourceEventCallback callback) {
+    if (reader_) {
+        reader_->setSourceEventCallback(callback);
+    }
+}
+
+// ============ 打开延迟配置（转发） ============
+
+void VideoFile::setProbeConfig(const StreamProbeConfig& config) {
+    // 创建 reader（如果还没创建），配置需在 open 之前生效
+    if (!reader_) {
+        reader_ = VideoReaderFactory::create(preferred_type_);
+    }
+    reader_->setProbeConfig(config);
+}
+
+bool VideoFile::setOutputFormat(PixelFormat format, int width, int height) {
+    if (!reader_) {
+        reader_ = VideoReaderFactory::create(preferred_type_);
+    }
+    return reader_->setOutputFormat(format, width, height);
+}
+
+// ============ 游标（转发） ============
+
+bool VideoFile::supportsCursors() const {
+    return reader_ && reader_->supportsCursors();
+}
+
+std::unique_ptr<VideoCursor> VideoFile::createCursor(int start_frame) const {
+    if (!reader_ || !reader_->isOpen()) {
+        printf("❌ ERROR: Cannot create cursor, file not opened\n");
+        return nullptr;
+    }
+    if (!reader_->supportsCursors()) {
+        printf("❌ ERROR: %s does not support cursors\n", reader_->getReaderType());
+        return nullptr;
+    }
+    return std::unique_ptr<VideoCursor>(new VideoCursor(this, start_frame));
+}
+
+void VideoFile::readaheadHint(int frame_index, int frame_count) const {
+    if (reader_) {
+        reader_->readaheadHint(frame_index, frame_count);
+    }
+}
@@ -3,6 +3,9 @@
 #include "../../include/videoFile/IoUringVideoReader.hpp"
 #include "../../include/videoFile/RtspVideoReader.hpp"
 #include "../../include/videoFile/FfmpegVideoReader.hpp"
+#include "../../include/videoFile/RtpVideoReader.hpp"
+#include "../../include/videoFile/ImageSequenceReader.hpp"
+#include "../../include/videoFile/V4l2CaptureReader.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,6 +48,12 @@ std::unique_ptr<IVideoReader> VideoReaderFactory::createByName(const char* name)
         return std::make_unique<RtspVideoReader>();
     } else if (strcmp(name, "ffmpeg") == 0) {
         return std::make_unique<FfmpegVideoReader>();
+    } else if (strcmp(name, "rtp") == 0) {
+        return std::make_unique<RtpVideoReader>();
+    } else if (strcmp(name, "images") == 0) {
+        return std::make_unique<ImageSequenceReader>();
+    } else if (strcmp(name, "v4l2") == 0) {
+        return std::make_unique<V4l2CaptureReader>();
     } else if (strcmp(name, "auto") == 0) {
         return create(ReaderType::AUTO);
     }
@@ -83,6 +92,9 @@ const char* VideoReaderFactory::typeToString(ReaderType type) {
         case ReaderType::DIRECT_READ: return "DIRECT_READ";
         case ReaderType::RTSP:        return "RTSP";
         case ReaderType::FFMPEG:      return "FFMPEG";
+        case ReaderType::RTP:         return "RTP";
+        case ReaderType::IMAGE_SEQUENCE: return "IMAGE_SEQUENCE";
+        case ReaderType::V4L2:        return "V4L2";
         default:                      return "UNKNOWN";
     }
 }
@@ -134,6 +146,15 @@ std::unique_ptr<IVideoReader> VideoReaderFactory::createByType(ReaderType type)
         case ReaderType::FFMPEG:
             return std::make_unique<FfmpegVideoReader>();
             
+        case ReaderType::RTP:
+            return std::make_unique<RtpVideoReader>();
+            
+        case ReaderType::IMAGE_SEQUENCE:
+            return std::make_unique<ImageSequenceReader>();
+            
+        case ReaderType::V4L2:
+            return std::make_unique<V4l2CaptureReader>();
+            
         case ReaderType::DIRECT_READ:
             printf("⚠️  Warning: DIRECT_READ not implemented, using mmap\n");
             return std::make_unique<MmapVideoReader>();
@@ -159,6 +180,12 @@ VideoReaderFactory::ReaderType VideoReaderFactory::getTypeFromEnvironment() {
         return ReaderType::RTSP;
     } else if (strcmp(env, "ffmpeg") == 0) {
         return ReaderType::FFMPEG;
+    } else if (strcmp(env, "rtp") == 0) {
+        return ReaderType::RTP;
+    } else if (strcmp(env, "images") == 0) {
+        return ReaderType::IMAGE_SEQUENCE;
+    } else if (strcmp(env, "v4l2") == 0) {
+        return ReaderType::V4L2;
     }
     
     return ReaderType::AUTO;